@@ -0,0 +1,323 @@
+// $Id: dskbench.cpp 1302 2026-10-19 20:41:12Z mueller $
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// 
+// Revision History: 
+// Date         Rev Version  Comment
+// 2026-10-19  1302   1.0    Initial version
+
+// dskbench replays a disk access record against a disk backend.
+//
+// The record is written by a disk unit with 'cpu0rpa0 record -start file',
+// it holds lba, block count, start time and latency of each VirtRead() and
+// VirtWrite() of a real session. dskbench creates the backend from an url
+// with Rw11VirtDisk::New(), like 'attach' does, so any scheme (file:, ram:,
+// over:, pack: and later additions) can be measured in isolation from a
+// running guest and from the rlink transport.
+//
+// Each thread opens a backend instance of its own and replays the complete
+// record, this models several systems using the same disk image. Requests
+// are issued back to back by default, with --timed the recorded start times
+// are kept. IOPS, throughput and latency percentiles for reads and writes
+// are reported. Writes modify the backend, use over: or ram: or a scratch
+// copy of the image, or skip them with --nowrite.
+//
+
+#include <time.h>
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <memory>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+#include "librtools/RerrMsg.hpp"
+#include "librtools/RosPrintf.hpp"
+#include "librw11/Rw11VirtDisk.hpp"
+#include "librw11/Rw11DiskRecorder.hpp"
+
+using namespace std;
+using namespace Retro;
+
+typedef Rw11DiskRecorder::record record;
+
+struct result {
+  vector<uint32_t> fLatRd;                  //!< read latencies (ns)
+  vector<uint32_t> fLatWr;                  //!< write latencies (ns)
+  uint64_t         fNBlkRd;                 //!< blocks read
+  uint64_t         fNBlkWr;                 //!< blocks written
+  uint64_t         fNErr;                   //!< failed accesses
+  double           fTime;                   //!< run time in sec
+  string           fEmsg;                   //!< first error message
+};
+
+static Rw11DiskRecorder::header gHdr;       // disk geometry from record
+static vector<record> gRecs;                // records to replay
+static size_t         gNThread = 1;         // replay threads
+static size_t         gNRepeat = 1;         // replay repeat count
+static bool           gTimed   = false;     // keep recorded start times
+static bool           gNoWrite = false;     // skip write records
+static bool           gCsv     = false;     // csv output
+
+//------------------------------------------+-----------------------------------
+static uint64_t TimeNs()
+{
+  return Rw11DiskRecorder::TimeNs();
+}
+
+//------------------------------------------+-----------------------------------
+static void SleepUntil(uint64_t tns)
+{
+  struct timespec ts;
+  ts.tv_sec  = time_t(tns / 1000000000);
+  ts.tv_nsec = long(tns % 1000000000);
+  while (::clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr)
+         != 0) {}
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+// replay all records nrepeat times on one backend instance
+static void Replay(Rw11VirtDisk* pdisk, result& res)
+{
+  size_t nblkmax = 1;
+  for (auto& r : gRecs) nblkmax = max(nblkmax, size_t(r.fNBlk));
+  vector<uint8_t> buf(nblkmax * gHdr.fBlkSize, 0);
+  uint64_t tspan = gRecs.empty() ? 0 : gRecs.back().fTime + 1;
+
+  RerrMsg emsg;
+  uint64_t t0 = TimeNs();
+  for (size_t irep=0; irep<gNRepeat; irep++) {
+    for (auto& r : gRecs) {
+      if (gTimed) SleepUntil(t0 + irep*tspan + r.fTime);
+      bool     ok;
+      uint64_t tbeg = TimeNs();
+      if (r.fOp == Rw11DiskRecorder::kOpRead) {
+        ok = pdisk->Read(r.fLba, r.fNBlk, buf.data(), emsg);
+      } else {
+        ok = pdisk->Write(r.fLba, r.fNBlk, buf.data(), emsg);
+      }
+      uint64_t dt = TimeNs() - tbeg;
+      uint32_t lat = dt > 0xffffffff ? 0xffffffff : uint32_t(dt);
+      if (!ok) {
+        if (res.fNErr == 0) res.fEmsg = emsg.Text();
+        res.fNErr += 1;
+      } else if (r.fOp == Rw11DiskRecorder::kOpRead) {
+        res.fLatRd.push_back(lat);
+        res.fNBlkRd += r.fNBlk;
+      } else {
+        res.fLatWr.push_back(lat);
+        res.fNBlkWr += r.fNBlk;
+      }
+    }
+  }
+  res.fTime = 1.e-9 * double(TimeNs() - t0);
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+// returns percentile p (0..1) of sorted latencies in usec
+static double Pctl(const vector<uint32_t>& lat, double p)
+{
+  if (lat.empty()) return 0.;
+  size_t ind = size_t(p * double(lat.size()-1) + 0.5);
+  return 1.e-3 * double(lat[ind]);
+}
+
+//------------------------------------------+-----------------------------------
+static double Mean(const vector<uint32_t>& lat)
+{
+  if (lat.empty()) return 0.;
+  double sum = 0.;
+  for (auto l : lat) sum += double(l);
+  return 1.e-3 * sum / double(lat.size());
+}
+
+//------------------------------------------+-----------------------------------
+static void PrintLat(const char* name, vector<uint32_t>& lat)
+{
+  sort(lat.begin(), lat.end());
+  if (gCsv) {
+    cout << "," << lat.size() << "," << Mean(lat)
+         << "," << Pctl(lat, 0.50) << "," << Pctl(lat, 0.90)
+         << "," << Pctl(lat, 0.99) << "," << Pctl(lat, 0.999)
+         << "," << Pctl(lat, 1.0);
+    return;
+  }
+  cout << "  " << name << ": n=" << lat.size();
+  if (!lat.empty()) {
+    cout << " lat(us) mean=" << RosPrintf(Mean(lat), "f", 0, 1)
+         << " p50="   << RosPrintf(Pctl(lat, 0.50),  "f", 0, 1)
+         << " p90="   << RosPrintf(Pctl(lat, 0.90),  "f", 0, 1)
+         << " p99="   << RosPrintf(Pctl(lat, 0.99),  "f", 0, 1)
+         << " p99.9=" << RosPrintf(Pctl(lat, 0.999), "f", 0, 1)
+         << " max="   << RosPrintf(Pctl(lat, 1.0),   "f", 0, 1);
+  }
+  cout << "\n";
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+// print summary of the record itself, latencies as seen in the session
+static void PrintInfo()
+{
+  result res = {};
+  for (auto& r : gRecs) {
+    if (!r.fOk) {
+      res.fNErr += 1;
+    } else if (r.fOp == Rw11DiskRecorder::kOpRead) {
+      res.fLatRd.push_back(r.fDt);
+      res.fNBlkRd += r.fNBlk;
+    } else {
+      res.fLatWr.push_back(r.fDt);
+      res.fNBlkWr += r.fNBlk;
+    }
+  }
+  double tspan = gRecs.empty() ? 0. : 1.e-9 * double(gRecs.back().fTime);
+  cout << "type=" << gHdr.fType << " blksize=" << gHdr.fBlkSize
+       << " nblock=" << gHdr.fNBlock << " geometry=" << gHdr.fNCyl
+       << "/" << gHdr.fNHead << "/" << gHdr.fNSect << "\n"
+       << "records=" << gRecs.size() << " failed=" << res.fNErr
+       << " span=" << RosPrintf(tspan, "f", 0, 3) << "s"
+       << " blkrd=" << res.fNBlkRd << " blkwr=" << res.fNBlkWr << "\n"
+       << "recorded latencies:\n";
+  PrintLat("read ", res.fLatRd);
+  PrintLat("write", res.fLatWr);
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+static void PrintHelp()
+{
+  cout << "usage: dskbench [OPTION]... RECFILE [URL]\n"
+       << "  replays the disk access record RECFILE against the disk\n"
+       << "  backend URL (any attach url, e.g. file:, ram:, over:) and\n"
+       << "  reports IOPS, throughput and latency percentiles. Without URL\n"
+       << "  the record is summarized.\n"
+       << "  Options:\n"
+       << "    --threads=N    N threads, each with its own backend instance\n"
+       << "    --repeat=N     replay the record N times\n"
+       << "    --timed        keep recorded start times (default back to back)\n"
+       << "    --nowrite      skip write records\n"
+       << "    --csv          print results as one csv line\n"
+       << "    --help         this message\n";
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+int main(int argc, char **argv)
+{
+  vector<string> pargs;
+  for (int i=1; i<argc; i++) {
+    string arg = argv[i];
+    string val;
+    size_t ieq = arg.find('=');
+    if (ieq != string::npos) val = arg.substr(ieq+1);
+    if        (arg.compare(0, 10, "--threads=") == 0) {
+      gNThread = ::strtoul(val.c_str(), nullptr, 10);
+    } else if (arg.compare(0, 9, "--repeat=") == 0) {
+      gNRepeat = ::strtoul(val.c_str(), nullptr, 10);
+    } else if (arg == "--timed") {
+      gTimed = true;
+    } else if (arg == "--nowrite") {
+      gNoWrite = true;
+    } else if (arg == "--csv") {
+      gCsv = true;
+    } else if (arg == "--help") {
+      PrintHelp();
+      return 0;
+    } else if (arg.compare(0, 1, "-") == 0 || pargs.size() >= 2) {
+      cerr << "dskbench-E: bad option or argument '" << arg
+           << "', see --help" << endl;
+      return 1;
+    } else {
+      pargs.push_back(arg);
+    }
+  }
+
+  if (pargs.empty() || gNThread == 0 || gNRepeat == 0) {
+    PrintHelp();
+    return 1;
+  }
+
+  RerrMsg emsg;
+  if (!Rw11DiskRecorder::Load(pargs[0], gHdr, gRecs, emsg)) {
+    cerr << "dskbench-E: " << emsg.Text() << endl;
+    return 1;
+  }
+  if (pargs.size() == 1) {
+    PrintInfo();
+    return 0;
+  }
+
+  // drop accesses which failed in the session, and writes if requested
+  gRecs.erase(remove_if(gRecs.begin(), gRecs.end(),
+                        [](const record& r) {
+                          return !r.fOk ||
+                            (gNoWrite && r.fOp == Rw11DiskRecorder::kOpWrite);
+                        }),
+              gRecs.end());
+
+  vector<unique_ptr<Rw11VirtDisk>> disks;
+  for (size_t i=0; i<gNThread; i++) {
+    unique_ptr<Rw11VirtDisk> up = Rw11VirtDisk::New(pargs[1], nullptr, emsg);
+    if (!up) {
+      cerr << "dskbench-E: " << emsg.Text() << endl;
+      return 1;
+    }
+    up->Setup(gHdr.fBlkSize, gHdr.fNBlock, gHdr.fNCyl, gHdr.fNHead,
+              gHdr.fNSect);
+    disks.push_back(move(up));
+  }
+
+  vector<result> res(gNThread);
+  vector<thread> threads;
+  uint64_t t0 = TimeNs();
+  for (size_t i=0; i<gNThread; i++)
+    threads.emplace_back(Replay, disks[i].get(), ref(res[i]));
+  for (auto& t: threads) t.join();
+  double twall = 1.e-9 * double(TimeNs() - t0);
+
+  result sum = {};
+  for (auto& r : res) {
+    sum.fLatRd.insert(sum.fLatRd.end(), r.fLatRd.begin(), r.fLatRd.end());
+    sum.fLatWr.insert(sum.fLatWr.end(), r.fLatWr.begin(), r.fLatWr.end());
+    sum.fNBlkRd += r.fNBlkRd;
+    sum.fNBlkWr += r.fNBlkWr;
+    sum.fNErr   += r.fNErr;
+    if (sum.fEmsg.empty()) sum.fEmsg = r.fEmsg;
+  }
+
+  size_t nops = sum.fLatRd.size() + sum.fLatWr.size();
+  double iops = twall > 0. ? double(nops) / twall : 0.;
+  double mbps = twall > 0. ? 1.e-6 * double(sum.fNBlkRd + sum.fNBlkWr) *
+                             double(gHdr.fBlkSize) / twall : 0.;
+  if (gCsv) {
+    cout << "url,threads,ops,failed,time,iops,mbps";
+    for (auto op : {"rd", "wr"})
+      for (auto col : {"n", "mean", "p50", "p90", "p99", "p999", "max"})
+        cout << "," << op << "_" << col;
+    cout << "\n";
+    cout << pargs[1] << "," << gNThread << "," << nops << "," << sum.fNErr
+         << "," << twall << "," << iops << "," << mbps;
+    PrintLat("read ", sum.fLatRd);
+    PrintLat("write", sum.fLatWr);
+    cout << "\n";
+  } else {
+    cout << "url=" << pargs[1] << " threads=" << gNThread
+         << " repeat=" << gNRepeat << (gTimed ? " timed" : "") << "\n"
+         << "ops=" << nops << " failed=" << sum.fNErr
+         << " time=" << RosPrintf(twall, "f", 0, 3) << "s"
+         << " iops=" << RosPrintf(iops, "f", 0, 0)
+         << " MB/s=" << RosPrintf(mbps, "f", 0, 1) << "\n";
+    PrintLat("read ", sum.fLatRd);
+    PrintLat("write", sum.fLatWr);
+  }
+  if (sum.fNErr) cerr << "dskbench-W: first error: " << sum.fEmsg << endl;
+
+  return sum.fNErr ? 1 : 0;
+}
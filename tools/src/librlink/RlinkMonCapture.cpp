@@ -0,0 +1,651 @@
+// $Id: RlinkMonCapture.cpp 1300 2026-10-19 19:12:37Z mueller $
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// 
+// Revision History: 
+// Date         Rev Version  Comment
+// 2026-10-19  1306   1.0.1  TLink stat in usec
+// 2026-10-19  1300   1.0    Initial version
+// ---------------------------------------------------------------------------
+
+/*!
+  \brief   Implemenation of RlinkMonCapture.
+*/
+
+#include <fcntl.h>
+#include <string.h>
+
+#include <algorithm>
+#include <mutex>
+
+#include "librtools/RosFill.hpp"
+#include "librtools/RosPrintf.hpp"
+#include "librtools/RlogMsg.hpp"
+#include "librtools/Rtools.hpp"
+
+#include "RlinkServer.hpp"
+
+#include "RlinkMonCapture.hpp"
+
+using namespace std;
+
+/*!
+  \class Retro::RlinkMonCapture
+  \brief Continuous background capture for rbd_rbmon and ibd_ibmon.
+
+  Both monitors have the same register layout and are accessed via
+  consecutive rbus addresses, the ibus registers via the rbus-ibus bridge.
+  The monitor is started in wstop mode. The fill level is polled from a
+  timer in the rlink server event loop, when the buffer is at least a
+  quarter full or the monitor stopped on a full buffer, the monitor is
+  suspended, drained with rblk's of the prudent block size and resumed.
+  Accesses to the own registers, caused by the polling, are dropped.
+
+  The link time used by polls and drains is measured, the poll period is
+  stretched such that the link load stays below the budget.
+
+  The hardware address filter (lolim/hilim) limits what is recorded. A
+  software trigger (address range, optionally writes only) can be set,
+  in that case only the last fNPre entries before the first matching
+  entry and the fNPost entries after it are recorded.
+
+  Recorded entries are written to a ring file with fixed size records
+  \code
+    header (32 bytes):
+      char[8]  magic "w11bmon1"
+      uint16   monitor type (0=rbmon, 1=ibmon)
+      uint16   unused
+      uint32   number of records in ring
+      uint64   total number of records written
+      uint64   unused
+    record (16 bytes):
+      uint64   drain time (ns, CLOCK_REALTIME)
+      uint16   d0,d1,d2,d3 raw monitor data
+  \endcode
+  When more records than fit are written the oldest are overwritten.
+  All values are in host byte order.
+*/
+
+// all method definitions in namespace Retro
+namespace Retro {
+
+//------------------------------------------+-----------------------------------
+// constants definitions
+
+const size_t   RlinkMonCapture::kRingSize;
+const size_t   RlinkMonCapture::kHdrSize;
+const size_t   RlinkMonCapture::kRecSize;
+const uint16_t RlinkMonCapture::kCNTL;
+const uint16_t RlinkMonCapture::kSTAT;
+const uint16_t RlinkMonCapture::kHILIM;
+const uint16_t RlinkMonCapture::kLOLIM;
+const uint16_t RlinkMonCapture::kADDR;
+const uint16_t RlinkMonCapture::kDATA;
+const uint16_t RlinkMonCapture::kCNTL_FUNC_STO;
+const uint16_t RlinkMonCapture::kCNTL_FUNC_STA;
+const uint16_t RlinkMonCapture::kCNTL_FUNC_SUS;
+const uint16_t RlinkMonCapture::kCNTL_FUNC_RES;
+const uint16_t RlinkMonCapture::kSTAT_V_BSIZE;
+const uint16_t RlinkMonCapture::kSTAT_B_BSIZE;
+const uint16_t RlinkMonCapture::kSTAT_M_WRAP;
+const uint16_t RlinkMonCapture::kSTAT_M_RUN;
+const uint16_t RlinkMonCapture::kADDR_V_LADDR;
+const uint16_t RlinkMonCapture::kADDR_B_LADDR;
+
+static const char kFileMagic[8] = {'w','1','1','b','m','o','n','1'};
+
+//------------------------------------------+-----------------------------------
+//! Default setup.
+
+RlinkMonCapture::setup::setup()
+  : fPeriod(0.01),
+    fBudget(0.05),
+    fFile(),
+    fNRec(1u<<20),
+    fLoLim(0x0000),
+    fHiLim(0xffff),
+    fTrig(false),
+    fTrigLo(0x0000),
+    fTrigHi(0xffff),
+    fTrigWOnly(false),
+    fNPre(0),
+    fNPost(0)
+{}
+
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Constructor
+
+  \param pserv    server used for Exec() and poll handler
+  \param type     monitor type
+  \param rbbase   rbus address of cntl register
+  \param selflo   own register range low, decoded address
+  \param selfhi   own register range high, decoded address
+  \param cntlena  additional cntl bits used at start
+ */
+
+RlinkMonCapture::RlinkMonCapture(RlinkServer* pserv, montype type,
+                                 uint16_t rbbase, uint16_t selflo,
+                                 uint16_t selfhi, uint16_t cntlena)
+  : fpServ(pserv),
+    fType(type),
+    fRbBase(rbbase),
+    fSelfLo(selflo),
+    fSelfHi(selfhi),
+    fCntlEna(cntlena),
+    fSetup(),
+    fActive(false),
+    fTriggered(false),
+    fDone(false),
+    fNMax(0),
+    fPeriodEff(),
+    fTLinkAvg(0.),
+    fTLinkPoll(0.),
+    fTimer("RlinkMonCapture::fTimer."),
+    fFile("RlinkMonCapture::fFile."),
+    fNRecord(0),
+    fOut(),
+    fNPostDone(0),
+    fBuf(),
+    fPre(),
+    fNPre(0),
+    fRing(kRingSize),
+    fNEntry(0),
+    fStats()
+{
+  fStats.Define(kStatNPoll,      "NPoll",      "polls");
+  fStats.Define(kStatNDrain,     "NDrain",     "drains");
+  fStats.Define(kStatNRblk,      "NRblk",      "rblk of data reg");
+  fStats.Define(kStatNEntry,     "NEntry",     "entries read");
+  fStats.Define(kStatNSelfDrop,  "NSelfDrop",  "own reg accesses dropped");
+  fStats.Define(kStatNOverrun,   "NOverrun",   "monitor buffer overruns");
+  fStats.Define(kStatNRecord,    "NRecord",    "records written to file");
+  fStats.Define(kStatNPeriodAdj, "NPeriodAdj", "period adjusts for budget");
+  fStats.Define(kStatTLink,      "TLink",      "link time used (us)");
+}
+
+//------------------------------------------+-----------------------------------
+//! Destructor
+
+RlinkMonCapture::~RlinkMonCapture()
+{
+  if (fTimer.IsOpen())
+    Rtools::Catch2Cerr(__func__, [this](){ StopTimer(); } );
+}
+
+//------------------------------------------+-----------------------------------
+//! Start monitor and capture.
+
+bool RlinkMonCapture::Start(const setup& set, RerrMsg& emsg)
+{
+  if (!set.fPeriod.IsPositive() || set.fBudget < 0. || set.fBudget >= 1. ||
+      set.fNRec == 0) {
+    emsg.Init("RlinkMonCapture::Start", "bad period, budget or nrec");
+    return false;
+  }
+  if (fActive && !Stop(emsg)) return false;
+
+  fSetup = set;
+  if (fType == kTypeIbmon) {                // clip to ibmon/rbmon range
+    fSetup.fLoLim = max(fSetup.fLoLim, uint16_t(0160000));
+    fSetup.fHiLim = min(fSetup.fHiLim, uint16_t(0177776));
+  } else {
+    fSetup.fHiLim = min(fSetup.fHiLim, uint16_t(0xfffb));
+  }
+  if (fSetup.fLoLim > fSetup.fHiLim) {
+    emsg.Init("RlinkMonCapture::Start", "lolim > hilim");
+    return false;
+  }
+
+  fTriggered = !fSetup.fTrig;
+  fDone      = false;
+  fNPostDone = 0;
+  fNRecord   = 0;
+  fOut.clear();
+  fPre.assign(fSetup.fTrig ? fSetup.fNPre : 0, rawent());
+  fNPre      = 0;
+  fNEntry    = 0;
+  fPeriodEff = fSetup.fPeriod;
+  fTLinkAvg  = 0.;
+
+  if (fSetup.fFile.length()) {
+    if (!fFile.Open(fSetup.fFile.c_str(), O_RDWR|O_CREAT|O_TRUNC, 0644, emsg))
+      return false;
+    if (!WriteHeader(emsg)) return false;
+  }
+
+  RlinkCommandList clist;
+  clist.AddWreg(fRbBase+kCNTL,  kCNTL_FUNC_STO);
+  clist.AddWreg(fRbBase+kLOLIM, fSetup.fLoLim);
+  clist.AddWreg(fRbBase+kHILIM, fSetup.fHiLim);
+  clist.AddWreg(fRbBase+kADDR,  0);
+  clist.AddWreg(fRbBase+kCNTL,  fCntlEna|WstopMask()|kCNTL_FUNC_STA);
+  size_t ista = clist.AddRreg(fRbBase+kSTAT);
+  if (!Server().Exec(clist, emsg)) return false;
+  fNMax = size_t(512) << ((clist[ista].Data()>>kSTAT_V_BSIZE) & kSTAT_B_BSIZE);
+
+  fActive = true;
+  fTimer.Open();
+  Server().AddPollHandler([this](const pollfd& pfd)
+                            { return TimerHandler(pfd); },
+                          fTimer.Fd(), POLLIN);
+  fTimer.SetRelative(fPeriodEff);
+  return true;
+}
+
+//------------------------------------------+-----------------------------------
+//! Stop capture, drain remaining entries and stop monitor.
+
+bool RlinkMonCapture::Stop(RerrMsg& emsg)
+{
+  StopTimer();
+  bool rc = true;
+  if (fActive) {
+    rc = Poll(true, emsg);
+    fActive = false;
+    RlinkCommandList clist;
+    clist.AddWreg(fRbBase+kCNTL, kCNTL_FUNC_STO);
+    if (rc) rc = Server().Exec(clist, emsg);
+  }
+  if (fFile.IsOpen()) {
+    if (rc) rc = FlushFile(emsg);
+    fFile.Close();
+  }
+  return rc;
+}
+
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Poll monitor fill level and drain when needed or forced.
+ */
+
+bool RlinkMonCapture::Poll(bool force, RerrMsg& emsg)
+{
+  if (!fActive) return true;
+  fStats.Inc(kStatNPoll);
+  fTLinkPoll = 0.;
+
+  RlinkCommandList clist;
+  size_t ista = clist.AddRreg(fRbBase+kSTAT);
+  size_t iadr = clist.AddRreg(fRbBase+kADDR);
+  if (!ExecTimed(clist, emsg)) return false;
+  uint16_t stat  = clist[ista].Data();
+  size_t   laddr = (clist[iadr].Data()>>kADDR_V_LADDR) & kADDR_B_LADDR;
+
+  if ((stat & kSTAT_M_RUN) && !force && laddr < fNMax/4) {
+    AdjustPeriod(fTLinkPoll);
+    return true;
+  }
+
+  fStats.Inc(kStatNDrain);
+  if (stat & kSTAT_M_RUN) {                 // suspend, get final address
+    clist.Clear();
+    clist.AddWreg(fRbBase+kCNTL, fCntlEna|WstopMask()|kCNTL_FUNC_SUS);
+    ista = clist.AddRreg(fRbBase+kSTAT);
+    iadr = clist.AddRreg(fRbBase+kADDR);
+    if (!ExecTimed(clist, emsg)) return false;
+    stat  = clist[ista].Data();
+    laddr = (clist[iadr].Data()>>kADDR_V_LADDR) & kADDR_B_LADDR;
+  }
+
+  bool stopped = !(stat & kSTAT_M_RUN);     // stopped due to wstop ?
+  if (stopped) fStats.Inc(kStatNOverrun);
+  size_t nent = (stopped && (stat & kSTAT_M_WRAP)) ? fNMax : laddr;
+  if (!ReadEntries(nent, emsg)) return false;
+
+  clist.Clear();                            // reset address, continue
+  clist.AddWreg(fRbBase+kADDR, 0);
+  if (fDone) {                              // post trigger count reached
+    clist.AddWreg(fRbBase+kCNTL, kCNTL_FUNC_STO);
+  } else {
+    clist.AddWreg(fRbBase+kCNTL, fCntlEna|WstopMask()|
+                  (stopped ? kCNTL_FUNC_STA : kCNTL_FUNC_RES));
+  }
+  if (!ExecTimed(clist, emsg)) return false;
+
+  AdjustPeriod(fTLinkPoll);
+  if (fFile.IsOpen()) return FlushFile(emsg);
+  return true;
+}
+
+//------------------------------------------+-----------------------------------
+//! Returns link load, average link time per poll over poll period.
+
+double RlinkMonCapture::LinkLoad() const
+{
+  double period = fPeriodEff.ToDouble();
+  return (period > 0.) ? fTLinkAvg/period : 0.;
+}
+
+//------------------------------------------+-----------------------------------
+//! Returns the last \a nent captured entries, oldest first.
+
+void RlinkMonCapture::GetLast(std::vector<rawent>& list, size_t nent) const
+{
+  size_t navail = size_t(min(fNEntry, uint64_t(kRingSize)));
+  if (nent > navail) nent = navail;
+  list.clear();
+  list.reserve(nent);
+  for (size_t i=0; i<nent; i++) {
+    list.push_back(fRing[size_t((fNEntry-nent+i) % kRingSize)]);
+  }
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Decode raw entries.
+
+  The result has the same layout as the lists returned by the \c read
+  procs of the Tcl packages \c rbmoni and \c ibd_ibmon, so their \c print
+  procs can be used.
+ */
+
+void RlinkMonCapture::Decode(montype type, const std::vector<rawent>& raw,
+                             std::vector<entry>& list)
+{
+  list.resize(raw.size());
+  for (size_t i=0; i<raw.size(); i++) {
+    const uint16_t* d = raw[i].fData;
+    entry& e = list[i];
+    e.fAddr = DecodeAddr(type, d);
+    e.fData = d[1];
+    if (type == kTypeRbmon) {
+      e.fFlag  = d[3] >> 8;
+      e.fDelay = ((d[3] & 0xff) << 6) | (d[2] >> 10);
+      e.fNBusy = d[2] & 0x3ff;
+      // set bnext flag when burst is set in following entry
+      if (i > 0 && (e.fFlag & 0x80)) list[i-1].fFlag |= 0x100;
+    } else {
+      e.fFlag  = ((d[3] >> 4) & 0x0f00) |   // burst,tout,nak,ack -> 11:8
+                 ((d[3] >> 4) & 0x0080) |   // busy               -> 7
+                 ((d[0] & 0x0001) << 5) |   // cacc               -> 5
+                 ((d[0] >> 9) & 0x0010) |   // racc               -> 4
+                 ((d[3] >> 5) & 0x0008) |   // rmw                -> 3
+                 ((d[0] >> 13) & 0x0006) |  // be1,be0            -> 2:1
+                 ((d[3] >> 9) & 0x0001);    // we                 -> 0
+      e.fDelay = d[2];
+      e.fNBusy = d[3] & 0xff;
+    }
+  }
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+//! Load all records from a ring file, oldest first.
+
+bool RlinkMonCapture::LoadFile(const std::string& fname, montype& type,
+                               std::vector<rawent>& raw, RerrMsg& emsg)
+{
+  RfileFd fd("RlinkMonCapture::LoadFile.fd.");
+  if (!fd.Open(fname.c_str(), O_RDONLY, emsg)) return false;
+
+  uint8_t hdr[kHdrSize];
+  if (fd.Read(hdr, kHdrSize, emsg) != ssize_t(kHdrSize) ||
+      ::memcmp(hdr, kFileMagic, 8) != 0) {
+    emsg.Init("RlinkMonCapture::LoadFile",
+              string("'") + fname + "' is not a monitor capture file");
+    return false;
+  }
+  uint16_t itype;
+  uint32_t nrec;
+  uint64_t ntot;
+  ::memcpy(&itype, hdr+8,  2);
+  ::memcpy(&nrec,  hdr+12, 4);
+  ::memcpy(&ntot,  hdr+16, 8);
+  type = (itype == kTypeIbmon) ? kTypeIbmon : kTypeRbmon;
+
+  size_t nent = size_t(min(ntot, uint64_t(nrec)));
+  size_t ibeg = (ntot > nrec) ? size_t(ntot % nrec) : 0;
+  vector<uint8_t> buf(nent*kRecSize);
+  if (nent > 0 &&
+      fd.Read(buf.data(), buf.size(), emsg) != ssize_t(buf.size())) {
+    emsg.Init("RlinkMonCapture::LoadFile", "truncated file");
+    return false;
+  }
+
+  raw.resize(nent);
+  for (size_t i=0; i<nent; i++) {
+    const uint8_t* prec = buf.data() + ((ibeg+i) % nent)*kRecSize;
+    ::memcpy(&raw[i].fTime, prec,   8);
+    ::memcpy(raw[i].fData,  prec+8, 8);
+  }
+  return true;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+void RlinkMonCapture::Dump(std::ostream& os, int ind, const char* text,
+                           int detail) const
+{
+  RosFill bl(ind);
+  os << bl << (text?text:"--") << "RlinkMonCapture @ " << this << endl;
+
+  os << bl << "  fpServ:          " << fpServ << endl;
+  os << bl << "  fType:           " << fType << endl;
+  os << bl << "  fRbBase:         " << RosPrintf(fRbBase,"x",4) << endl;
+  os << bl << "  fSelfLo/Hi:      " << RosPrintf(fSelfLo,"o0",6) << " "
+                                    << RosPrintf(fSelfHi,"o0",6) << endl;
+  os << bl << "  fActive:         " << RosPrintf(fActive) << endl;
+  os << bl << "  fTriggered:      " << RosPrintf(fTriggered) << endl;
+  os << bl << "  fDone:           " << RosPrintf(fDone) << endl;
+  os << bl << "  fNMax:           " << fNMax << endl;
+  os << bl << "  fPeriodEff:      " << fPeriodEff << endl;
+  os << bl << "  fTLinkAvg:       " << fTLinkAvg << endl;
+  os << bl << "  fFile:           " << fFile.Fd() << endl;
+  os << bl << "  fNRecord:        " << fNRecord << endl;
+  os << bl << "  fNEntry:         " << fNEntry << endl;
+  fStats.Dump(os, ind+2, "fStats: ", detail-1);
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+//! Handler for poll timer, runs in server context.
+
+int RlinkMonCapture::TimerHandler(const pollfd& pfd)
+{
+  // bail-out and cancel handler if poll returns an error event
+  if (pfd.revents & (~pfd.events)) return -1;
+
+  fTimer.Read();                            // harvest expiration count
+
+  // lock connect to protect capture state against Tcl side accesses
+  lock_guard<RlinkConnect> lock(Server().Connect());
+  if (!fActive) return 0;
+
+  RerrMsg emsg;
+  if (!Poll(false, emsg)) {
+    RlogMsg lmsg(Server().LogFile());
+    lmsg << "-E moncap: poll failed: " << emsg;
+  }
+  if (fDone) {                              // monitor stopped, close file
+    fActive = false;
+    if (fFile.IsOpen()) fFile.Close();
+    return 0;
+  }
+  fTimer.SetRelative(fPeriodEff);
+  return 0;
+}
+
+//------------------------------------------+-----------------------------------
+//! Read \a nent entries starting at monitor address zero.
+
+bool RlinkMonCapture::ReadEntries(size_t nent, RerrMsg& emsg)
+{
+  size_t nword  = 4*nent;
+  size_t blkmax = (Server().Connect().BlockSizePrudent()/4)*4;
+  fBuf.resize(nword);
+
+  RlinkCommandList clist;
+  clist.AddWreg(fRbBase+kADDR, 0);
+  size_t ndone = 0;
+  while (nword > ndone) {
+    size_t nblk = min(blkmax, nword-ndone);
+    clist.AddRblk(fRbBase+kDATA, fBuf.data()+ndone, nblk);
+    if (!ExecTimed(clist, emsg)) return false;
+    fStats.Inc(kStatNRblk);
+    ndone += nblk;
+    clist.Clear();
+  }
+
+  Rtime tnow(CLOCK_REALTIME);
+  rawent ent;
+  ent.fTime = uint64_t(tnow.Sec())*1000000000ull + uint64_t(tnow.NSec());
+  for (size_t i=0; i<nent; i++) {
+    ::memcpy(ent.fData, fBuf.data()+4*i, sizeof(ent.fData));
+    Process(ent);
+  }
+  fStats.Inc(kStatNEntry, double(nent));
+  return true;
+}
+
+//------------------------------------------+-----------------------------------
+//! Handle one entry: drop self accesses, check trigger, record.
+
+void RlinkMonCapture::Process(const rawent& ent)
+{
+  uint16_t addr = DecodeAddr(fType, ent.fData);
+  if (addr >= fSelfLo && addr <= fSelfHi) {
+    fStats.Inc(kStatNSelfDrop);
+    return;
+  }
+
+  fRing[size_t(fNEntry % kRingSize)] = ent;
+  fNEntry += 1;
+  if (fDone) return;
+
+  if (!fTriggered) {
+    bool we = ent.fData[3] & 0x0200;        // we is d3 bit 9 for both
+    if (addr < fSetup.fTrigLo || addr > fSetup.fTrigHi ||
+        (fSetup.fTrigWOnly && !we)) {
+      if (fPre.size()) fPre[size_t(fNPre++ % fPre.size())] = ent;
+      return;
+    }
+    fTriggered = true;                      // trigger seen, flush pre ring
+    size_t npre = size_t(min(fNPre, uint64_t(fPre.size())));
+    for (size_t i=0; i<npre; i++) {
+      Record(fPre[size_t((fNPre-npre+i) % fPre.size())]);
+    }
+  }
+
+  Record(ent);
+  if (fSetup.fTrig && fSetup.fNPost > 0 && ++fNPostDone >= fSetup.fNPost)
+    fDone = true;
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+//! Returns decoded address of raw entry.
+
+uint16_t RlinkMonCapture::DecodeAddr(montype type, const uint16_t* data)
+{
+  if (type == kTypeRbmon) return data[0];
+  return 0160000 | (data[0] & 017776);
+}
+
+//------------------------------------------+-----------------------------------
+//! Queue one entry for the ring file.
+
+void RlinkMonCapture::Record(const rawent& ent)
+{
+  if (fFile.IsOpen()) fOut.push_back(ent);
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+//! Write pending records to ring file and update header.
+
+bool RlinkMonCapture::FlushFile(RerrMsg& emsg)
+{
+  if (fOut.empty()) return true;
+
+  uint32_t nrec = fSetup.fNRec;
+  vector<uint8_t> obuf;
+  size_t i = 0;
+  while (i < fOut.size()) {
+    size_t irec = size_t(fNRecord % nrec);  // write up to end of ring
+    size_t nseg = min(fOut.size()-i, size_t(nrec)-irec);
+    obuf.resize(nseg*kRecSize);
+    for (size_t j=0; j<nseg; j++) {
+      ::memcpy(obuf.data()+j*kRecSize,   &fOut[i+j].fTime, 8);
+      ::memcpy(obuf.data()+j*kRecSize+8, fOut[i+j].fData,  8);
+    }
+    if (fFile.Seek(off_t(kHdrSize + irec*kRecSize), SEEK_SET, emsg) < 0 ||
+        !fFile.WriteAll(obuf.data(), obuf.size(), emsg)) return false;
+    fNRecord += nseg;
+    fStats.Inc(kStatNRecord, double(nseg));
+    i += nseg;
+  }
+  fOut.clear();
+  return WriteHeader(emsg);
+}
+
+//------------------------------------------+-----------------------------------
+//! Write ring file header.
+
+bool RlinkMonCapture::WriteHeader(RerrMsg& emsg)
+{
+  uint8_t  hdr[kHdrSize] = {};
+  uint16_t type = fType;
+  uint32_t nrec = fSetup.fNRec;
+  ::memcpy(hdr,    kFileMagic, 8);
+  ::memcpy(hdr+8,  &type,      2);
+  ::memcpy(hdr+12, &nrec,      4);
+  ::memcpy(hdr+16, &fNRecord,  8);
+  if (fFile.Seek(0, SEEK_SET, emsg) < 0) return false;
+  return fFile.WriteAll(hdr, kHdrSize, emsg);
+}
+
+//------------------------------------------+-----------------------------------
+//! Update average link time and stretch period to stay within budget.
+
+void RlinkMonCapture::AdjustPeriod(double dt)
+{
+  fTLinkAvg = (fTLinkAvg > 0.) ? 0.875*fTLinkAvg + 0.125*dt : dt;
+  if (fSetup.fBudget <= 0.) return;
+
+  double preq = fSetup.fPeriod.ToDouble();
+  double peff = max(preq, fTLinkAvg/fSetup.fBudget);
+  double pcur = fPeriodEff.ToDouble();
+  // only adjust on 10% change to avoid jitter in effective period
+  if (peff > 1.1*pcur || peff < 0.9*pcur) {
+    fPeriodEff = Rtime(peff);
+    fStats.Inc(kStatNPeriodAdj);
+  }
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+//! Exec \a clist and account the link time used.
+
+bool RlinkMonCapture::ExecTimed(RlinkCommandList& clist, RerrMsg& emsg)
+{
+  Rtime tbeg(CLOCK_MONOTONIC);
+  bool rc = Server().Exec(clist, emsg);
+  double dt = (Rtime(CLOCK_MONOTONIC) - tbeg).ToDouble();
+  fTLinkPoll += dt;
+  fStats.Inc(kStatTLink, 1.e6*dt);
+  return rc;
+}
+
+//------------------------------------------+-----------------------------------
+//! Stop poll timer and remove its poll handler.
+
+void RlinkMonCapture::StopTimer()
+{
+  if (!fTimer.IsOpen()) return;
+  Server().RemovePollHandler(fTimer.Fd());
+  fTimer.Close();
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+//! Returns cntl.wstop mask, differs between rbmon and ibmon.
+
+uint16_t RlinkMonCapture::WstopMask() const
+{
+  return (fType == kTypeRbmon) ? 0x0008 : 0x0040;
+}
+
+} // end namespace Retro
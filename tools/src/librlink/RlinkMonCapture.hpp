@@ -0,0 +1,193 @@
+// $Id: RlinkMonCapture.hpp 1300 2026-10-19 19:12:37Z mueller $
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// 
+// Revision History: 
+// Date         Rev Version  Comment
+// 2026-10-19  1306   1.0.1  TLink stat in usec
+// 2026-10-19  1300   1.0    Initial version
+// ---------------------------------------------------------------------------
+
+
+/*!
+  \brief   Declaration of class RlinkMonCapture.
+*/
+
+#ifndef included_Retro_RlinkMonCapture
+#define included_Retro_RlinkMonCapture 1
+
+#include <poll.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <ostream>
+
+#include "librtools/Rstats.hpp"
+#include "librtools/RerrMsg.hpp"
+#include "librtools/Rtime.hpp"
+#include "librtools/RtimerFd.hpp"
+#include "librtools/RfileFd.hpp"
+
+#include "RlinkCommandList.hpp"
+
+namespace Retro {
+
+  class RlinkServer;                        // forw decl to avoid circular incl
+
+  class RlinkMonCapture {
+    public:
+    // monitor types
+      enum montype {
+        kTypeRbmon = 0,                     //!< rbd_rbmon rbus monitor
+        kTypeIbmon = 1                      //!< ibd_ibmon ibus monitor
+      };
+
+    // capture setup
+      struct setup {
+        Rtime       fPeriod;                //!< poll period
+        double      fBudget;                //!< link time budget (fraction)
+        std::string fFile;                  //!< ring file name (or empty)
+        uint32_t    fNRec;                  //!< ring file size (records)
+        uint16_t    fLoLim;                 //!< hardware filter low limit
+        uint16_t    fHiLim;                 //!< hardware filter high limit
+        bool        fTrig;                  //!< trigger enabled
+        uint16_t    fTrigLo;                //!< trigger address low limit
+        uint16_t    fTrigHi;                //!< trigger address high limit
+        bool        fTrigWOnly;             //!< trigger on writes only
+        uint32_t    fNPre;                  //!< entries kept before trigger
+        uint32_t    fNPost;                 //!< entries from trigger on (0=all)
+                    setup();
+      };
+
+    // a decoded entry, same layout as returned by rbmoni/ibd_ibmon read
+      struct entry {
+        uint16_t    fFlag;                  //!< flags (FLAGS pseudo register)
+        uint16_t    fAddr;                  //!< address
+        uint16_t    fData;                  //!< data
+        uint16_t    fDelay;                 //!< delay to previous entry
+        uint16_t    fNBusy;                 //!< number of busy cycles
+      };
+
+    // a raw entry with capture time stamp
+      struct rawent {
+        uint64_t    fTime;                  //!< drain time (ns, realtime)
+        uint16_t    fData[4];               //!< monitor data d0..d3
+      };
+
+                    RlinkMonCapture(RlinkServer* pserv, montype type,
+                                    uint16_t rbbase, uint16_t selflo,
+                                    uint16_t selfhi, uint16_t cntlena);
+                   ~RlinkMonCapture();
+
+                    RlinkMonCapture(const RlinkMonCapture&) = delete;
+      RlinkMonCapture& operator=(const RlinkMonCapture&) = delete;
+
+      RlinkServer&  Server() const;
+      montype       Type() const;
+
+      bool          Start(const setup& set, RerrMsg& emsg);
+      bool          Stop(RerrMsg& emsg);
+      bool          Poll(bool force, RerrMsg& emsg);
+      bool          IsActive() const;
+      bool          Triggered() const;
+      bool          Done() const;
+      const setup&  Setup() const;
+      const Rtime&  PeriodEff() const;
+      double        LinkLoad() const;
+      uint64_t      NEntry() const;
+      uint64_t      NRecord() const;
+
+      void          GetLast(std::vector<rawent>& list, size_t nent) const;
+      static void   Decode(montype type, const std::vector<rawent>& raw,
+                           std::vector<entry>& list);
+      static bool   LoadFile(const std::string& fname, montype& type,
+                             std::vector<rawent>& raw, RerrMsg& emsg);
+
+      Rstats&       Stats();
+      void          Dump(std::ostream& os, int ind=0, const char* text=0,
+                         int detail=0) const;
+
+    // some constants (also defined in cpp)
+      static const size_t   kRingSize = 4096;     //!< in-memory entries
+      static const size_t   kHdrSize  = 32;       //!< ring file header size
+      static const size_t   kRecSize  = 16;       //!< ring file record size
+
+      static const uint16_t kCNTL      = 0;       //!< cntl reg offset
+      static const uint16_t kSTAT      = 1;       //!< stat reg offset
+      static const uint16_t kHILIM     = 2;       //!< hilim reg offset
+      static const uint16_t kLOLIM     = 3;       //!< lolim reg offset
+      static const uint16_t kADDR      = 4;       //!< addr reg offset
+      static const uint16_t kDATA      = 5;       //!< data reg offset
+
+      static const uint16_t kCNTL_FUNC_STO = 0x4; //!< cntl.func: stop
+      static const uint16_t kCNTL_FUNC_STA = 0x5; //!< cntl.func: start
+      static const uint16_t kCNTL_FUNC_SUS = 0x6; //!< cntl.func: suspend
+      static const uint16_t kCNTL_FUNC_RES = 0x7; //!< cntl.func: resume
+      static const uint16_t kSTAT_V_BSIZE  = 13;  //!< stat.bsize shift
+      static const uint16_t kSTAT_B_BSIZE  = 0x7; //!< stat.bsize bit mask
+      static const uint16_t kSTAT_M_WRAP   = 0x4; //!< stat.wrap mask
+      static const uint16_t kSTAT_M_RUN    = 0x1; //!< stat.run mask
+      static const uint16_t kADDR_V_LADDR  = 2;   //!< addr.laddr shift
+      static const uint16_t kADDR_B_LADDR  = 0x3fff; //!< addr.laddr bit mask
+
+    // statistics counter indices
+      enum stats {
+        kStatNPoll = 0,                     //!< polls
+        kStatNDrain,                        //!< drains
+        kStatNRblk,                         //!< rblk's of data reg
+        kStatNEntry,                        //!< entries read
+        kStatNSelfDrop,                     //!< own register accesses dropped
+        kStatNOverrun,                      //!< monitor buffer overruns
+        kStatNRecord,                       //!< records written to file
+        kStatNPeriodAdj,                    //!< period adjusts for budget
+        kStatTLink,                         //!< link time used (us)
+        kDimStat
+      };
+
+    protected:
+      int           TimerHandler(const pollfd& pfd);
+      bool          ReadEntries(size_t nent, RerrMsg& emsg);
+      void          Process(const rawent& ent);
+      static uint16_t DecodeAddr(montype type, const uint16_t* data);
+      void          Record(const rawent& ent);
+      bool          FlushFile(RerrMsg& emsg);
+      bool          WriteHeader(RerrMsg& emsg);
+      void          AdjustPeriod(double dt);
+      bool          ExecTimed(RlinkCommandList& clist, RerrMsg& emsg);
+      void          StopTimer();
+      uint16_t      WstopMask() const;
+
+    protected:
+      RlinkServer*  fpServ;                 //!< server back pointer
+      montype       fType;                  //!< monitor type
+      uint16_t      fRbBase;                //!< rbus address of cntl reg
+      uint16_t      fSelfLo;                //!< own register range low
+      uint16_t      fSelfHi;                //!< own register range high
+      uint16_t      fCntlEna;               //!< cntl bits used for start
+      setup         fSetup;                 //!< active setup
+      bool          fActive;                //!< capture active
+      bool          fTriggered;             //!< trigger seen
+      bool          fDone;                  //!< post trigger count reached
+      size_t        fNMax;                  //!< monitor buffer size
+      Rtime         fPeriodEff;             //!< effective poll period
+      double        fTLinkAvg;              //!< average link time per poll
+      double        fTLinkPoll;             //!< link time of current poll
+      RtimerFd      fTimer;                 //!< poll timer
+      RfileFd       fFile;                  //!< ring file
+      uint64_t      fNRecord;               //!< records written to file
+      std::vector<rawent>   fOut;           //!< records pending for file
+      uint32_t      fNPostDone;             //!< entries after trigger
+      std::vector<uint16_t> fBuf;           //!< readout buffer
+      std::vector<rawent>   fPre;           //!< pre trigger ring
+      uint64_t      fNPre;                  //!< entries put to pre ring
+      std::vector<rawent>   fRing;          //!< last entries ring
+      uint64_t      fNEntry;                //!< entries captured
+      Rstats        fStats;                 //!< statistics
+  };
+
+} // end namespace Retro
+
+#include "RlinkMonCapture.ipp"
+
+#endif
@@ -0,0 +1,97 @@
+// $Id: RlinkMonCapture.ipp 1300 2026-10-19 19:12:37Z mueller $
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// 
+// Revision History: 
+// Date         Rev Version  Comment
+// 2026-10-19  1300   1.0    Initial version
+// ---------------------------------------------------------------------------
+
+/*!
+  \brief   Implemenation (inline) of RlinkMonCapture.
+*/
+
+// all method definitions in namespace Retro
+namespace Retro {
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+inline RlinkServer& RlinkMonCapture::Server() const
+{
+  return *fpServ;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+inline RlinkMonCapture::montype RlinkMonCapture::Type() const
+{
+  return fType;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+inline bool RlinkMonCapture::IsActive() const
+{
+  return fActive;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+inline bool RlinkMonCapture::Triggered() const
+{
+  return fTriggered;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+inline bool RlinkMonCapture::Done() const
+{
+  return fDone;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+inline const RlinkMonCapture::setup& RlinkMonCapture::Setup() const
+{
+  return fSetup;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+inline const Rtime& RlinkMonCapture::PeriodEff() const
+{
+  return fPeriodEff;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+inline uint64_t RlinkMonCapture::NEntry() const
+{
+  return fNEntry;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+inline uint64_t RlinkMonCapture::NRecord() const
+{
+  return fNRecord;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+inline Rstats& RlinkMonCapture::Stats()
+{
+  return fStats;
+}
+
+} // end namespace Retro
@@ -1,9 +1,11 @@
 // $Id: RlinkPort.cpp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2011-2018 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2011-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1295   1.6    add busy-poll mode (spin= url option)
+// 2026-10-19  1294   1.5    add ApplySched()
 // 2018-12-19  1090   1.4.4  use RosPrintf(bool)
 // 2018-12-18  1089   1.4.3  use c++ style casts
 // 2017-04-29   888   1.4.2  BUGFIX: RawRead(): proper irc for exactsize=false
@@ -74,6 +76,9 @@ RlinkPort::RlinkPort()
     fTraceLevel(0),
     fTsLastRead(),
     fTsLastWrite(),
+    fSpinTime(0),
+    fSpinWin(0),
+    fSpinAvg(0.),
     fStats()
 {
   fStats.Define(kStatNPortWrite,    "NPortWrite", "Port::Write() calls");
@@ -82,6 +87,10 @@ RlinkPort::RlinkPort()
   fStats.Define(kStatNPortRxByt,    "NPortRxByt", "Port Rx bytes rcvd");
   fStats.Define(kStatNPortRawWrite, "NPortRawWrite", "Port::RawWrite() calls");
   fStats.Define(kStatNPortRawRead,  "NPortRawRead",  "Port::RawRead() calls");
+  fStats.Define(kStatNPortSpin,     "NPortSpin",     "Port reads busy-polled");
+  fStats.Define(kStatNPortSpinHit,  "NPortSpinHit",  "busy-poll hits");
+  fStats.Define(kStatNPortSpinMiss, "NPortSpinMiss", "busy-poll misses");
+  fStats.Define(kStatTPortSpin,     "TPortSpin",     "busy-poll time (usec)");
 }
 
 //------------------------------------------+-----------------------------------
@@ -124,7 +133,20 @@ int RlinkPort::Read(uint8_t* buf, size_t size, const Rtime& timeout,
 
   fStats.Inc(kStatNPortRead);
 
-  bool rdpoll = PollRead(timeout);
+  bool rdpoll = false;
+  if (fSpinTime > 0) {                      // busy-poll mode
+    Rtime tbeg(CLOCK_MONOTONIC);
+    Rtime tused;
+    rdpoll = SpinRead(timeout, tused);
+    if (!rdpoll) {                          // spin missed, fall back to poll
+      Rtime trest = timeout - tused;
+      if (trest.IsNegative()) trest.Clear();
+      rdpoll = PollRead(trest);
+      if (rdpoll) SpinUpdate(Rtime(CLOCK_MONOTONIC) - tbeg);
+    }
+  } else {
+    rdpoll = PollRead(timeout);
+  }
   if (!rdpoll) return kTout;
 
   int irc = -1;
@@ -244,6 +266,124 @@ bool RlinkPort::PollRead(const Rtime& timeout)
   return true;
 }
 
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Setup busy-poll mode from the \c spin=usec url option.
+
+  Must be called by the Open() of concrete ports after the url was parsed.
+ */
+
+bool RlinkPort::SetupSpin(RerrMsg& emsg)
+{
+  fSpinTime = 0;
+  fSpinWin  = 0;
+  fSpinAvg  = 0.;
+
+  string spin;
+  if (!fUrl.FindOpt("spin", spin)) return true;
+
+  unsigned long usec;
+  if (!Rtools::String2Long(spin, usec, emsg)) return false;
+  if (usec < 1 || usec > 100000) {
+    emsg.Init("RlinkPort::SetupSpin()",
+              string("spin=") + spin + " not in range 1..100000");
+    return false;
+  }
+
+  fSpinTime = usec;
+  fSpinWin  = usec;
+  return true;
+}
+
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Busy-poll for read data.
+
+  Spins with non-blocking poll() calls until data is available, the
+  current busy-poll window fSpinWin expired, or \a timeout is reached.
+  Data already available on entry is not counted as busy-poll.
+
+  \param timeout  maximal time to wait
+  \param tused    returns time spent spinning
+  \returns true if data is available, false if caller must fall back
+           to a blocking poll.
+ */
+
+bool RlinkPort::SpinRead(const Rtime& timeout, Rtime& tused)
+{
+  struct pollfd fds[1] = {{fFdRead,         // fd
+                           POLLIN,          // events
+                           0}};             // revents
+
+  Rtime tbeg(CLOCK_MONOTONIC);
+  Rtime tnow = tbeg;
+  double tmax = 1.e-6 * double(fSpinWin);
+  if (double(timeout) < tmax) tmax = double(timeout);
+
+  bool hit = false;
+  int  nturn = 0;
+  while (true) {
+    int irc = ::poll(fds, 1, 0);
+    if (irc < 0 && errno != EINTR)
+      throw Rexception("RlinkPort::SpinRead()","poll() failed: rc<0: ", errno);
+    if (irc > 0) {
+      if (fds[0].revents == POLLERR)
+        throw Rexception("RlinkPort::SpinRead()", "poll() failed: POLLERR");
+      hit = true;
+      break;
+    }
+    nturn += 1;
+    tnow.GetClock(CLOCK_MONOTONIC);
+    if (double(tnow-tbeg) >= tmax) break;
+  }
+  if (nturn == 0) return true;              // data was already there
+
+  if (hit) tnow.GetClock(CLOCK_MONOTONIC);
+  tused = tnow - tbeg;
+  fStats.Inc(kStatNPortSpin);
+  fStats.Inc(hit ? kStatNPortSpinHit : kStatNPortSpinMiss);
+  fStats.Inc(kStatTPortSpin, 1.e6 * double(tused));
+  if (hit) SpinUpdate(tused);
+
+  return hit;
+}
+
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Adapt busy-poll window to observed response wait time.
+
+  Keeps a running average of the wait time and sets the window to twice
+  that average. When responses take longer than the configured fSpinTime
+  the window is reduced to 1/16 of it, spinning would mostly burn cpu.
+ */
+
+void RlinkPort::SpinUpdate(const Rtime& tused)
+{
+  double dt = 1.e6 * double(tused);
+  fSpinAvg = (fSpinAvg > 0.) ? 0.875*fSpinAvg + 0.125*dt : dt;
+
+  uint32_t wmin = fSpinTime/16 > 0 ? fSpinTime/16 : 1;
+  double   win  = 2. * fSpinAvg;
+  if (win > double(fSpinTime)) {
+    fSpinWin = wmin;
+  } else {
+    fSpinWin = uint32_t(win) > wmin ? uint32_t(win) : wmin;
+  }
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Apply scheduling setup to port internal threads.
+
+  The default does nothing, ports with a driver thread override it.
+ */
+
+bool RlinkPort::ApplySched(const RthreadSched& /*sched*/, RerrMsg& /*emsg*/)
+{
+  return true;
+}
+
 //------------------------------------------+-----------------------------------
 //! FIXME_docs
 int RlinkPort::RawRead(uint8_t* buf, size_t size, bool exactsize,
@@ -300,6 +440,9 @@ void RlinkPort::Dump(std::ostream& os, int ind, const char* text,
   os << bl << "  fTraceLevel:     " << fTraceLevel << endl;
   os << bl << "  fTsLastRead:     " << fTsLastRead << endl;
   os << bl << "  fTsLastWrite:    " << fTsLastWrite << endl;
+  os << bl << "  fSpinTime:       " << fSpinTime << endl;
+  os << bl << "  fSpinWin:        " << fSpinWin << endl;
+  os << bl << "  fSpinAvg:        " << RosPrintf(fSpinAvg,"f",8,1) << endl;
   fStats.Dump(os, ind+2, "fStats: ", detail);
   return;
 }
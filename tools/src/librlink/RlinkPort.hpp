@@ -1,9 +1,11 @@
 // $Id: RlinkPort.hpp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2011-2019 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2011-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1295   1.6    add busy-poll mode (spin= url option)
+// 2026-10-19  1294   1.5    add ApplySched()
 // 2019-06-07  1160   1.4.5  Stats() not longer const
 // 2018-12-16  1084   1.4.4  use =delete for noncopyable instead of boost
 // 2018-12-07  1078   1.4.3  use std::shared_ptr instead of boost
@@ -39,6 +41,7 @@
 #include "librtools/Rstats.hpp"
 #include "librtools/RparseUrl.hpp"
 #include "librtools/Rtime.hpp"
+#include "librtools/RthreadSched.hpp"
 
 namespace Retro {
 
@@ -59,6 +62,7 @@ namespace Retro {
                          RerrMsg& emsg);
       virtual int   Write(const uint8_t* buf, size_t size, RerrMsg& emsg);
       virtual bool  PollRead(const Rtime& timeout);
+      virtual bool  ApplySched(const RthreadSched& sched, RerrMsg& emsg);
 
       int           RawRead(uint8_t* buf, size_t size, bool exactsize,
                             const Rtime& timeout, Rtime& tused, RerrMsg& emsg);
@@ -68,6 +72,8 @@ namespace Retro {
 
       const RparseUrl&  Url() const;
       bool          XonEnable() const;
+      uint32_t      SpinTime() const;
+      uint32_t      SpinWindow() const;
 
       int           FdRead() const;
       int           FdWrite() const;
@@ -95,11 +101,18 @@ namespace Retro {
         kStatNPortRxByt,
         kStatNPortRawWrite,
         kStatNPortRawRead,
+        kStatNPortSpin,
+        kStatNPortSpinHit,
+        kStatNPortSpinMiss,
+        kStatTPortSpin,
         kDimStat
       };    
 
     protected:
       void          CloseFd(int& fd);
+      bool          SetupSpin(RerrMsg& emsg);
+      bool          SpinRead(const Rtime& timeout, Rtime& tused);
+      void          SpinUpdate(const Rtime& tused);
 
     protected:
       bool          fIsOpen;                //!< is open flag
@@ -111,6 +124,9 @@ namespace Retro {
       uint32_t      fTraceLevel;            //!< trace level
       Rtime         fTsLastRead;            //!< time stamp last write
       Rtime         fTsLastWrite;           //!< time stamp last write
+      uint32_t      fSpinTime;              //!< max busy-poll window (usec)
+      uint32_t      fSpinWin;               //!< current busy-poll window (usec)
+      double        fSpinAvg;               //!< average response wait (usec)
       Rstats        fStats;                 //!< statistics
   };
   
@@ -1,9 +1,10 @@
 // $Id: RlinkPort.ipp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2011-2019 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2011-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1295   1.4    add busy-poll mode (spin= url option)
 // 2019-06-07  1160   1.3.2  Stats() not longer const
 // 2018-12-07  1078   1.3.1  use std::shared_ptr instead of boost
 // 2015-04-11   666   1.3    add fXon, XonEnable()
@@ -45,6 +46,22 @@ inline bool RlinkPort::XonEnable() const
   return fXon;
 }
 
+//------------------------------------------+-----------------------------------
+//! Returns maximal busy-poll window in usec (0 if busy-poll is disabled)
+
+inline uint32_t RlinkPort::SpinTime() const
+{
+  return fSpinTime;
+}
+
+//------------------------------------------+-----------------------------------
+//! Returns current (adapted) busy-poll window in usec
+
+inline uint32_t RlinkPort::SpinWindow() const
+{
+  return fSpinWin;
+}
+
 //------------------------------------------+-----------------------------------
 //! FIXME_docs
 
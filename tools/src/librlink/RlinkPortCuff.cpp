@@ -1,9 +1,11 @@
 // $Id: RlinkPortCuff.cpp 1209 2021-08-22 13:17:33Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2012-2021 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2012-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1295   1.2.1  add spin= url option
+// 2026-10-19  1294   1.2    add ApplySched() for driver thread
 // 2021-08-17  1209   1.1.11 drop libusb_set_debug (now deprecated)
 // 2018-12-18  1089   1.1.10 use c++ style casts
 // 2018-12-17  1088   1.1.9  use std::thread instead of boost
@@ -95,7 +97,8 @@ bool RlinkPortCuff::Open(const std::string& url, RerrMsg& emsg)
 
   if (IsOpen()) Close();
 
-  if (!fUrl.Set(url, "|trace|noinit|", "cuff", emsg)) return false;
+  if (!fUrl.Set(url, "|trace|noinit|spin=|", "cuff", emsg)) return false;
+  if (!SetupSpin(emsg)) return false;
 
   // initialize USB context
   irc = libusb_init(&fpUsbContext);
@@ -259,6 +262,15 @@ void RlinkPortCuff::Close()
   return;
 }
 
+//------------------------------------------+-----------------------------------
+//! Apply scheduling setup to the USB driver thread
+
+bool RlinkPortCuff::ApplySched(const RthreadSched& sched, RerrMsg& emsg)
+{
+  if (!fDriverThread.joinable()) return true;
+  return sched.Apply(fDriverThread.native_handle(), emsg);
+}
+
 //------------------------------------------+-----------------------------------
 //! FIXME_docs
 
@@ -1,9 +1,10 @@
 // $Id: RlinkPortCuff.hpp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2012-2018 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2012-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1294   1.1    add ApplySched() for driver thread
 // 2018-12-17  1088   1.0.2  use std::thread instead of boost
 // 2013-01-02   467   1.0.1  get cleanup code right; add USBErrorName()
 // 2012-12-26   465   1.0    Initial version
@@ -37,6 +38,8 @@ namespace Retro {
       virtual bool  Open(const std::string& url, RerrMsg& emsg);
       virtual void  Close();
 
+      virtual bool  ApplySched(const RthreadSched& sched, RerrMsg& emsg);
+
     // some constants (also defined in cpp)
       static const size_t kUSBBufferSize  = 4096;  //!< USB buffer size
       static const int    kUSBWriteEP     = 4   ;  //!< USB write endpoint
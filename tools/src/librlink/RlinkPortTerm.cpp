@@ -1,9 +1,10 @@
 // $Id: RlinkPortTerm.cpp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2011-2018 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2011-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1295   1.3.6  add spin= url option
 // 2018-12-22  1091   1.3.5  Open(): add time_t cast (-Wfloat-conversion fix)
 // 2018-11-30  1075   1.3.4  use list-init
 // 2018-09-21  1048   1.3.3  coverity fixup (uninitialized field)
@@ -78,7 +79,9 @@ bool RlinkPortTerm::Open(const std::string& url, RerrMsg& emsg)
 {
   Close();
 
-  if (!fUrl.Set(url, "|baud=|break|cts|xon|noinit|", "term", emsg)) return false;
+  if (!fUrl.Set(url, "|baud=|break|cts|xon|noinit|spin=|", "term",
+                 emsg)) return false;
+  if (!SetupSpin(emsg)) return false;
 
   // if path doesn't start with a '/' prepend a '/dev/tty'
   if (fUrl.Path().substr(0,1) != "/") {
@@ -1,9 +1,14 @@
 // $Id: RlinkServer.cpp 1185 2019-07-12 17:29:12Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2013-2019 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2013-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1306   2.5.1  BUGFIX: sched delay hist labels
+// 2026-10-19  1300   2.5    add RbmonCapture(), fupRmcap (rbmon background capture)
+// 2026-10-19  1294   2.4    add sched affinity/policy/prio, memlock; wakeup delay stats
+// 2026-10-19  1281   2.3    add CoalesceAttnPrim(); AddAttnHandler(): add
+//                             optional primary info clist
 // 2019-06-15  1164   2.2.11 adapt to new ReventFd API
 // 2019-04-07  1127   2.2.10 trace now with timestamp and selective
 // 2019-02-23  1114   2.2.9  use std::bind instead of lambda
@@ -30,6 +35,7 @@
 */
 
 #include <unistd.h>
+#include <time.h>
 
 #include <functional>
 
@@ -68,7 +74,12 @@ RlinkServer::RlinkServer()
     fAttnPatt(0),
     fAttnNotiPatt(0),
     fTraceLevel(0),
-    fStats()
+    fAttnCoal(true),
+    fSched(),
+    fMemLock(false),
+    fWakeupTime(0),
+    fStats(),
+    fupRmcap()
 {
   fContext.SetStatus(0, RlinkCommand::kStat_M_RbTout |
                         RlinkCommand::kStat_M_RbNak  |
@@ -85,6 +96,20 @@ RlinkServer::RlinkServer()
   fStats.Define(kStatNAttnHdl  ,"NAttnHdl"  ,"Attn handler calls");
   fStats.Define(kStatNAttnNoti ,"NAttnNoti" ,"Attn notifies processed");
   fStats.Define(kStatNAttnHarv ,"NAttnHarv" ,"Attn handler restarts");
+  fStats.Define(kStatNAttnCoal ,"NAttnCoal" ,"Attn coalesced prim clists");
+  fStats.Define(kStatNAttnCoalHdl,"NAttnCoalHdl","Attn handlers coalesced");
+  fStats.Define(kStatNSchedDly, "NSchedDly", "Wakeup dispatch delays");
+  fStats.Define(kStatTSchedDly, "TSchedDly", "Wakeup dispatch delay sum (us)");
+  fStats.Define(kStatTSchedDlyMax,"TSchedDlyMax",
+                                              "Wakeup dispatch delay max (us)");
+  fStats.Define(kStatNSchedDly0016,"NSchedDly0016","delay <    16 us");
+  fStats.Define(kStatNSchedDly0032,"NSchedDly0032","delay <    32 us");
+  fStats.Define(kStatNSchedDly0064,"NSchedDly0064","delay <    64 us");
+  fStats.Define(kStatNSchedDly0128,"NSchedDly0128","delay <   128 us");
+  fStats.Define(kStatNSchedDly0256,"NSchedDly0256","delay <   256 us");
+  fStats.Define(kStatNSchedDly0512,"NSchedDly0512","delay <   512 us");
+  fStats.Define(kStatNSchedDly1024,"NSchedDly1024","delay <  1024 us");
+  fStats.Define(kStatNSchedDlyLong,"NSchedDlyLong","delay >= 1024 us");
   fStats.Define(kStatNAttn00,   "NAttn00",   "Attn bit  0 set");
   fStats.Define(kStatNAttn01,   "NAttn01",   "Attn bit  1 set");
   fStats.Define(kStatNAttn02,   "NAttn02",   "Attn bit  2 set");
@@ -131,10 +156,20 @@ void RlinkServer::SetConnect(const std::shared_ptr<RlinkConnect>& spconn)
 }
 
 //------------------------------------------+-----------------------------------
-//! FIXME_docs
+//! Add an attention handler.
+/*!
+  \param attnhdl     handler function
+  \param mask        attention mask handled by this handler
+  \param cdata       client data, used together with \a mask as handler id
+  \param pprimclist  optional primary info clist. If given, it must start
+                     with an attn command and must not contain a labo. The
+                     handler must use it in GetAttnInfo(). This allows to
+                     coalesce the primary info clists of several handlers
+                     into a single rlink transaction, see CoalesceAttnPrim().
+ */
 
 void RlinkServer::AddAttnHandler(attnhdl_t&& attnhdl, uint16_t mask,
-                                 void* cdata)
+                                 void* cdata, RlinkCommandList* pprimclist)
 {
   if (mask == 0)
     throw Rexception("RlinkServer::AddAttnHandler()", "Bad args: mask == 0");
@@ -148,7 +183,7 @@ void RlinkServer::AddAttnHandler(attnhdl_t&& attnhdl, uint16_t mask,
                        "Bad args: duplicate handler");
     }
   }
-  fAttnDsc.emplace_back(move(attnhdl), id);
+  fAttnDsc.emplace_back(move(attnhdl), id, pprimclist);
 
   return;
 }
@@ -158,6 +193,12 @@ void RlinkServer::AddAttnHandler(attnhdl_t&& attnhdl, uint16_t mask,
 
 void RlinkServer::GetAttnInfo(AttnArgs& args, RlinkCommandList& clist)
 {
+  // primary info clist was already executed in CoalesceAttnPrim()
+  if (args.fPrimDone) {
+    args.fHarvestDone = true;
+    return;
+  }
+
   RlinkCommand& cmd0 = clist[0];
   if (cmd0.Command() != RlinkCommand::kCmdAttn)
     throw Rexception("RlinkServer::GetAttnInfo", "clist did't start with attn");
@@ -288,6 +329,8 @@ void RlinkServer::Resume()
 
 void RlinkServer::Wakeup()
 {
+  uint64_t tzero = 0;                       // keep oldest pending wakeup
+  fWakeupTime.compare_exchange_strong(tzero, TimeNs());
   fWakeupEvent.Signal();
   return;
 }
@@ -353,6 +396,64 @@ void RlinkServer::SetTraceLevel(uint32_t level)
   return;
 }
 
+//------------------------------------------+-----------------------------------
+//! Set server thread core list, applied immediately when active
+
+void RlinkServer::SetSchedAffinity(const std::string& list)
+{
+  fSched.SetAffinity(list);
+  if (IsActive()) ApplySched(false);
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+//! Set server thread scheduling policy (other, fifo, rr)
+
+void RlinkServer::SetSchedPolicy(const std::string& policy)
+{
+  fSched.SetPolicy(policy);
+  if (IsActive()) ApplySched(false);
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+//! Set server thread scheduling priority (for fifo and rr)
+
+void RlinkServer::SetSchedPriority(int prio)
+{
+  fSched.SetPriority(prio);
+  if (IsActive()) ApplySched(false);
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+//! Lock or unlock all process memory with mlockall()/munlockall()
+
+void RlinkServer::SetMemLock(bool lock)
+{
+  RerrMsg emsg;
+  if (lock != fMemLock && !RthreadSched::LockMemory(lock, emsg))
+    throw Rexception(emsg);
+  fMemLock = lock;
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+//! Returns rbmon background capture, created on first use.
+
+RlinkMonCapture& RlinkServer::RbmonCapture()
+{
+  if (!fspConn || !fspConn->HasRbmon())
+    throw Rexception("RlinkServer::RbmonCapture", "Bad state: no rbmon");
+  if (!fupRmcap)
+    fupRmcap.reset(new RlinkMonCapture(this, RlinkMonCapture::kTypeRbmon,
+                                       RlinkConnect::kRbaddr_RMBASE,
+                                       RlinkConnect::kRbaddr_RMBASE,
+                                       RlinkConnect::kRbaddr_RMBASE+
+                                         RlinkMonCapture::kDATA, 0));
+  return *fupRmcap;
+}
+
 //------------------------------------------+-----------------------------------
 //! FIXME_docs
 
@@ -377,13 +478,17 @@ void RlinkServer::Dump(std::ostream& os, int ind, const char* text,
   for (size_t i=0; i<fAttnDsc.size(); i++) 
     os << bl << "    [" << RosPrintf(i,"d",3) << "]: "
        << RosPrintBvi(fAttnDsc[i].fId.fMask,16)
-       << ", " << fAttnDsc[i].fId.fCdata << endl;
+       << ", " << fAttnDsc[i].fId.fCdata
+       << ", " << fAttnDsc[i].fpPrimClist << endl;
   os << bl << "  fActnList.size:  " << fActnList.size() << endl;
   os << bl << "  fWakeupEvent:    " << fWakeupEvent.Fd() << endl;
   fELoop.Dump(os, ind+2, "fELoop", detail);
   os << bl << "  fServerThread:   " << fServerThread.get_id() << endl;
   os << bl << "  fAttnPatt:       " << RosPrintBvi(fAttnPatt,16) << endl;
   os << bl << "  fAttnNotiPatt:   " << RosPrintBvi(fAttnNotiPatt,16) << endl;
+  os << bl << "  fAttnCoal:       " << RosPrintf(fAttnCoal) << endl;
+  fSched.Dump(os, ind+2, "fSched: ");
+  os << bl << "  fMemLock:        " << RosPrintf(fMemLock) << endl;
   fStats.Dump(os, ind+2, "fStats: ", detail-1);
   return;
 }
@@ -413,9 +518,9 @@ void RlinkServer::StartOrResume(bool resume)
     fELoop.AddPollHandler(bind(&RlinkServer::RlinkHandler, this, _1), 
                           rlinkfd, POLLIN);
   
-  // and start server thread
+  // and start server thread, apply scheduling setup from inside
   fELoop.UnStop();
-  fServerThread = thread([this](){ fELoop.EventLoop(); });
+  fServerThread = thread([this](){ ApplySched(true); fELoop.EventLoop(); });
 
   if (resume) {
     RerrMsg emsg;
@@ -428,6 +533,41 @@ void RlinkServer::StartOrResume(bool resume)
   return;
 }
 
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Apply scheduling setup to server and port driver threads.
+
+  Called with \a inside true from the server thread at startup, failures
+  are logged there. Called from outside for setup changes of an active
+  server, failures are thrown.
+ */
+
+void RlinkServer::ApplySched(bool inside)
+{
+  if (inside && fSched.IsDefault()) return;
+  RerrMsg emsg;
+  pthread_t tid = inside ? ::pthread_self() : fServerThread.native_handle();
+  bool ok = fSched.Apply(tid, emsg);
+  if (ok && fspConn && fspConn->IsOpen())
+    ok = fspConn->Port().ApplySched(fSched, emsg);
+  if (!ok) {
+    if (!inside) throw Rexception(emsg);
+    RlogMsg lmsg(LogFile(), 'E');
+    lmsg << "server thread scheduling setup failed: " << emsg;
+  }
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+//! Returns monotonic time in ns
+
+uint64_t RlinkServer::TimeNs()
+{
+  struct timespec ts;
+  ::clock_gettime(CLOCK_MONOTONIC, &ts);
+  return uint64_t(ts.tv_sec)*1000000000u + uint64_t(ts.tv_nsec);
+}
+
 //------------------------------------------+-----------------------------------
 //! FIXME_docs
 
@@ -457,6 +597,12 @@ void RlinkServer::CallAttnHandler()
     if (fAttnPatt & (uint16_t(1)<<i)) fStats.Inc(kStatNAttn00+i);
   }
 
+  // if several handlers with primary info clist are pending, execute all
+  // these clists in one rlink transaction
+  vector<bool> vprim(fAttnDsc.size(), false);
+  uint16_t pharv = 0;
+  if (fAttnCoal) pharv = CoalesceAttnPrim(vprim);
+
   // now call handlers, multiple handlers may be called for one attn bit
   uint16_t hnext = 0;
   uint16_t hdone = 0;
@@ -464,6 +610,10 @@ void RlinkServer::CallAttnHandler()
     uint16_t hmatch = fAttnPatt & fAttnDsc[i].fId.fMask;
     if (hmatch) {
       AttnArgs args(fAttnPatt, fAttnDsc[i].fId.fMask);
+      if (vprim[i]) {
+        args.fAttnHarvest = pharv;
+        args.fPrimDone    = true;
+      }
       lock_guard<RlinkConnect> lock(*fspConn);
 
       if (fTraceLevel > 0) {
@@ -517,6 +667,94 @@ void RlinkServer::CallAttnHandler()
   return;
 }
 
+//------------------------------------------+-----------------------------------
+//! Execute primary info clists of all pending handlers in one transaction.
+/*!
+  All handlers with a pending attention and a registered primary info clist
+  are collected. The commands of their clists, except the leading attn, are
+  concatenated behind a single attn command as long as the expected response
+  fits into the prudent rbuf size. The combined clist is executed once, and
+  the results are copied back into the clists of the handlers, which then
+  find them in place when they call GetAttnInfo().
+
+  The attn command harvests all pending attentions, also those of handlers
+  which aren't coalesced. All bits in fAttnPatt are handled in this round
+  anyway, so only new attentions are reported as harvest.
+
+  \param[out] vprim  \c true for each handler whose clist was executed
+  \returns attentions harvested and not yet in fAttnPatt
+ */
+
+uint16_t RlinkServer::CoalesceAttnPrim(std::vector<bool>& vprim)
+{
+  size_t nprim = 0;
+  for (auto& dsc : fAttnDsc) {
+    if ((fAttnPatt & dsc.fId.fMask) && dsc.fpPrimClist) nprim += 1;
+  }
+  if (nprim < 2) return 0;                  // nothing to gain
+
+  lock_guard<RlinkConnect> lock(*fspConn);
+
+  size_t rsizemax = Connect().RbufSize() - RlinkConnect::kRbufPrudentDelta;
+  size_t rsize = 1+2+1+2;                   // attn: cmd+data+stat+crc
+  RlinkCommandList clist;
+  clist.AddAttn();
+  vector<size_t> vbeg(fAttnDsc.size(), 0);
+
+  for (size_t i=0; i<fAttnDsc.size(); i++) {
+    RlinkCommandList* pclist = fAttnDsc[i].fpPrimClist;
+    if (!(fAttnPatt & fAttnDsc[i].fId.fMask) || pclist == nullptr) continue;
+    if (pclist->Size() == 0 ||
+        (*pclist)[0].Command() != RlinkCommand::kCmdAttn) continue;
+
+    size_t rsizecl = 0;
+    bool   labo    = false;
+    for (size_t j=1; j<pclist->Size(); j++) {
+      const RlinkCommand& cmd = (*pclist)[j];
+      if (cmd.Command() == RlinkCommand::kCmdLabo) labo = true;
+      if (cmd.Command() == RlinkCommand::kCmdRblk) {
+        rsizecl += 1+2+2*cmd.BlockSize()+2+1+2;
+      } else {
+        rsizecl += 1+2+1+2;
+      }
+    }
+    // a labo would abort the clists of other handlers; skip if rbuf full
+    if (labo || rsize+rsizecl > rsizemax) continue;
+
+    rsize  += rsizecl;
+    vbeg[i] = clist.Size();
+    for (size_t j=1; j<pclist->Size(); j++) clist.AddCommand((*pclist)[j]);
+    vprim[i] = true;
+  }
+
+  size_t ncoal = 0;
+  for (size_t i=0; i<vprim.size(); i++) if (vprim[i]) ncoal += 1;
+  if (ncoal < 2) {                          // handlers execute on their own
+    vprim.assign(vprim.size(), false);
+    return 0;
+  }
+
+  Exec(clist);
+  fStats.Inc(kStatNAttnCoal);
+  fStats.Inc(kStatNAttnCoalHdl, double(ncoal));
+
+  for (size_t i=0; i<fAttnDsc.size(); i++) {
+    if (!vprim[i]) continue;
+    RlinkCommandList& pclist = *fAttnDsc[i].fpPrimClist;
+    pclist[0] = clist[0];
+    for (size_t j=1; j<pclist.Size(); j++) pclist[j] = clist[vbeg[i]+j-1];
+  }
+
+  if (fTraceLevel > 1) {
+    RlogMsg lmsg(LogFile(),'I');
+    lmsg << "attnhdl-coa: patt=" << RosPrintBvi(fAttnPatt,8)
+         << " harv=" << RosPrintBvi(clist[0].Data(),8)
+         << " ncoal=" << ncoal;
+  }
+
+  return clist[0].Data() & ~fAttnPatt;
+}
+
 //------------------------------------------+-----------------------------------
 //! FIXME_docs
 
@@ -550,6 +788,17 @@ int RlinkServer::WakeupHandler(const pollfd& pfd)
   if (pfd.revents & (~pfd.events)) return -1;
 
   fWakeupEvent.Wait();                      // read event
+
+  uint64_t twake = fWakeupTime.exchange(0);
+  if (twake != 0) {
+    uint64_t tnow = TimeNs();
+    size_t   dly  = (tnow > twake) ? size_t((tnow-twake)/1000) : 0;
+    fStats.Inc(kStatNSchedDly);
+    fStats.Inc(kStatTSchedDly, double(dly));
+    if (double(dly) > fStats.Value(kStatTSchedDlyMax))
+      fStats.Set(kStatTSchedDlyMax, double(dly));
+    fStats.IncLogHist(kStatNSchedDly0016, 0xf, 0x7ff, (dly==0) ? 1 : dly);
+  }
   return 0;
 }
 
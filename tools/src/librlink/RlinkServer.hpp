@@ -1,9 +1,13 @@
 // $Id: RlinkServer.hpp 1185 2019-07-12 17:29:12Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2013-2019 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2013-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1306   2.5.1  BUGFIX: sched delay hist labels
+// 2026-10-19  1300   2.5    add RbmonCapture(), fupRmcap (rbmon background capture)
+// 2026-10-19  1294   2.4    add sched affinity/policy/prio, memlock; wakeup delay stats
+// 2026-10-19  1281   2.3    add coalesced attn primary clist harvest
 // 2019-06-07  1160   2.2.7  Stats() not longer const
 // 2018-12-17  1088   2.2.6  use std::thread instead of boost
 // 2018-12-16  1084   2.2.5  use =delete for noncopyable instead of boost
@@ -35,13 +39,16 @@
 #include <memory>
 #include <functional>
 #include <thread>
+#include <atomic>
 
 #include "librtools/Rstats.hpp"
 #include "librtools/ReventFd.hpp"
+#include "librtools/RthreadSched.hpp"
 
 #include "RlinkConnect.hpp"
 #include "RlinkContext.hpp"
 #include "RlinkServerEventLoop.hpp"
+#include "RlinkMonCapture.hpp"
 
 namespace Retro {
 
@@ -53,6 +60,7 @@ namespace Retro {
         uint16_t    fAttnMask;              //!< in: handler attention mask
         uint16_t    fAttnHarvest;           //!< out: harvested attentions
         bool        fHarvestDone;           //!< out: set true when harvested
+        bool        fPrimDone;              //!< in: prim clist already done
                     AttnArgs();
                     AttnArgs(uint16_t apatt, uint16_t amask);
       };
@@ -77,7 +85,8 @@ namespace Retro {
       void          Exec(RlinkCommandList& clist);
 
       void          AddAttnHandler(attnhdl_t&& attnhdl, uint16_t mask,
-                                   void* cdata = nullptr);
+                                   void* cdata = nullptr,
+                                   RlinkCommandList* pprimclist = nullptr);
       void          RemoveAttnHandler(uint16_t mask, void* cdata = nullptr);
       void          GetAttnInfo(AttnArgs& args, RlinkCommandList& clist);
       void          GetAttnInfo(AttnArgs& args);
@@ -102,6 +111,19 @@ namespace Retro {
 
       void          SetTraceLevel(uint32_t level);
       uint32_t      TraceLevel() const;
+      void          SetAttnCoalesce(bool coal);
+      bool          AttnCoalesce() const;
+
+      void          SetSchedAffinity(const std::string& list);
+      const std::string& SchedAffinity() const;
+      void          SetSchedPolicy(const std::string& policy);
+      const std::string& SchedPolicy() const;
+      void          SetSchedPriority(int prio);
+      int           SchedPriority() const;
+      void          SetMemLock(bool lock);
+      bool          MemLock() const;
+
+      RlinkMonCapture& RbmonCapture();
 
       Rstats&       Stats();
 
@@ -118,6 +140,19 @@ namespace Retro {
         kStatNAttnHdl,                      //!< Attn handler calls
         kStatNAttnNoti,                     //!< Attn notifies processed
         kStatNAttnHarv,                     //!< Attn handler restarts
+        kStatNAttnCoal,                     //!< Attn coalesced prim clists
+        kStatNAttnCoalHdl,                  //!< Attn handlers coalesced
+        kStatNSchedDly,                     //!< Wakeup dispatch delays
+        kStatTSchedDly,                     //!< Wakeup dispatch delay sum
+        kStatTSchedDlyMax,                  //!< Wakeup dispatch delay max
+        kStatNSchedDly0016,                 //!< delay <    16 us
+        kStatNSchedDly0032,                 //!< delay <    32 us
+        kStatNSchedDly0064,                 //!< delay <    64 us
+        kStatNSchedDly0128,                 //!< delay <   128 us
+        kStatNSchedDly0256,                 //!< delay <   256 us
+        kStatNSchedDly0512,                 //!< delay <   512 us
+        kStatNSchedDly1024,                 //!< delay <  1024 us
+        kStatNSchedDlyLong,                 //!< delay >= 1024 us
         kStatNAttn00,                       //!< Attn bit  0 set
         kStatNAttn01,                       //!< Attn bit  1 set
         kStatNAttn02,                       //!< Attn bit  2 set
@@ -141,9 +176,12 @@ namespace Retro {
 
     protected:
       void          StartOrResume(bool resume);
+      void          ApplySched(bool inside);
+      static uint64_t  TimeNs();
       bool          AttnPending() const;
       bool          ActnPending() const;
       void          CallAttnHandler();
+      uint16_t      CoalesceAttnPrim(std::vector<bool>& vprim);
       void          CallActnHandler();
       int           WakeupHandler(const pollfd& pfd);
       int           RlinkHandler(const pollfd& pfd);
@@ -160,8 +198,10 @@ namespace Retro {
       struct AttnDsc {
         attnhdl_t   fHandler;
         AttnId      fId;
+        RlinkCommandList* fpPrimClist;      //!< primary info clist (or 0)
                     AttnDsc();
-                    AttnDsc(attnhdl_t&& hdl, const AttnId& id);
+                    AttnDsc(attnhdl_t&& hdl, const AttnId& id,
+                            RlinkCommandList* pprimclist);
       };
 
       std::shared_ptr<RlinkConnect>  fspConn;
@@ -174,7 +214,12 @@ namespace Retro {
       uint16_t      fAttnPatt;              //!< current attn pattern
       uint16_t      fAttnNotiPatt;          //!< attn notifier pattern
       uint32_t      fTraceLevel;            //!< trace level
+      bool          fAttnCoal;              //!< coalesce attn prim clists
+      RthreadSched  fSched;                 //!< server thread scheduling
+      bool          fMemLock;               //!< mlockall requested
+      std::atomic<uint64_t> fWakeupTime;    //!< time of pending Wakeup (ns)
       Rstats        fStats;                 //!< statistics
+      std::unique_ptr<RlinkMonCapture> fupRmcap; //!< rbmon capture
 };
   
 } // end namespace Retro
@@ -1,9 +1,11 @@
 // $Id: RlinkServer.ipp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2013-2019 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2013-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1294   2.4    add sched affinity/policy/prio, memlock; wakeup delay stats
+// 2026-10-19  1281   2.3    add coalesced attn primary clist harvest
 // 2019-06-07  1160   2.2.3  Stats() not longer const
 // 2018-12-15  1083   2.2.2  for std::function setups: use rval ref and move
 // 2018-12-07  1078   2.2.1  use std::shared_ptr instead of boost
@@ -82,6 +84,55 @@ inline uint32_t RlinkServer::TraceLevel() const
 //------------------------------------------+-----------------------------------
 //! FIXME_docs
 
+inline void RlinkServer::SetAttnCoalesce(bool coal)
+{
+  fAttnCoal = coal;
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+inline bool RlinkServer::AttnCoalesce() const
+{
+  return fAttnCoal;
+}
+
+//------------------------------------------+-----------------------------------
+//! Returns server thread core list
+
+inline const std::string& RlinkServer::SchedAffinity() const
+{
+  return fSched.Affinity();
+}
+
+//------------------------------------------+-----------------------------------
+//! Returns server thread scheduling policy
+
+inline const std::string& RlinkServer::SchedPolicy() const
+{
+  return fSched.Policy();
+}
+
+//------------------------------------------+-----------------------------------
+//! Returns server thread scheduling priority
+
+inline int RlinkServer::SchedPriority() const
+{
+  return fSched.Priority();
+}
+
+//------------------------------------------+-----------------------------------
+//! Returns true if process memory is locked
+
+inline bool RlinkServer::MemLock() const
+{
+  return fMemLock;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
 inline Rstats& RlinkServer::Stats()
 {
   return fStats;
@@ -118,7 +169,8 @@ inline RlinkServer::AttnArgs::AttnArgs()
   : fAttnPatt(0),
     fAttnMask(0), 
     fAttnHarvest(0),
-    fHarvestDone(false) 
+    fHarvestDone(false),
+    fPrimDone(false)
 {}
 
 //------------------------------------------+-----------------------------------
@@ -128,7 +180,8 @@ inline RlinkServer::AttnArgs::AttnArgs(uint16_t apatt, uint16_t amask)
   : fAttnPatt(apatt),
     fAttnMask(amask), 
     fAttnHarvest(0),
-    fHarvestDone(false)
+    fHarvestDone(false),
+    fPrimDone(false)
 {}
 
 //==========================================+===================================
@@ -176,15 +229,18 @@ inline bool RlinkServer::AttnId::operator==(const AttnId& rhs) const
 
 inline RlinkServer::AttnDsc::AttnDsc()
   : fHandler(),
-    fId()
+    fId(),
+    fpPrimClist(nullptr)
 {}
 
 //------------------------------------------+-----------------------------------
 //! Constructor
 
-inline RlinkServer::AttnDsc::AttnDsc(attnhdl_t&& hdl, const AttnId& id)
+inline RlinkServer::AttnDsc::AttnDsc(attnhdl_t&& hdl, const AttnId& id,
+                                     RlinkCommandList* pprimclist)
   : fHandler(move(hdl)),
-    fId(id)
+    fId(id),
+    fpPrimClist(pprimclist)
 {}
 
 } // end namespace Retro
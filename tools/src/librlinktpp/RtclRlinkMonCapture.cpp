@@ -0,0 +1,186 @@
+// $Id: RtclRlinkMonCapture.cpp 1300 2026-10-19 19:12:37Z mueller $
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// 
+// Revision History: 
+// Date         Rev Version  Comment
+// 2026-10-19  1300   1.0    Initial version
+// ---------------------------------------------------------------------------
+
+/*!
+  \brief   Implemenation of class RtclRlinkMonCapture.
+ */
+
+#include <mutex>
+#include <vector>
+#include <string>
+
+#include "librtcltools/RtclOPtr.hpp"
+#include "librtcltools/RtclNameSet.hpp"
+#include "librtcltools/RtclStats.hpp"
+#include "librlink/RlinkServer.hpp"
+
+#include "RtclRlinkMonCapture.hpp"
+
+using namespace std;
+
+/*!
+  \class Retro::RtclRlinkMonCapture
+  \brief Tcl glue for RlinkMonCapture, shared by rbmon and ibmon commands.
+
+  Handles
+  \code
+    -start ?-file f? ?-nrec n? ?-period dt? ?-budget frac?
+           ?-lolim a? ?-hilim a? ?-trig lo hi? ?-twonly? ?-npre n? ?-npost n?
+    -stop
+    -poll
+    -read ?nent?
+    -load fname
+    -info
+    -stats ?stats opts?
+  \endcode
+  \c -read and \c -load return a list of \c {flag addr data delay nbusy}
+  entries, the format returned by \c rbmoni::read and \c ibd_ibmon::read,
+  so the \c print procs of these packages can be used.
+*/
+
+// all method definitions in namespace Retro
+namespace Retro {
+
+//------------------------------------------+-----------------------------------
+//! Returns decoded entries as Tcl list.
+
+static Tcl_Obj* EntryList(RlinkMonCapture::montype type,
+                          const vector<RlinkMonCapture::rawent>& raw)
+{
+  vector<RlinkMonCapture::entry> list;
+  RlinkMonCapture::Decode(type, raw, list);
+  Tcl_Obj* plist = Tcl_NewListObj(0, nullptr);
+  for (auto& e : list) {
+    Tcl_Obj* pent[5] = {Tcl_NewIntObj(e.fFlag),  Tcl_NewIntObj(e.fAddr),
+                        Tcl_NewIntObj(e.fData),  Tcl_NewIntObj(e.fDelay),
+                        Tcl_NewIntObj(e.fNBusy)};
+    Tcl_ListObjAppendElement(nullptr, plist, Tcl_NewListObj(5, pent));
+  }
+  return plist;
+}
+
+//------------------------------------------+-----------------------------------
+//! Execute a capture sub command, returns TCL_OK or TCL_ERROR.
+
+int RtclRlinkMonCapture::Exec(RtclArgs& args, RlinkMonCapture& mcap)
+{
+  static RtclNameSet optset("-start|-stop|-poll|-read|-load|-info|-stats|"
+                            "-file|-nrec|-period|-budget|-lolim|-hilim|"
+                            "-trig|-twonly|-npre|-npost");
+
+  RlinkMonCapture::setup set;
+  double period = set.fPeriod.ToDouble();
+  string opt;
+  string func;
+  while (args.NextOpt(opt, optset)) {
+    if (opt == "-file") {
+      if (!args.GetArg("file", set.fFile)) return TCL_ERROR;
+    } else if (opt == "-nrec") {
+      if (!args.GetArg("nrec", set.fNRec, 1u<<28, 1)) return TCL_ERROR;
+    } else if (opt == "-period") {
+      if (!args.GetArg("period", period, 1.e-4, 3600.)) return TCL_ERROR;
+    } else if (opt == "-budget") {
+      if (!args.GetArg("budget", set.fBudget, 0., 0.9)) return TCL_ERROR;
+    } else if (opt == "-lolim") {
+      if (!args.GetArg("lolim", set.fLoLim)) return TCL_ERROR;
+    } else if (opt == "-hilim") {
+      if (!args.GetArg("hilim", set.fHiLim)) return TCL_ERROR;
+    } else if (opt == "-trig") {
+      if (!args.GetArg("lo", set.fTrigLo)) return TCL_ERROR;
+      if (!args.GetArg("hi", set.fTrigHi)) return TCL_ERROR;
+      set.fTrig = true;
+    } else if (opt == "-twonly") {
+      set.fTrigWOnly = true;
+    } else if (opt == "-npre") {
+      if (!args.GetArg("npre", set.fNPre, 1u<<20)) return TCL_ERROR;
+    } else if (opt == "-npost") {
+      if (!args.GetArg("npost", set.fNPost)) return TCL_ERROR;
+    } else {
+      if (func.length()) return args.Quit("-E: only one of -start,-stop,"
+                                          "-poll,-read,-load,-info,-stats "
+                                          "allowed");
+      func = opt;
+      if (func == "-stats" || func == "-load") break;
+    }
+  }
+  if (!args.OptValid()) return TCL_ERROR;
+  if (func.length() == 0) func = "-info";
+  set.fPeriod = Rtime(period);
+
+  if ((set.fTrigWOnly || set.fNPre || set.fNPost) && !set.fTrig)
+    return args.Quit("-E: -twonly, -npre or -npost require -trig");
+
+  if (func == "-stats") {
+    RtclStats::Context cntx;
+    if (!RtclStats::GetArgs(args, cntx)) return TCL_ERROR;
+    lock_guard<RlinkConnect> lock(mcap.Server().Connect());
+    if (!RtclStats::Exec(args, cntx, mcap.Stats())) return TCL_ERROR;
+    return TCL_OK;
+  }
+
+  RerrMsg emsg;
+  if (func == "-load") {                    // no lock needed, file only
+    string fname;
+    if (!args.GetArg("fname", fname)) return TCL_ERROR;
+    if (!args.AllDone()) return TCL_ERROR;
+    RlinkMonCapture::montype type;
+    vector<RlinkMonCapture::rawent> raw;
+    if (!RlinkMonCapture::LoadFile(fname, type, raw, emsg))
+      return args.Quit(emsg);
+    if (type != mcap.Type())
+      return args.Quit("-E: file holds data of other monitor type");
+    args.SetResult(EntryList(type, raw));
+    return TCL_OK;
+  }
+
+  uint32_t nent = RlinkMonCapture::kRingSize;
+  if (func == "-read") {
+    if (!args.GetArg("??nent", nent, RlinkMonCapture::kRingSize))
+      return TCL_ERROR;
+  }
+  if (!args.AllDone()) return TCL_ERROR;
+
+  lock_guard<RlinkConnect> lock(mcap.Server().Connect());
+
+  if (func == "-start") {
+    if (!mcap.Start(set, emsg)) return args.Quit(emsg);
+  } else if (func == "-stop") {
+    if (!mcap.Stop(emsg)) return args.Quit(emsg);
+  } else if (func == "-poll") {
+    if (!mcap.Poll(true, emsg)) return args.Quit(emsg);
+
+  } else if (func == "-read") {
+    vector<RlinkMonCapture::rawent> raw;
+    mcap.GetLast(raw, nent);
+    args.SetResult(EntryList(mcap.Type(), raw));
+
+  } else {
+    const RlinkMonCapture::setup& cur = mcap.Setup();
+    RtclOPtr plist(Tcl_NewListObj(0, nullptr));
+    auto add = [&plist](const char* name, Tcl_Obj* pval) {
+      Tcl_ListObjAppendElement(nullptr, plist, Tcl_NewStringObj(name, -1));
+      Tcl_ListObjAppendElement(nullptr, plist, pval);
+    };
+    add("active",    Tcl_NewBooleanObj(mcap.IsActive()));
+    add("triggered", Tcl_NewBooleanObj(mcap.Triggered()));
+    add("done",      Tcl_NewBooleanObj(mcap.Done()));
+    add("file",      Tcl_NewStringObj(cur.fFile.c_str(), -1));
+    add("period",    Tcl_NewDoubleObj(cur.fPeriod.ToDouble()));
+    add("periodeff", Tcl_NewDoubleObj(mcap.PeriodEff().ToDouble()));
+    add("budget",    Tcl_NewDoubleObj(cur.fBudget));
+    add("linkload",  Tcl_NewDoubleObj(mcap.LinkLoad()));
+    add("nentry",    Tcl_NewWideIntObj(Tcl_WideInt(mcap.NEntry())));
+    add("nrecord",   Tcl_NewWideIntObj(Tcl_WideInt(mcap.NRecord())));
+    args.SetResult(plist);
+  }
+
+  return TCL_OK;
+}
+
+} // end namespace Retro
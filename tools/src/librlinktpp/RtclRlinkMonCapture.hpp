@@ -0,0 +1,30 @@
+// $Id: RtclRlinkMonCapture.hpp 1300 2026-10-19 19:12:37Z mueller $
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// 
+// Revision History: 
+// Date         Rev Version  Comment
+// 2026-10-19  1300   1.0    Initial version
+// ---------------------------------------------------------------------------
+
+
+/*!
+  \brief   Declaration of class RtclRlinkMonCapture.
+*/
+
+#ifndef included_Retro_RtclRlinkMonCapture
+#define included_Retro_RtclRlinkMonCapture 1
+
+#include "librtcltools/RtclArgs.hpp"
+#include "librlink/RlinkMonCapture.hpp"
+
+namespace Retro {
+
+  class RtclRlinkMonCapture {
+    public:
+      static int    Exec(RtclArgs& args, RlinkMonCapture& mcap);
+  };
+
+} // end namespace Retro
+
+#endif
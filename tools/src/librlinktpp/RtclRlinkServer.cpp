@@ -1,9 +1,12 @@
 // $Id: RtclRlinkServer.cpp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2013-2019 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2013-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1300   1.3.1  add M_moncap
+// 2026-10-19  1294   1.3    add affinity,policy,priority,memlock
+// 2026-10-19  1281   1.2.5  add attncoal getter/setter
 // 2019-06-07  1160   1.2.4  use RtclStats::Exec()
 // 2019-02-23  1114   1.2.3  use std::bind instead of lambda
 // 2018-12-17  1087   1.2.2  use std::lock_guard instead of boost
@@ -40,6 +43,7 @@
 #include "librtcltools/RtclStats.hpp"
 #include "librtcltools/RtclContext.hpp"
 #include "RtclRlinkConnect.hpp"
+#include "RtclRlinkMonCapture.hpp"
 
 #include "RtclRlinkServer.hpp"
 
@@ -67,6 +71,7 @@ RtclRlinkServer::RtclRlinkServer(Tcl_Interp* interp, const char* name)
   AddMeth("server",   bind(&RtclRlinkServer::M_server,  this, _1));
   AddMeth("attn",     bind(&RtclRlinkServer::M_attn,    this, _1));
   AddMeth("stats",    bind(&RtclRlinkServer::M_stats,   this, _1));
+  AddMeth("moncap",   bind(&RtclRlinkServer::M_moncap,  this, _1));
   AddMeth("print",    bind(&RtclRlinkServer::M_print,   this, _1));
   AddMeth("dump",     bind(&RtclRlinkServer::M_dump,    this, _1));
   AddMeth("get",      bind(&RtclRlinkServer::M_get,     this, _1));
@@ -77,9 +82,30 @@ RtclRlinkServer::RtclRlinkServer(Tcl_Interp* interp, const char* name)
   RlinkServer* pobj  = &Obj();
   fGets.Add<uint32_t>  ("tracelevel", 
                           bind(&RlinkServer::TraceLevel, pobj));
+  fGets.Add<bool>      ("attncoal", 
+                          bind(&RlinkServer::AttnCoalesce, pobj));
+
+  fGets.Add<const string&> ("affinity",
+                          bind(&RlinkServer::SchedAffinity, pobj));
+  fGets.Add<const string&> ("policy",
+                          bind(&RlinkServer::SchedPolicy, pobj));
+  fGets.Add<int>       ("priority",
+                          bind(&RlinkServer::SchedPriority, pobj));
+  fGets.Add<bool>      ("memlock",
+                          bind(&RlinkServer::MemLock, pobj));
 
   fSets.Add<uint32_t>  ("tracelevel",
                           bind(&RlinkServer::SetTraceLevel, pobj, _1));
+  fSets.Add<bool>      ("attncoal",
+                          bind(&RlinkServer::SetAttnCoalesce, pobj, _1));
+  fSets.Add<const string&> ("affinity",
+                          bind(&RlinkServer::SetSchedAffinity, pobj, _1));
+  fSets.Add<const string&> ("policy",
+                          bind(&RlinkServer::SetSchedPolicy, pobj, _1));
+  fSets.Add<int>       ("priority",
+                          bind(&RlinkServer::SetSchedPriority, pobj, _1));
+  fSets.Add<bool>      ("memlock",
+                          bind(&RlinkServer::SetMemLock, pobj, _1));
 
   // attributes of buildin RlinkContext
   RlinkContext* pcntx = &Obj().Context();
@@ -268,6 +294,16 @@ int RtclRlinkServer::M_stats(RtclArgs& args)
   return kOK;
 }
 
+//------------------------------------------+-----------------------------------
+//! Access to the rbmon background capture.
+
+int RtclRlinkServer::M_moncap(RtclArgs& args)
+{
+  if (!Obj().Connect().HasRbmon())
+    return args.Quit("-E: no rbus monitor (rbd_rbmon) available");
+  return RtclRlinkMonCapture::Exec(args, Obj().RbmonCapture());
+}
+
 //------------------------------------------+-----------------------------------
 //! FIXME_docs
 
@@ -1,9 +1,10 @@
 // $Id: RtclRlinkServer.hpp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2013-2018 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2013-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1300   1.2.2  add M_moncap
 // 2018-12-07  1078   1.2.1  use std::shared_ptr instead of boost
 // 2018-12-01  1076   1.2    use unique_ptr
 // 2015-04-04   662   1.1    add M_get, M_set; remove 'server -trace'
@@ -45,6 +46,7 @@ namespace Retro {
       int           M_server(RtclArgs& args);
       int           M_attn(RtclArgs& args);
       int           M_stats(RtclArgs& args);
+      int           M_moncap(RtclArgs& args);
       int           M_print(RtclArgs& args);
       int           M_dump(RtclArgs& args);
       int           M_get(RtclArgs& args);
@@ -1,9 +1,10 @@
 // $Id: RtclContext.cpp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2011-2018 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2011-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1293   1.0.8  add mutex for context map; cleanup on interp delete
 // 2018-12-18  1089   1.0.7  use c++ style casts
 // 2018-12-02  1076   1.0.6  use nullptr
 // 2018-11-16  1070   1.0.5  use auto; use emplace,make_pair; use range loop
@@ -36,6 +37,7 @@ using namespace std;
 namespace Retro {
 
 RtclContext::xmap_t RtclContext::fContextMap;
+std::mutex RtclContext::fContextMutex;
 
 //------------------------------------------+-----------------------------------
 //! Default constructor
@@ -148,6 +150,8 @@ RtclProxyBase* RtclContext::FindProxy(const std::string& type,
 
 RtclContext& RtclContext::Find(Tcl_Interp* interp)
 {
+  // several interpreters can live in different threads, see ti_multi
+  lock_guard<mutex> lock(fContextMutex);
   RtclContext* pcntx = 0;
   auto it = fContextMap.find(interp);
   if (it != fContextMap.end()) {
@@ -157,7 +161,8 @@ RtclContext& RtclContext::Find(Tcl_Interp* interp)
     fContextMap.emplace(make_pair(interp, pcntx));
     Tcl_CreateExitHandler(reinterpret_cast<Tcl_ExitProc*>(ThunkTclExitProc),
                           reinterpret_cast<ClientData>(pcntx));
-
+    Tcl_CallWhenDeleted(interp, ThunkTclInterpDeleteProc,
+                        reinterpret_cast<ClientData>(pcntx));
   }
   return *pcntx;
 }
@@ -181,4 +186,26 @@ void RtclContext::ThunkTclExitProc(ClientData cdata)
   return;
 }
 
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Drop context when interpreter is deleted before process exit.
+
+  Only done when all Class and Proxy objects are gone already, otherwise
+  the cleanup is left to ThunkTclExitProc().
+ */
+
+void RtclContext::ThunkTclInterpDeleteProc(ClientData cdata,
+                                           Tcl_Interp* interp)
+{
+  RtclContext* pcntx = reinterpret_cast<RtclContext*>(cdata);
+  lock_guard<mutex> lock(fContextMutex);
+  if (pcntx->fSetClass.empty() && pcntx->fSetProxy.empty()) {
+    fContextMap.erase(interp);
+    Tcl_DeleteExitHandler(reinterpret_cast<Tcl_ExitProc*>(ThunkTclExitProc),
+                          cdata);
+    delete pcntx;
+  }
+  return;
+}
+
 } // end namespace Retro
@@ -1,9 +1,10 @@
 // $Id: RtclContext.hpp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2011-2018 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2011-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1293   1.0.6  add mutex for context map; cleanup on interp delete
 // 2018-12-16  1084   1.0.5  use =delete for noncopyable instead of boost
 // 2017-02-04   866   1.0.4  rename fMapContext -> fContextMap
 // 2013-01-12   474   1.0.3  add FindProxy() method
@@ -25,6 +26,7 @@
 #include <string>
 #include <set>
 #include <map>
+#include <mutex>
 
 #include "RtclClassBase.hpp"
 #include "RtclProxyBase.hpp"
@@ -59,6 +61,8 @@ namespace Retro {
       static RtclContext&  Find(Tcl_Interp* interp);
 
       static void   ThunkTclExitProc(ClientData cdata);
+      static void   ThunkTclInterpDeleteProc(ClientData cdata,
+                                             Tcl_Interp* interp);
 
     protected:
 
@@ -67,6 +71,7 @@ namespace Retro {
       pset_t        fSetProxy;              //!< set for Proxy objects
 
       static xmap_t fContextMap;            //!< map of contexts
+      static std::mutex fContextMutex;      //!< protects fContextMap
   };
   
 } // end namespace Retro
@@ -1,9 +1,10 @@
 // $Id: RtclStats.cpp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2011-2019 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2011-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1288   1.2    add -prom option
 // 2019-06-07  1160   1.1    Rename Collect->Exec, not longer const; add -reset
 // 2014-08-22   584   1.0.2  use nullptr
 // 2013-03-06   495   1.0.1  Rename Exec->Collect
@@ -37,13 +38,15 @@ namespace Retro {
 bool RtclStats::GetArgs(RtclArgs& args, Context& cntx)
 {
   static RtclNameSet optset("-lname|-ltext|-lvalue|-lpair|-lall|"
-                            "-atext|-avalue|-print|-reset");
+                            "-atext|-avalue|-print|-prom|-reset");
 
   string opt;
   string varname;
   string format;
   int    width=0;
   int    prec=0;
+  string prefix;
+  string label;
 
   if (args.NextOpt(opt, optset)) {
     if (opt == "-atext" || opt == "-avalue") {
@@ -52,6 +55,16 @@ bool RtclStats::GetArgs(RtclArgs& args, Context& cntx)
       if (!args.GetArg("?format", format)) return false;
       if (!args.GetArg("?width", width, 0, 32)) return false;
       if (!args.GetArg("?prec",  prec,  0, 32)) return false;
+    } else if (opt == "-prom") {
+      prefix = "w11";
+      if (!args.GetArg("?prefix", prefix)) return false;
+      // label is the command path up to the 'stats' method, e.g. 'cpu0rka'
+      for (int i=0; i<args.Objc(); i++) {
+        string word(Tcl_GetString(args.Objv(i)));
+        if (word == "stats") break;
+        if (i > 0) label += ".";
+        label += word;
+      }
     }
 
   } else {
@@ -65,6 +78,8 @@ bool RtclStats::GetArgs(RtclArgs& args, Context& cntx)
   cntx.format  = format;
   cntx.width   = width;
   cntx.prec    = prec;
+  cntx.prefix  = prefix;
+  cntx.label   = label;
 
   return true;
 }
@@ -133,6 +148,11 @@ bool RtclStats::Exec(RtclArgs& args, const Context& cntx, Rstats& stats)
     stats.Print(sos, cntx.format.c_str(), cntx.width, cntx.prec);
     args.AppendResultLines(sos);
 
+  } else if (cntx.opt == "-prom") {         // -prom --------------------------
+    ostringstream sos;
+    stats.PrintProm(sos, cntx.prefix, cntx.label);
+    args.AppendResultLines(sos);
+
   } else if (cntx.opt == "-reset") {        // -reset -------------------------
     stats.Reset();
 
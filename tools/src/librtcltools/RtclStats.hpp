@@ -1,9 +1,10 @@
 // $Id: RtclStats.hpp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2011-2019 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2011-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1288   1.2    add -prom option
 // 2019-06-07  1160   1.1    Rename Collect->Exec, not longer const
 // 2013-03-06   495   1.0.1  Rename Exec->Collect
 // 2011-02-26   364   1.0    Initial version
@@ -33,9 +34,12 @@ namespace Retro {
         std::string   format;
         int           width;
         int           prec;
+        std::string   prefix;
+        std::string   label;
 
                       Context()
-                        : opt(), varname(), format(), width(0), prec(0)
+                        : opt(), varname(), format(), width(0), prec(0),
+                          prefix(), label()
                       {}
       };
     
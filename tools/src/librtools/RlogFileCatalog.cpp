@@ -1,9 +1,11 @@
 // $Id: RlogFileCatalog.cpp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2013-2018 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2013-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1306   1.0.4  FindOrCreate(): return shared_ptr by value
+// 2026-10-19  1293   1.0.3  add mutex, thread safe for ti_multi
 // 2018-12-07  1078   1.0.2  use std::shared_ptr instead of boost
 // 2018-11-09  1066   1.0.1  use auto; use make_pair,emplace
 // 2013-02-22   491   1.0    Initial version
@@ -37,11 +39,16 @@ RlogFileCatalog& RlogFileCatalog::Obj()
 }
 
 //------------------------------------------+-----------------------------------
-//! FIXME_docs
+//! Returns the log file \a name, creates it when not yet known.
+/*!
+  Returns by value, the map entry can be erased by Delete() from another
+  thread as soon as fMutex is released.
+ */
 
-const std::shared_ptr<RlogFile>& 
+std::shared_ptr<RlogFile> 
   RlogFileCatalog::FindOrCreate(const std::string& name)
 {
+  lock_guard<mutex> lock(fMutex);
   auto it = fMap.find(name);
   if (it != fMap.end()) return it->second;
 
@@ -56,6 +63,7 @@ const std::shared_ptr<RlogFile>&
 
 void RlogFileCatalog::Delete(const std::string& name)
 {
+  lock_guard<mutex> lock(fMutex);
   fMap.erase(name);
   return;
 }
@@ -1,9 +1,11 @@
 // $Id: RlogFileCatalog.hpp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2011-2018 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2011-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1306   1.0.4  FindOrCreate(): return shared_ptr by value
+// 2026-10-19  1293   1.0.3  add mutex, thread safe for ti_multi
 // 2018-12-16  1084   1.0.2  use =delete for noncopyable instead of boost
 // 2018-12-07  1078   1.0.1  use std::shared_ptr instead of boost
 // 2013-02-22   491   1.0    Initial version
@@ -18,6 +20,7 @@
 
 #include <map>
 #include <memory>
+#include <mutex>
 
 #include "RlogFile.hpp"
 
@@ -28,7 +31,7 @@ namespace Retro {
 
       static RlogFileCatalog&  Obj();    
 
-      const std::shared_ptr<RlogFile>& FindOrCreate(const std::string& name);
+      std::shared_ptr<RlogFile> FindOrCreate(const std::string& name);
       void          Delete(const std::string& name);
 
     private:
@@ -42,6 +45,7 @@ namespace Retro {
       typedef std::map<std::string, std::shared_ptr<RlogFile>> map_t;
 
       map_t         fMap;                   //!< name->rlogfile map
+      std::mutex    fMutex;                 //!< protects fMap
   };
   
 } // end namespace Retro
@@ -1,9 +1,12 @@
 // $Id: Rstats.cpp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2011-2019 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2011-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1306   1.1.1  counters hold double again, Inc() via cas loop;
+//                           PrintProm(): add TYPE line
+// 2026-10-19  1288   1.1    atomic counters; add Snapshot(),PrintProm()
 // 2019-06-07  1160   1.0.6  add Reset(); drop operator-=() and operator*=()
 // 2018-12-18  1089   1.0.5  use c++ style casts
 // 2017-02-04   865   1.0.4  add NameMaxLength(); Print(): add counter name
@@ -18,6 +21,7 @@
 */
 
 #include <algorithm>
+#include <cctype>
 
 #include "Rstats.hpp"
 
@@ -80,7 +84,7 @@ void Rstats::Define(size_t ind, const std::string& name,
 
   // in case it's the 'next' counter use push_back
   if (ind == Size()) {
-    fValue.push_back(0.);
+    fValue.push_back(counter());
     fName.push_back(name);
     fText.push_back(text);
 
@@ -91,7 +95,7 @@ void Rstats::Define(size_t ind, const std::string& name,
       fName.resize(ind+1);
       fText.resize(ind+1);
     }
-    fValue[ind] = 0.;
+    fValue[ind] = counter();
     fName[ind]  = name;
     fText[ind]  = text;
   }
@@ -104,7 +108,7 @@ void Rstats::Define(size_t ind, const std::string& name,
 
 void Rstats::Reset()
 {
-  for (auto& o: fValue) o = 0.;
+  for (auto& o: fValue) o.fVal.store(0., memory_order_relaxed);
   return;
 }
 
@@ -163,9 +167,11 @@ void Rstats::Print(std::ostream& os, const char* format,
     prec   = fPrec;
   }
 
+  vector<double> vals;
+  Snapshot(vals);
   size_t maxlen = NameMaxLength();
   for (size_t i=0; i<Size(); i++) {
-    os << RosPrintf(fValue[i], format, width, prec)
+    os << RosPrintf(vals[i], format, width, prec)
        << " : " << RosPrintf(fName[i].c_str(),"-s",maxlen) 
        << " : " << fText[i] << endl;
   }
@@ -186,7 +192,7 @@ void Rstats::Dump(std::ostream& os, int ind, const char* text,
     
     for (size_t i=0; i<Size(); i++) {
       os << bl << "  " << fName[i] << ":" << RosFill(maxlen-fName[i].length()+1)
-         << RosPrintf(fValue[i], "f", 12)
+         << RosPrintf(Value(i), "f", 12)
          << "  '" << fText[i] << "'" << endl;
     }
   }  else {
@@ -202,6 +208,55 @@ void Rstats::Dump(std::ostream& os, int ind, const char* text,
   return;
 }
 
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Take a snapshot of all counter values.
+
+  All counters of this object are copied into \a vals without holding up
+  the threads updating them. Each counter is read with an independent
+  relaxed load, so counters updated concurrently may be from slightly
+  different times. Values are neither consistent across counters nor
+  across different Rstats objects.
+ */
+
+void Rstats::Snapshot(std::vector<double>& vals) const
+{
+  vals.resize(Size());
+  for (size_t i=0; i<Size(); i++) 
+    vals[i] = fValue[i].fVal.load(memory_order_relaxed);
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Print counters in Prometheus text exposition format.
+
+  Each counter gives a line \c prefix_name{obj="label"} value, preceeded by
+  a \c HELP line with the counter text and a \c TYPE line. Characters not
+  allowed in metric names are replaced by '_'.
+
+  \note The output covers only this object. When several objects share
+        metric names, as all units or controllers of a type do, the caller
+        must merge the outputs so that each metric has one \c HELP and
+        \c TYPE line followed by all samples, see rw11::stats_prom.
+ */
+
+void Rstats::PrintProm(std::ostream& os, const std::string& prefix,
+                       const std::string& label) const
+{
+  vector<double> vals;
+  Snapshot(vals);
+  for (size_t i=0; i<Size(); i++) {
+    string mname = prefix + "_" + fName[i];
+    for (auto& c: mname) if (!isalnum(uint8_t(c)) && c != '_') c = '_';
+    os << "# HELP " << mname << " " << fText[i] << "\n";
+    os << "# TYPE " << mname << " counter\n";
+    os << mname << "{obj=\"" << label << "\"} " 
+       << RosPrintf(vals[i], "f", 0, 0) << "\n";
+  }
+  return;
+}
+
 //------------------------------------------+-----------------------------------
 //! FIXME_docs
 
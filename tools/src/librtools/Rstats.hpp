@@ -1,9 +1,11 @@
 // $Id: Rstats.hpp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2011-2019 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2011-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1306   1.1.1  counters hold double again, Inc() via cas loop
+// 2026-10-19  1288   1.1    atomic counters; add Snapshot(),PrintProm()
 // 2019-06-07  1160   1.0.3  add Reset(); drop operator-=() and operator*=()
 // 2017-02-04   865   1.0.2  add NameMaxLength(); Dump(): add detail arg
 // 2017-02-18   851   1.0.1  add IncLogHist; fix + and * operator definition
@@ -21,6 +23,7 @@
 #include <cstdint>
 #include <string>
 #include <vector>
+#include <atomic>
 #include <ostream>
 
 namespace Retro {
@@ -54,13 +57,32 @@ namespace Retro {
                           int width=0, int prec=0) const;
       void          Dump(std::ostream& os, int ind=0, const char* text=0,
                          int detail=0) const;
+      void          Snapshot(std::vector<double>& vals) const;
+      void          PrintProm(std::ostream& os, const std::string& prefix,
+                              const std::string& label) const;
 
       double        operator[](size_t ind) const;
 
       Rstats&       operator=(const Rstats& rhs);
 
   private:
-      std::vector<double> fValue;           //!< counter value
+      /*!
+        \brief counter cell, relaxed atomic to allow lock-free updates from
+        several threads; copyable to allow use in std::vector.
+       */
+      struct counter {
+        std::atomic<double> fVal;           //!< counter value
+
+                      counter() : fVal(0.) {}
+                      counter(const counter& rhs)
+                        : fVal(rhs.fVal.load(std::memory_order_relaxed)) {}
+        counter&      operator=(const counter& rhs)
+                        { fVal.store(rhs.fVal.load(std::memory_order_relaxed),
+                                     std::memory_order_relaxed);
+                          return *this; }
+      };
+
+      std::vector<counter> fValue;          //!< counter value
       std::vector<std::string> fName;       //!< counter name
       std::vector<std::string> fText;       //!< counter text
       std::uint32_t fHash;                  //!< hash value for name+text
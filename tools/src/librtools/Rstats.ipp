@@ -1,9 +1,12 @@
 // $Id: Rstats.ipp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2011- by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2011-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1306   1.1.1  counters hold double again, Inc() via cas loop;
+//                           Inc(): range check again
+// 2026-10-19  1288   1.1    use atomic counters; Inc() w/o range check
 // 2011-02-06   359   1.0    Initial version
 // ---------------------------------------------------------------------------
 
@@ -19,16 +22,26 @@ namespace Retro {
 
 inline void Rstats::Set(size_t ind, double val)
 {
-  fValue.at(ind) = val;
+  fValue.at(ind).fVal.store(val, std::memory_order_relaxed);
   return;
 }
 
 //------------------------------------------+-----------------------------------
-//! FIXME_docs
+/*!
+  \brief Increment counter \a ind by \a val.
+
+  Lock-free, called in hot paths from the server thread and from driver
+  threads. Like Set() and Value() it throws std::out_of_range for an
+  undefined counter index; fValue never grows after Define(). Uses a compare-exchange loop because std::atomic<double> has no
+  fetch_add() before C++20.
+ */
 
 inline void Rstats::Inc(size_t ind, double val)
 {
-  fValue.at(ind) += val;
+  std::atomic<double>& cnt = fValue.at(ind).fVal;
+  double old = cnt.load(std::memory_order_relaxed);
+  while (!cnt.compare_exchange_weak(old, old+val, std::memory_order_relaxed))
+    {}
   return;
 }
 
@@ -45,7 +58,7 @@ inline size_t Rstats::Size() const
 
 inline double Rstats::Value(size_t ind) const
 {
-  return fValue.at(ind);
+  return fValue.at(ind).fVal.load(std::memory_order_relaxed);
 }
 
 //------------------------------------------+-----------------------------------
@@ -69,7 +82,7 @@ inline const std::string& Rstats::Text(size_t ind) const
 
 inline double Rstats::operator[](size_t ind) const
 {
-  return fValue.at(ind);
+  return Value(ind);
 }
 
 //------------------------------------------+-----------------------------------
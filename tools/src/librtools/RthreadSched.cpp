@@ -0,0 +1,188 @@
+// $Id: RthreadSched.cpp 1294 2026-10-19 12:02:45Z mueller $
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// 
+// Revision History: 
+// Date         Rev Version  Comment
+// 2026-10-19  1294   1.0    Initial version
+// ---------------------------------------------------------------------------
+
+/*!
+  \brief   Implemenation of class RthreadSched.
+*/
+
+#include <sched.h>
+#include <sys/mman.h>
+#include <errno.h>
+
+#include <sstream>
+
+#include "RthreadSched.hpp"
+
+#include "RosFill.hpp"
+#include "Rexception.hpp"
+
+using namespace std;
+
+/*!
+  \class Retro::RthreadSched
+  \brief Holds and applies CPU affinity and scheduling policy of a thread.
+
+  Used to keep latency critical threads, like the rlink server thread,
+  on a dedicated core and optionally under a real-time policy. The setters
+  only check and store, Apply() changes a running thread.
+*/
+
+// all method definitions in namespace Retro
+namespace Retro {
+
+//------------------------------------------+-----------------------------------
+//! Default constructor
+
+RthreadSched::RthreadSched()
+  : fAffinity(),
+    fCpus(),
+    fPolicy("other"),
+    fPriority(0)
+{}
+
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Set CPU affinity.
+  \param list  comma separated list of cores or core ranges, like "2,4-7".
+               With an empty list the inherited affinity is kept.
+  \throws Rexception if list is malformed
+ */
+
+void RthreadSched::SetAffinity(const std::string& list)
+{
+  vector<int> cpus;
+  istringstream iss(list);
+  string item;
+  while (getline(iss, item, ',')) {
+    int  beg  = 0;
+    int  end  = 0;
+    char dash = 0;
+    istringstream is(item);
+    if (!(is >> beg) || beg < 0 || beg >= CPU_SETSIZE)
+      throw Rexception("RthreadSched::SetAffinity()", 
+                       "Bad args: invalid core list '" + list + "'");
+    end = beg;
+    if (is >> dash) {
+      if (dash != '-' || !(is >> end) || end < beg || end >= CPU_SETSIZE)
+        throw Rexception("RthreadSched::SetAffinity()", 
+                         "Bad args: invalid core list '" + list + "'");
+    }
+    for (int i=beg; i<=end; i++) cpus.push_back(i);
+  }
+  fAffinity = list;
+  fCpus     = cpus;
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Set scheduling policy.
+  \param policy  one of "other", "fifo", or "rr"
+  \throws Rexception if policy is unknown
+ */
+
+void RthreadSched::SetPolicy(const std::string& policy)
+{
+  if (policy != "other" && policy != "fifo" && policy != "rr")
+    throw Rexception("RthreadSched::SetPolicy()", 
+                     "Bad args: policy must be other, fifo or rr");
+  fPolicy = policy;
+  if (fPolicy == "other") {
+    fPriority = 0;
+  } else if (fPriority == 0) {
+    fPriority = 1;
+  }
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Set scheduling priority, only used for fifo and rr policy.
+  \throws Rexception if prio out of range
+ */
+
+void RthreadSched::SetPriority(int prio)
+{
+  int pmin = sched_get_priority_min(SCHED_FIFO);
+  int pmax = sched_get_priority_max(SCHED_FIFO);
+  if (prio < pmin || prio > pmax)
+    throw Rexception("RthreadSched::SetPriority()", 
+                     "Bad args: priority out of range");
+  fPriority = prio;
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Apply affinity and policy to thread \a tid.
+
+  Setting a real-time policy usually requires CAP_SYS_NICE or a suitable
+  RLIMIT_RTPRIO, so a failure is returned in \a emsg for the caller to log.
+ */
+
+bool RthreadSched::Apply(pthread_t tid, RerrMsg& emsg) const
+{
+  int irc = 0;
+  if (!fCpus.empty()) {                     // empty list: leave as inherited
+    cpu_set_t cset;
+    CPU_ZERO(&cset);
+    for (auto i: fCpus) CPU_SET(i, &cset);
+    irc = ::pthread_setaffinity_np(tid, sizeof(cset), &cset);
+    if (irc != 0) {
+      emsg.InitErrno("RthreadSched::Apply()", 
+                     "pthread_setaffinity_np() failed: ", irc);
+      return false;
+    }
+  }
+
+  struct sched_param sp = {};
+  int policy = SCHED_OTHER;
+  if (fPolicy == "fifo") policy = SCHED_FIFO;
+  if (fPolicy == "rr")   policy = SCHED_RR;
+  sp.sched_priority = (policy == SCHED_OTHER) ? 0 : fPriority;
+  irc = ::pthread_setschedparam(tid, policy, &sp);
+  if (irc != 0) {
+    emsg.InitErrno("RthreadSched::Apply()", 
+                   "pthread_setschedparam() failed: ", irc);
+    return false;
+  }
+  return true;
+}
+
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Lock (or unlock) all current and future pages of the process.
+ */
+
+bool RthreadSched::LockMemory(bool lock, RerrMsg& emsg)
+{
+  int irc = lock ? ::mlockall(MCL_CURRENT|MCL_FUTURE) : ::munlockall();
+  if (irc != 0) {
+    emsg.InitErrno("RthreadSched::LockMemory()", 
+                   lock ? "mlockall() failed: " : "munlockall() failed: ",
+                   errno);
+    return false;
+  }
+  return true;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+void RthreadSched::Dump(std::ostream& os, int ind, const char* text) const
+{
+  RosFill bl(ind);
+  os << bl << (text?text:"--") << "RthreadSched @ " << this << endl;
+  os << bl << "  fAffinity:       " << fAffinity << endl;
+  os << bl << "  fPolicy:         " << fPolicy << endl;
+  os << bl << "  fPriority:       " << fPriority << endl;
+  return;
+}
+
+} // end namespace Retro
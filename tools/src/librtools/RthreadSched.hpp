@@ -0,0 +1,57 @@
+// $Id: RthreadSched.hpp 1294 2026-10-19 12:02:45Z mueller $
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// 
+// Revision History: 
+// Date         Rev Version  Comment
+// 2026-10-19  1294   1.0    Initial version
+// ---------------------------------------------------------------------------
+
+
+/*!
+  \brief   Declaration of class \c RthreadSched.
+*/
+
+#ifndef included_Retro_RthreadSched
+#define included_Retro_RthreadSched 1
+
+#include <pthread.h>
+
+#include <string>
+#include <vector>
+#include <ostream>
+
+#include "RerrMsg.hpp"
+
+namespace Retro {
+
+  class RthreadSched {
+    public:
+                    RthreadSched();
+
+      void          SetAffinity(const std::string& list);
+      const std::string& Affinity() const;
+      void          SetPolicy(const std::string& policy);
+      const std::string& Policy() const;
+      void          SetPriority(int prio);
+      int           Priority() const;
+
+      bool          IsDefault() const;
+      bool          Apply(pthread_t tid, RerrMsg& emsg) const;
+
+      static bool   LockMemory(bool lock, RerrMsg& emsg);
+
+      void          Dump(std::ostream& os, int ind=0, const char* text=0) const;
+
+    protected:
+      std::string   fAffinity;              //!< core list, e.g. "2,4-7"
+      std::vector<int> fCpus;               //!< cores from core list
+      std::string   fPolicy;                //!< policy: other, fifo, or rr
+      int           fPriority;              //!< priority for fifo and rr
+  };
+
+} // end namespace Retro
+
+#include "RthreadSched.ipp"
+
+#endif
@@ -0,0 +1,49 @@
+// $Id: RthreadSched.ipp 1294 2026-10-19 12:02:45Z mueller $
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// 
+// Revision History: 
+// Date         Rev Version  Comment
+// 2026-10-19  1294   1.0    Initial version
+// ---------------------------------------------------------------------------
+
+/*!
+  \brief   Implemenation (inline) of class RthreadSched.
+*/
+
+// all method definitions in namespace Retro
+namespace Retro {
+
+//------------------------------------------+-----------------------------------
+//! Returns core list, empty if no affinity set
+
+inline const std::string& RthreadSched::Affinity() const
+{
+  return fAffinity;
+}
+
+//------------------------------------------+-----------------------------------
+//! Returns scheduling policy name
+
+inline const std::string& RthreadSched::Policy() const
+{
+  return fPolicy;
+}
+
+//------------------------------------------+-----------------------------------
+//! Returns scheduling priority
+
+inline int RthreadSched::Priority() const
+{
+  return fPriority;
+}
+
+//------------------------------------------+-----------------------------------
+//! Returns true if neither affinity nor policy is set
+
+inline bool RthreadSched::IsDefault() const
+{
+  return fCpus.empty() && fPolicy == "other";
+}
+
+} // end namespace Retro
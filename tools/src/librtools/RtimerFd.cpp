@@ -1,9 +1,11 @@
 // $Id: RtimerFd.cpp 1185 2019-07-12 17:29:12Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2013-2019 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2013-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1299   1.2    add SetPeriodic()
+// 2026-10-19  1297   1.1.1  BUGFIX: SetRelative(): allow dt < 1 sec
 // 2019-06-08  1161   1.1    derive from Rfd, inherit IsOpen,Close,Fd
 // 2017-02-18   852   1.0    Initial version
 // 2013-01-11   473   0.1    First draft
@@ -67,7 +69,7 @@ void RtimerFd::SetRelative(const Rtime& dt)
   if (!IsOpen())
     throw Rexception(fCnam+"SetRelative()", "bad state: not open");
 
-  if (dt.Sec() <= 0 || dt.NSec() <= 0)
+  if (!dt.IsPositive())
     throw Rexception(fCnam+"SetRelative()", "bad value: dt zero or negative ");
 
   struct itimerspec itspec;
@@ -81,6 +83,32 @@ void RtimerFd::SetRelative(const Rtime& dt)
   return;
 }
 
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Start periodic timer, first expiration after \a dt.
+
+  The expirations are on a fixed grid, so handler latency does not
+  accumulate. Read() returns the number of expirations since last Read().
+ */
+
+void RtimerFd::SetPeriodic(const Rtime& dt)
+{
+  if (!IsOpen())
+    throw Rexception(fCnam+"SetPeriodic()", "bad state: not open");
+
+  if (!dt.IsPositive())
+    throw Rexception(fCnam+"SetPeriodic()", "bad value: dt zero or negative ");
+
+  struct itimerspec itspec;
+  itspec.it_interval          = dt.Timespec();
+  itspec.it_value             = dt.Timespec();
+
+  if (::timerfd_settime(fFd, 0, &itspec, nullptr) < 0)
+    throw Rexception(fCnam+"SetPeriodic()", 
+                     "timerfd_settime() failed: ", errno);
+  return;
+}
+
 //------------------------------------------+-----------------------------------
 //! FIXME_docs
 
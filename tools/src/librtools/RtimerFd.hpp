@@ -1,9 +1,10 @@
 // $Id: RtimerFd.hpp 1185 2019-07-12 17:29:12Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2013-2019 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2013-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1299   1.2    add SetPeriodic()
 // 2019-06-08  1161   1.1    derive from Rfd, inherit IsOpen,Close,Fd
 // 2018-12-16  1084   1.0.1  use =delete for noncopyable instead of boost
 // 2017-02-18   852   1.0    Initial version
@@ -37,6 +38,7 @@ namespace Retro {
       void          Open(clockid_t clkid=CLOCK_MONOTONIC);
       void          SetRelative(const Rtime& dt);
       void          SetRelative(double dt);
+      void          SetPeriodic(const Rtime& dt);
       void          Cancel();
       uint64_t      Read();
 
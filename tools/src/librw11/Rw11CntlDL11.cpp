@@ -1,9 +1,11 @@
 // $Id: Rw11CntlDL11.cpp 1185 2019-07-12 17:29:12Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2013-2019 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2013-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1286   1.5.3  add WakeupTx(); hold tx fifo reads on backpressure
+// 2026-10-19  1281   1.5.2  register fPrimClist for coalesced attn harvest
 // 2019-05-31  1156   1.5.1  size->fuse rename; use unit.StatInc[RT]x
 // 2019-04-27  1139   1.5    add dl11_buf readout
 // 2019-04-19  1133   1.4.2  use ExecWibr(),ExecRibr()
@@ -100,6 +102,7 @@ Rw11CntlDL11::Rw11CntlDL11()
     fFsize(0),
     fTxRblkSize(4),
     fTxQueBusy(false),
+    fTxHold(false),
     fLastRbuf(0)
 {
   // must be here because Units have a back-ptr (not available at Rw11CntlBase)
@@ -107,6 +110,7 @@ Rw11CntlDL11::Rw11CntlDL11()
   
   fStats.Define(kStatNRxBlk,  "NRxBlk" , "wblk done");
   fStats.Define(kStatNTxQue,  "NTxQue" , "rblk queued");
+  fStats.Define(kStatNTxHold, "NTxHold", "tx held off by backpressure");
 }
 
 //------------------------------------------+-----------------------------------
@@ -164,7 +168,7 @@ void Rw11CntlDL11::Start()
 
   // add attn handler
   Server().AddAttnHandler(bind(&Rw11CntlDL11::AttnHandler, this, _1), 
-                          uint16_t(1)<<fLam, this);
+                          uint16_t(1)<<fLam, this, &fPrimClist);
   fStarted = true;
   return;
 }
@@ -202,6 +206,25 @@ void Rw11CntlDL11::Wakeup()
   return;
 }
 
+//------------------------------------------+-----------------------------------
+//! Resume tx fifo reads after terminal backpressure was released.
+
+void Rw11CntlDL11::WakeupTx()
+{
+  if (!fTxHold || !fspUnit[0]->SndReady()) return; // spurious call
+  fTxHold = false;
+  if (!Buffered()) return;
+
+  fTxRblkSize = fFsize;                     // fifo likely full, read it all
+  fPrimClist[fPC_xbuf].SetBlockRead(fTxRblkSize);
+  if (!fTxQueBusy) {
+    fStats.Inc(kStatNTxQue);
+    fTxQueBusy = true;
+    Server().QueueAction(bind(&Rw11CntlDL11::TxRcvHandler, this));
+  }
+  return;
+}
+
 //------------------------------------------+-----------------------------------
 //! FIXME_docs
 
@@ -259,6 +282,7 @@ void Rw11CntlDL11::Dump(std::ostream& os, int ind, const char* text,
   os << bl << "  fFsize:          " << RosPrintf(fFsize,"d",3) << endl;
   os << bl << "  fTxRblkSize:     " << RosPrintf(fTxRblkSize,"d",3) << endl;
   os << bl << "  fTxQueBusy:      " << RosPrintf(fTxQueBusy) << endl;
+  os << bl << "  fTxHold:         " << RosPrintf(fTxHold) << endl;
   os << bl << "  fTLastRbuf:      " << RosPrintf(fLastRbuf) << endl;
 
   Rw11CntlBase<Rw11UnitDL11,1>::Dump(os, ind, " ^", detail);
@@ -388,12 +412,21 @@ void Rw11CntlDL11::TxProcessBuf(const RlinkCommand& cmd, bool prim,
   }
   fspUnit[0]->Snd(ochr, done);
 
+  // stop draining the fifo when the terminal asserts backpressure; the
+  // fifo fills and xrdy is held off until WakeupTx() resumes reading
+  if (!fTxHold && !fspUnit[0]->SndReady()) {
+    fStats.Inc(kStatNTxHold);
+    fTxHold = true;
+  }
+
   // determine next chunk size from highest fifo 'fuse' field, at least 4
+  // while held off read only a single char per attn
   fTxRblkSize = max(uint16_t(4), max(uint16_t(done),fumax));
+  if (fTxHold) fTxRblkSize = 1;
   
   // queue further reads when queue idle and fifo not emptied
   // check for 'size==1' not seen in current read
-  if ((!fTxQueBusy) && fumin > 1) {       // if fumin>1 no fuse==1 seen
+  if ((!fTxQueBusy) && (!fTxHold) && fumin > 1) { // no fuse==1 seen
     fStats.Inc(kStatNTxQue);
     fTxQueBusy = true;
     Server().QueueAction(bind(&Rw11CntlDL11::TxRcvHandler, this));
@@ -1,9 +1,10 @@
 // $Id: Rw11CntlDL11.hpp 1185 2019-07-12 17:29:12Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2013-2019 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2013-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1286   1.4.2  add WakeupTx(); hold tx fifo reads on backpressure
 // 2019-05-30  1155   1.4.1  size->fuse rename; use unit.StatInc[RT]x
 // 2019-04-26  1139   1.4    add dl11_buf readout
 // 2019-04-06  1126   1.3    xbuf.val in msb; rrdy in rbuf (new iface)
@@ -40,6 +41,7 @@ namespace Retro {
 
       virtual void  UnitSetup(size_t ind);
       void          Wakeup();
+      void          WakeupTx();
 
       void          SetRxQlim(uint16_t qlim);
       uint16_t      RxQlim() const;
@@ -93,6 +95,7 @@ namespace Retro {
       enum stats {
         kStatNRxBlk= Rw11Cntl::kDimStat,    //!< done wblk
         kStatNTxQue,                        //!< queue rblk
+        kStatNTxHold,                       //!< tx held off by backpressure
         kDimStat
       };
     
@@ -116,6 +119,7 @@ namespace Retro {
       uint16_t      fFsize;                 //!< fifo size
       uint16_t      fTxRblkSize;            //!< tx rblk chunk size
       bool          fTxQueBusy;             //!< tx queue busy
+      bool          fTxHold;                //!< tx held off by backpressure
       uint16_t      fLastRbuf;              //!< last seen rbuf
   };
   
@@ -4,6 +4,8 @@
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1286   1.0.2  add WakeupTx(); hold tx fifo reads on backpressure
+// 2026-10-19  1281   1.0.1  register fPrimClist for coalesced attn harvest
 // 2019-05-19  1150   1.0    Initial version
 // 2019-05-04  1146   0.1    First draft
 // ---------------------------------------------------------------------------
@@ -115,6 +117,7 @@ Rw11CntlDZ11::Rw11CntlDZ11()
     fFsize(0),
     fTxRblkSize(4),
     fTxQueBusy(false),
+    fTxHold(false),
     fRxCurUnit(0),
     fLastFuse(0),
     fCurDtr(0),
@@ -129,6 +132,7 @@ Rw11CntlDZ11::Rw11CntlDZ11()
   
   fStats.Define(kStatNRxBlk,    "NRxBlk"    , "wblk done");
   fStats.Define(kStatNTxQue,    "NTxQue"    , "rblk queued");
+  fStats.Define(kStatNTxHold,   "NTxHold"   , "tx held off by backpressure");
   fStats.Define(kStatNCalDtr,   "NCalDtr"   , "cal dtr  received");
   fStats.Define(kStatNCalBrk,   "NCalBrk"   , "cal brk  received");
   fStats.Define(kStatNCalRxon,  "NCalRxon"  , "cal rxon received");
@@ -189,7 +193,7 @@ void Rw11CntlDZ11::Start()
 
   // add attn handler
   Server().AddAttnHandler(bind(&Rw11CntlDZ11::AttnHandler, this, _1), 
-                          uint16_t(1)<<fLam, this);
+                          uint16_t(1)<<fLam, this, &fPrimClist);
   fStarted = true;
   return;
 }
@@ -242,6 +246,24 @@ void Rw11CntlDZ11::Wakeup()
   return;
 }
 
+//------------------------------------------+-----------------------------------
+//! Resume tx fifo reads after terminal backpressure was released.
+
+void Rw11CntlDZ11::WakeupTx()
+{
+  if (!fTxHold || !TxAllReady()) return;   // spurious call or still held
+  fTxHold = false;
+
+  fTxRblkSize = fFsize;                     // fifo likely full, read it all
+  fPrimClist[fPC_fdat].SetBlockRead(fTxRblkSize);
+  if (!fTxQueBusy) {
+    fStats.Inc(kStatNTxQue);
+    fTxQueBusy = true;
+    Server().QueueAction(bind(&Rw11CntlDZ11::TxRcvHandler, this));
+  }
+  return;
+}
+
 //------------------------------------------+-----------------------------------
 //! FIXME_docs
 
@@ -310,6 +332,7 @@ void Rw11CntlDZ11::Dump(std::ostream& os, int ind, const char* text,
   os << bl << "  fFsize:          " << RosPrintf(fFsize,"d",3) << endl;
   os << bl << "  fTxRblkSize:     " << RosPrintf(fTxRblkSize,"d",3) << endl;
   os << bl << "  fTxQueBusy:      " << RosPrintf(fTxQueBusy) << endl;
+  os << bl << "  fTxHold:         " << RosPrintf(fTxHold) << endl;
   os << bl << "  fRxCurUnit:      " << RosPrintf(fRxCurUnit,"d",3) << endl;
   os << bl << "  fLastFuse:       " << RosPrintf(fLastFuse,"d",3) << endl;
   os << bl << "  fCurDtr:         " << RosPrintBvi(fCurDtr,2) << endl;
@@ -478,13 +501,23 @@ void Rw11CntlDZ11::TxProcess(const RlinkCommand& cmd, bool prim, uint16_t fuse)
   for (size_t i = 0; i < kNUnit; i++) {
     if (sndcnt[i]) fspUnit[i]->Snd(sndbuf[i], sndcnt[i]);
   }  
+
+  // stop draining the fifo when a terminal asserts backpressure; the
+  // fifo fills and tx ready is held off until WakeupTx() resumes reading.
+  // All lines share the fifo, so all lines are held off.
+  if (!fTxHold && !TxAllReady()) {
+    fStats.Inc(kStatNTxHold);
+    fTxHold = true;
+  }
  
   // determine next chunk size: done+tfuse, at least 4, at most fFsize
+  // while held off read only a single char per attn
   fTxRblkSize = uint16_t(done)+tfuse;
   fTxRblkSize = max(uint16_t(4), min(fTxRblkSize, fFsize));
+  if (fTxHold) fTxRblkSize = 1;
   
   // queue further reads when queue idle and fifo not emptied
-  if ((!fTxQueBusy) && done > 0 && (!lastseen)) {
+  if ((!fTxQueBusy) && (!fTxHold) && done > 0 && (!lastseen)) {
     fStats.Inc(kStatNTxQue);
     fTxQueBusy = true;
     Server().QueueAction(bind(&Rw11CntlDZ11::TxRcvHandler, this));
@@ -514,6 +547,17 @@ void Rw11CntlDZ11::TxProcess(const RlinkCommand& cmd, bool prim, uint16_t fuse)
   return;
 }
 
+//------------------------------------------+-----------------------------------
+//! Returns \c true when no line asserts terminal backpressure.
+
+bool Rw11CntlDZ11::TxAllReady() const
+{
+  for (size_t i = 0; i < kNUnit; i++) {
+    if (!fspUnit[i]->SndReady()) return false;
+  }
+  return true;
+}
+
 //------------------------------------------+-----------------------------------
 //! FIXME_docs
 
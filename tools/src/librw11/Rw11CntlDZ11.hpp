@@ -4,6 +4,7 @@
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1286   1.0.1  add WakeupTx(); hold tx fifo reads on backpressure
 // 2019-05-19  1150   1.0    Initial version
 // 2019-05-04  1146   0.1    First draft
 // ---------------------------------------------------------------------------
@@ -34,6 +35,7 @@ namespace Retro {
       virtual void  UnitSetup(size_t ind);
       virtual void  UnitSetupAll();
       void          Wakeup();
+      void          WakeupTx();
 
       void          SetRxQlim(uint16_t qlim);
       uint16_t      RxQlim() const;
@@ -119,6 +121,7 @@ namespace Retro {
       enum stats {
         kStatNRxBlk= Rw11Cntl::kDimStat,    //!< done wblk
         kStatNTxQue,                        //!< queue rblk
+        kStatNTxHold,                       //!< tx held off by backpressure
         kStatNCalDtr,                       //!< cal dtr received
         kStatNCalBrk,                       //!< cal brk received
         kStatNCalRxon,                      //!< cal rxon received
@@ -136,6 +139,7 @@ namespace Retro {
       void          TxProcess(const RlinkCommand& cmd, bool prim,
                               uint16_t fuse);
       int           TxRcvHandler();
+      bool          TxAllReady() const;
       bool          NextBusyRxUnit();
     
     protected:
@@ -149,6 +153,7 @@ namespace Retro {
       uint16_t      fFsize;                 //!< fifo size
       uint16_t      fTxRblkSize;            //!< tx rblk chunk size
       bool          fTxQueBusy;             //!< tx queue busy
+      bool          fTxHold;                //!< tx held off by backpressure
       size_t        fRxCurUnit;             //!< rx current unit
       uint16_t      fLastFuse;              //!< last seen fuse
       uint8_t       fCurDtr;                //!< current dtr
@@ -1,9 +1,11 @@
 // $Id: Rw11CntlLP11.cpp 1185 2019-07-12 17:29:12Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2013-2019 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2013-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1296   1.4    ProcessBuf(): write chunk via WriteSpan()
+// 2026-10-19  1281   1.3.6  register fPrimClist for coalesced attn harvest
 // 2019-05-30  1155   1.3.5  size->fuse rename
 // 2019-04-27  1140   1.3.4  use RtraceTools::
 // 2019-04-19  1133   1.3.3  use ExecWibr()
@@ -27,6 +29,8 @@
   \brief   Implemenation of Rw11CntlLP11.
 */
 
+#include <string.h>
+
 #include <functional>
 #include <algorithm>
 
@@ -146,7 +150,7 @@ void Rw11CntlLP11::Start()
   
   // add attn handler
   Server().AddAttnHandler(bind(&Rw11CntlLP11::AttnHandler, this, _1), 
-                          uint16_t(1)<<fLam, this);
+                          uint16_t(1)<<fLam, this, &fPrimClist);
 
   fStarted = true;
   return;
@@ -244,25 +248,57 @@ void Rw11CntlLP11::ProcessUnbuf(uint16_t buf)
 
 void Rw11CntlLP11::WriteChar(uint8_t ochr)
 {
-  if (ochr == 0) {                          // count NULL char
-    fStats.Inc(kStatNNull);
-    return;
+  WriteSpan(&ochr, 1);
+  return;  
+}
+
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Write a span of characters to the attached stream.
+
+  NUL characters are dropped, lines and pages are counted, and the remaining
+  characters are written with a single VirtWrite(). The scans use memchr(),
+  which is vectorized, so a span without NUL characters is not copied.
+  The stream is flushed when a form feed was seen.
+
+  \param buf   character buffer, is modified when NUL characters are dropped
+  \param size  number of characters in \a buf
+ */
+
+void Rw11CntlLP11::WriteSpan(uint8_t* buf, size_t size)
+{
+  uint8_t* pend = buf + size;
+  uint8_t* pnul = static_cast<uint8_t*>(::memchr(buf, 0, size));
+  if (pnul) pend = remove(pnul, pend, uint8_t(0));
+  size_t nchr = pend - buf;
+  if (nchr < size) fStats.Inc(kStatNNull, double(size-nchr));
+  if (nchr == 0) return;
+
+  size_t nline = 0;
+  size_t npage = 0;
+  const uint8_t* p = buf;
+  while ((p = static_cast<const uint8_t*>(::memchr(p, '\n', pend-p)))) {
+    nline += 1;
+    p     += 1;
   }
-  
-  fStats.Inc(kStatNChar);
+  p = buf;
+  while ((p = static_cast<const uint8_t*>(::memchr(p, '\f', pend-p)))) {
+    npage += 1;
+    p     += 1;
+  }
+
+  fStats.Inc(kStatNChar, double(nchr));
+  if (nline > 0) fStats.Inc(kStatNLine, double(nline));
+  if (npage > 0) fStats.Inc(kStatNPage, double(npage));
+
   RerrMsg emsg;
-  bool rc = fspUnit[0]->VirtWrite(&ochr, 1, emsg);
+  bool rc = fspUnit[0]->VirtWrite(buf, nchr, emsg);
   if (!rc) {
     RlogMsg lmsg(LogFile());
     lmsg << emsg;
     UnitSetup(0);
   }
-  if (ochr == '\f') {                     // ^L = FF = FormFeed seen ?
-    fStats.Inc(kStatNPage);
-    rc = fspUnit[0]->VirtFlush(emsg);
-  } else if (ochr == '\n') {              // ^J = LF = LineFeed seen ?
-    fStats.Inc(kStatNLine);
-  }
+  if (npage > 0) rc = fspUnit[0]->VirtFlush(emsg);
   return;  
 }
 
@@ -284,6 +320,8 @@ void Rw11CntlLP11::ProcessBuf(const RlinkCommand& cmd, bool prim)
   uint16_t fdel  = 0;
   uint16_t fumin  = 0;
   uint16_t fumax  = 0;
+  uint8_t  obuf[kFifoMaxSize];
+  size_t   nout   = 0;
 
   if (done > 0) {
     fbeg  = (pbuf[0]     >>kBUF_V_FUSE) & kBUF_B_FUSE;
@@ -297,8 +335,13 @@ void Rw11CntlLP11::ProcessBuf(const RlinkCommand& cmd, bool prim)
     uint16_t fuse = (pbuf[i]>>kBUF_V_FUSE) & kBUF_B_FUSE;
     fumin = min(fumin,fuse);
     fumax = max(fumax,fuse);
-    WriteChar(ochr);
+    obuf[nout++] = ochr;
+    if (nout == sizeof(obuf)) {             // buffer full (not expected)
+      WriteSpan(obuf, nout);
+      nout = 0;
+    }
   }
+  if (nout > 0) WriteSpan(obuf, nout);      // write whole chunk at once
 
   // determine next chunk size from highest fifo 'fuse' field, at least 4
   fRblkSize = max(uint16_t(4), max(uint16_t(done),fumax));
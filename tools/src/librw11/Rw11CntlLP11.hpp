@@ -1,9 +1,10 @@
 // $Id: Rw11CntlLP11.hpp 1185 2019-07-12 17:29:12Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2013-2019 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2013-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History:
 // Date         Rev Version  Comment
+// 2026-10-19  1296   1.3    ProcessBuf(): write chunk via WriteSpan()
 // 2019-05-30  1155   1.2.3  size->fuse rename
 // 2019-04-14  1131   1.2.2  remove SetOnline(), use UnitSetup()
 // 2019-04-07  1127   1.2.1  add fQueBusy and queue protection
@@ -85,6 +86,7 @@ namespace Retro {
       int           AttnHandler(RlinkServer::AttnArgs& args);
       void          ProcessUnbuf(uint16_t buf);
       void          WriteChar(uint8_t ochr);
+      void          WriteSpan(uint8_t* buf, size_t size);
       void          ProcessBuf(const RlinkCommand& cmd, bool prim);
       int           RcvHandler();
 
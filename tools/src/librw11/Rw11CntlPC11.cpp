@@ -1,9 +1,11 @@
 // $Id: Rw11CntlPC11.cpp 1185 2019-07-12 17:29:12Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2013-2019 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2013-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1296   1.6    PpProcessBuf(): write chunk via PpWriteSpan()
+// 2026-10-19  1281   1.5.3  register fPrimClist for coalesced attn harvest
 // 2019-05-31  1156   1.5.2  size->fuse rename
 // 2019-04-27  1140   1.5.1  use RtraceTools::
 // 2019-04-20  1134   1.5    add pc11_buf readout
@@ -168,7 +170,7 @@ void Rw11CntlPC11::Start()
 
   // add attn handler
   Server().AddAttnHandler(bind(&Rw11CntlPC11::AttnHandler, this, _1), 
-                          uint16_t(1)<<fLam, this);
+                          uint16_t(1)<<fLam, this, &fPrimClist);
 
   fStarted = true;
   return;
@@ -433,9 +435,18 @@ void Rw11CntlPC11::ProcessUnbuf(uint16_t rbuf, uint16_t pbuf)
 //! FIXME_docs
 
 void Rw11CntlPC11::PpWriteChar(uint8_t ochr)
+{
+  PpWriteSpan(&ochr, 1);
+  return;
+}
+  
+//------------------------------------------+-----------------------------------
+//! Write a span of punch characters with a single VirtWrite()
+
+void Rw11CntlPC11::PpWriteSpan(const uint8_t* buf, size_t size)
 {
   RerrMsg emsg;
-  bool rc = fspUnit[kUnit_PP]->VirtWrite(&ochr, 1, emsg);
+  bool rc = fspUnit[kUnit_PP]->VirtWrite(buf, size, emsg);
   if (!rc) {
     RlogMsg lmsg(LogFile());
     lmsg << "-E " << Name() << ":" << emsg;
@@ -540,6 +551,8 @@ void Rw11CntlPC11::PpProcessBuf(const RlinkCommand& cmd, bool prim,
   uint16_t fdel  = 0;
   uint16_t fumin = 0;
   uint16_t fumax = 0;
+  uint8_t  obuf[kFifoMaxSize];
+  size_t   nout  = 0;
 
   fbeg  = (pbuf[0]     >>kPBUF_V_FUSE) & kPBUF_B_FUSE;
   fend  = (pbuf[done-1]>>kPBUF_V_FUSE) & kPBUF_B_FUSE;
@@ -551,8 +564,13 @@ void Rw11CntlPC11::PpProcessBuf(const RlinkCommand& cmd, bool prim,
     uint16_t fuse = (pbuf[i]>>kPBUF_V_FUSE) & kPBUF_B_FUSE;
     fumin = min(fumin,fuse);
     fumax = max(fumax,fuse);
-    PpWriteChar(ochr);
+    obuf[nout++] = ochr;
+    if (nout == sizeof(obuf)) {             // buffer full (not expected)
+      PpWriteSpan(obuf, nout);
+      nout = 0;
+    }
   }
+  if (nout > 0) PpWriteSpan(obuf, nout);    // write whole chunk at once
 
   // determine next chunk size from highest fifo 'fuse' field, at least 4
   fPpRblkSize = max(uint16_t(4), max(uint16_t(done),fumax));
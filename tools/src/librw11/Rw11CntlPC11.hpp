@@ -1,9 +1,10 @@
 // $Id: Rw11CntlPC11.hpp 1185 2019-07-12 17:29:12Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2013-2019 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2013-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1296   1.5    PpProcessBuf(): write chunk via PpWriteSpan()
 // 2019-05-30  1155   1.4.1  size->fuse rename
 // 2019-04-20  1134   1.4    add pc11_buf readout
 // 2019-04-14  1131   1.3.1  remove SetOnline(), use UnitSetup()
@@ -112,6 +113,7 @@ namespace Retro {
       int           AttnHandler(RlinkServer::AttnArgs& args);
       void          ProcessUnbuf(uint16_t rbuf, uint16_t pbuf);
       void          PpWriteChar(uint8_t ochr);
+      void          PpWriteSpan(const uint8_t* buf, size_t size);
       void          PrProcessBuf(uint16_t rbuf);
       void          PpProcessBuf(const RlinkCommand& cmd, bool prim,
                                  uint16_t rbuf);
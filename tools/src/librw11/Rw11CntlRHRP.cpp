@@ -1,11 +1,15 @@
 // $Id: Rw11CntlRHRP.cpp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2015-2019 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2015-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // Other credits: 
 //   the boot code is from the simh project and Copyright Robert M Supnik
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1306   1.0.16 UNS on latched async write error
+// 2026-10-19  1304   1.0.15 add Timing(), seek and rotation timing model
+// 2026-10-19  1301   1.0.14 add IoTrace(), per request I/O trace
+// 2026-10-19  1281   1.0.13 register fPrimClist for coalesced attn harvest
 // 2019-04-19  1133   1.0.12 use ExecWibr()
 // 2019-04-14  1131   1.0.11 proper unit init, call UnitSetupAll() in Start()
 // 2019-02-23  1114   1.0.10 use std::bind instead of lambda
@@ -182,14 +186,19 @@ Rw11CntlRHRP::Rw11CntlRHRP()
     fRd_nwrd(0),
     fRd_fu(0),
     fRd_ovr(false),
+    fRd_tdue(0.),
+    fTAttnLast(0.),
     fRdma(this,
           std::bind(&Rw11CntlRHRP::RdmaPreExecCB,  this, _1, _2, _3, _4),
-          std::bind(&Rw11CntlRHRP::RdmaPostExecCB, this, _1, _2, _3, _4))
+          std::bind(&Rw11CntlRHRP::RdmaPostExecCB, this, _1, _2, _3, _4)),
+    fIoTrace(),
+    fTiming(this)
 {
   // must be here because Units have a back-ptr (not available at Rw11CntlBase)
   for (size_t i=0; i<NUnit(); i++) {
     fspUnit[i].reset(new Rw11UnitRHRP(this, i));
   }
+  fRdma.SetIoTrace(&fIoTrace);
 
   fStats.Define(kStatNFuncWchk   , "NFuncWchk"    , "func WCHK");
   fStats.Define(kStatNFuncWrite  , "NFuncWrite"   , "func WRITE");
@@ -198,6 +207,7 @@ Rw11CntlRHRP::Rw11CntlRHRP()
   fStats.Define(kStatNFuncPack   , "NFuncPack"    , "func PACK ACK (loc)");
   fStats.Define(kStatNFuncPore   , "NFuncPore"    , "func PORT REL (loc)");
   fStats.Define(kStatNFuncSeek   , "NFuncSeek"    , "func SEEK (loc)");
+  fStats.Define(kStatNAsyncErr   , "NAsyncErr"    , "async write error, UNS");
 }
 
 //------------------------------------------+-----------------------------------
@@ -271,7 +281,7 @@ void Rw11CntlRHRP::Start()
 
   // add attn handler
   Server().AddAttnHandler(bind(&Rw11CntlRHRP::AttnHandler, this, _1), 
-                          uint16_t(1)<<fLam, this);
+                          uint16_t(1)<<fLam, this, &fPrimClist);
 
   fStarted = true;
   return;
@@ -385,7 +395,11 @@ void Rw11CntlRHRP::Dump(std::ostream& os, int ind, const char* text,
   os << bl << "  fRd_nwrd:        " << RosPrintf(fRd_nwrd,"d",6) << endl;
   os << bl << "  fRd_fu:          " << RosPrintf(fRd_fu,"d",6) << endl;
   os << bl << "  fRd_ovr:         " << RosPrintf(fRd_ovr) << endl;
+  os << bl << "  fRd_tdue:        " << fRd_tdue << endl;
+  os << bl << "  fTAttnLast:      " << fTAttnLast << endl;
   fRdma.Dump(os, ind+2, "fRdma: ", detail);
+  fIoTrace.Dump(os, ind+2, "fIoTrace: ", detail);
+  fTiming.Dump(os, ind+2, "fTiming: ", detail);
   Rw11CntlBase<Rw11UnitRHRP,4>::Dump(os, ind, " ^", detail);
   return;
 }
@@ -472,6 +486,8 @@ int Rw11CntlRHRP::AttnHandler(RlinkServer::AttnArgs& args)
   bool ovr = lba + nblk > unit.NBlock();
   if (ovr) nwrd = (unit.NBlock()-lba) * (unit.BlockSize()/2);
 
+  fIoTrace.Begin(unum, fu, lba, nwrd);
+
   // remember request parameters for call back and error exit handling
 
   fRd_rpcs1 = rpcs1;
@@ -488,6 +504,13 @@ int Rw11CntlRHRP::AttnHandler(RlinkServer::AttnArgs& args)
   fRd_nwrd  = nwrd;
   fRd_fu    = fu;
   fRd_ovr   = ovr;
+  fRd_tdue  = 0.;
+
+  // seeks are done by ibdr_rhrp autonomously, if some were done since the
+  // last request assume they started then, so they overlap with it
+  double tnow  = Rw11DiskTiming::Now();
+  double tseek = (rpcs3 & kRPCS3_M_RSEEKDONE) ? fTAttnLast : tnow;
+  fTAttnLast = tnow;
 
   // check for general abort conditions
   // note: only 'data transfer' functions handled via backend
@@ -497,6 +520,21 @@ int Rw11CntlRHRP::AttnHandler(RlinkServer::AttnArgs& args)
   if (! unit.HasVirt()) {                   // not attached
     AddErrorExit(clist, kRPER1_M_UNS);      // signal UNS (drive unsafe)
     Server().Exec(clist);                   // doit
+    fIoTrace.End(kRPER1_M_UNS);
+    return 0;
+  }
+
+  // failed overlapped write --> signal drive unsave status
+  //   the error stays latched until the unit is detached
+  RerrMsg emsg;
+  if (! unit.VirtCheck(emsg)) {             // async write failed
+    fStats.Inc(kStatNAsyncErr);
+    RlogMsg lmsg(LogFile());
+    lmsg << "-E " << Name() << ": unit " << unum
+         << " async write failed: " << emsg;
+    AddErrorExit(clist, kRPER1_M_UNS);      // signal UNS (drive unsafe)
+    Server().Exec(clist);                   // doit
+    fIoTrace.End(kRPER1_M_UNS);
     return 0;
   }
 
@@ -504,6 +542,7 @@ int Rw11CntlRHRP::AttnHandler(RlinkServer::AttnArgs& args)
   if (ca > unit.NCylinder() || ta > unit.NHead() || sa > unit.NSector()) {
     AddErrorExit(clist, kRPER1_M_IAE);      // signal IAE (invalid address err)
     Server().Exec(clist);                   // doit
+    fIoTrace.End(kRPER1_M_IAE);
     return 0;
   }
   
@@ -513,26 +552,34 @@ int Rw11CntlRHRP::AttnHandler(RlinkServer::AttnArgs& args)
     if (unit.WProt()) {                     // write on write locked drive ?
       AddErrorExit(clist, kRPER1_M_WLE);    // signal WLE (write lock error)
     } else {
+      fRd_tdue = fTiming.Transfer(unum, unit, lba, unit.Nwrd2Nblk(nwrd),
+                                  tnow, tseek);
       fRdma.QueueDiskWrite(addr, nwrd, Rw11Cpu::kCPAH_M_22BIT, lba, &unit);
     }
 
   } else if (fu == kFUNC_WCD) {             // Write Check -------------------
     fStats.Inc(kStatNFuncWchk );
+    fRd_tdue = fTiming.Transfer(unum, unit, lba, unit.Nwrd2Nblk(nwrd),
+                                tnow, tseek);
     fRdma.QueueDiskWriteCheck(addr, nwrd, Rw11Cpu::kCPAH_M_22BIT, lba, &unit);
     
   } else if (fu == kFUNC_READ ) {           // Read --------------------------
     fStats.Inc(kStatNFuncRead);
+    fRd_tdue = fTiming.Transfer(unum, unit, lba, unit.Nwrd2Nblk(nwrd),
+                                tnow, tseek);
     fRdma.QueueDiskRead(addr, nwrd, Rw11Cpu::kCPAH_M_22BIT, lba, &unit);
 
   } else {
     // FIXME: handle other special functions (currently simply error out !!)
     AddErrorExit(clist, kRPER1_M_ILF);      // signal ILF (invalid function)
     Server().Exec(clist);                   // doit
+    fIoTrace.End(kRPER1_M_ILF);
     return 0;
   }
 
   if (clist.Size()) {                       // if handled directly
     Server().Exec(clist);                   // doit
+    fIoTrace.End(kRPER1_M_WLE);             // only write lock error here
   }
 
   return 0;
@@ -545,7 +592,9 @@ void Rw11CntlRHRP::RdmaPreExecCB(int stat, size_t nwdone, size_t nwnext,
                                  RlinkCommandList& clist)
 {
   // if last chunk and not doing WCD add a labo and normal exit csr update
-  if (stat == Rw11Rdma::kStatusBusyLast && fRd_fu != kFUNC_WCD) {
+  // but only when the completion is already due (see timing model)
+  if (stat == Rw11Rdma::kStatusBusyLast && fRd_fu != kFUNC_WCD &&
+      (!fTiming.Enabled() || fRd_tdue <= Rw11DiskTiming::Now())) {
     clist.AddLabo();
     AddNormalExit(clist, nwdone+nwnext, 0, 0);
   }
@@ -583,13 +632,19 @@ void Rw11CntlRHRP::RdmaPostExecCB(int stat, size_t ndone,
     if (ccode != RlinkCommand::kCmdLabo || (rper1 != 0 && cdata == 0))
       throw Rexception("Rw11CntlRHRP::RdmaPostExecCB",
                        "Bad state: Labo not found or missed abort");
-    if (cdata == 0) return;
+    if (cdata == 0) {                       // fused exit was done
+      fIoTrace.End(0);
+      return;
+    }
   }
 
-  // finally to RHRP register update
-  RlinkCommandList clist1;
-  AddNormalExit(clist1, ndone, rper1, rpcs2);
-  Server().Exec(clist1);
+  // finally to RHRP register update, delayed if timing model requests
+  fTiming.Schedule(fRd_tdue, [this, ndone, rper1, rpcs2](){
+      RlinkCommandList clist1;
+      AddNormalExit(clist1, ndone, rper1, rpcs2);
+      Server().Exec(clist1);
+      fIoTrace.End(rper1 ? rper1 : rpcs2);
+    });
   return;
 }
 
@@ -1,9 +1,14 @@
 // $Id: Rw11CntlRHRP.hpp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2015-2019 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2015-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1306   1.0.7  UNS on latched async write error
+// 2026-10-19  1305   1.0.6  add SetOverlap(),Overlap()
+// 2026-10-19  1304   1.0.5  add Timing(), seek and rotation timing model
+// 2026-10-19  1301   1.0.4  add IoTrace(), per request I/O trace
+// 2026-10-19  1282   1.0.3  add SetChunkAuto(),ChunkAuto()
 // 2019-06-07  1160   1.0.2  RdmaStats() not longer const
 // 2017-04-02   865   1.0.1  Dump(): add detail arg
 // 2015-05-14   680   1.0    Initial version
@@ -21,6 +26,7 @@
 #include "Rw11CntlBase.hpp"
 #include "Rw11UnitRHRP.hpp"
 #include "Rw11RdmaDisk.hpp"
+#include "Rw11DiskTiming.hpp"
 
 namespace Retro {
 
@@ -41,8 +47,14 @@ namespace Retro {
 
       void          SetChunkSize(size_t chunk);
       size_t        ChunkSize() const;
+      void          SetChunkAuto(bool autoena);
+      bool          ChunkAuto() const;
+      void          SetOverlap(bool overlap);
+      bool          Overlap() const;
 
       Rstats&       RdmaStats();
+      Rw11IoTrace&  IoTrace();
+      Rw11DiskTiming& Timing();
 
       virtual void  Dump(std::ostream& os, int ind=0, const char* text=0,
                          int detail=0) const;
@@ -164,6 +176,7 @@ namespace Retro {
         kStatNFuncPack,
         kStatNFuncPore,
         kStatNFuncSeek,
+        kStatNAsyncErr,
         kDimStat
       };    
 
@@ -203,7 +216,11 @@ namespace Retro {
       uint32_t      fRd_nwrd;               //!< Rdma: current nwrd
       uint16_t      fRd_fu;                 //!< Rdma: request fu code
       bool          fRd_ovr;                //!< Rdma: overrun condition found
+      double        fRd_tdue;               //!< Rdma: completion due time
+      double        fTAttnLast;             //!< time of last request attn
       Rw11RdmaDisk  fRdma;                  //!< Rdma controller
+      Rw11IoTrace   fIoTrace;               //!< per request I/O trace
+      Rw11DiskTiming fTiming;               //!< seek and rotation timing
   };
   
 } // end namespace Retro
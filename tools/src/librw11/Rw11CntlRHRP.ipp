@@ -1,9 +1,14 @@
 // $Id: Rw11CntlRHRP.ipp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2015-2019 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2015-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1306   1.0.6  SetOverlap(): document error semantics
+// 2026-10-19  1305   1.0.5  add SetOverlap(),Overlap()
+// 2026-10-19  1304   1.0.4  add Timing(), seek and rotation timing model
+// 2026-10-19  1301   1.0.3  add IoTrace(), per request I/O trace
+// 2026-10-19  1282   1.0.2  add SetChunkAuto(),ChunkAuto()
 // 2019-06-07  1160   1.0.1  RdmaStats() not longer const
 // 2015-05-14   680   1.0    Initial version
 // 2015-03-21   659   0.1    First draft
@@ -37,10 +42,74 @@ inline size_t Rw11CntlRHRP::ChunkSize() const
 //------------------------------------------+-----------------------------------
 //! FIXME_docs
 
+inline void Rw11CntlRHRP::SetChunkAuto(bool autoena)
+{
+  fRdma.SetChunkAuto(autoena);
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+inline bool Rw11CntlRHRP::ChunkAuto() const
+{
+  return fRdma.ChunkAuto();
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
 inline Rstats& Rw11CntlRHRP::RdmaStats()
 {
   return fRdma.Stats();
 }
 
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+inline Rw11IoTrace& Rw11CntlRHRP::IoTrace()
+{
+  return fIoTrace;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+inline Rw11DiskTiming& Rw11CntlRHRP::Timing()
+{
+  return fTiming;
+}
+
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Enable overlapped operation of the units.
+
+  When enabled, disk writes are handed to the writer thread of the unit,
+  see Rw11UnitDisk::VirtWriteAsync(), and the request completes when the
+  data is fetched from memory. The backend write then overlaps with later
+  requests, e.g. reads and transfers on other units. A unit waits for its
+  own pending writes before it is read, so reads always see the data
+  written before.
+
+  The error semantics change: a write whose backend write fails has
+  already completed without error for the guest. The failure is latched
+  by the unit, logged, and reported as UNS (drive unsafe) for the next
+  and all later requests of the unit until it is detached.
+ */
+
+inline void Rw11CntlRHRP::SetOverlap(bool overlap)
+{
+  fRdma.SetWriteAsync(overlap);
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+inline bool Rw11CntlRHRP::Overlap() const
+{
+  return fRdma.WriteAsync();
+}
+
 
 } // end namespace Retro
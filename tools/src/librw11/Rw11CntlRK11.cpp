@@ -1,11 +1,14 @@
 // $Id: Rw11CntlRK11.cpp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2013-2019 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2013-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // Other credits: 
 //   the boot code is from the simh project and Copyright Robert M Supnik
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1304   2.0.15 add Timing(), seek and rotation timing model
+// 2026-10-19  1301   2.0.14 add IoTrace(), per request I/O trace
+// 2026-10-19  1281   2.0.13 register fPrimClist for coalesced attn harvest
 // 2019-04-19  1133   2.0.12 use ExecWibr()
 // 2019-04-14  1131   2.0.11 proper unit init, call UnitSetupAll() in Start()
 // 2019-02-23  1114   2.0.10 use std::bind instead of lambda
@@ -149,14 +152,18 @@ Rw11CntlRK11::Rw11CntlRK11()
     fRd_nwrd(0),
     fRd_fu(0),
     fRd_ovr(false),
+    fRd_tdue(0.),
     fRdma(this,
           std::bind(&Rw11CntlRK11::RdmaPreExecCB,  this, _1, _2, _3, _4),
-          std::bind(&Rw11CntlRK11::RdmaPostExecCB, this, _1, _2, _3, _4))
+          std::bind(&Rw11CntlRK11::RdmaPostExecCB, this, _1, _2, _3, _4)),
+    fIoTrace(),
+    fTiming(this)
 {
   // must be here because Units have a back-ptr (not available at Rw11CntlBase)
   for (size_t i=0; i<NUnit(); i++) {
     fspUnit[i].reset(new Rw11UnitRK11(this, i));
   }
+  fRdma.SetIoTrace(&fIoTrace);
 
   fStats.Define(kStatNFuncCreset , "NFuncCreset"  , "func CRESET");
   fStats.Define(kStatNFuncWrite  , "NFuncWrite"   , "func WRITE");
@@ -216,7 +223,7 @@ void Rw11CntlRK11::Start()
 
   // add attn handler
   Server().AddAttnHandler(bind(&Rw11CntlRK11::AttnHandler, this, _1), 
-                          uint16_t(1)<<fLam, this);
+                          uint16_t(1)<<fLam, this, &fPrimClist);
 
   fStarted = true;
   return;
@@ -304,7 +311,10 @@ void Rw11CntlRK11::Dump(std::ostream& os, int ind, const char* text,
   os << bl << "  fRd_nwrd:        " << fRd_nwrd << endl;
   os << bl << "  fRd_fu:          " << fRd_fu   << endl;
   os << bl << "  fRd_ovr:         " << RosPrintf(fRd_ovr)  << endl;
+  os << bl << "  fRd_tdue:        " << fRd_tdue << endl;
   fRdma.Dump(os, ind+2, "fRdma: ", detail);
+  fIoTrace.Dump(os, ind+2, "fIoTrace: ", detail);
+  fTiming.Dump(os, ind+2, "fTiming: ", detail);
   Rw11CntlBase<Rw11UnitRK11,8>::Dump(os, ind, " ^", detail);
   return;
 }
@@ -385,6 +395,8 @@ int Rw11CntlRK11::AttnHandler(RlinkServer::AttnArgs& args)
     return 0;
   }
 
+  fIoTrace.Begin(dr, fu, lba, nwrd);
+
   // check for general abort conditions
   if (fu != kFUNC_CRESET &&                 // function not control reset
       (!unit.HasVirt())) {                  //   and drive not attached
@@ -405,6 +417,7 @@ int Rw11CntlRK11::AttnHandler(RlinkServer::AttnArgs& args)
     cpu.AddWibr(clist, fBase+kRKMR, kRKMR_M_FDONE);
     LogRker(rker);
     Server().Exec(clist);
+    fIoTrace.End(rker);
     return 0;
   }
 
@@ -421,6 +434,9 @@ int Rw11CntlRK11::AttnHandler(RlinkServer::AttnArgs& args)
   fRd_nwrd  = nwrd;
   fRd_ovr   = ovr;
   fRd_fu    = fu;
+  fRd_tdue  = 0.;
+
+  double tsdone = -1.;                      // seek done due time, if delayed
 
   // now handle the functions
   if (fu == kFUNC_CRESET) {                 // Control reset -----------------
@@ -437,6 +453,8 @@ int Rw11CntlRK11::AttnHandler(RlinkServer::AttnArgs& args)
     if (rker) {
       AddErrorExit(clist, rker);
     } else {
+      fRd_tdue = fTiming.Transfer(dr, unit, lba, unit.Nwrd2Nblk(nwrd),
+                                  Rw11DiskTiming::Now());
       fRdma.QueueDiskWrite(addr, nwrd, Rw11Cpu::kCPAH_M_UBM22, lba, &unit);
     }
 
@@ -448,6 +466,8 @@ int Rw11CntlRK11::AttnHandler(RlinkServer::AttnArgs& args)
     if (rker) {
       AddErrorExit(clist, rker);
     } else {
+      fRd_tdue = fTiming.Transfer(dr, unit, lba, unit.Nwrd2Nblk(nwrd),
+                                  Rw11DiskTiming::Now());
       fRdma.QueueDiskRead(addr, nwrd, Rw11Cpu::kCPAH_M_UBM22, lba, &unit);
     }
 
@@ -459,6 +479,8 @@ int Rw11CntlRK11::AttnHandler(RlinkServer::AttnArgs& args)
     if (rker) {
       AddErrorExit(clist, rker);
     } else {
+      fRd_tdue = fTiming.Transfer(dr, unit, lba, unit.Nwrd2Nblk(nwrd),
+                                  Rw11DiskTiming::Now());
       fRdma.QueueDiskWriteCheck(addr, nwrd, Rw11Cpu::kCPAH_M_UBM22, lba, &unit);
     }
 
@@ -477,7 +499,12 @@ int Rw11CntlRK11::AttnHandler(RlinkServer::AttnArgs& args)
       rkds |= se;
       unit.SetRkds(rkds);
       cpu.AddWibr(clist, fBase+kRKDS, rkds);
-      cpu.AddWibr(clist, fBase+kRKMR, 1u<<dr); // issue seek done
+      double tseek = fTiming.Seek(dr, unit, cy, Rw11DiskTiming::Now());
+      if (fTiming.Enabled()) {
+        tsdone = tseek;                     // seek done issued later
+      } else {
+        cpu.AddWibr(clist, fBase+kRKMR, 1u<<dr); // issue seek done
+      }
     }
 
   } else if (fu == kFUNC_RCHK) {            // Read Check --------------------
@@ -487,6 +514,10 @@ int Rw11CntlRK11::AttnHandler(RlinkServer::AttnArgs& args)
     if (rkcs & kRKCS_M_IBA) rker |= kRKER_M_DRE;  // IBA not supported
     if (rker) {
       AddErrorExit(clist, rker);
+    } else if (fTiming.Enabled()) {       // delay exit by transfer time
+      fRd_tdue = fTiming.Transfer(dr, unit, lba, unit.Nwrd2Nblk(nwrd),
+                                  Rw11DiskTiming::Now());
+      ScheduleNormalExit(nwrd, 0);
     } else {
       AddNormalExit(clist, nwrd, 0);        // no action, virt disks don't err
     }
@@ -494,7 +525,12 @@ int Rw11CntlRK11::AttnHandler(RlinkServer::AttnArgs& args)
   } else if (fu == kFUNC_DRESET) {          // Drive Reset -------------------
     fStats.Inc(kStatNFuncDreset);
     cpu.AddWibr(clist, fBase+kRKMR, kRKMR_M_FDONE);
-    cpu.AddWibr(clist, fBase+kRKMR, 1u<<dr);   // issue seek done
+    double tseek = fTiming.Seek(dr, unit, 0, Rw11DiskTiming::Now());
+    if (fTiming.Enabled()) {
+      tsdone = tseek;                       // seek done issued later
+    } else {
+      cpu.AddWibr(clist, fBase+kRKMR, 1u<<dr);   // issue seek done
+    }
     
   } else if (fu == kFUNC_WLOCK) {           // Write Lock --------------------
     fStats.Inc(kStatNFuncWlock);
@@ -507,6 +543,15 @@ int Rw11CntlRK11::AttnHandler(RlinkServer::AttnArgs& args)
 
   if (clist.Size()) {                       // if handled directly
     Server().Exec(clist);                   // doit
+    fIoTrace.End(rker);
+  }
+
+  if (tsdone >= 0.) {                       // issue delayed seek done
+    fTiming.Schedule(tsdone, [this, dr](){
+        RlinkCommandList clist1;
+        Cpu().AddWibr(clist1, fBase+kRKMR, 1u<<dr);
+        Server().Exec(clist1);
+      });
   }
   return 0;
 }
@@ -518,7 +563,9 @@ void Rw11CntlRK11::RdmaPreExecCB(int stat, size_t nwdone, size_t nwnext,
                                  RlinkCommandList& clist)
 {
   // if last chunk and not doing WCHK add a labo and normal exit csr update
-  if (stat == Rw11Rdma::kStatusBusyLast && fRd_fu != kFUNC_WCHK) {
+  // but only when the completion is already due (see timing model)
+  if (stat == Rw11Rdma::kStatusBusyLast && fRd_fu != kFUNC_WCHK &&
+      (!fTiming.Enabled() || fRd_tdue <= Rw11DiskTiming::Now())) {
     clist.AddLabo();
     AddNormalExit(clist, nwdone+nwnext, 0);
   }
@@ -556,14 +603,28 @@ void Rw11CntlRK11::RdmaPostExecCB(int stat, size_t ndone,
     if (ccode != RlinkCommand::kCmdLabo || (rker != 0 && cdata == 0))
       throw Rexception("Rw11CntlRK11::RdmaPostExecCB",
                        "Bad state: Labo not found or missed abort");
-    if (cdata == 0) return;
+    if (cdata == 0) {                       // fused exit was done
+      fIoTrace.End(fRd_ovr ? kRKER_M_OVR : 0);
+      return;
+    }
   }
 
-  // finally to RK11 register update
-  RlinkCommandList clist1;
-  AddNormalExit(clist1, ndone, rker);
-  Server().Exec(clist1);
+  // finally to RK11 register update, delayed if timing model requests
+  ScheduleNormalExit(ndone, rker);
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+//! Do normal exit csr update at completion due time \c fRd_tdue.
 
+void Rw11CntlRK11::ScheduleNormalExit(size_t ndone, uint16_t rker)
+{
+  fTiming.Schedule(fRd_tdue, [this, ndone, rker](){
+      RlinkCommandList clist;
+      AddNormalExit(clist, ndone, rker);
+      Server().Exec(clist);
+      fIoTrace.End(fRd_ovr ? (rker|kRKER_M_OVR) : rker);
+    });
   return;
 }
 
@@ -1,9 +1,12 @@
 // $Id: Rw11CntlRK11.hpp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2013-2019 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2013-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1304   2.0.5  add Timing(), seek and rotation timing model
+// 2026-10-19  1301   2.0.4  add IoTrace(), per request I/O trace
+// 2026-10-19  1282   2.0.3  add SetChunkAuto(),ChunkAuto()
 // 2019-06-07  1160   2.0.2  RdmaStats() not longer const
 // 2017-04-02   865   2.0.1  Dump(): add detail arg
 // 2015-01-03   627   2.0    use Rw11RdmaDisk
@@ -24,6 +27,7 @@
 #include "Rw11CntlBase.hpp"
 #include "Rw11UnitRK11.hpp"
 #include "Rw11RdmaDisk.hpp"
+#include "Rw11DiskTiming.hpp"
 
 namespace Retro {
 
@@ -44,8 +48,12 @@ namespace Retro {
 
       void          SetChunkSize(size_t chunk);
       size_t        ChunkSize() const;
+      void          SetChunkAuto(bool autoena);
+      bool          ChunkAuto() const;
 
       Rstats&       RdmaStats();
+      Rw11IoTrace&  IoTrace();
+      Rw11DiskTiming& Timing();
 
       virtual void  Dump(std::ostream& os, int ind=0, const char* text=0,
                          int detail=0) const;
@@ -152,6 +160,7 @@ namespace Retro {
       void          AddErrorExit(RlinkCommandList& clist, uint16_t rker);
       void          AddNormalExit(RlinkCommandList& clist, size_t ndone,
                                   uint16_t rker=0);
+      void          ScheduleNormalExit(size_t ndone, uint16_t rker);
 
     protected:
       size_t        fPC_rkwc;               //!< PrimClist: rkwc index
@@ -167,7 +176,10 @@ namespace Retro {
       uint32_t      fRd_nwrd;               //!< Rdma: current nwrd
       uint16_t      fRd_fu;                 //!< Rdma: request fu code
       bool          fRd_ovr;                //!< Rdma: overrun condition found
+      double        fRd_tdue;               //!< Rdma: completion due time
       Rw11RdmaDisk  fRdma;                  //!< Rdma controller
+      Rw11IoTrace   fIoTrace;               //!< per request I/O trace
+      Rw11DiskTiming fTiming;               //!< seek and rotation timing
   };
   
 } // end namespace Retro
@@ -1,12 +1,15 @@
 // $Id: Rw11CntlRL11.cpp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2014-2019 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2014-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // Other credits: 
 //   the boot code is from the simh project and Copyright Robert M Supnik
 //   CalcCrc() is adopted from the simh project and Copyright Robert M Supnik
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1304   1.0.15 add Timing(), seek and rotation timing model
+// 2026-10-19  1301   1.0.14 add IoTrace(), per request I/O trace
+// 2026-10-19  1281   1.0.13 register fPrimClist for coalesced attn harvest
 // 2019-04-14  1131   1.0.12 proper unit init, call UnitSetupAll() in Start()
 // 2019-02-23  1114   1.0.11 use std::bind instead of lambda
 // 2018-12-22  1091   1.0.10 AttnHandler(): sa->san (-Wshadow fix)
@@ -190,14 +193,18 @@ Rw11CntlRL11::Rw11CntlRL11()
     fRd_nwrd(0),
     fRd_fu(0),
     fRd_ovr(false),
+    fRd_tdue(0.),
     fRdma(this,
           std::bind(&Rw11CntlRL11::RdmaPreExecCB,  this, _1, _2, _3, _4),
-          std::bind(&Rw11CntlRL11::RdmaPostExecCB, this, _1, _2, _3, _4))
+          std::bind(&Rw11CntlRL11::RdmaPostExecCB, this, _1, _2, _3, _4)),
+    fIoTrace(),
+    fTiming(this)
 {
   // must be here because Units have a back-ptr (not available at Rw11CntlBase)
   for (size_t i=0; i<NUnit(); i++) {
     fspUnit[i].reset(new Rw11UnitRL11(this, i));
   }
+  fRdma.SetIoTrace(&fIoTrace);
 
   fStats.Define(kStatNFuncWchk   , "NFuncWchk"    , "func WCHK");
   fStats.Define(kStatNFuncRhdr   , "NFuncRhdr"    , "func RHDR");
@@ -256,7 +263,7 @@ void Rw11CntlRL11::Start()
 
   // add attn handler
   Server().AddAttnHandler(bind(&Rw11CntlRL11::AttnHandler, this, _1), 
-                          uint16_t(1)<<fLam, this);
+                          uint16_t(1)<<fLam, this, &fPrimClist);
 
   fStarted = true;
   return;
@@ -375,7 +382,10 @@ void Rw11CntlRL11::Dump(std::ostream& os, int ind, const char* text,
   os << bl << "  fRd_nwrd:        " << RosPrintf(fRd_nwrd,"d",6) << endl;
   os << bl << "  fRd_fu:          " << RosPrintf(fRd_fu,"d",6) << endl;
   os << bl << "  fRd_ovr:         " << RosPrintf(fRd_ovr)  << endl;
+  os << bl << "  fRd_tdue:        " << fRd_tdue << endl;
   fRdma.Dump(os, ind+2, "fRdma: ", detail);
+  fIoTrace.Dump(os, ind+2, "fIoTrace: ", detail);
+  fTiming.Dump(os, ind+2, "fTiming: ", detail);
   Rw11CntlBase<Rw11UnitRL11,4>::Dump(os, ind, " ^", detail);
   return;
 }
@@ -454,6 +464,8 @@ int Rw11CntlRL11::AttnHandler(RlinkServer::AttnArgs& args)
     return 0;
   }
 
+  fIoTrace.Begin(ds, fu, lba, nwrd);
+
   // remember request parameters for call back and error exit handling
   fRd_rlcs  = rlcs;
   fRd_rlda  = rlda;
@@ -465,6 +477,7 @@ int Rw11CntlRL11::AttnHandler(RlinkServer::AttnArgs& args)
   fRd_nwrd  = nwrd;
   fRd_ovr   = ovr;
   fRd_fu    = fu;
+  fRd_tdue  = 0.;
 
   // check for general abort conditions
   // note: only 'data transfer' functions handled via backend
@@ -475,6 +488,7 @@ int Rw11CntlRL11::AttnHandler(RlinkServer::AttnArgs& args)
     AddErrorExit(clist, kERR_OPI);          // just signal OPI
                                             // drive stat is LOAD anyway
     Server().Exec(clist);                   // doit
+    fIoTrace.End(kERR_OPI);
     return 0;
   }
 
@@ -514,6 +528,7 @@ int Rw11CntlRL11::AttnHandler(RlinkServer::AttnArgs& args)
            << "->" << RosPrintBvi(posn,8);
     }
     Server().Exec(clist);                   // doit
+    fIoTrace.End(0);
     return 0;
   }
 
@@ -529,33 +544,43 @@ int Rw11CntlRL11::AttnHandler(RlinkServer::AttnArgs& args)
   if (true && poserr) {
     AddErrorExit(clist, kERR_HNFND);
     Server().Exec(clist);                   // doit
+    fIoTrace.End(kERR_HNFND);
     return 0;
   }  
 
   // now handle the functions
-  
+  // note: the timing model charges the seek done by ibdr_rl11 here, as
+  //       a move from the cylinder of the last transfer of this drive
+
   if (fu == kFUNC_WRITE) {                  // Write -------------------------
     fStats.Inc(kStatNFuncWrite);
     if (unit.WProt()) {                     // write on write locked drive ?
       AddSetStatus(clist, ds, sta | kSTA_M_WGE);
       AddErrorExit(clist, kERR_M_DE); 
     } else {
+      fRd_tdue = fTiming.Transfer(ds, unit, lba, unit.Nwrd2Nblk(nwrd),
+                                  Rw11DiskTiming::Now());
       fRdma.QueueDiskWrite(addr, nwrd, Rw11Cpu::kCPAH_M_UBM22, lba, &unit);
     }
 
   } else if (fu == kFUNC_WCHK) {            // Write Check -------------------
     fStats.Inc(kStatNFuncWchk );
+    fRd_tdue = fTiming.Transfer(ds, unit, lba, unit.Nwrd2Nblk(nwrd),
+                                Rw11DiskTiming::Now());
     fRdma.QueueDiskWriteCheck(addr, nwrd, Rw11Cpu::kCPAH_M_UBM22, lba, &unit);
     
   } else if (fu == kFUNC_READ ||            // Read or 
              fu == kFUNC_RNHC) {            // Read No Header Check ----------
     fStats.Inc(fu==kFUNC_READ ? kStatNFuncRead : kStatNFuncRnhc);
 
+    fRd_tdue = fTiming.Transfer(ds, unit, lba, unit.Nwrd2Nblk(nwrd),
+                                Rw11DiskTiming::Now());
     fRdma.QueueDiskRead(addr, nwrd, Rw11Cpu::kCPAH_M_UBM22, lba, &unit);
   }
 
   if (clist.Size()) {                       // if handled directly
     Server().Exec(clist);                   // doit
+    fIoTrace.End(kERR_M_DE);                // only write lock error here
   }
   return 0;
 }
@@ -567,7 +592,9 @@ void Rw11CntlRL11::RdmaPreExecCB(int stat, size_t nwdone, size_t nwnext,
                                  RlinkCommandList& clist)
 {
   // if last chunk and not doing WCHK add a labo and normal exit csr update
-  if (stat == Rw11Rdma::kStatusBusyLast && fRd_fu != kFUNC_WCHK) {
+  // but only when the completion is already due (see timing model)
+  if (stat == Rw11Rdma::kStatusBusyLast && fRd_fu != kFUNC_WCHK &&
+      (!fTiming.Enabled() || fRd_tdue <= Rw11DiskTiming::Now())) {
     clist.AddLabo();
     AddNormalExit(clist, nwdone+nwnext, 0);
   }
@@ -603,13 +630,19 @@ void Rw11CntlRL11::RdmaPostExecCB(int stat, size_t ndone,
     if (ccode != RlinkCommand::kCmdLabo || (rlerr != 0 && cdata == 0))
       throw Rexception("Rw11CntlRL11::RdmaPostExecCB",
                        "Bad state: Labo not found or missed abort");
-    if (cdata == 0) return;
+    if (cdata == 0) {                       // fused exit was done
+      fIoTrace.End(0);
+      return;
+    }
   }
 
-  // finally to RL11 register update
-  RlinkCommandList clist1;
-  AddNormalExit(clist1, ndone, rlerr);
-  Server().Exec(clist1);
+  // finally to RL11 register update, delayed if timing model requests
+  fTiming.Schedule(fRd_tdue, [this, ndone, rlerr](){
+      RlinkCommandList clist1;
+      AddNormalExit(clist1, ndone, rlerr);
+      Server().Exec(clist1);
+      fIoTrace.End(rlerr);
+    });
   return;
 }
 
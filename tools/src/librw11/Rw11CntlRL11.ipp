@@ -1,9 +1,12 @@
 // $Id: Rw11CntlRL11.ipp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2015-2019 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2015-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1304   1.0.4  add Timing(), seek and rotation timing model
+// 2026-10-19  1301   1.0.3  add IoTrace(), per request I/O trace
+// 2026-10-19  1282   1.0.2  add SetChunkAuto(),ChunkAuto()
 // 2019-06-07  1160   1.0.1  RdmaStats() not longer const
 // 2015-01-10   632   1.0    Initial version
 // ---------------------------------------------------------------------------
@@ -36,10 +39,43 @@ inline size_t Rw11CntlRL11::ChunkSize() const
 //------------------------------------------+-----------------------------------
 //! FIXME_docs
 
+inline void Rw11CntlRL11::SetChunkAuto(bool autoena)
+{
+  fRdma.SetChunkAuto(autoena);
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+inline bool Rw11CntlRL11::ChunkAuto() const
+{
+  return fRdma.ChunkAuto();
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
 inline Rstats& Rw11CntlRL11::RdmaStats()
 {
   return fRdma.Stats();
 }
 
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+inline Rw11IoTrace& Rw11CntlRL11::IoTrace()
+{
+  return fIoTrace;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+inline Rw11DiskTiming& Rw11CntlRL11::Timing()
+{
+  return fTiming;
+}
+
 
 } // end namespace Retro
@@ -1,11 +1,13 @@
 // $Id: Rw11CntlTM11.cpp 1183 2019-07-10 18:48:41Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2015-2019 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2015-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // Other credits: 
 //   the boot code is from the simh project and Copyright Robert M Supnik
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1301   1.1.2  add IoTrace(), per request I/O trace
+// 2026-10-19  1281   1.1.1  register fPrimClist for coalesced attn harvest
 // 2019-07-10  1183   1.1    support odd record length
 // 2019-07-08  1182   1.0.11 BUGFIX: AddNormalExit(): get tmds logic right
 // 2019-04-19  1133   1.0.10 use ExecWibr()
@@ -138,7 +140,8 @@ Rw11CntlTM11::Rw11CntlTM11()
     fBuf(),
     fRdma(this,
           std::bind(&Rw11CntlTM11::RdmaPreExecCB,  this, _1, _2, _3, _4),
-          std::bind(&Rw11CntlTM11::RdmaPostExecCB, this, _1, _2, _3, _4))
+          std::bind(&Rw11CntlTM11::RdmaPostExecCB, this, _1, _2, _3, _4)),
+    fIoTrace()
 {
   // must be here because Units have a back-ptr (not available at Rw11CntlBase)
   for (size_t i=0; i<NUnit(); i++) {
@@ -201,7 +204,7 @@ void Rw11CntlTM11::Start()
 
   // add attn handler
   Server().AddAttnHandler(bind(&Rw11CntlTM11::AttnHandler, this, _1), 
-                          uint16_t(1)<<fLam, this);
+                          uint16_t(1)<<fLam, this, &fPrimClist);
 
   fStarted = true;
   return;
@@ -291,6 +294,7 @@ void Rw11CntlTM11::Dump(std::ostream& os, int ind, const char* text,
   os << bl << "  fRd_opcode:      " << fRd_opcode  << endl;
   os << bl << "  fBuf.size:       " << RosPrintf(fBuf.size(),"d",6) << endl;
   fRdma.Dump(os, ind+2, "fRdma: ", detail);
+  fIoTrace.Dump(os, ind+2, "fIoTrace: ", detail);
   Rw11CntlBase<Rw11UnitTM11,4>::Dump(os, ind, " ^", detail);
   return;
 }
@@ -346,10 +350,15 @@ int Rw11CntlTM11::AttnHandler(RlinkServer::AttnArgs& args)
     return 0;
   }
 
+  // trace with tape record position as lba
+  int posrec = (unum < NUnit()) ? fspUnit[unum]->PosRecord() : -1;
+  fIoTrace.Begin(unum, fu, (posrec >= 0) ? uint32_t(posrec) : 0, (nbyt+1)/2);
+
   // check for general abort conditions: invalid unit number
   if (unum >= NUnit()) {
     AddErrorExit(clist, kTMCR_M_RICMD);
     Server().Exec(clist);
+    fIoTrace.End();
     return 0;
   }
 
@@ -365,6 +374,7 @@ int Rw11CntlTM11::AttnHandler(RlinkServer::AttnArgs& args)
   if ((!unit.HasVirt()) || (wcmd && unit.Virt().WProt()) ) {
     AddErrorExit(clist, kTMCR_M_RICMD);
     Server().Exec(clist);
+    fIoTrace.End();
     return 0;
   }
 
@@ -394,6 +404,7 @@ int Rw11CntlTM11::AttnHandler(RlinkServer::AttnArgs& args)
     if (fBuf.size() < nwalloc) fBuf.resize(nwalloc);
     bool rc = unit.VirtReadRecord(nbyt, reinterpret_cast<uint8_t*>(fBuf.data()),
                                   fRd_rddone, fRd_opcode, emsg);
+    fIoTrace.Back();
     if (!rc) WriteLog("read", emsg);
     if ((!rc) || fRd_rddone == 0) {
       AddFastExit(clist, fRd_opcode, 0);
@@ -434,6 +445,7 @@ int Rw11CntlTM11::AttnHandler(RlinkServer::AttnArgs& args)
 
   if (clist.Size()) {                       // if handled directly
     Server().Exec(clist);                   // doit
+    fIoTrace.End();
   }
 
   return 0;
@@ -465,6 +477,7 @@ void Rw11CntlTM11::RdmaPostExecCB(int stat, size_t ndone,
   RlinkCommandList clist1;
   AddNormalExit(clist1, ndone, tmcr);
   Server().Exec(clist1);
+  fIoTrace.End();
   return;
 }
 
@@ -475,6 +488,7 @@ void Rw11CntlTM11::AddErrorExit(RlinkCommandList& clist, uint16_t tmcr)
 {
   Rw11Cpu& cpu = Cpu();
 
+  fIoTrace.AddResult(tmcr);
   tmcr |= (kRFUNC_DONE<<kTMCR_V_FUNC);
   cpu.AddWibr(clist, fBase+kTMCR, tmcr);
   if (fTraceLevel>1) {
@@ -529,6 +543,8 @@ void Rw11CntlTM11::AddFastExit(RlinkCommandList& clist, int opcode, size_t ndone
                                   (kRFUNC_WUNIT<<kTMCR_V_FUNC) );
   cpu.AddWibr(clist, fBase+kTMRL, tmds);
   if (ndone) cpu.AddWibr(clist, fBase+kTMBC, tmbc);
+  fIoTrace.Back();                          // tape op done before fast exit
+  fIoTrace.AddResult(tmcr);
   tmcr |= (kRFUNC_DONE<<kTMCR_V_FUNC);
   cpu.AddWibr(clist, fBase+kTMCR, tmcr);
 
@@ -593,6 +609,7 @@ void Rw11CntlTM11::AddNormalExit(RlinkCommandList& clist, size_t ndone,
     if (!unit.VirtWriteRecord(nbyt, reinterpret_cast<uint8_t*>(fBuf.data()), 
                               opcode, emsg)) 
       WriteLog("write", emsg);
+    fIoTrace.Back();
   }
 
   // now Virt status up-to-date, even for writes
@@ -601,6 +618,7 @@ void Rw11CntlTM11::AddNormalExit(RlinkCommandList& clist, size_t ndone,
   if (unit.Virt().Bot())   tmds |= kTMRL_M_BOT;
   if (unit.Virt().Eot())   tmds |= kTMRL_M_EOT;
 
+  fIoTrace.AddResult(tmcr);
   uint16_t tmba = uint16_t(addr & 0xfffe);
   uint16_t ea   = uint16_t((addr>>16)&0x0003);
   tmcr |= kTMCR_M_REAENA | (ea<<kTMCR_V_REA);
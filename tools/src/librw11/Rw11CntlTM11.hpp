@@ -1,9 +1,11 @@
 // $Id: Rw11CntlTM11.hpp 1183 2019-07-10 18:48:41Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2015-2019 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2015-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1301   1.1.2  add IoTrace(), per request I/O trace
+// 2026-10-19  1282   1.1.1  add SetChunkAuto(),ChunkAuto()
 // 2019-07-10  1183   1.1    support odd record length
 // 2019-06-07  1160   1.0.2  RdmaStats() not longer const
 // 2017-04-02   865   1.0.1  Dump(): add detail arg
@@ -22,6 +24,7 @@
 #include "Rw11CntlBase.hpp"
 #include "Rw11UnitTM11.hpp"
 #include "Rw11Rdma.hpp"
+#include "Rw11IoTrace.hpp"
 
 namespace Retro {
 
@@ -42,8 +45,11 @@ namespace Retro {
 
       void          SetChunkSize(size_t chunk);
       size_t        ChunkSize() const;
+      void          SetChunkAuto(bool autoena);
+      bool          ChunkAuto() const;
 
       Rstats&       RdmaStats();
+      Rw11IoTrace&  IoTrace();
 
       virtual void  Dump(std::ostream& os, int ind=0, const char* text=0,
                          int detail=0) const;
@@ -166,6 +172,7 @@ namespace Retro {
       int           fRd_opcode;             //!< Rdma: read opcode
       std::vector<uint16_t>  fBuf;          //!< data buffer
       Rw11Rdma      fRdma;                  //!< Rdma controller
+      Rw11IoTrace   fIoTrace;               //!< per request I/O trace
   };
   
 } // end namespace Retro
@@ -1,9 +1,11 @@
 // $Id: Rw11CntlTM11.ipp 1183 2019-07-10 18:48:41Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2015-2019 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2015-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1301   1.0.3  add IoTrace(), per request I/O trace
+// 2026-10-19  1282   1.0.2  add SetChunkAuto(),ChunkAuto()
 // 2019-06-07  1160   1.0.1  RdmaStats() not longer const
 // 2015-05-17   683   1.0    Initial version
 // ---------------------------------------------------------------------------
@@ -36,10 +38,35 @@ inline size_t Rw11CntlTM11::ChunkSize() const
 //------------------------------------------+-----------------------------------
 //! FIXME_docs
 
+inline void Rw11CntlTM11::SetChunkAuto(bool autoena)
+{
+  fRdma.SetChunkAuto(autoena);
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+inline bool Rw11CntlTM11::ChunkAuto() const
+{
+  return fRdma.ChunkAuto();
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
 inline Rstats& Rw11CntlTM11::RdmaStats()
 {
   return fRdma.Stats();
 }
 
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+inline Rw11IoTrace& Rw11CntlTM11::IoTrace()
+{
+  return fIoTrace;
+}
+
 
 } // end namespace Retro
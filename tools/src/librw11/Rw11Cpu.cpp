@@ -1,9 +1,16 @@
 // $Id: Rw11Cpu.cpp 1274 2022-08-08 09:21:53Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2013-2022 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2013-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1300   1.4.3  add IbmonCapture(), fupImcap (ibmon background capture)
+// 2026-10-19  1299   1.4.2  add Pcnt(), fupPcnt (dmpcnt sampler)
+// 2026-10-19  1298   1.4.1  add Prof(), fupProf (pc sampling profiler)
+// 2026-10-19  1297   1.4    add Cmon(), fupCmon (dmcmon readout engine)
+// 2026-10-19  1285   1.3.1  add MemReadBulk()
+// 2026-10-19  1284   1.3    add SnapSave(),SnapRestore()
+// 2026-10-19  1283   1.2.22 LoadAbs(): read file at once, coalesce, batch Exec
 // 2022-08-08  1274   1.2.21 ssr->mmr rename
 // 2019-06-29  1175   1.2.20 MemWriteByte(): use membe 
 // 2019-04-30  1143   1.2.19 add m9312 setup and HasM9312()
@@ -50,11 +57,13 @@
 #include <fcntl.h>
 #include <errno.h>
 #include <unistd.h>
+#include <sys/stat.h>
 
 #include <vector>
 #include <map>
 #include <algorithm>
 #include <chrono>
+#include <sstream>
 
 #include "librtools/Rexception.hpp"
 #include "librtools/RlogMsg.hpp"
@@ -62,6 +71,7 @@
 #include "librtools/RosPrintf.hpp"
 #include "librtools/RosPrintBvi.hpp"
 #include "Rw11Cntl.hpp"
+#include "Rw11Unit.hpp"
 
 #include "Rw11Cpu.hpp"
 
@@ -211,6 +221,9 @@ const uint16_t  Rw11Cpu::kIISTBASE;
 const uint16_t  Rw11Cpu::kIISTACR;
 const uint16_t  Rw11Cpu::kIISTADR;
 
+const std::string Rw11Cpu::kSnapMagic("w11snap1");
+const size_t    Rw11Cpu::kSnapNCpReg;
+
 //------------------------------------------+-----------------------------------
 //! Constructor
 
@@ -238,6 +251,10 @@ Rw11Cpu::Rw11Cpu(const std::string& type)
     fCntlMap(),
     fIAddrMap(),
     fRAddrMap(),
+    fupCmon(),
+    fupProf(),
+    fupPcnt(),
+    fupImcap(),
     fStats()
 {}
 
@@ -529,6 +546,43 @@ bool Rw11Cpu::MemRead(uint16_t addr, std::vector<uint16_t>& data,
   return true;
 }
 
+//------------------------------------------+-----------------------------------
+//! Read a large memory region with 22 bit addressing.
+/*!
+  Unlike MemRead() the region can be anywhere in the 22 bit address space
+  and is read with maximal size rblk transfers, each Exec() carries just
+  an address setup and one rblk which fills the rbuf. This minimizes the
+  number of round trips, which dominate the transfer time.
+
+  \param addr   start address, must be even
+  \param data   vector for read data, resized to nword
+  \param nword  number of words to read
+  \param emsg   contains error description in case of failure
+  \returns \c true on success
+ */
+
+bool Rw11Cpu::MemReadBulk(uint32_t addr, std::vector<uint16_t>& data, 
+                          size_t nword, RerrMsg& emsg)
+{
+  if ((addr & 0x1) || addr + 2*nword > MemSize()) {
+    emsg.Init("Rw11Cpu::MemReadBulk", "addr odd or range beyond MemSize()");
+    return false;
+  }
+
+  size_t blkmax = Connect().BlockSizeMax();
+  data.resize(nword);
+  size_t ndone = 0;
+  RlinkCommandList clist;
+  while (nword>ndone) {
+    size_t nblk = min(blkmax, nword-ndone);
+    clist.Clear();
+    AddRMem(clist, addr+2*ndone, data.data()+ndone, nblk, kCPAH_M_22BIT, true);
+    if (!Server().Exec(clist, emsg)) return false;
+    ndone += nblk;
+  }
+  return true;
+}
+
 //------------------------------------------+-----------------------------------
 //! FIXME_docs
 
@@ -620,174 +674,221 @@ bool Rw11Cpu::ProbeCntl(Rw11Probe& dsc)
 }
 
 //------------------------------------------+-----------------------------------
-//! FIXME_docs
+//! Load an absolute binary (lda) file into memory.
+/*!
+  The file is read in one go and all records are parsed in memory. Records
+  which are adjacent or overlapping are coalesced into contiguous address
+  ranges. Memory is only written when the whole file was parsed without
+  error, the ranges are written with block transfers, packed into as few
+  Exec() calls as the rbuf allows.
 
-// absolute binary format described in notes_ptape.txt
+  \param fname   file name
+  \param emsg    contains error description in case of failure
+  \param start   start address, or 0177777 if none defined
+  \param trace   if \c true, log all blocks and the ranges written
+  \returns \c true on success
+
+  The absolute binary format is described in notes_ptape.txt.
+ */
 
 bool Rw11Cpu::LoadAbs(const std::string& fname, RerrMsg& emsg,
                       uint16_t& start, bool trace)
 {
   start = -1;
-  int fd = open(fname.c_str(), O_RDONLY);
 
-  if (fd < 0) {
-    emsg.InitErrno("Rw11Cpu::LoadAbs()", string("open() for '") + fname + 
-                   "' failed: ", errno);
-    return false;
+  // read the whole file
+  RfileFd fd("Rw11Cpu::LoadAbs.fd.");
+  if (!fd.Open(fname.c_str(), O_RDONLY, emsg)) return false;
+  struct stat sbuf;
+  if (!fd.Stat(&sbuf, emsg)) return false;
+
+  vector<uint8_t> fbuf(sbuf.st_size);
+  size_t nbyte = 0;
+  while (nbyte < fbuf.size()) {
+    ssize_t irc = fd.Read(fbuf.data()+nbyte, fbuf.size()-nbyte, emsg);
+    if (irc < 0) return false;
+    if (irc == 0) break;
+    nbyte += irc;
   }
-  
-  enum states {
-    s_chr0,                                 // skip 000; search 001 start code
-    s_chr1,                                 // read 000 record starte code
-    s_cntlow,                               // read count lsb
-    s_cnthgh,                               // read count msb
-    s_adrlow,                               // read address lsb
-    s_adrhgh,                               // read address msb
-    s_data,                                 // read data
-    s_chksum                                // read checksum
+  fd.Close();
+
+  // parse all records; coalesce adjacent or overlapping ones
+  struct range {
+    uint32_t              fAddr;            // byte address of first byte
+    std::vector<uint8_t>  fData;            // data bytes
   };
-  
-  vector<uint16_t> data;
-  data.reserve(256);
-  
-  int chrnum = -1;                          // char number in block
-  int blknum = 0;                           // block number
-  int bytcnt = 0;                           // byte count
-  uint16_t ldaddr = 0;                      // load address
-  uint8_t chksum = 0;                       // check sum
-  uint16_t addr = 0;                        // current address
-  uint16_t word = 0;                        // current word
-
-  bool firstodd = false;                    // first byte to odd address
-  
-  bool ok = false;
-  bool go = true;
-  enum states state = s_chr0;
-
-  while (go) {
-    uint8_t byte;
-    int irc = ::read(fd, &byte, 1);
-    if (irc == 0) {
-      if (state == s_chr0) {
-        ok = true;
-      } else {
-        emsg.Init("Rw11Cpu::LoadAbs()", "unexpected EOF");
-      }
+  vector<range> rlist;
+
+  size_t pos    = 0;                        // position of block in fbuf
+  int    blknum = 0;                        // block number
+  bool   ok     = false;
+
+  while (true) {
+    while (pos < nbyte && fbuf[pos] == 0) pos += 1; // skip 000
+    if (pos == nbyte) {                             // EOF between blocks ok
+      ok = true;
       break;
-    } else if (irc < 0) {
-      emsg.InitErrno("Rw11Cpu::LoadAbs()", "read() failed: ", errno);
+    }
+    if (fbuf[pos] != 1) {                           // search 001 start code
+      emsg.InitPrintf("Rw11Cpu::LoadAbs()", 
+                      "unexpected start-of-block %3.3o", fbuf[pos]);
       break;
     }
-
-    chrnum += 1;
-    chksum += byte;
-
-    //cout << "+++1 " << blknum << "," << chrnum << " s=" << state << " : " 
-    //     << RosPrintBvi(byte,8) << endl;
-
-    switch (state) {
-    case s_chr0:                            // skip 000; search 001 start code
-      if (byte == 0) {
-        chrnum = -1;
-        state = s_chr0;
-      } else if (byte == 1) {
-        state = s_chr1;
-      } else {
-        emsg.InitPrintf("Rw11Cpu::LoadAbs()", 
-                        "unexpected start-of-block %3.3o", byte);
-        go = false;
-      }
+    if (pos+1 < nbyte && fbuf[pos+1] != 0) {        // check 000 2nd char
+      emsg.InitPrintf("Rw11Cpu::LoadAbs()", 
+                      "unexpected 2nd char %3.3o", fbuf[pos+1]);
       break;
-
-    case s_chr1:                            // read 000 record starte code ---
-      if (byte == 0) {
-        state = s_cntlow;
-      } else {
-        emsg.InitPrintf("Rw11Cpu::LoadAbs()", 
-                        "unexpected 2nd char %3.3o", byte);
-        go = false;
-      }
+    }
+    if (pos+6 > nbyte) {
+      emsg.Init("Rw11Cpu::LoadAbs()", "unexpected EOF");
       break;
-      
-    case s_cntlow:                          // read count lsb ----------------
-      bytcnt = byte;
-      state  = s_cnthgh;
+    }
+
+    size_t   bytcnt = size_t(fbuf[pos+2]) | size_t(fbuf[pos+3])<<8;
+    uint16_t ldaddr = uint16_t(fbuf[pos+4]) | uint16_t(fbuf[pos+5])<<8;
+    if (bytcnt < 6) {
+      emsg.InitPrintf("Rw11Cpu::LoadAbs()", "invalid byte count %d", 
+                      int(bytcnt));
       break;
-      
-    case s_cnthgh:                          // read count msb ----------------
-      bytcnt |= uint16_t(byte) << 8;
-      state  = s_adrlow;
+    }
+
+    if (trace) {
+      RlogMsg lmsg(Connect().LogFile());
+      lmsg << "LoadAbs-I: block " << RosPrintf(blknum,"d",3)
+           << ", length " << RosPrintf(bytcnt-6,"d",5)
+           << " byte, address " << RosPrintBvi(ldaddr,8);
+      if (bytcnt > 6)
+        lmsg << ":" << RosPrintBvi(uint16_t(ldaddr+(bytcnt-6)-1),8);
+    }
+
+    if (pos+bytcnt+1 > nbyte) {                     // need data + checksum
+      emsg.Init("Rw11Cpu::LoadAbs()", "unexpected EOF");
       break;
-      
-    case s_adrlow:                          // read address lsb --------------
-      ldaddr = byte;
-      state = s_adrhgh;
+    }
+    uint8_t chksum = 0;
+    for (size_t i=pos; i<=pos+bytcnt; i++) chksum += fbuf[i];
+    if (chksum != 0) {
+      emsg.InitPrintf("Rw11Cpu::LoadAbs()", "check sum error %3.3o", chksum);
       break;
-      
-    case s_adrhgh:                          // read address msb --------------
-      ldaddr |= uint16_t(byte) << 8;
-      addr = ldaddr;
-      word = 0;
-      firstodd = (addr & 0x01) == 1;
-      
+    }
+
+    if (bytcnt == 6) {                              // start address block
+      start = ldaddr;
       if (trace) {
         RlogMsg lmsg(Connect().LogFile());
-        lmsg << "LoadAbs-I: block " << RosPrintf(blknum,"d",3)
-             << ", length " << RosPrintf(bytcnt-6,"d",5)
-             << " byte, address " << RosPrintBvi(ldaddr,8);
-        if (bytcnt > 6)
-          lmsg << ":" << RosPrintBvi(uint16_t(ldaddr+(bytcnt-6)-1),8);
+        lmsg << "LoadAbs-I: start address " << RosPrintBvi(ldaddr,8);
       }
-      state = (bytcnt == 6) ? s_chksum : s_data;
+      ok = true;
       break;
-    
-    case s_data:                            // read data ---------------------
-      if ((addr & 0x01) == 0) {             // even (low) byte
-        word = byte;
-      } else {                              // odd (high) byte
-        if (firstodd) {                       // first odd byte
-          if (!MemWriteByte(addr, byte, emsg)) go = false; // write byte and
-          ldaddr += 1;                                     // update blk addr
-          firstodd = false;
-        } else {
-          word |= uint16_t(byte) << 8;
-          data.push_back(word);
-        }
-      }
-      addr += 1;
-      if (chrnum == bytcnt-1) state = s_chksum;
+    }
+
+    const uint8_t* pdata = fbuf.data()+pos+6;
+    size_t   ndata = bytcnt-6;
+    if (ldaddr + ndata > 0x10000) {
+      emsg.InitPrintf("Rw11Cpu::LoadAbs()", 
+                      "block %d extends beyond 177777", blknum);
       break;
-      
-    case s_chksum:                          // read checksum -----------------
-      if (chksum != 0) {
-        emsg.InitPrintf("Rw11Cpu::LoadAbs()", "check sum error %3.3o", chksum);
-        go = false;
-      } else if (bytcnt == 6) {
-        start = ldaddr;
-        if (trace) {
-          RlogMsg lmsg(Connect().LogFile());
-          lmsg << "LoadAbs-I: start address " << RosPrintBvi(ldaddr,8);
-        }
-        go = false;
-        ok = true;
-      } else {
-        if (!MemWrite(ldaddr, data, emsg)) go = false;
-        if ((addr & 0x01) == 1) {           // last byte even -> write it
-          if (!MemWriteByte(addr-1, uint8_t(word), emsg)) go = false;
-        }
-        data.clear();
+    }
+
+    range* pr = rlist.empty() ? nullptr : &rlist.back();
+    if (pr && ldaddr >= pr->fAddr && ldaddr <= pr->fAddr+pr->fData.size()) {
+      size_t off = ldaddr - pr->fAddr;
+      if (off+ndata > pr->fData.size()) pr->fData.resize(off+ndata);
+      copy(pdata, pdata+ndata, pr->fData.begin()+off);
+    } else {
+      rlist.push_back({ldaddr, vector<uint8_t>(pdata, pdata+ndata)});
+    }
+
+    pos    += bytcnt+1;
+    blknum += 1;
+  }
+
+  if (!ok) return false;
+
+  // convert ranges into word buffers, they must stay until Exec() is done
+  vector<vector<uint16_t>> wlist(rlist.size());
+  for (size_t i=0; i<rlist.size(); i++) {
+    const range& r = rlist[i];
+    size_t ioff  = r.fAddr & 0x1;           // odd leading byte ?
+    size_t nword = (r.fData.size()-ioff)/2;
+    wlist[i].resize(nword);
+    for (size_t j=0; j<nword; j++) {
+      wlist[i][j] = uint16_t(r.fData[ioff+2*j]) | 
+                    uint16_t(r.fData[ioff+2*j+1])<<8;
+    }
+  }
+
+  // and write them; split in Exec() calls when the rbuf size (each command
+  // has a response) or the word limit (keep Exec() time short on slow
+  // links) is reached
+  size_t   blkmax  = Connect().BlockSizeMax();
+  size_t   ncmdmax = (Connect().RbufSize() - 
+                      RlinkConnect::kRbufPrudentDelta) / (1+2+1+2);
+  size_t   nwrdmax = 4*blkmax;
+  size_t   nwrd    = 0;
+  size_t   nexec   = 0;
+  RlinkCommandList clist;
+
+  auto flush = [&]() {
+    if (clist.Size() == 0) return true;
+    nexec += 1;
+    if (!Server().Exec(clist, emsg)) return false;
+    clist.Clear();
+    nwrd = 0;
+    return true;
+  };
+  auto addbyte = [&](uint32_t addr, uint8_t data) {
+    if (clist.Size()+3 > ncmdmax && !flush()) return false;
+    uint16_t be = (addr & 0x01) ? kCPMEMBE_M_BE1 : kCPMEMBE_M_BE0;
+    AddLalh(clist, addr&0x3ffffe, kCPAH_M_22BIT);
+    AddMembe(clist, be);
+    clist.AddWreg(fBase+kCPMEM, (uint16_t(data)<<8) | data);
+    return true;
+  };
+
+  for (size_t i=0; i<rlist.size(); i++) {
+    const range& r = rlist[i];
+    uint32_t addr = r.fAddr;
+    if (trace) {
+      RlogMsg lmsg(Connect().LogFile());
+      lmsg << "LoadAbs-I: write " << RosPrintf(r.fData.size(),"d",5)
+           << " byte, address " << RosPrintBvi(uint16_t(addr),8)
+           << ":" << RosPrintBvi(uint16_t(addr+r.fData.size()-1),8);
+    }
+    if (addr & 0x01) {                      // odd leading byte
+      if (!addbyte(addr, r.fData[0])) return false;
+      addr += 1;
+    }
+
+    const uint16_t* pwrd = wlist[i].data();
+    size_t nrest = wlist[i].size();
+    while (nrest > 0) {
+      size_t ncmd = clist.Size();
+      if (ncmd+3 > ncmdmax || nwrd >= nwrdmax) {
+        if (!flush()) return false;
       }
-      chrnum = -1;
-      blknum += 1;
-      state = s_chr0;
-      break;
+      size_t nblk = min(nrest, nwrdmax-nwrd);
+      nblk = min(nblk, blkmax*((ncmdmax-clist.Size()-2)));
+      AddWMem(clist, addr, pwrd, nblk, 0);  // mode 0: 16 bit addressing
+      addr  += 2*nblk;
+      pwrd  += nblk;
+      nwrd  += nblk;
+      nrest -= nblk;
+    }
 
-    } // switch(state)
-  } // while(go)
-  
-  ::close(fd);
-  
-  return ok;
+    if ((r.fAddr+r.fData.size()) & 0x01) {  // odd trailing byte
+      if (!addbyte(addr, r.fData.back())) return false;
+    }
+  }
+  if (!flush()) return false;
+
+  if (trace) {
+    RlogMsg lmsg(Connect().LogFile());
+    lmsg << "LoadAbs-I: " << blknum << " blocks in " << rlist.size()
+         << " ranges written with " << nexec << " Exec() calls";
+  }
+
+  return true;
 }
 
 //------------------------------------------+-----------------------------------
@@ -848,6 +949,334 @@ bool Rw11Cpu::Boot(const std::string& uname, RerrMsg& emsg)
   return true;
 }
 
+//------------------------------------------+-----------------------------------
+//! Save a snapshot of the cpu and memory state into a file.
+/*!
+  When the cpu is running it is suspended while the snapshot is taken and
+  resumed afterwards. The snapshot contains
+  - the PSW and PC, and R0-R5 of both register sets and the stack pointers
+    of kernel, supervisor and user mode
+  - STKLIM, PIRQ and the MMU registers MMR0, MMR3 and all PDR/PAR
+  - the full memory, read with maximal rblk transfers and written with a
+    simple zero run length encoding
+  - the list of attached units with their urls
+
+  Device state is not part of the snapshot, the snapshot should therefore
+  be taken when the devices are idle.
+
+  \param fname   file name
+  \param emsg    contains error description in case of failure
+  \returns \c true on success
+ */
+
+bool Rw11Cpu::SnapSave(const std::string& fname, RerrMsg& emsg)
+{
+  RfileFd fd("Rw11Cpu::SnapSave.fd.");
+  if (!fd.Open(fname.c_str(), O_WRONLY|O_CREAT|O_TRUNC, 0644, emsg)) 
+    return false;
+
+  // suspend cpu if running
+  RlinkCommandList clist;
+  int istat = clist.AddRreg(fBase+kCPSTAT);
+  if (!Server().Exec(clist, emsg)) return false;
+  uint16_t cpstat = clist[istat].Data();
+  bool dosusp = (cpstat & kCPSTAT_M_CpuGo) && !(cpstat & kCPSTAT_M_CpuSusp);
+  if (dosusp) {
+    clist.Clear();
+    clist.AddWreg(fBase+kCPCNTL, kCPFUNC_SUSPEND);
+    if (!Server().Exec(clist, emsg)) return false;
+  }
+
+  bool ok = SnapSaveState(fd, emsg);
+
+  if (dosusp) {
+    RerrMsg emsgres;
+    clist.Clear();
+    clist.AddWreg(fBase+kCPCNTL, kCPFUNC_RESUME);
+    if (!Server().Exec(clist, emsgres) && ok) {
+      emsg = emsgres;
+      ok = false;
+    }
+  }
+
+  fd.Close();
+  return ok;
+}
+
+//------------------------------------------+-----------------------------------
+//! Restore the cpu and memory state from a snapshot file.
+/*!
+  The cpu must be halted, it is left halted with the PC of the snapshot,
+  so a <tt>cp -start</tt> continues execution. The snapshot file is read
+  and checked completely before anything is written.
+
+  \param fname   file name
+  \param emsg    contains error description in case of failure
+  \param force   if \c false, the restore is refused when the set of attached
+                 units differs from the one in the snapshot
+  \returns \c true on success
+ */
+
+bool Rw11Cpu::SnapRestore(const std::string& fname, RerrMsg& emsg, bool force)
+{
+  // read the whole file
+  RfileFd fd("Rw11Cpu::SnapRestore.fd.");
+  if (!fd.Open(fname.c_str(), O_RDONLY, emsg)) return false;
+  struct stat sbuf;
+  if (!fd.Stat(&sbuf, emsg)) return false;
+
+  vector<uint8_t> fbuf(sbuf.st_size);
+  size_t nbyte = 0;
+  while (nbyte < fbuf.size()) {
+    ssize_t irc = fd.Read(fbuf.data()+nbyte, fbuf.size()-nbyte, emsg);
+    if (irc < 0) return false;
+    if (irc == 0) break;
+    nbyte += irc;
+  }
+  fd.Close();
+
+  // decode header and meta data
+  size_t pos = 0;
+  auto getword = [&fbuf, &pos, nbyte](uint16_t& word) {
+    if (pos+2 > nbyte) return false;
+    word = uint16_t(fbuf[pos]) | uint16_t(fbuf[pos+1])<<8;
+    pos += 2;
+    return true;
+  };
+
+  if (nbyte < kSnapMagic.length() ||
+      kSnapMagic.compare(0, string::npos, 
+                         reinterpret_cast<const char*>(fbuf.data()),
+                         kSnapMagic.length()) != 0) {
+    emsg.Init("Rw11Cpu::SnapRestore", string("'") + fname + 
+              "' is not a w11 snapshot file");
+    return false;
+  }
+  pos = kSnapMagic.length();
+
+  uint16_t msizel = 0;
+  uint16_t msizeh = 0;
+  uint16_t nmeta  = 0;
+  if (!getword(msizel) || !getword(msizeh) || !getword(nmeta) ||
+      pos + nmeta + (nmeta&0x1) > nbyte) {
+    emsg.Init("Rw11Cpu::SnapRestore", "unexpected EOF in header");
+    return false;
+  }
+  uint32_t msize = uint32_t(msizel) | uint32_t(msizeh)<<16;
+  if (msize != MemSize()) {
+    emsg.InitPrintf("Rw11Cpu::SnapRestore", 
+                    "memory size mismatch: snapshot %u, system %u",
+                    msize, MemSize());
+    return false;
+  }
+
+  string meta(reinterpret_cast<const char*>(fbuf.data()+pos), nmeta);
+  pos += nmeta + (nmeta&0x1);
+  string metanow;
+  SnapMeta(metanow);
+  if (meta != metanow && !force) {
+    emsg.Init("Rw11Cpu::SnapRestore", 
+              string("attached units differ; snapshot:\n") + meta + 
+              "now:\n" + metanow);
+    return false;
+  }
+
+  // decode register state
+  vector<uint16_t> iblist;
+  SnapIbList(iblist);
+  uint16_t nreg = 0;
+  if (!getword(nreg) || nreg != kSnapNCpReg + iblist.size()) {
+    emsg.Init("Rw11Cpu::SnapRestore", "register count mismatch");
+    return false;
+  }
+  vector<uint16_t> regs(nreg);
+  for (auto& reg : regs) {
+    if (!getword(reg)) {
+      emsg.Init("Rw11Cpu::SnapRestore", "unexpected EOF in registers");
+      return false;
+    }
+  }
+
+  // decode memory image, check that it is complete
+  vector<uint16_t> mem(msize/2);
+  size_t nmem = 0;
+  while (nmem < mem.size()) {
+    uint16_t head = 0;
+    if (!getword(head)) break;
+    size_t nrun = head & 0x7fff;
+    if (nrun == 0 || nmem+nrun > mem.size()) break;
+    if (head & 0x8000) {                    // zero run
+      nmem += nrun;                         // mem is already zero'ed
+    } else {                                // literal words
+      if (pos+2*nrun > nbyte) break;
+      for (size_t i=0; i<nrun; i++) getword(mem[nmem+i]);
+      nmem += nrun;
+    }
+  }
+  if (nmem != mem.size() || pos != nbyte) {
+    emsg.Init("Rw11Cpu::SnapRestore", "corrupt memory image");
+    return false;
+  }
+
+  // cpu must be halted
+  RlinkCommandList clist;
+  int istat = clist.AddRreg(fBase+kCPSTAT);
+  if (!Server().Exec(clist, emsg)) return false;
+  if (clist[istat].Data() & kCPSTAT_M_CpuGo) {
+    emsg.Init("Rw11Cpu::SnapRestore", "cpu running, stop it first");
+    return false;
+  }
+
+  // write memory
+  size_t nwrdmax = 4*Connect().BlockSizeMax();
+  for (size_t ndone=0; ndone<mem.size(); ndone+=nwrdmax) {
+    size_t nblk = min(nwrdmax, mem.size()-ndone);
+    clist.Clear();
+    AddWMem(clist, 2*ndone, mem.data()+ndone, nblk);
+    if (!Server().Exec(clist, emsg)) return false;
+  }
+
+  // write registers; first the ibus registers, MMR0 is last in list
+  clist.Clear();
+  for (size_t i=0; i<iblist.size(); i++) {
+    AddWibr(clist, iblist[i], regs[kSnapNCpReg+i]);
+  }
+  if (!Server().Exec(clist, emsg)) return false;
+
+  // then GPRs of all register sets and modes, finally PSW and PC
+  clist.Clear();
+  size_t ireg = 2;
+  for (uint16_t rset : {0, 1}) {
+    for (uint16_t mode : {0, 1, 3}) {
+      clist.AddWreg(fBase+kCPPSW, uint16_t(mode<<14 | rset<<11));
+      for (uint16_t i=0; i<7; i++) clist.AddWreg(fBase+kCPR0+i, regs[ireg++]);
+    }
+  }
+  clist.AddWreg(fBase+kCPPSW, regs[0]);
+  clist.AddWreg(fBase+kCPPC,  regs[1]);
+  if (!Server().Exec(clist, emsg)) return false;
+
+  return true;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+bool Rw11Cpu::SnapSaveState(RfileFd& fd, RerrMsg& emsg)
+{
+  vector<uint8_t> obuf;
+  auto putword = [&obuf](uint16_t word) {
+    obuf.push_back(uint8_t(word));
+    obuf.push_back(uint8_t(word>>8));
+  };
+
+  // header: magic, memory size, meta data
+  obuf.insert(obuf.end(), kSnapMagic.begin(), kSnapMagic.end());
+  putword(uint16_t(MemSize()));
+  putword(uint16_t(MemSize()>>16));
+  string meta;
+  SnapMeta(meta);
+  putword(uint16_t(meta.length()));
+  obuf.insert(obuf.end(), meta.begin(), meta.end());
+  if (meta.length() & 0x1) obuf.push_back(0);
+
+  // registers: PSW, PC, then GPRs for all register sets and modes
+  RlinkCommandList clist;
+  int ipsw = clist.AddRreg(fBase+kCPPSW);
+  clist.AddRreg(fBase+kCPPC);
+  for (uint16_t rset : {0, 1}) {
+    for (uint16_t mode : {0, 1, 3}) {
+      clist.AddWreg(fBase+kCPPSW, uint16_t(mode<<14 | rset<<11));
+      for (uint16_t i=0; i<7; i++) clist.AddRreg(fBase+kCPR0+i);
+    }
+  }
+  if (!Server().Exec(clist, emsg)) return false;
+  uint16_t psw = clist[ipsw].Data();
+
+  vector<uint16_t> iblist;
+  SnapIbList(iblist);
+  putword(uint16_t(kSnapNCpReg + iblist.size()));
+  for (size_t i=0; i<clist.Size(); i++) {
+    if (clist[i].Command() == RlinkCommand::kCmdRreg) putword(clist[i].Data());
+  }
+
+  // restore original PSW, read ibus registers
+  clist.Clear();
+  clist.AddWreg(fBase+kCPPSW, psw);
+  for (auto ibaddr : iblist) AddRibr(clist, ibaddr);
+  if (!Server().Exec(clist, emsg)) return false;
+  for (size_t i=1; i<clist.Size(); i++) putword(clist[i].Data());
+
+  if (!fd.WriteAll(obuf.data(), obuf.size(), emsg)) return false;
+
+  // memory: read in maximal rblk chunks; encode zero runs
+  size_t blkmax = Connect().BlockSizeMax();
+  size_t nword  = MemSize()/2;
+  vector<uint16_t> data(blkmax);
+  for (size_t ndone=0; ndone<nword; ndone+=blkmax) {
+    size_t nblk = min(blkmax, nword-ndone);
+    clist.Clear();
+    AddRMem(clist, 2*ndone, data.data(), nblk, kCPAH_M_22BIT, true);
+    if (!Server().Exec(clist, emsg)) return false;
+
+    obuf.clear();
+    size_t i = 0;
+    while (i < nblk) {
+      size_t n = 0;
+      while (i+n < nblk && n < 0x7fff && data[i+n] == 0) n += 1;
+      if (n > 0) {                          // zero run
+        putword(uint16_t(0x8000 | n));
+        i += n;
+        continue;
+      }
+      while (i+n < nblk && n < 0x7fff &&    // literal up to next zero pair
+             !(data[i+n] == 0 && i+n+1 < nblk && data[i+n+1] == 0)) n += 1;
+      if (n == 0) n = 1;
+      putword(uint16_t(n));
+      for (size_t j=0; j<n; j++) putword(data[i+j]);
+      i += n;
+    }
+    if (!fd.WriteAll(obuf.data(), obuf.size(), emsg)) return false;
+  }
+
+  return true;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+void Rw11Cpu::SnapMeta(std::string& meta) const
+{
+  ostringstream sos;
+  for (auto& o: fCntlMap) {
+    Rw11Cntl& cntl = *o.second;
+    for (size_t i=0; i<cntl.NUnit(); i++) {
+      Rw11Unit& unit = cntl.UnitBase(i);
+      if (unit.IsAttached()) sos << unit.Name() << " " 
+                                 << unit.AttachUrl() << "\n";
+    }
+  }
+  meta = sos.str();
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+void Rw11Cpu::SnapIbList(std::vector<uint16_t>& iblist) const
+{
+  iblist.clear();
+  iblist.push_back(kCPUSTKLIM);
+  iblist.push_back(kCPUPIRQ);
+  iblist.push_back(kMMUMMR3);
+  for (uint16_t base : {kMMUPDRK, kMMUPARK, kMMUPDRS, kMMUPARS, 
+                        kMMUPDRU, kMMUPARU}) {
+    for (uint16_t i=0; i<16; i++) iblist.push_back(base+2*i);
+  }
+  iblist.push_back(kMMUMMR0);               // MMR0 last, enables MMU
+  return;
+}
+
 //------------------------------------------+-----------------------------------
 //! FIXME_docs
 
@@ -942,6 +1371,48 @@ void Rw11Cpu::W11AttnHandler()
   return;
 }
 
+//------------------------------------------+-----------------------------------
+//! Returns dmcmon readout engine, created on first use.
+
+Rw11CpuMonitor& Rw11Cpu::Cmon()
+{
+  if (!fupCmon) fupCmon.reset(new Rw11CpuMonitor(this));
+  return *fupCmon;
+}
+
+//------------------------------------------+-----------------------------------
+//! Returns pc sampling profiler, created on first use.
+
+Rw11CpuProfiler& Rw11Cpu::Prof()
+{
+  if (!fupProf) fupProf.reset(new Rw11CpuProfiler(this));
+  return *fupProf;
+}
+
+//------------------------------------------+-----------------------------------
+//! Returns dmpcnt sampler, created on first use.
+
+Rw11CpuPerfCnt& Rw11Cpu::Pcnt()
+{
+  if (!fupPcnt) fupPcnt.reset(new Rw11CpuPerfCnt(this));
+  return *fupPcnt;
+}
+
+//------------------------------------------+-----------------------------------
+//! Returns ibmon background capture, created on first use.
+
+RlinkMonCapture& Rw11Cpu::IbmonCapture()
+{
+  if (!HasIbmon())
+    throw Rexception("Rw11Cpu::IbmonCapture", "Bad state: no ibmon");
+  if (!fupImcap)
+    fupImcap.reset(new RlinkMonCapture(&Server(), RlinkMonCapture::kTypeIbmon,
+                                       IbusRemoteAddr(kIMBASE+kIMCNTL),
+                                       kIMBASE+kIMCNTL, kIMBASE+kIMDATA,
+                                       0x0038)); // conena|remena|locena
+  return *fupImcap;
+}
+
 //------------------------------------------+-----------------------------------
 //! FIXME_docs
 
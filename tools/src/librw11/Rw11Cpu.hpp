@@ -1,9 +1,15 @@
 // $Id: Rw11Cpu.hpp 1274 2022-08-08 09:21:53Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2013-2022 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2013-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1300   1.4.3  add IbmonCapture(), fupImcap (ibmon background capture)
+// 2026-10-19  1299   1.4.2  add Pcnt(), fupPcnt (dmpcnt sampler)
+// 2026-10-19  1298   1.4.1  add Prof(), fupProf (pc sampling profiler)
+// 2026-10-19  1297   1.4    add Cmon(), fupCmon (dmcmon readout engine)
+// 2026-10-19  1285   1.3.1  add MemReadBulk()
+// 2026-10-19  1284   1.3    add SnapSave(),SnapRestore()
 // 2022-08-08  1274   1.2.21 ssr->mmr rename
 // 2019-06-07  1160   1.2.20 Stats() not longer const
 // 2019-04-30  1143   1.2.19 add HasM9312()
@@ -51,10 +57,15 @@
 
 #include "librtools/Rstats.hpp"
 #include "librtools/RerrMsg.hpp"
+#include "librtools/RfileFd.hpp"
 #include "librlink/RlinkConnect.hpp"
 #include "librlink/RlinkAddrMap.hpp"
+#include "librlink/RlinkMonCapture.hpp"
 
 #include "Rw11Probe.hpp"
+#include "Rw11CpuMonitor.hpp"
+#include "Rw11CpuProfiler.hpp"
+#include "Rw11CpuPerfCnt.hpp"
 
 #include "librtools/Rbits.hpp"
 #include "Rw11.hpp"
@@ -139,6 +150,8 @@ namespace Retro {
 
       bool          MemRead(uint16_t addr, std::vector<uint16_t>& data, 
                             size_t nword, RerrMsg& emsg);
+      bool          MemReadBulk(uint32_t addr, std::vector<uint16_t>& data, 
+                                size_t nword, RerrMsg& emsg);
       bool          MemWrite(uint16_t addr, const std::vector<uint16_t>& data,
                              RerrMsg& emsg);
       bool          MemWriteByte(uint32_t addr, uint8_t data, RerrMsg& emsg);
@@ -149,6 +162,10 @@ namespace Retro {
                             uint16_t& start, bool trace=false);
       bool          Boot(const std::string& uname, RerrMsg& emsg);
 
+      bool          SnapSave(const std::string& fname, RerrMsg& emsg);
+      bool          SnapRestore(const std::string& fname, RerrMsg& emsg,
+                                bool force=false);
+
       void          SetCpuActUp();
       void          SetCpuActDown(uint16_t stat);
       int           WaitCpuActDown(const Rtime& tout, Rtime&twait);
@@ -173,6 +190,11 @@ namespace Retro {
 
       void          W11AttnHandler();
 
+      Rw11CpuMonitor& Cmon();
+      Rw11CpuProfiler& Prof();
+      Rw11CpuPerfCnt& Pcnt();
+      RlinkMonCapture& IbmonCapture();
+
       Rstats&       Stats();
       virtual void  Dump(std::ostream& os, int ind=0, const char* text=0,
                          int detail=0) const;
@@ -322,9 +344,16 @@ namespace Retro {
       static const uint16_t  kIISTACR = 0x0000;   //!< II.ACR   reg offset
       static const uint16_t  kIISTADR = 0x0002;   //!< II.ADR   reg offset
 
+    // defs for snapshot files
+      static const std::string kSnapMagic;        //!< snapshot file magic
+      static const size_t    kSnapNCpReg = 2+2*3*7; //!< psw,pc + gprs
+
     protected:
       void          SetupStd();
       void          SetupOpt();
+      bool          SnapSaveState(RfileFd& fd, RerrMsg& emsg);
+      void          SnapMeta(std::string& meta) const;
+      void          SnapIbList(std::vector<uint16_t>& iblist) const;
 
     private:
                     Rw11Cpu() {}            //!< default ctor blocker
@@ -353,6 +382,10 @@ namespace Retro {
       cmap_t        fCntlMap;               //!< name->cntl map
       RlinkAddrMap  fIAddrMap;              //!< ibus name<->address mapping
       RlinkAddrMap  fRAddrMap;              //!< rbus name<->address mapping
+      std::unique_ptr<Rw11CpuMonitor> fupCmon; //!< dmcmon readout engine
+      std::unique_ptr<Rw11CpuProfiler> fupProf; //!< pc sampling profiler
+      std::unique_ptr<Rw11CpuPerfCnt> fupPcnt; //!< dmpcnt sampler
+      std::unique_ptr<RlinkMonCapture> fupImcap; //!< ibmon capture
       Rstats        fStats;                 //!< statistics
   };
   
@@ -0,0 +1,463 @@
+// $Id: Rw11CpuMonitor.cpp 1297 2026-10-19 14:10:21Z mueller $
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// 
+// Revision History: 
+// Date         Rev Version  Comment
+// 2026-10-19  1297   1.0    Initial version
+// ---------------------------------------------------------------------------
+
+/*!
+  \brief   Implemenation of Rw11CpuMonitor.
+*/
+
+#include <string.h>
+
+#include <algorithm>
+#include <mutex>
+
+#include "librtools/RosFill.hpp"
+#include "librtools/RosPrintf.hpp"
+#include "librtools/RlogMsg.hpp"
+#include "librtools/Rtools.hpp"
+#include "librlink/RlinkCommandList.hpp"
+
+#include "Rw11Cpu.hpp"
+
+#include "Rw11CpuMonitor.hpp"
+
+using namespace std;
+
+/*!
+  \class Retro::Rw11CpuMonitor
+  \brief Streaming readout engine for the dmcmon cpu monitor.
+
+  The monitor is started in wstop mode, so it stops instead of overwriting
+  entries when its buffer is full. Drain() reads all entries recorded so
+  far with large rblk's of cm.data, resets the monitor address to zero and
+  resumes it. The monitor is only suspended when a readout is done, and a
+  periodic drain is skipped when the buffer is less than a quarter full.
+  If the monitor was found stopped the chunk is flagged as overrun, the
+  instructions executed till the restart are lost.
+
+  Entries are kept in an in-memory ring buffer of the last kRingSize
+  entries and optionally written to a trace file. The file starts with
+  a 16 byte header
+  \code
+    char[8]  magic "w11cmon1"
+    uint16   cm.cntl  (as used for start)
+    uint16   cm.stat  (at start)
+    uint32   monitor buffer size (entries)
+  \endcode
+  followed by one chunk per drain
+  \code
+    uint32   number of entries
+    uint32   flags (kChunkF_Overrun)
+    uint64   time stamp (ns, CLOCK_REALTIME)
+    uint16   data[9*nent]   entries in d0,..,d8 order
+  \endcode
+  All values are in host (little endian) byte order.
+*/
+
+// all method definitions in namespace Retro
+namespace Retro {
+
+//------------------------------------------+-----------------------------------
+// constants definitions
+
+const size_t   Rw11CpuMonitor::kEntSize;
+const size_t   Rw11CpuMonitor::kRingSize;
+const uint32_t Rw11CpuMonitor::kChunkF_Overrun;
+const uint16_t Rw11CpuMonitor::kCNTL_V_MWSUP;
+const uint16_t Rw11CpuMonitor::kCNTL_V_IMODE;
+const uint16_t Rw11CpuMonitor::kCNTL_V_WSTOP;
+const uint16_t Rw11CpuMonitor::kCNTL_FUNC_STO;
+const uint16_t Rw11CpuMonitor::kCNTL_FUNC_STA;
+const uint16_t Rw11CpuMonitor::kCNTL_FUNC_SUS;
+const uint16_t Rw11CpuMonitor::kCNTL_FUNC_RES;
+const uint16_t Rw11CpuMonitor::kSTAT_V_BSIZE;
+const uint16_t Rw11CpuMonitor::kSTAT_B_BSIZE;
+const uint16_t Rw11CpuMonitor::kSTAT_M_WRAP;
+const uint16_t Rw11CpuMonitor::kSTAT_M_SUSP;
+const uint16_t Rw11CpuMonitor::kSTAT_M_RUN;
+const uint16_t Rw11CpuMonitor::kADDR_V_LADDR;
+const uint16_t Rw11CpuMonitor::kADDR_B_LADDR;
+
+static const char kFileMagic[8] = {'w','1','1','c','m','o','n','1'};
+
+//------------------------------------------+-----------------------------------
+//! Constructor
+
+Rw11CpuMonitor::Rw11CpuMonitor(Rw11Cpu* pcpu)
+  : fpCpu(pcpu),
+    fActive(false),
+    fCntl(0),
+    fStat(0),
+    fNMax(0),
+    fPeriod(),
+    fTimer("Rw11CpuMonitor::fTimer."),
+    fFile("Rw11CpuMonitor::fFile."),
+    fFileName(),
+    fBuf(),
+    fRing(kRingSize*kEntSize),
+    fNEntry(0),
+    fStats()
+{
+  fStats.Define(kStatNDrain,     "NDrain",     "Drain() calls");
+  fStats.Define(kStatNDrainSkip, "NDrainSkip", "drains skipped");
+  fStats.Define(kStatNRblk,      "NRblk",      "rblk of cm.data");
+  fStats.Define(kStatNEntry,     "NEntry",     "entries captured");
+  fStats.Define(kStatNOverrun,   "NOverrun",   "buffer overruns");
+  fStats.Define(kStatNFileByt,   "NFileByt",   "bytes written to file");
+}
+
+//------------------------------------------+-----------------------------------
+//! Destructor
+
+Rw11CpuMonitor::~Rw11CpuMonitor()
+{
+  if (fTimer.IsOpen())
+    Rtools::Catch2Cerr(__func__, [this](){ StopTimer(); } );
+}
+
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Start the monitor and the readout.
+
+  \param imode   instruction mode (one entry per instruction)
+  \param mwsup   suppress memory wait states
+  \param fname   trace file name, no file written when empty
+  \param period  drain period, no periodic drain when zero
+  \param emsg    error message
+ */
+
+bool Rw11CpuMonitor::Start(bool imode, bool mwsup, const std::string& fname,
+                           const Rtime& period, RerrMsg& emsg)
+{
+  if (!Cpu().HasCmon()) {
+    emsg.Init("Rw11CpuMonitor::Start", "cpu has no dmcmon");
+    return false;
+  }
+  if (fActive && !Stop(emsg)) return false;
+
+  uint16_t base = Cpu().Base() + Rw11Cpu::kCMBASE;
+  fCntl = (uint16_t(mwsup) << kCNTL_V_MWSUP) |
+          (uint16_t(imode) << kCNTL_V_IMODE) |
+          (uint16_t(1)     << kCNTL_V_WSTOP);
+
+  RlinkCommandList clist;
+  clist.AddWreg(base+Rw11Cpu::kCMCNTL, fCntl|kCNTL_FUNC_STA);
+  size_t ista = clist.AddRreg(base+Rw11Cpu::kCMSTAT);
+  if (!Cpu().Server().Exec(clist, emsg)) return false;
+  fStat = clist[ista].Data();
+  fNMax = size_t(256) << ((fStat>>kSTAT_V_BSIZE) & kSTAT_B_BSIZE);
+
+  fFileName = fname;
+  if (fFileName.length()) {
+    if (!fFile.Open(fFileName.c_str(), O_WRONLY|O_CREAT|O_TRUNC, 0644, emsg))
+      return false;
+    uint8_t hdr[16];
+    uint32_t nmax = fNMax;
+    ::memcpy(hdr,    kFileMagic, 8);
+    ::memcpy(hdr+8,  &fCntl,     2);
+    ::memcpy(hdr+10, &fStat,     2);
+    ::memcpy(hdr+12, &nmax,      4);
+    if (!fFile.WriteAll(hdr, sizeof(hdr), emsg)) return false;
+    fStats.Inc(kStatNFileByt, double(sizeof(hdr)));
+  }
+
+  fNEntry = 0;
+  fPeriod = period;
+  fActive = true;
+
+  if (fPeriod.IsPositive()) {
+    fTimer.Open();
+    Cpu().Server().AddPollHandler([this](const pollfd& pfd)
+                                    { return TimerHandler(pfd); },
+                                  fTimer.Fd(), POLLIN);
+    fTimer.SetRelative(fPeriod);
+  }
+
+  return true;
+}
+
+//------------------------------------------+-----------------------------------
+//! Stop readout, drain remaining entries and stop the monitor.
+
+bool Rw11CpuMonitor::Stop(RerrMsg& emsg)
+{
+  if (!fActive) return true;
+  StopTimer();
+  bool rc = Drain(true, emsg);
+  fActive = false;
+
+  RlinkCommandList clist;
+  uint16_t base = Cpu().Base() + Rw11Cpu::kCMBASE;
+  clist.AddWreg(base+Rw11Cpu::kCMCNTL, kCNTL_FUNC_STO);
+  size_t ista = clist.AddRreg(base+Rw11Cpu::kCMSTAT);
+  if (rc) rc = Cpu().Server().Exec(clist, emsg);
+  if (rc) fStat = clist[ista].Data();
+
+  if (fFile.IsOpen()) fFile.Close();
+  return rc;
+}
+
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Read all entries recorded since the last drain.
+
+  \param force  when false the drain is skipped when the monitor runs and
+                its buffer is less than a quarter full
+  \param emsg   error message
+ */
+
+bool Rw11CpuMonitor::Drain(bool force, RerrMsg& emsg)
+{
+  if (!fActive) {
+    emsg.Init("Rw11CpuMonitor::Drain", "monitor readout not active");
+    return false;
+  }
+  fStats.Inc(kStatNDrain);
+
+  uint16_t base = Cpu().Base() + Rw11Cpu::kCMBASE;
+  RlinkCommandList clist;
+  size_t ista = clist.AddRreg(base+Rw11Cpu::kCMSTAT);
+  size_t iadr = clist.AddRreg(base+Rw11Cpu::kCMADDR);
+  if (!Cpu().Server().Exec(clist, emsg)) return false;
+  fStat = clist[ista].Data();
+  size_t laddr = (clist[iadr].Data()>>kADDR_V_LADDR) & kADDR_B_LADDR;
+
+  if (fStat & kSTAT_M_RUN) {                // monitor runs
+    if (!force && laddr < fNMax/4) {        // few entries, nothing to do
+      fStats.Inc(kStatNDrainSkip);
+      return true;
+    }
+    clist.Clear();                          // suspend, get final address
+    clist.AddWreg(base+Rw11Cpu::kCMCNTL, fCntl|kCNTL_FUNC_SUS);
+    ista = clist.AddRreg(base+Rw11Cpu::kCMSTAT);
+    iadr = clist.AddRreg(base+Rw11Cpu::kCMADDR);
+    if (!Cpu().Server().Exec(clist, emsg)) return false;
+    fStat = clist[ista].Data();
+    laddr = (clist[iadr].Data()>>kADDR_V_LADDR) & kADDR_B_LADDR;
+  }
+
+  bool stopped = !(fStat & kSTAT_M_RUN);    // stopped due to wstop ?
+  bool overrun = stopped && (fStat & kSTAT_M_WRAP);
+  size_t nent  = overrun ? fNMax : laddr;
+  if (!ReadEntries(nent, overrun, emsg)) return false;
+
+  clist.Clear();                            // reset address, continue
+  clist.AddWreg(base+Rw11Cpu::kCMADDR, 0);
+  if (stopped) {
+    clist.AddWreg(base+Rw11Cpu::kCMCNTL, fCntl|kCNTL_FUNC_STA);
+  } else {
+    clist.AddWreg(base+Rw11Cpu::kCMCNTL, fCntl|kCNTL_FUNC_RES);
+  }
+  return Cpu().Server().Exec(clist, emsg);
+}
+
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Returns the last \a nent entries in d0,..,d8 order.
+
+  At most kRingSize entries are available.
+ */
+
+void Rw11CpuMonitor::GetLast(std::vector<uint16_t>& data, size_t nent) const
+{
+  size_t navail = size_t(min(fNEntry, uint64_t(kRingSize)));
+  if (nent > navail) nent = navail;
+  data.resize(nent*kEntSize);
+  for (size_t i=0; i<nent; i++) {
+    size_t iring = size_t((fNEntry-nent+i) % kRingSize);
+    ::memcpy(data.data()+i*kEntSize, fRing.data()+iring*kEntSize,
+             kEntSize*sizeof(uint16_t));
+  }
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Load entries from a trace file.
+
+  \param fname  trace file name
+  \param first  index of first entry
+  \param nent   number of entries, all remaining when 0
+  \param data   returns entries in d0,..,d8 order
+  \param cntl   returns cm.cntl from file header
+  \param stat   returns cm.stat from file header
+  \param emsg   error message
+ */
+
+bool Rw11CpuMonitor::LoadFile(const std::string& fname, uint64_t first,
+                              size_t nent, std::vector<uint16_t>& data,
+                              uint16_t& cntl, uint16_t& stat, RerrMsg& emsg)
+{
+  RfileFd fd("Rw11CpuMonitor::LoadFile.fd.");
+  if (!fd.Open(fname.c_str(), O_RDONLY, emsg)) return false;
+
+  uint8_t hdr[16];
+  if (fd.Read(hdr, sizeof(hdr), emsg) != ssize_t(sizeof(hdr)) ||
+      ::memcmp(hdr, kFileMagic, 8) != 0) {
+    emsg.Init("Rw11CpuMonitor::LoadFile",
+              string("'") + fname + "' is not a cmon trace file");
+    return false;
+  }
+  ::memcpy(&cntl, hdr+8,  2);
+  ::memcpy(&stat, hdr+10, 2);
+
+  data.clear();
+  uint64_t ient = 0;                        // index of first entry in chunk
+  while (nent == 0 || data.size() < nent*kEntSize) {
+    uint8_t chdr[16];
+    ssize_t irc = fd.Read(chdr, sizeof(chdr), emsg);
+    if (irc == 0) break;                    // eof
+    if (irc != ssize_t(sizeof(chdr))) {
+      if (irc > 0) emsg.Init("Rw11CpuMonitor::LoadFile", "truncated chunk");
+      return false;
+    }
+    uint32_t cnent;
+    ::memcpy(&cnent, chdr, 4);
+    size_t cbyt = size_t(cnent)*kEntSize*sizeof(uint16_t);
+
+    if (ient+cnent <= first) {              // chunk before first, skip
+      if (fd.Seek(cbyt, SEEK_CUR, emsg) < 0) return false;
+      ient += cnent;
+      continue;
+    }
+
+    vector<uint16_t> cbuf(size_t(cnent)*kEntSize);
+    if (fd.Read(cbuf.data(), cbyt, emsg) != ssize_t(cbyt)) {
+      emsg.Init("Rw11CpuMonitor::LoadFile", "truncated chunk");
+      return false;
+    }
+    size_t ibeg = (first > ient) ? size_t(first-ient) : 0;
+    size_t iend = cnent;
+    if (nent != 0) iend = min(iend, ibeg + nent - data.size()/kEntSize);
+    data.insert(data.end(), cbuf.begin()+ibeg*kEntSize,
+                cbuf.begin()+iend*kEntSize);
+    ient += cnent;
+  }
+
+  return true;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+void Rw11CpuMonitor::Dump(std::ostream& os, int ind, const char* text,
+                          int detail) const
+{
+  RosFill bl(ind);
+  os << bl << (text?text:"--") << "Rw11CpuMonitor @ " << this << endl;
+
+  os << bl << "  fpCpu:           " << fpCpu << endl;
+  os << bl << "  fActive:         " << RosPrintf(fActive) << endl;
+  os << bl << "  fCntl:           " << RosPrintf(fCntl,"o0",6) << endl;
+  os << bl << "  fStat:           " << RosPrintf(fStat,"o0",6) << endl;
+  os << bl << "  fNMax:           " << fNMax << endl;
+  os << bl << "  fPeriod:         " << fPeriod << endl;
+  os << bl << "  fTimer:          " << fTimer.Fd() << endl;
+  os << bl << "  fFileName:       " << fFileName << endl;
+  os << bl << "  fNEntry:         " << fNEntry << endl;
+  fStats.Dump(os, ind+2, "fStats: ", detail-1);
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+//! Handler for drain timer, runs in server context.
+
+int Rw11CpuMonitor::TimerHandler(const pollfd& pfd)
+{
+  // bail-out and cancel handler if poll returns an error event
+  if (pfd.revents & (~pfd.events)) return -1;
+
+  fTimer.Read();                            // harvest expiration count
+
+  // lock connect to protect monitor state against Tcl side accesses
+  lock_guard<RlinkConnect> lock(Cpu().Connect());
+  if (!fActive) return 0;
+
+  RerrMsg emsg;
+  if (!Drain(false, emsg)) {
+    RlogMsg lmsg(Cpu().LogFile());
+    lmsg << "-E cmon: drain failed: " << emsg;
+  }
+  fTimer.SetRelative(fPeriod);
+  return 0;
+}
+
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Read \a nent entries starting at monitor address zero.
+
+  Uses rblk's of the prudent block size, rounded down to full entries.
+ */
+
+bool Rw11CpuMonitor::ReadEntries(size_t nent, bool overrun, RerrMsg& emsg)
+{
+  if (overrun) fStats.Inc(kStatNOverrun);
+  if (nent == 0 && !overrun) return true;
+
+  uint16_t base = Cpu().Base() + Rw11Cpu::kCMBASE;
+  size_t nword  = nent*kEntSize;
+  size_t blkmax = (Cpu().Connect().BlockSizePrudent()/kEntSize)*kEntSize;
+  fBuf.resize(nword);
+
+  RlinkCommandList clist;
+  clist.AddWreg(base+Rw11Cpu::kCMADDR, 0);
+  size_t ndone = 0;
+  while (nword > ndone) {
+    size_t nblk = min(blkmax, nword-ndone);
+    clist.AddRblk(base+Rw11Cpu::kCMDATA, fBuf.data()+ndone, nblk);
+    if (!Cpu().Server().Exec(clist, emsg)) return false;
+    fStats.Inc(kStatNRblk);
+    ndone += nblk;
+    clist.Clear();
+  }
+
+  for (size_t i=0; i<nent; i++) {
+    size_t iring = size_t((fNEntry+i) % kRingSize);
+    ::memcpy(fRing.data()+iring*kEntSize, fBuf.data()+i*kEntSize,
+             kEntSize*sizeof(uint16_t));
+  }
+  fNEntry += nent;
+  fStats.Inc(kStatNEntry, double(nent));
+
+  if (fFile.IsOpen())
+    return WriteChunk(fBuf.data(), nent, overrun ? kChunkF_Overrun : 0, emsg);
+  return true;
+}
+
+//------------------------------------------+-----------------------------------
+//! Write one chunk to the trace file.
+
+bool Rw11CpuMonitor::WriteChunk(const uint16_t* data, size_t nent,
+                                uint32_t flags, RerrMsg& emsg)
+{
+  uint8_t  chdr[16];
+  uint32_t cnent = nent;
+  Rtime    tnow(CLOCK_REALTIME);
+  uint64_t tns   = uint64_t(tnow.Sec())*1000000000ull + uint64_t(tnow.NSec());
+  ::memcpy(chdr,   &cnent, 4);
+  ::memcpy(chdr+4, &flags, 4);
+  ::memcpy(chdr+8, &tns,   8);
+  size_t nbyt = nent*kEntSize*sizeof(uint16_t);
+  if (!fFile.WriteAll(chdr, sizeof(chdr), emsg)) return false;
+  if (nbyt > 0 && !fFile.WriteAll(data, nbyt, emsg)) return false;
+  fStats.Inc(kStatNFileByt, double(sizeof(chdr)+nbyt));
+  return true;
+}
+
+//------------------------------------------+-----------------------------------
+//! Stop drain timer and remove its poll handler.
+
+void Rw11CpuMonitor::StopTimer()
+{
+  if (!fTimer.IsOpen()) return;
+  Cpu().Server().RemovePollHandler(fTimer.Fd());
+  fTimer.Close();
+  return;
+}
+
+} // end namespace Retro
@@ -0,0 +1,121 @@
+// $Id: Rw11CpuMonitor.hpp 1297 2026-10-19 14:10:21Z mueller $
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// 
+// Revision History: 
+// Date         Rev Version  Comment
+// 2026-10-19  1297   1.0    Initial version
+// ---------------------------------------------------------------------------
+
+
+/*!
+  \brief   Declaration of class Rw11CpuMonitor.
+*/
+
+#ifndef included_Retro_Rw11CpuMonitor
+#define included_Retro_Rw11CpuMonitor 1
+
+#include <poll.h>
+
+#include <string>
+#include <vector>
+#include <ostream>
+
+#include "librtools/Rstats.hpp"
+#include "librtools/RerrMsg.hpp"
+#include "librtools/Rtime.hpp"
+#include "librtools/RtimerFd.hpp"
+#include "librtools/RfileFd.hpp"
+
+namespace Retro {
+
+  class Rw11Cpu;                            // forw decl to avoid circular incl
+
+  class Rw11CpuMonitor {
+    public:
+      explicit      Rw11CpuMonitor(Rw11Cpu* pcpu);
+                   ~Rw11CpuMonitor();
+
+                    Rw11CpuMonitor(const Rw11CpuMonitor&) = delete; // noncopy
+      Rw11CpuMonitor& operator=(const Rw11CpuMonitor&) = delete; // noncopy
+
+      Rw11Cpu&      Cpu() const;
+
+      bool          Start(bool imode, bool mwsup, const std::string& fname,
+                          const Rtime& period, RerrMsg& emsg);
+      bool          Stop(RerrMsg& emsg);
+      bool          Drain(bool force, RerrMsg& emsg);
+      bool          IsActive() const;
+
+      uint16_t      Cntl() const;
+      uint16_t      Stat() const;
+      uint64_t      NEntry() const;
+      void          GetLast(std::vector<uint16_t>& data, size_t nent) const;
+
+      static bool   LoadFile(const std::string& fname, uint64_t first,
+                             size_t nent, std::vector<uint16_t>& data,
+                             uint16_t& cntl, uint16_t& stat, RerrMsg& emsg);
+
+      Rstats&       Stats();
+      void          Dump(std::ostream& os, int ind=0, const char* text=0,
+                         int detail=0) const;
+
+    // some constants (also defined in cpp)
+      static const size_t   kEntSize  = 9;          //!< words per entry
+      static const size_t   kRingSize = 16384;      //!< in-memory entries
+      static const uint32_t kChunkF_Overrun = 0x1;  //!< chunk: entries lost
+
+      static const uint16_t kCNTL_V_MWSUP = 5;      //!< cntl.mwsup shift
+      static const uint16_t kCNTL_V_IMODE = 4;      //!< cntl.imode shift
+      static const uint16_t kCNTL_V_WSTOP = 3;      //!< cntl.wstop shift
+      static const uint16_t kCNTL_FUNC_STO = 0x4;   //!< cntl.func: stop
+      static const uint16_t kCNTL_FUNC_STA = 0x5;   //!< cntl.func: start
+      static const uint16_t kCNTL_FUNC_SUS = 0x6;   //!< cntl.func: suspend
+      static const uint16_t kCNTL_FUNC_RES = 0x7;   //!< cntl.func: resume
+      static const uint16_t kSTAT_V_BSIZE = 13;     //!< stat.bsize shift
+      static const uint16_t kSTAT_B_BSIZE = 0x7;    //!< stat.bsize bit mask
+      static const uint16_t kSTAT_M_WRAP  = 0x4;    //!< stat.wrap mask
+      static const uint16_t kSTAT_M_SUSP  = 0x2;    //!< stat.susp mask
+      static const uint16_t kSTAT_M_RUN   = 0x1;    //!< stat.run mask
+      static const uint16_t kADDR_V_LADDR = 4;      //!< addr.laddr shift
+      static const uint16_t kADDR_B_LADDR = 0xfff;  //!< addr.laddr bit mask
+
+    // statistics counter indices
+      enum stats {
+        kStatNDrain = 0,                    //!< Drain() calls
+        kStatNDrainSkip,                    //!< drains skipped (few entries)
+        kStatNRblk,                         //!< rblk's of cm.data
+        kStatNEntry,                        //!< entries captured
+        kStatNOverrun,                      //!< buffer overruns
+        kStatNFileByt,                      //!< bytes written to trace file
+        kDimStat
+      };
+
+    protected:
+      int           TimerHandler(const pollfd& pfd);
+      bool          ReadEntries(size_t nent, bool overrun, RerrMsg& emsg);
+      bool          WriteChunk(const uint16_t* data, size_t nent,
+                               uint32_t flags, RerrMsg& emsg);
+      void          StopTimer();
+
+    protected:
+      Rw11Cpu*      fpCpu;                  //!< cpu back pointer
+      bool          fActive;                //!< monitor readout active
+      uint16_t      fCntl;                  //!< cm.cntl used for start
+      uint16_t      fStat;                  //!< last cm.stat seen
+      size_t        fNMax;                  //!< monitor buffer size (entries)
+      Rtime         fPeriod;                //!< drain period
+      RtimerFd      fTimer;                 //!< drain timer
+      RfileFd       fFile;                  //!< trace file
+      std::string   fFileName;              //!< trace file name
+      std::vector<uint16_t> fBuf;           //!< readout buffer
+      std::vector<uint16_t> fRing;          //!< last entries ring buffer
+      uint64_t      fNEntry;                //!< total entries captured
+      Rstats        fStats;                 //!< statistics
+  };
+
+} // end namespace Retro
+
+#include "Rw11CpuMonitor.ipp"
+
+#endif
@@ -0,0 +1,65 @@
+// $Id: Rw11CpuMonitor.ipp 1297 2026-10-19 14:10:21Z mueller $
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// 
+// Revision History: 
+// Date         Rev Version  Comment
+// 2026-10-19  1297   1.0    Initial version
+// ---------------------------------------------------------------------------
+
+/*!
+  \brief   Implemenation (inline) of Rw11CpuMonitor.
+*/
+
+// all method definitions in namespace Retro
+namespace Retro {
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+inline Rw11Cpu& Rw11CpuMonitor::Cpu() const
+{
+  return *fpCpu;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+inline bool Rw11CpuMonitor::IsActive() const
+{
+  return fActive;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+inline uint16_t Rw11CpuMonitor::Cntl() const
+{
+  return fCntl;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+inline uint16_t Rw11CpuMonitor::Stat() const
+{
+  return fStat;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+inline uint64_t Rw11CpuMonitor::NEntry() const
+{
+  return fNEntry;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+inline Rstats& Rw11CpuMonitor::Stats()
+{
+  return fStats;
+}
+
+} // end namespace Retro
@@ -0,0 +1,382 @@
+// $Id: Rw11CpuPerfCnt.cpp 1299 2026-10-19 17:31:05Z mueller $
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// 
+// Revision History: 
+// Date         Rev Version  Comment
+// 2026-10-19  1299   1.0    Initial version
+// ---------------------------------------------------------------------------
+
+/*!
+  \brief   Implemenation of Rw11CpuPerfCnt.
+*/
+
+#include <errno.h>
+#include <string.h>
+
+#include <mutex>
+
+#include "librtools/RosFill.hpp"
+#include "librtools/RosPrintf.hpp"
+#include "librtools/RlogMsg.hpp"
+#include "librtools/Rtools.hpp"
+#include "librlink/RlinkCommandList.hpp"
+
+#include "Rw11Cpu.hpp"
+
+#include "Rw11CpuPerfCnt.hpp"
+
+using namespace std;
+
+/*!
+  \class Retro::Rw11CpuPerfCnt
+  \brief Periodic sampler for the dmpcnt performance counters.
+
+  All 32 counters are read with one rblk of pc.data per tick of a periodic
+  timer in the rlink server event loop. The time stamp of a sample is the
+  midpoint of the rlink transaction. For each sample the deltas to the
+  previous sample are computed, the last samples are kept in a ring buffer
+  and optionally written to a file. Two file formats are supported
+  - csv: a header line with the counter names, followed by one line per
+    sample with time, dt and the 32 counter deltas.
+  - binary: a 16 byte header with magic "w11pcnt1", uint32 number of
+    counters and uint32 period in usec, followed by one record per sample
+    with a double time and the 32 uint32 raw counter values, all in host
+    byte order.
+*/
+
+// all method definitions in namespace Retro
+namespace Retro {
+
+//------------------------------------------+-----------------------------------
+// constants definitions
+
+const size_t   Rw11CpuPerfCnt::kNCnt;
+const uint16_t Rw11CpuPerfCnt::kCNTL_M_AINC;
+const uint16_t Rw11CpuPerfCnt::kCNTL_FUNC_STO;
+const uint16_t Rw11CpuPerfCnt::kCNTL_FUNC_STA;
+const uint16_t Rw11CpuPerfCnt::kCNTL_FUNC_CLR;
+const uint16_t Rw11CpuPerfCnt::kCNTL_FUNC_LOA;
+
+static const char* kCntNames[Rw11CpuPerfCnt::kNCnt] = {
+  "cpu_cpbusy",  "cpu_km_prix",  "cpu_km_pri0",  "cpu_km_wait",
+  "cpu_sm",      "cpu_um",       "cpu_idec",     "cpu_pcload",
+  "cpu_vfetch",  "cpu_irupt",    "ca_rd",        "ca_wr",
+  "ca_rdhit",    "ca_wrhit",     "ca_rdmem",     "ca_wrmem",
+  "ca_rdwait",   "ca_wrwait",    "ib_rd",        "ib_wr",
+  "ib_busy",     "rb_rd",        "rb_wr",        "rb_busy",
+  "ext_rdrhit",  "ext_wrrhit",   "ext_wrflush",  "ext_rlrxact",
+  "ext_rlrxback","ext_rltxact",  "ext_rltxback", "ext_udec"
+};
+
+static const char kFileMagic[8] = {'w','1','1','p','c','n','t','1'};
+
+//------------------------------------------+-----------------------------------
+//! Constructor
+
+Rw11CpuPerfCnt::Rw11CpuPerfCnt(Rw11Cpu* pcpu)
+  : fpCpu(pcpu),
+    fActive(false),
+    fPeriod(),
+    fTStart(),
+    fTimer("Rw11CpuPerfCnt::fTimer."),
+    fFile(nullptr),
+    fBinary(false),
+    fTLast(0.),
+    fCntLast{},
+    fRing(),
+    fNSample(0),
+    fStats()
+{
+  fStats.Define(kStatNSample,    "NSample",    "samples taken");
+  fStats.Define(kStatNTickMiss,  "NTickMiss",  "timer ticks missed");
+  fStats.Define(kStatNSampleErr, "NSampleErr", "samples failed");
+  fStats.Define(kStatNFileByt,   "NFileByt",   "bytes written to file");
+}
+
+//------------------------------------------+-----------------------------------
+//! Destructor
+
+Rw11CpuPerfCnt::~Rw11CpuPerfCnt()
+{
+  if (fTimer.IsOpen())
+    Rtools::Catch2Cerr(__func__, [this](){ StopTimer(); } );
+  CloseFile();
+}
+
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Clear and start the counters and start sampling.
+
+  \param period  sampling period
+  \param nring   number of samples kept in ring buffer
+  \param fname   output file name, no file written when empty
+  \param binary  binary instead of csv output format
+  \param emsg    error message
+ */
+
+bool Rw11CpuPerfCnt::Start(const Rtime& period, size_t nring,
+                           const std::string& fname, bool binary,
+                           RerrMsg& emsg)
+{
+  if (!Cpu().HasPcnt()) {
+    emsg.Init("Rw11CpuPerfCnt::Start", "cpu has no dmpcnt");
+    return false;
+  }
+  if (!period.IsPositive() || nring == 0) {
+    emsg.Init("Rw11CpuPerfCnt::Start", "period and nring must be positive");
+    return false;
+  }
+  if (fActive && !Stop(emsg)) return false;
+
+  uint16_t base = Cpu().Base() + Rw11Cpu::kPCBASE;
+  RlinkCommandList clist;
+  clist.AddWreg(base+Rw11Cpu::kPCCNTL, kCNTL_FUNC_CLR);
+  clist.AddWreg(base+Rw11Cpu::kPCCNTL, kCNTL_FUNC_STA);
+  if (!Cpu().Server().Exec(clist, emsg)) return false;
+
+  fPeriod  = period;
+  fBinary  = binary;
+  fNSample = 0;
+  fRing.assign(nring, sample());
+
+  if (fname.length()) {
+    fFile = ::fopen(fname.c_str(), "w");
+    if (fFile == nullptr) {
+      emsg.InitErrno("Rw11CpuPerfCnt::Start",
+                     string("fopen() for '") + fname + "' failed: ", errno);
+      return false;
+    }
+    if (!WriteHeader(emsg)) {
+      CloseFile();
+      return false;
+    }
+  }
+
+  fTStart.GetClock(CLOCK_MONOTONIC);
+  if (!ReadCounters(fCntLast, fTLast, emsg)) {
+    CloseFile();
+    return false;
+  }
+
+  fActive = true;
+  fTimer.Open();
+  Cpu().Server().AddPollHandler([this](const pollfd& pfd)
+                                  { return TimerHandler(pfd); },
+                                fTimer.Fd(), POLLIN);
+  fTimer.SetPeriodic(fPeriod);
+  return true;
+}
+
+//------------------------------------------+-----------------------------------
+//! Stop sampling and the counters, close output file.
+
+bool Rw11CpuPerfCnt::Stop(RerrMsg& emsg)
+{
+  if (!fActive) return true;
+  StopTimer();
+  fActive = false;
+  CloseFile();
+
+  RlinkCommandList clist;
+  clist.AddWreg(Cpu().Base()+Rw11Cpu::kPCBASE+Rw11Cpu::kPCCNTL,
+                kCNTL_FUNC_STO);
+  return Cpu().Server().Exec(clist, emsg);
+}
+
+//------------------------------------------+-----------------------------------
+//! Returns the last \a nsam samples, oldest first.
+
+void Rw11CpuPerfCnt::GetLast(std::vector<sample>& list, size_t nsam) const
+{
+  size_t nring  = fRing.size();
+  size_t navail = (fNSample < nring) ? size_t(fNSample) : nring;
+  if (nsam > navail) nsam = navail;
+  list.clear();
+  list.reserve(nsam);
+  for (size_t i=0; i<nsam; i++) {
+    list.push_back(fRing[size_t((fNSample-nsam+i) % nring)]);
+  }
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+//! Returns name of counter \a ind.
+
+const char* Rw11CpuPerfCnt::CntName(size_t ind)
+{
+  return (ind < kNCnt) ? kCntNames[ind] : "?";
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+void Rw11CpuPerfCnt::Dump(std::ostream& os, int ind, const char* text,
+                          int detail) const
+{
+  RosFill bl(ind);
+  os << bl << (text?text:"--") << "Rw11CpuPerfCnt @ " << this << endl;
+
+  os << bl << "  fpCpu:           " << fpCpu << endl;
+  os << bl << "  fActive:         " << RosPrintf(fActive) << endl;
+  os << bl << "  fPeriod:         " << fPeriod << endl;
+  os << bl << "  fTimer:          " << fTimer.Fd() << endl;
+  os << bl << "  fFile:           " << fFile << endl;
+  os << bl << "  fBinary:         " << RosPrintf(fBinary) << endl;
+  os << bl << "  fTLast:          " << fTLast << endl;
+  os << bl << "  fRing.size:      " << fRing.size() << endl;
+  os << bl << "  fNSample:        " << fNSample << endl;
+  fStats.Dump(os, ind+2, "fStats: ", detail-1);
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+//! Handler for sampling timer, runs in server context.
+
+int Rw11CpuPerfCnt::TimerHandler(const pollfd& pfd)
+{
+  // bail-out and cancel handler if poll returns an error event
+  if (pfd.revents & (~pfd.events)) return -1;
+
+  uint64_t nexp = fTimer.Read();            // harvest expiration count
+  if (nexp == 0) return 0;                  // spurious wakeup
+  if (nexp > 1) fStats.Inc(kStatNTickMiss, double(nexp-1));
+
+  // lock connect to protect sampler state against Tcl side accesses
+  lock_guard<RlinkConnect> lock(Cpu().Connect());
+  if (!fActive) return 0;
+
+  RerrMsg emsg;
+  if (!Sample(emsg)) {
+    fStats.Inc(kStatNSampleErr);
+    RlogMsg lmsg(Cpu().LogFile());
+    lmsg << "-E pcnt: sample failed: " << emsg;
+  }
+  return 0;
+}
+
+//------------------------------------------+-----------------------------------
+//! Read all counters with one rblk, \a time is transaction midpoint.
+
+bool Rw11CpuPerfCnt::ReadCounters(uint32_t* cnt, double& time, RerrMsg& emsg)
+{
+  uint16_t base = Cpu().Base() + Rw11Cpu::kPCBASE;
+  uint16_t data[2*kNCnt];
+  RlinkCommandList clist;
+  clist.AddWreg(base+Rw11Cpu::kPCCNTL, kCNTL_M_AINC|kCNTL_FUNC_LOA);
+  clist.AddRblk(base+Rw11Cpu::kPCDATA, data, 2*kNCnt);
+
+  Rtime tbeg(CLOCK_MONOTONIC);
+  if (!Cpu().Server().Exec(clist, emsg)) return false;
+  Rtime tend(CLOCK_MONOTONIC);
+  time = 0.5*((tbeg-fTStart).ToDouble() + (tend-fTStart).ToDouble());
+
+  for (size_t i=0; i<kNCnt; i++) {
+    cnt[i] = uint32_t(data[2*i]) | (uint32_t(data[2*i+1]) << 16);
+  }
+  return true;
+}
+
+//------------------------------------------+-----------------------------------
+//! Take one sample, compute deltas, store in ring and write to file.
+
+bool Rw11CpuPerfCnt::Sample(RerrMsg& emsg)
+{
+  sample& sam = fRing[size_t(fNSample % fRing.size())];
+  if (!ReadCounters(sam.fCnt, sam.fTime, emsg)) return false;
+
+  sam.fDt = sam.fTime - fTLast;
+  for (size_t i=0; i<kNCnt; i++) {
+    sam.fDlt[i] = sam.fCnt[i] - fCntLast[i]; // modulo 2^32, handles wrap
+    fCntLast[i] = sam.fCnt[i];
+  }
+  fTLast = sam.fTime;
+  fNSample += 1;
+  fStats.Inc(kStatNSample);
+
+  if (fFile) return WriteSample(sam, emsg);
+  return true;
+}
+
+//------------------------------------------+-----------------------------------
+//! Write file header.
+
+bool Rw11CpuPerfCnt::WriteHeader(RerrMsg& emsg)
+{
+  int irc;
+  if (fBinary) {
+    uint8_t hdr[16];
+    uint32_t ncnt   = kNCnt;
+    uint32_t period = uint32_t(fPeriod.ToDouble()*1.e6 + 0.5);
+    ::memcpy(hdr,    kFileMagic, 8);
+    ::memcpy(hdr+8,  &ncnt,      4);
+    ::memcpy(hdr+12, &period,    4);
+    irc = (::fwrite(hdr, sizeof(hdr), 1, fFile) == 1) ? int(sizeof(hdr)) : -1;
+  } else {
+    string line = "time,dt";
+    for (size_t i=0; i<kNCnt; i++) {
+      line += ",";
+      line += kCntNames[i];
+    }
+    line += "\n";
+    irc = ::fputs(line.c_str(), fFile) >= 0 ? int(line.length()) : -1;
+  }
+  if (irc < 0) {
+    emsg.InitErrno("Rw11CpuPerfCnt::WriteHeader", "write failed: ", errno);
+    return false;
+  }
+  fStats.Inc(kStatNFileByt, double(irc));
+  return true;
+}
+
+//------------------------------------------+-----------------------------------
+//! Write one sample to file.
+
+bool Rw11CpuPerfCnt::WriteSample(const sample& sam, RerrMsg& emsg)
+{
+  int irc;
+  if (fBinary) {
+    bool ok = ::fwrite(&sam.fTime, sizeof(sam.fTime), 1, fFile) == 1 &&
+              ::fwrite(sam.fCnt, sizeof(sam.fCnt), 1, fFile) == 1;
+    irc = ok ? int(sizeof(sam.fTime)+sizeof(sam.fCnt)) : -1;
+  } else {
+    char buf[16*(kNCnt+2)];
+    int  nc = ::snprintf(buf, sizeof(buf), "%.6f,%.6f", sam.fTime, sam.fDt);
+    for (size_t i=0; i<kNCnt; i++) {
+      nc += ::snprintf(buf+nc, sizeof(buf)-nc, ",%u", sam.fDlt[i]);
+    }
+    buf[nc++] = '\n';
+    irc = (::fwrite(buf, nc, 1, fFile) == 1) ? nc : -1;
+  }
+  if (irc < 0) {
+    emsg.InitErrno("Rw11CpuPerfCnt::WriteSample", "write failed: ", errno);
+    return false;
+  }
+  fStats.Inc(kStatNFileByt, double(irc));
+  return true;
+}
+
+//------------------------------------------+-----------------------------------
+//! Stop sampling timer and remove its poll handler.
+
+void Rw11CpuPerfCnt::StopTimer()
+{
+  if (!fTimer.IsOpen()) return;
+  Cpu().Server().RemovePollHandler(fTimer.Fd());
+  fTimer.Close();
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+//! Close output file if open.
+
+void Rw11CpuPerfCnt::CloseFile()
+{
+  if (fFile) {
+    ::fclose(fFile);
+    fFile = nullptr;
+  }
+  return;
+}
+
+} // end namespace Retro
@@ -0,0 +1,113 @@
+// $Id: Rw11CpuPerfCnt.hpp 1299 2026-10-19 17:31:05Z mueller $
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// 
+// Revision History: 
+// Date         Rev Version  Comment
+// 2026-10-19  1299   1.0    Initial version
+// ---------------------------------------------------------------------------
+
+
+/*!
+  \brief   Declaration of class Rw11CpuPerfCnt.
+*/
+
+#ifndef included_Retro_Rw11CpuPerfCnt
+#define included_Retro_Rw11CpuPerfCnt 1
+
+#include <poll.h>
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+#include <ostream>
+
+#include "librtools/Rstats.hpp"
+#include "librtools/RerrMsg.hpp"
+#include "librtools/Rtime.hpp"
+#include "librtools/RtimerFd.hpp"
+
+namespace Retro {
+
+  class Rw11Cpu;                            // forw decl to avoid circular incl
+
+  class Rw11CpuPerfCnt {
+    public:
+    // some constants (also defined in cpp)
+      static const size_t   kNCnt = 32;     //!< number of counters
+
+      struct sample {
+        double      fTime;                  //!< time since start (sec)
+        double      fDt;                    //!< time since previous sample
+        uint32_t    fCnt[kNCnt];            //!< counter values
+        uint32_t    fDlt[kNCnt];            //!< counter deltas
+      };
+
+      explicit      Rw11CpuPerfCnt(Rw11Cpu* pcpu);
+                   ~Rw11CpuPerfCnt();
+
+                    Rw11CpuPerfCnt(const Rw11CpuPerfCnt&) = delete;
+      Rw11CpuPerfCnt& operator=(const Rw11CpuPerfCnt&) = delete;
+
+      Rw11Cpu&      Cpu() const;
+
+      bool          Start(const Rtime& period, size_t nring,
+                          const std::string& fname, bool binary,
+                          RerrMsg& emsg);
+      bool          Stop(RerrMsg& emsg);
+      bool          IsActive() const;
+      const Rtime&  Period() const;
+      uint64_t      NSample() const;
+
+      void          GetLast(std::vector<sample>& list, size_t nsam) const;
+
+      static const char* CntName(size_t ind);
+
+      Rstats&       Stats();
+      void          Dump(std::ostream& os, int ind=0, const char* text=0,
+                         int detail=0) const;
+
+      static const uint16_t kCNTL_M_AINC   = 0x8000; //!< cntl.ainc mask
+      static const uint16_t kCNTL_FUNC_STO = 0x4;    //!< cntl.func: stop
+      static const uint16_t kCNTL_FUNC_STA = 0x5;    //!< cntl.func: start
+      static const uint16_t kCNTL_FUNC_CLR = 0x6;    //!< cntl.func: clear
+      static const uint16_t kCNTL_FUNC_LOA = 0x7;    //!< cntl.func: load
+
+    // statistics counter indices
+      enum stats {
+        kStatNSample = 0,                   //!< samples taken
+        kStatNTickMiss,                     //!< timer ticks missed
+        kStatNSampleErr,                    //!< samples failed
+        kStatNFileByt,                      //!< bytes written to file
+        kDimStat
+      };
+
+    protected:
+      int           TimerHandler(const pollfd& pfd);
+      bool          ReadCounters(uint32_t* cnt, double& time, RerrMsg& emsg);
+      bool          Sample(RerrMsg& emsg);
+      bool          WriteHeader(RerrMsg& emsg);
+      bool          WriteSample(const sample& sam, RerrMsg& emsg);
+      void          StopTimer();
+      void          CloseFile();
+
+    protected:
+      Rw11Cpu*      fpCpu;                  //!< cpu back pointer
+      bool          fActive;                //!< sampling active
+      Rtime         fPeriod;                //!< sampling period
+      Rtime         fTStart;                //!< start time
+      RtimerFd      fTimer;                 //!< sampling timer
+      FILE*         fFile;                  //!< output file
+      bool          fBinary;                //!< binary output format
+      double        fTLast;                 //!< time of last sample
+      uint32_t      fCntLast[kNCnt];        //!< counters of last sample
+      std::vector<sample> fRing;            //!< sample ring buffer
+      uint64_t      fNSample;               //!< total samples taken
+      Rstats        fStats;                 //!< statistics
+  };
+
+} // end namespace Retro
+
+#include "Rw11CpuPerfCnt.ipp"
+
+#endif
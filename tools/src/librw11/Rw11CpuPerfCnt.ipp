@@ -0,0 +1,57 @@
+// $Id: Rw11CpuPerfCnt.ipp 1299 2026-10-19 17:31:05Z mueller $
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// 
+// Revision History: 
+// Date         Rev Version  Comment
+// 2026-10-19  1299   1.0    Initial version
+// ---------------------------------------------------------------------------
+
+/*!
+  \brief   Implemenation (inline) of Rw11CpuPerfCnt.
+*/
+
+// all method definitions in namespace Retro
+namespace Retro {
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+inline Rw11Cpu& Rw11CpuPerfCnt::Cpu() const
+{
+  return *fpCpu;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+inline bool Rw11CpuPerfCnt::IsActive() const
+{
+  return fActive;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+inline const Rtime& Rw11CpuPerfCnt::Period() const
+{
+  return fPeriod;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+inline uint64_t Rw11CpuPerfCnt::NSample() const
+{
+  return fNSample;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+inline Rstats& Rw11CpuPerfCnt::Stats()
+{
+  return fStats;
+}
+
+} // end namespace Retro
@@ -0,0 +1,343 @@
+// $Id: Rw11CpuProfiler.cpp 1298 2026-10-19 16:02:44Z mueller $
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// 
+// Revision History: 
+// Date         Rev Version  Comment
+// 2026-10-19  1306   1.0.1  Sample(): keep user suspend; TSample in usec
+// 2026-10-19  1298   1.0    Initial version
+// ---------------------------------------------------------------------------
+
+/*!
+  \brief   Implemenation of Rw11CpuProfiler.
+*/
+
+#include <stdio.h>
+#include <errno.h>
+
+#include <algorithm>
+#include <mutex>
+
+#include "librtools/RosFill.hpp"
+#include "librtools/RosPrintf.hpp"
+#include "librtools/RlogMsg.hpp"
+#include "librtools/Rtools.hpp"
+#include "librlink/RlinkCommandList.hpp"
+
+#include "Rw11Cpu.hpp"
+
+#include "Rw11CpuProfiler.hpp"
+
+using namespace std;
+
+/*!
+  \class Retro::Rw11CpuProfiler
+  \brief Statistical guest pc profiler.
+
+  Samples pc and psw of the running cpu periodically from a timer in the
+  rlink server event loop and accumulates a histogram per cpu mode (psw cm
+  field) and pc. Two sampling methods are available
+  - if the cpu has a dmcmon the pc of the last instruction is read from
+    cm.ipc and the psw via ibus. The cpu is not disturbed, but pc and psw
+    are not read atomically, at a mode switch a sample may be attributed
+    to the wrong mode.
+  - otherwise, or when requested, the cpu is suspended, pc and psw are
+    read and the cpu is resumed, all in one rlink transaction.
+
+  Samples are skipped while the cpu is not active. The time spent per
+  sample is averaged, and the effective sampling period is stretched such
+  that sample time / period stays below the overhead budget.
+*/
+
+// all method definitions in namespace Retro
+namespace Retro {
+
+//------------------------------------------+-----------------------------------
+// constants definitions
+
+const size_t   Rw11CpuProfiler::kNMode;
+const size_t   Rw11CpuProfiler::kNPc;
+
+//------------------------------------------+-----------------------------------
+//! Constructor
+
+Rw11CpuProfiler::Rw11CpuProfiler(Rw11Cpu* pcpu)
+  : fpCpu(pcpu),
+    fActive(false),
+    fSusp(false),
+    fPeriod(),
+    fPeriodEff(),
+    fBudget(0.),
+    fTSampleAvg(0.),
+    fTimer("Rw11CpuProfiler::fTimer."),
+    fHist(kNMode*kNPc, 0),
+    fNSample(0),
+    fStats()
+{
+  fStats.Define(kStatNSample,     "NSample",     "samples taken");
+  fStats.Define(kStatNSampleIdle, "NSampleIdle", "samples skipped: cpu idle");
+  fStats.Define(kStatNSampleErr,  "NSampleErr",  "samples failed");
+  fStats.Define(kStatNPeriodAdj,  "NPeriodAdj",  "period adjusts for budget");
+  fStats.Define(kStatTSample,     "TSample",     "time spent sampling (us)");
+}
+
+//------------------------------------------+-----------------------------------
+//! Destructor
+
+Rw11CpuProfiler::~Rw11CpuProfiler()
+{
+  if (fTimer.IsOpen())
+    Rtools::Catch2Cerr(__func__, [this](){ StopTimer(); } );
+}
+
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Start sampling.
+
+  \param period  requested sampling period
+  \param budget  overhead budget as fraction of time, no limit when zero
+  \param susp    force suspend/resume sampling method
+  \param emsg    error message
+
+  The histogram is not cleared, sampling can be stopped and resumed.
+ */
+
+bool Rw11CpuProfiler::Start(const Rtime& period, double budget, bool susp,
+                            RerrMsg& emsg)
+{
+  if (!period.IsPositive()) {
+    emsg.Init("Rw11CpuProfiler::Start", "period must be positive");
+    return false;
+  }
+  if (budget < 0. || budget >= 1.) {
+    emsg.Init("Rw11CpuProfiler::Start", "budget must be in [0,1)");
+    return false;
+  }
+  if (fActive) Stop();
+
+  fSusp       = susp || !Cpu().HasCmon();
+  fPeriod     = period;
+  fPeriodEff  = period;
+  fBudget     = budget;
+  fTSampleAvg = 0.;
+  fActive     = true;
+
+  fTimer.Open();
+  Cpu().Server().AddPollHandler([this](const pollfd& pfd)
+                                  { return TimerHandler(pfd); },
+                                fTimer.Fd(), POLLIN);
+  fTimer.SetRelative(fPeriodEff);
+  return true;
+}
+
+//------------------------------------------+-----------------------------------
+//! Stop sampling.
+
+void Rw11CpuProfiler::Stop()
+{
+  StopTimer();
+  fActive = false;
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+//! Clear histogram.
+
+void Rw11CpuProfiler::Clear()
+{
+  fill(fHist.begin(), fHist.end(), 0);
+  fNSample = 0;
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+//! Returns estimated overhead, average sample time over effective period.
+
+double Rw11CpuProfiler::Overhead() const
+{
+  double period = fPeriodEff.ToDouble();
+  return (period > 0.) ? fTSampleAvg/period : 0.;
+}
+
+//------------------------------------------+-----------------------------------
+//! Returns non-empty histogram bins, sorted by decreasing count.
+
+void Rw11CpuProfiler::GetHist(std::vector<entry>& hist) const
+{
+  hist.clear();
+  for (size_t i=0; i<fHist.size(); i++) {
+    if (fHist[i] == 0) continue;
+    hist.push_back({uint16_t(i/kNPc), uint16_t(2*(i%kNPc)), fHist[i]});
+  }
+  stable_sort(hist.begin(), hist.end(),
+              [](const entry& a, const entry& b)
+                { return a.fCount > b.fCount; });
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Write histogram as text file.
+
+  Lines starting with '#' are comments, data lines contain mode (k,s,i,u),
+  pc (octal) and sample count, sorted by decreasing count.
+ */
+
+bool Rw11CpuProfiler::WriteFile(const std::string& fname,
+                                RerrMsg& emsg) const
+{
+  FILE* fout = ::fopen(fname.c_str(), "w");
+  if (fout == nullptr) {
+    emsg.InitErrno("Rw11CpuProfiler::WriteFile",
+                   string("fopen() for '") + fname + "' failed: ", errno);
+    return false;
+  }
+
+  static const char* modnam = "ksiu";
+  vector<entry> hist;
+  GetHist(hist);
+  ::fprintf(fout, "# w11 cpu profile\n");
+  ::fprintf(fout, "# method   %s\n", fSusp ? "susp" : "cmon");
+  ::fprintf(fout, "# period   %.6f  eff %.6f  budget %.4f  overhead %.4f\n",
+            fPeriod.ToDouble(), fPeriodEff.ToDouble(), fBudget, Overhead());
+  ::fprintf(fout, "# nsample  %llu\n", (unsigned long long)fNSample);
+  ::fprintf(fout, "# mode     pc  count\n");
+  for (auto& e : hist) {
+    ::fprintf(fout, "%c  %6.6o  %u\n", modnam[e.fMode], e.fPc, e.fCount);
+  }
+
+  if (::fclose(fout) != 0) {
+    emsg.InitErrno("Rw11CpuProfiler::WriteFile", "fclose() failed: ", errno);
+    return false;
+  }
+  return true;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+void Rw11CpuProfiler::Dump(std::ostream& os, int ind, const char* text,
+                           int detail) const
+{
+  RosFill bl(ind);
+  os << bl << (text?text:"--") << "Rw11CpuProfiler @ " << this << endl;
+
+  os << bl << "  fpCpu:           " << fpCpu << endl;
+  os << bl << "  fActive:         " << RosPrintf(fActive) << endl;
+  os << bl << "  fSusp:           " << RosPrintf(fSusp) << endl;
+  os << bl << "  fPeriod:         " << fPeriod << endl;
+  os << bl << "  fPeriodEff:      " << fPeriodEff << endl;
+  os << bl << "  fBudget:         " << fBudget << endl;
+  os << bl << "  fTSampleAvg:     " << fTSampleAvg << endl;
+  os << bl << "  fTimer:          " << fTimer.Fd() << endl;
+  os << bl << "  fNSample:        " << fNSample << endl;
+  fStats.Dump(os, ind+2, "fStats: ", detail-1);
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+//! Handler for sampling timer, runs in server context.
+
+int Rw11CpuProfiler::TimerHandler(const pollfd& pfd)
+{
+  // bail-out and cancel handler if poll returns an error event
+  if (pfd.revents & (~pfd.events)) return -1;
+
+  fTimer.Read();                            // harvest expiration count
+
+  // lock connect to protect profiler state against Tcl side accesses
+  lock_guard<RlinkConnect> lock(Cpu().Connect());
+  if (!fActive) return 0;
+
+  if (Cpu().CpuAct()) {
+    RerrMsg emsg;
+    if (!Sample(emsg)) {
+      fStats.Inc(kStatNSampleErr);
+      RlogMsg lmsg(Cpu().LogFile());
+      lmsg << "-E prof: sample failed: " << emsg;
+    }
+  } else {
+    fStats.Inc(kStatNSampleIdle);
+  }
+
+  fTimer.SetRelative(fPeriodEff);
+  return 0;
+}
+
+//------------------------------------------+-----------------------------------
+//! Take one pc/psw sample.
+
+bool Rw11CpuProfiler::Sample(RerrMsg& emsg)
+{
+  uint16_t base = Cpu().Base();
+  RlinkCommandList clist;
+  size_t ipc;
+  size_t ipsw;
+  Rtime tbeg(CLOCK_MONOTONIC);
+
+  if (fSusp) {
+    // check cpu state first, a cpu suspended by the user must stay suspended.
+    // The connect lock is held, so the state can't change before sampling.
+    size_t istat = clist.AddRreg(base+Rw11Cpu::kCPSTAT);
+    if (!Cpu().Server().Exec(clist, emsg)) return false;
+    uint16_t cpstat = clist[istat].Data();
+    if (!(cpstat & Rw11Cpu::kCPSTAT_M_CpuGo) ||
+        (cpstat & Rw11Cpu::kCPSTAT_M_CpuSusp)) {
+      fStats.Inc(kStatNSampleIdle);
+      return true;
+    }
+    clist.Clear();
+    clist.AddWreg(base+Rw11Cpu::kCPCNTL, Rw11Cpu::kCPFUNC_SUSPEND);
+    ipc  = clist.AddRreg(base+Rw11Cpu::kCPPC);
+    ipsw = clist.AddRreg(base+Rw11Cpu::kCPPSW);
+    clist.AddWreg(base+Rw11Cpu::kCPCNTL, Rw11Cpu::kCPFUNC_RESUME);
+  } else {
+    ipc  = clist.AddRreg(base+Rw11Cpu::kCMBASE+Rw11Cpu::kCMIPC);
+    ipsw = Cpu().AddRibr(clist, Rw11Cpu::kCPUPSW);
+  }
+
+  if (!Cpu().Server().Exec(clist, emsg)) return false;
+  double dt = (Rtime(CLOCK_MONOTONIC) - tbeg).ToDouble();
+
+  uint16_t pc   = clist[ipc].Data();
+  uint16_t mode = (clist[ipsw].Data() >> 14) & 0x3;
+  uint32_t& bin = fHist[mode*kNPc + pc/2];
+  if (bin != 0xffffffff) bin += 1;
+  fNSample += 1;
+  fStats.Inc(kStatNSample);
+  fStats.Inc(kStatTSample, 1.e6*dt);
+  AdjustPeriod(dt);
+  return true;
+}
+
+//------------------------------------------+-----------------------------------
+//! Update average sample time and stretch period to stay within budget.
+
+void Rw11CpuProfiler::AdjustPeriod(double dt)
+{
+  fTSampleAvg = (fTSampleAvg > 0.) ? 0.875*fTSampleAvg + 0.125*dt : dt;
+  if (fBudget <= 0.) return;
+
+  double preq = fPeriod.ToDouble();
+  double peff = max(preq, fTSampleAvg/fBudget);
+  double pcur = fPeriodEff.ToDouble();
+  // only adjust on 10% change to avoid jitter in effective period
+  if (peff > 1.1*pcur || peff < 0.9*pcur) {
+    fPeriodEff = Rtime(peff);
+    fStats.Inc(kStatNPeriodAdj);
+  }
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+//! Stop sampling timer and remove its poll handler.
+
+void Rw11CpuProfiler::StopTimer()
+{
+  if (!fTimer.IsOpen()) return;
+  Cpu().Server().RemovePollHandler(fTimer.Fd());
+  fTimer.Close();
+  return;
+}
+
+} // end namespace Retro
@@ -0,0 +1,108 @@
+// $Id: Rw11CpuProfiler.hpp 1298 2026-10-19 16:02:44Z mueller $
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// 
+// Revision History: 
+// Date         Rev Version  Comment
+// 2026-10-19  1306   1.0.1  Sample(): keep user suspend; TSample in usec
+// 2026-10-19  1298   1.0    Initial version
+// ---------------------------------------------------------------------------
+
+
+/*!
+  \brief   Declaration of class Rw11CpuProfiler.
+*/
+
+#ifndef included_Retro_Rw11CpuProfiler
+#define included_Retro_Rw11CpuProfiler 1
+
+#include <poll.h>
+
+#include <string>
+#include <vector>
+#include <ostream>
+
+#include "librtools/Rstats.hpp"
+#include "librtools/RerrMsg.hpp"
+#include "librtools/Rtime.hpp"
+#include "librtools/RtimerFd.hpp"
+
+namespace Retro {
+
+  class Rw11Cpu;                            // forw decl to avoid circular incl
+
+  class Rw11CpuProfiler {
+    public:
+      struct entry {
+        uint16_t    fMode;                  //!< cpu mode (psw cm field)
+        uint16_t    fPc;                    //!< pc
+        uint32_t    fCount;                 //!< number of samples
+      };
+
+      explicit      Rw11CpuProfiler(Rw11Cpu* pcpu);
+                   ~Rw11CpuProfiler();
+
+                    Rw11CpuProfiler(const Rw11CpuProfiler&) = delete;
+      Rw11CpuProfiler& operator=(const Rw11CpuProfiler&) = delete;
+
+      Rw11Cpu&      Cpu() const;
+
+      bool          Start(const Rtime& period, double budget, bool susp,
+                          RerrMsg& emsg);
+      void          Stop();
+      void          Clear();
+      bool          IsActive() const;
+      bool          UseSuspend() const;
+
+      const Rtime&  Period() const;
+      const Rtime&  PeriodEff() const;
+      double        Budget() const;
+      double        Overhead() const;
+      uint64_t      NSample() const;
+
+      void          GetHist(std::vector<entry>& hist) const;
+      bool          WriteFile(const std::string& fname, RerrMsg& emsg) const;
+
+      Rstats&       Stats();
+      void          Dump(std::ostream& os, int ind=0, const char* text=0,
+                         int detail=0) const;
+
+    // some constants (also defined in cpp)
+      static const size_t   kNMode = 4;     //!< number of psw cm codes
+      static const size_t   kNPc   = 32768; //!< number of (even) pc values
+
+    // statistics counter indices
+      enum stats {
+        kStatNSample = 0,                   //!< samples taken
+        kStatNSampleIdle,                   //!< samples skipped, cpu not active
+        kStatNSampleErr,                    //!< samples failed
+        kStatNPeriodAdj,                    //!< period adjusts for budget
+        kStatTSample,                       //!< time spent in sampling (us)
+        kDimStat
+      };
+
+    protected:
+      int           TimerHandler(const pollfd& pfd);
+      bool          Sample(RerrMsg& emsg);
+      void          AdjustPeriod(double dt);
+      void          StopTimer();
+
+    protected:
+      Rw11Cpu*      fpCpu;                  //!< cpu back pointer
+      bool          fActive;                //!< sampling active
+      bool          fSusp;                  //!< sample via suspend/resume
+      Rtime         fPeriod;                //!< requested sampling period
+      Rtime         fPeriodEff;             //!< effective sampling period
+      double        fBudget;                //!< overhead budget (fraction)
+      double        fTSampleAvg;            //!< average time per sample (sec)
+      RtimerFd      fTimer;                 //!< sampling timer
+      std::vector<uint32_t> fHist;          //!< histogram [mode][pc/2]
+      uint64_t      fNSample;               //!< total samples in histogram
+      Rstats        fStats;                 //!< statistics
+  };
+
+} // end namespace Retro
+
+#include "Rw11CpuProfiler.ipp"
+
+#endif
@@ -0,0 +1,81 @@
+// $Id: Rw11CpuProfiler.ipp 1298 2026-10-19 16:02:44Z mueller $
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// 
+// Revision History: 
+// Date         Rev Version  Comment
+// 2026-10-19  1298   1.0    Initial version
+// ---------------------------------------------------------------------------
+
+/*!
+  \brief   Implemenation (inline) of Rw11CpuProfiler.
+*/
+
+// all method definitions in namespace Retro
+namespace Retro {
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+inline Rw11Cpu& Rw11CpuProfiler::Cpu() const
+{
+  return *fpCpu;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+inline bool Rw11CpuProfiler::IsActive() const
+{
+  return fActive;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+inline bool Rw11CpuProfiler::UseSuspend() const
+{
+  return fSusp;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+inline const Rtime& Rw11CpuProfiler::Period() const
+{
+  return fPeriod;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+inline const Rtime& Rw11CpuProfiler::PeriodEff() const
+{
+  return fPeriodEff;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+inline double Rw11CpuProfiler::Budget() const
+{
+  return fBudget;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+inline uint64_t Rw11CpuProfiler::NSample() const
+{
+  return fNSample;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+inline Rstats& Rw11CpuProfiler::Stats()
+{
+  return fStats;
+}
+
+} // end namespace Retro
@@ -0,0 +1,500 @@
+// $Id: Rw11Dasm.cpp 1303 2026-10-19 21:28:40Z mueller $
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// 
+// Revision History: 
+// Date         Rev Version  Comment
+// 2026-10-19  1303   1.0    Initial version
+// ---------------------------------------------------------------------------
+
+/*!
+  \brief   Implemenation of Rw11Dasm.
+*/
+
+#include <stdio.h>
+
+#include "Rw11Dasm.hpp"
+
+using namespace std;
+
+/*!
+  \namespace Retro::Rw11Dasm
+  \brief PDP-11 disassembler, table driven.
+
+  The opcode table is the one of \c rw11::dasm_opdsc in tcl/rw11/dasm.tcl,
+  the generated text is the same as produced by \c rw11::dasm_iline, so
+  both can be used interchangeably. Mnemonics starting with '!' denote
+  instructions not implemented in the w11.
+
+  On first use a 64k entry table mapping each instruction word to its
+  opcode descriptor is built, after that decoding an instruction is a
+  single table lookup.
+*/
+
+// all method definitions in namespace Retro
+namespace Retro {
+namespace Rw11Dasm {
+
+// instruction types, same as itype in dasm.tcl
+enum itype {
+  k0arg = 0,                                //!< no operand
+  k1arg,                                    //!< dst operand
+  k2arg,                                    //!< src and dst operand
+  kRsrc,                                    //!< register and dst operand
+  kRdst,                                    //!< dst operand and register
+  k1reg,                                    //!< register
+  kBr,                                      //!< branch
+  kSob,                                     //!< sob
+  kTrap,                                    //!< emt and trap
+  kSpl,                                     //!< spl
+  kCcop,                                    //!< condition code operate
+  kMark,                                    //!< mark
+  k1fpp,                                    //!< fpp dst operand
+  kRfpp                                     //!< fpp accumulator and operand
+};
+
+struct opdsc {
+  uint16_t      fCode;                      //!< opcode
+  uint16_t      fMask;                      //!< operand field mask
+  const char*   fName;                      //!< mnemonic
+  itype         fType;                      //!< instruction type
+};
+
+static const opdsc kOpTab[] = {
+  {0000000, 0000000, "halt",    k0arg},
+  {0000001, 0000000, "wait",    k0arg},
+  {0000002, 0000000, "rti",     k0arg},
+  {0000003, 0000000, "bpt",     k0arg},
+  {0000004, 0000000, "iot",     k0arg},
+  {0000005, 0000000, "reset",   k0arg},
+  {0000006, 0000000, "rtt",     k0arg},
+  {0000007, 0000000, "!mfpt",   k0arg},
+  {0000100, 0000077, "jmp",     k1arg},
+  {0000200, 0000007, "rts",     k1reg},
+  {0000230, 0000007, "spl",     kSpl},
+  {0000240, 0000017, "cl",      kCcop},
+  {0000260, 0000017, "se",      kCcop},
+  {0000300, 0000077, "swab",    k1arg},
+  {0000400, 0000377, "br",      kBr},
+  {0001000, 0000377, "bne",     kBr},
+  {0001400, 0000377, "beq",     kBr},
+  {0002000, 0000377, "bge",     kBr},
+  {0002400, 0000377, "blt",     kBr},
+  {0003000, 0000377, "bgt",     kBr},
+  {0003400, 0000377, "ble",     kBr},
+  {0004000, 0000777, "jsr",     kRsrc},
+  {0005000, 0000077, "clr",     k1arg},
+  {0005100, 0000077, "com",     k1arg},
+  {0005200, 0000077, "inc",     k1arg},
+  {0005300, 0000077, "dec",     k1arg},
+  {0005400, 0000077, "neg",     k1arg},
+  {0005500, 0000077, "adc",     k1arg},
+  {0005600, 0000077, "sbc",     k1arg},
+  {0005700, 0000077, "tst",     k1arg},
+  {0006000, 0000077, "ror",     k1arg},
+  {0006100, 0000077, "rol",     k1arg},
+  {0006200, 0000077, "asr",     k1arg},
+  {0006300, 0000077, "asl",     k1arg},
+  {0006400, 0000077, "mark",    kMark},
+  {0006500, 0000077, "mfpi",    k1arg},
+  {0006600, 0000077, "mtpi",    k1arg},
+  {0006700, 0000077, "sxt",     k1arg},
+  {0007000, 0000077, "!csm",    k1arg},
+  {0007200, 0000077, "!tstset", k1arg},
+  {0007300, 0000077, "!wrtlck", k1arg},
+  {0010000, 0007777, "mov",     k2arg},
+  {0020000, 0007777, "cmp",     k2arg},
+  {0030000, 0007777, "bit",     k2arg},
+  {0040000, 0007777, "bic",     k2arg},
+  {0050000, 0007777, "bis",     k2arg},
+  {0060000, 0007777, "add",     k2arg},
+  {0070000, 0000777, "mul",     kRdst},
+  {0071000, 0000777, "div",     kRdst},
+  {0072000, 0000777, "ash",     kRdst},
+  {0073000, 0000777, "ashc",    kRdst},
+  {0074000, 0000777, "xor",     kRsrc},
+  {0077000, 0000777, "sob",     kSob},
+  {0100000, 0000377, "bpl",     kBr},
+  {0100400, 0000377, "bmi",     kBr},
+  {0101000, 0000377, "bhi",     kBr},
+  {0101400, 0000377, "blos",    kBr},
+  {0102000, 0000377, "bvc",     kBr},
+  {0102400, 0000377, "bvs",     kBr},
+  {0103000, 0000377, "bcc",     kBr},
+  {0103400, 0000377, "bcs",     kBr},
+  {0104000, 0000377, "emt",     kTrap},
+  {0104400, 0000377, "trap",    kTrap},
+  {0105000, 0000077, "clrb",    k1arg},
+  {0105100, 0000077, "comb",    k1arg},
+  {0105200, 0000077, "incb",    k1arg},
+  {0105300, 0000077, "decb",    k1arg},
+  {0105400, 0000077, "negb",    k1arg},
+  {0105500, 0000077, "adcb",    k1arg},
+  {0105600, 0000077, "sbcb",    k1arg},
+  {0105700, 0000077, "tstb",    k1arg},
+  {0106000, 0000077, "rorb",    k1arg},
+  {0106100, 0000077, "rolb",    k1arg},
+  {0106200, 0000077, "asrb",    k1arg},
+  {0106300, 0000077, "aslb",    k1arg},
+  {0106400, 0000077, "!mtps",   k1arg},
+  {0106500, 0000077, "mfpd",    k1arg},
+  {0106600, 0000077, "mtpd",    k1arg},
+  {0106700, 0000077, "!mfps",   k1arg},
+  {0110000, 0007777, "movb",    k2arg},
+  {0120000, 0007777, "cmpb",    k2arg},
+  {0130000, 0007777, "bitb",    k2arg},
+  {0140000, 0007777, "bicb",    k2arg},
+  {0150000, 0007777, "bisb",    k2arg},
+  {0160000, 0007777, "sub",     k2arg},
+  {0170000, 0000000, "!cfcc",   k0arg},
+  {0170001, 0000000, "!setf",   k0arg},
+  {0170011, 0000000, "!setd",   k0arg},
+  {0170002, 0000000, "!seti",   k0arg},
+  {0170012, 0000000, "!setl",   k0arg},
+  {0170100, 0000077, "!ldfps",  k1fpp},
+  {0170200, 0000077, "!stfps",  k1fpp},
+  {0170300, 0000077, "!stst",   k1fpp},
+  {0170400, 0000077, "!clrf",   k1fpp},
+  {0170500, 0000077, "!tstf",   k1fpp},
+  {0170600, 0000077, "!absf",   k1fpp},
+  {0170700, 0000077, "!negf",   k1fpp},
+  {0171000, 0000377, "!mulf",   kRfpp},
+  {0171400, 0000377, "!modf",   kRfpp},
+  {0172000, 0000377, "!addf",   kRfpp},
+  {0172400, 0000377, "!ldf",    kRfpp},
+  {0173000, 0000377, "!subf",   kRfpp},
+  {0173400, 0000377, "!cmpf",   kRfpp},
+  {0174000, 0000377, "!stf",    kRfpp},
+  {0174400, 0000377, "!divf",   kRfpp},
+  {0175000, 0000377, "!stexp",  kRfpp},
+  {0175400, 0000377, "!stcif",  kRfpp},
+  {0176000, 0000377, "!stcfd",  kRfpp},
+  {0176400, 0000377, "!ldexp",  kRfpp},
+  {0177000, 0000377, "!ldcif",  kRfpp},
+  {0177400, 0000377, "!ldcdf",  kRfpp},
+};
+
+static const size_t kNOpTab = sizeof(kOpTab)/sizeof(kOpTab[0]);
+
+struct vecdsc {
+  uint16_t      fVec;                       //!< vector address
+  const char*   fName;                      //!< device or trap name
+};
+
+static const vecdsc kVecTab[] = {
+  {0004, "iit"   },
+  {0010, "rit"   },
+  {0014, "bpt"   },
+  {0020, "iot"   },
+  {0024, "pwr"   },
+  {0030, "emt"   },
+  {0034, "trp"   },
+  {0060, "dla-r" },
+  {0064, "dla-t" },
+  {0070, "pc-r"  },
+  {0074, "pc-p"  },
+  {0100, "kw-l"  },
+  {0104, "kw-p"  },
+  {0114, "mse"   },
+  {0120, "deuna" },
+  {0160, "rla"   },
+  {0200, "lpa"   },
+  {0220, "rka"   },
+  {0224, "tma"   },
+  {0240, "pir"   },
+  {0244, "fpp"   },
+  {0250, "mmu"   },
+  {0254, "rpa"   },
+  {0260, "iist"  },
+  {0300, "dlb-r" },
+  {0304, "dlb-t" },
+  {0310, "dza-r" },
+  {0314, "dza-t" },
+};
+
+//------------------------------------------+-----------------------------------
+// returns the opcode map, built on first call (index into kOpTab or 0xff)
+
+static const uint8_t* OpMap()
+{
+  static const vector<uint8_t> map = []() {
+    vector<uint8_t> m(0x10000, 0xff);
+    for (size_t i=0; i<kNOpTab; i++) {
+      const opdsc& d = kOpTab[i];
+      for (uint32_t o=0; o<=d.fMask; o++) {
+        if ((o & d.fMask) != o) continue;   // only bits within mask
+        m[d.fCode | o] = uint8_t(i);
+      }
+    }
+    return m;
+  }();
+  return map.data();
+}
+
+//------------------------------------------+-----------------------------------
+// appends the register name
+
+static void AddReg(string& txt, uint16_t reg)
+{
+  static const char* kRegNam[8] = {"r0","r1","r2","r3","r4","r5","sp","pc"};
+  txt += kRegNam[reg & 07];
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+// appends an index or immediate word, or 'n' if not available
+
+static void AddWord(string& txt, const uint16_t* pw, size_t nw, size_t& nuse)
+{
+  if (nuse+1 < nw) {
+    char buf[8];
+    ::snprintf(buf, sizeof(buf), "%6.6o", unsigned(pw[nuse+1]));
+    txt += buf;
+    nuse += 1;
+  } else {
+    txt += 'n';
+  }
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+// appends an operand, same as dasm_regmod
+
+static void AddRegMod(string& txt, uint16_t regmod, bool fpp,
+                      const uint16_t* pw, size_t nw, size_t& nuse)
+{
+  uint16_t mod = (regmod >> 3) & 07;
+  uint16_t reg =  regmod       & 07;
+  switch (mod) {
+  case 0:
+    if (fpp && reg <= 5) {
+      txt += 'f';
+      txt += char('0'+reg);
+    } else {
+      AddReg(txt, reg);
+    }
+    break;
+  case 1:
+    txt += '(';  AddReg(txt, reg); txt += ')';
+    break;
+  case 2:
+    if (reg != 7) {
+      txt += '(';  AddReg(txt, reg); txt += ")+";
+    } else {
+      txt += '#';  AddWord(txt, pw, nw, nuse);
+    }
+    break;
+  case 3:
+    if (reg != 7) {
+      txt += "@(";  AddReg(txt, reg); txt += ")+";
+    } else {
+      txt += "@#";  AddWord(txt, pw, nw, nuse);
+    }
+    break;
+  case 4:
+    txt += "-(";  AddReg(txt, reg); txt += ')';
+    break;
+  case 5:
+    txt += "@-(";  AddReg(txt, reg); txt += ')';
+    break;
+  case 6:
+    AddWord(txt, pw, nw, nuse);
+    txt += '(';  AddReg(txt, reg); txt += ')';
+    break;
+  case 7:
+    txt += '@';  AddWord(txt, pw, nw, nuse);
+    txt += '(';  AddReg(txt, reg); txt += ')';
+    break;
+  }
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+// appends an octal number with ndig digits
+
+static void AddOct(string& txt, unsigned val, int ndig)
+{
+  char buf[16];
+  ::snprintf(buf, sizeof(buf), "%*.*o", ndig, ndig, val);
+  txt += buf;
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Disassemble one instruction.
+
+  \param pw   pointer to instruction word, followed by index and immediate
+              words if available
+  \param nw   number of words available at \a pw, must be at least 1
+  \param txt  instruction text
+  \returns number of words used, 1 to 3
+
+  Index and immediate words beyond \a nw are shown as 'n', as done by
+  \c rw11::dasm_iline when no rilist is given. Unknown opcodes give a text
+  of the form '?ooooooo?'.
+ */
+
+size_t Inst2Txt(const uint16_t* pw, size_t nw, std::string& txt)
+{
+  txt.clear();
+  uint16_t ireg = pw[0];
+  uint8_t  iop  = OpMap()[ireg];
+  if (iop == 0xff) {
+    txt += '?';
+    AddOct(txt, ireg, 6);
+    txt += '?';
+    return 1;
+  }
+
+  const opdsc& d = kOpTab[iop];
+  uint16_t src  = (ireg >> 6) & 077;
+  uint16_t dst  =  ireg       & 077;
+  uint16_t reg6 = (ireg >> 6) &  07;
+  uint16_t reg0 =  ireg       &  07;
+  size_t   nuse = 0;
+
+  // Note on br and sob: offsets are expressed as ". +- nnn" where . is the
+  // pc of the instruction, as in dasm_iline and the assembler
+  txt += d.fName;
+  switch (d.fType) {
+  case k0arg:
+    break;
+  case k1arg:
+    txt += ' ';
+    AddRegMod(txt, dst, false, pw, nw, nuse);
+    break;
+  case k2arg:
+    txt += ' ';
+    AddRegMod(txt, src, false, pw, nw, nuse);
+    txt += ',';
+    AddRegMod(txt, dst, false, pw, nw, nuse);
+    break;
+  case kRsrc:
+    txt += ' ';
+    AddReg(txt, reg6);
+    txt += ',';
+    AddRegMod(txt, dst, false, pw, nw, nuse);
+    break;
+  case kRdst:
+    txt += ' ';
+    AddRegMod(txt, dst, false, pw, nw, nuse);
+    txt += ',';
+    AddReg(txt, reg6);
+    break;
+  case k1reg:
+    txt += ' ';
+    AddReg(txt, reg0);
+    break;
+  case kBr:
+    if (ireg & 0200) {
+      int off = ((~ireg) & 0177) + 1;
+      txt += " .-" + to_string((off - 1) * 2);
+    } else {
+      int off = ireg & 0177;
+      txt += " .+" + to_string((off + 1) * 2);
+    }
+    break;
+  case kSob:
+    txt += ' ';
+    AddReg(txt, reg6);
+    txt += ",.-" + to_string((int(ireg & 0077) - 1) * 2);
+    break;
+  case kTrap:
+    txt += ' ';
+    AddOct(txt, ireg & 0377, 3);
+    break;
+  case kSpl:
+    txt += ' ';
+    txt += char('0' + (ireg & 07));
+    txt += ' ';
+    break;
+  case kCcop: {
+    if ((ireg & 017) == 0) {
+      txt = "nop";
+    } else if (ireg == 0257) {
+      txt = "ccc";
+    } else if (ireg == 0277) {
+      txt = "scc";
+    } else {
+      string name = txt;
+      txt.clear();
+      static const char kFlag[4] = {'n','z','v','c'};
+      for (int i=0; i<4; i++) {
+        if ((ireg & (010 >> i)) == 0) continue;
+        if (!txt.empty()) txt += '+';
+        txt += name;
+        txt += kFlag[i];
+      }
+    }
+    break;
+  }
+  case kMark:
+    txt += ' ';
+    AddOct(txt, ireg & 0077, 3);
+    break;
+  case k1fpp:
+    txt += ' ';
+    AddRegMod(txt, dst, true, pw, nw, nuse);
+    break;
+  case kRfpp:
+    txt += " f";
+    txt += char('0' + ((ireg >> 6) & 03));
+    txt += ',';
+    AddRegMod(txt, dst, true, pw, nw, nuse);
+    break;
+  }
+
+  return nuse + 1;
+}
+
+//------------------------------------------+-----------------------------------
+//! Disassemble an instruction word alone, same as rw11::dasm_ireg2txt.
+
+std::string Ireg2Txt(uint16_t ireg)
+{
+  string txt;
+  Inst2Txt(&ireg, 1, txt);
+  return txt;
+}
+
+//------------------------------------------+-----------------------------------
+//! Returns name for vector \a vec, or an empty string if not known.
+
+const char* Vec2Txt(uint16_t vec)
+{
+  for (auto& v : kVecTab) if (v.fVec == vec) return v.fName;
+  return "";
+}
+
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Disassemble a buffer of words.
+
+  \param addr  address of first word
+  \param pw    pointer to words
+  \param nw    number of words
+  \param list  one line per instruction, cleared first
+
+  Index and immediate words are consumed as given by the instruction. The
+  last instruction can be incomplete, missing words are shown as 'n'.
+ */
+
+void Buffer(uint32_t addr, const uint16_t* pw, size_t nw,
+            std::vector<line>& list)
+{
+  list.clear();
+  list.reserve(nw);
+  size_t i = 0;
+  while (i < nw) {
+    line l;
+    l.fAddr = addr + 2*uint32_t(i);
+    l.fNWrd = uint16_t(Inst2Txt(pw+i, nw-i, l.fText));
+    i += l.fNWrd;
+    list.push_back(move(l));
+  }
+  return;
+}
+
+} // end namespace Rw11Dasm
+} // end namespace Retro
@@ -0,0 +1,41 @@
+// $Id: Rw11Dasm.hpp 1303 2026-10-19 21:28:40Z mueller $
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// 
+// Revision History: 
+// Date         Rev Version  Comment
+// 2026-10-19  1303   1.0    Initial version
+// ---------------------------------------------------------------------------
+
+/*!
+  \brief   Declaration of Rw11Dasm, the PDP-11 disassembler.
+*/
+
+#ifndef included_Retro_Rw11Dasm
+#define included_Retro_Rw11Dasm 1
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Retro {
+
+  namespace Rw11Dasm {
+    // one disassembled instruction
+    struct line {
+      uint32_t      fAddr;                  //!< address of first word
+      uint16_t      fNWrd;                  //!< words used (1 to 3)
+      std::string   fText;                  //!< instruction text
+    };
+
+    size_t         Inst2Txt(const uint16_t* pw, size_t nw, std::string& txt);
+    std::string    Ireg2Txt(uint16_t ireg);
+    const char*    Vec2Txt(uint16_t vec);
+    void           Buffer(uint32_t addr, const uint16_t* pw, size_t nw,
+                          std::vector<line>& list);
+
+  } // end namespace Rw11Dasm
+
+} // end namespace Retro
+
+#endif
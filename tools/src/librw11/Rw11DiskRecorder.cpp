@@ -0,0 +1,258 @@
+// $Id: Rw11DiskRecorder.cpp 1302 2026-10-19 20:41:12Z mueller $
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// 
+// Revision History: 
+// Date         Rev Version  Comment
+// 2026-10-19  1306   1.0.1  doc: Add() also called from writer thread
+// 2026-10-19  1302   1.0    Initial version
+// ---------------------------------------------------------------------------
+
+/*!
+  \brief   Implemenation of Rw11DiskRecorder.
+*/
+
+#include <time.h>
+#include <string.h>
+
+#include "librtools/RosFill.hpp"
+#include "librtools/RosPrintf.hpp"
+
+#include "Rw11DiskRecorder.hpp"
+
+using namespace std;
+
+/*!
+  \class Retro::Rw11DiskRecorder
+  \brief Records the backend accesses of a disk unit to a file.
+
+  Rw11UnitDisk calls Add() for each VirtRead() and VirtWrite() while a
+  recorder is attached. The records are buffered and written in chunks of
+  kNBuf records. Add() is called in the server thread or with the connect
+  lock held, and for overlapped writes in the writer thread of the unit.
+  The unit drains the writer before any other access and takes the unit's
+  async lock with the writer idle for Dump(), so Rw11DiskRecorder itself
+  does no locking.
+
+  The file has a 48 byte header, the magic "w11dskr1", the record size,
+  block size, number of blocks, cylinders, heads and sectors as uint32,
+  and the drive type as zero padded 16 character string. The header is
+  followed by 24 byte records as defined by struct record, all in host
+  byte order. The number of records is given by the file size. Load()
+  reads such a file, it is used by the dskbench replay tool.
+*/
+
+// all method definitions in namespace Retro
+namespace Retro {
+
+static const char kFileMagic[8] = {'w','1','1','d','s','k','r','1'};
+
+// constants definitions
+const size_t Rw11DiskRecorder::kHdrSize;
+const size_t Rw11DiskRecorder::kRecSize;
+const size_t Rw11DiskRecorder::kNBuf;
+
+//------------------------------------------+-----------------------------------
+//! Default constructor
+
+Rw11DiskRecorder::header::header()
+  : fType(),
+    fBlkSize(0),
+    fNBlock(0),
+    fNCyl(0),
+    fNHead(0),
+    fNSect(0)
+{}
+
+//------------------------------------------+-----------------------------------
+//! Default constructor
+
+Rw11DiskRecorder::Rw11DiskRecorder()
+  : fFile("Rw11DiskRecorder::fFile."),
+    fFName(),
+    fT0(0),
+    fNRecord(0),
+    fNError(0),
+    fBuf()
+{
+  static_assert(sizeof(record) == kRecSize, "bad record size");
+}
+
+//------------------------------------------+-----------------------------------
+//! Destructor
+
+Rw11DiskRecorder::~Rw11DiskRecorder()
+{
+  RerrMsg emsg;
+  Close(emsg);
+}
+
+//------------------------------------------+-----------------------------------
+//! Create record file \a fname and write header, starts the time base.
+
+bool Rw11DiskRecorder::Open(const std::string& fname, const header& hdr,
+                            RerrMsg& emsg)
+{
+  if (!Close(emsg)) return false;
+  if (!fFile.Open(fname.c_str(), O_WRONLY|O_CREAT|O_TRUNC, 0644, emsg))
+    return false;
+
+  uint8_t  buf[kHdrSize];
+  uint32_t val[6] = {uint32_t(kRecSize), hdr.fBlkSize, hdr.fNBlock,
+                     hdr.fNCyl, hdr.fNHead, hdr.fNSect};
+  ::memset(buf, 0, kHdrSize);
+  ::memcpy(buf,    kFileMagic, 8);
+  ::memcpy(buf+8,  val, sizeof(val));
+  ::memcpy(buf+32, hdr.fType.data(), min(hdr.fType.size(), size_t(15)));
+  if (!fFile.WriteAll(buf, kHdrSize, emsg)) {
+    fFile.Close();
+    return false;
+  }
+
+  fFName   = fname;
+  fT0      = TimeNs();
+  fNRecord = 0;
+  fNError  = 0;
+  fBuf.clear();
+  fBuf.reserve(kNBuf);
+  return true;
+}
+
+//------------------------------------------+-----------------------------------
+//! Write pending records and close the record file.
+
+bool Rw11DiskRecorder::Close(RerrMsg& emsg)
+{
+  if (!fFile.IsOpen()) return true;
+  bool ok = Flush(emsg);
+  fFile.Close();
+  return ok;
+}
+
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Add a record for a backend access.
+
+  \param op    kOpRead or kOpWrite
+  \param lba   first block
+  \param nblk  number of blocks
+  \param tbeg  start time of the access as returned by TimeNs()
+  \param ok    access status
+
+  The latency is taken as time from \a tbeg to now. File write errors are
+  counted in NError(), the record chunk is dropped in that case.
+ */
+
+void Rw11DiskRecorder::Add(uint8_t op, size_t lba, size_t nblk, uint64_t tbeg,
+                           bool ok)
+{
+  if (!fFile.IsOpen()) return;
+  uint64_t tend = TimeNs();
+  uint64_t dt   = tend - tbeg;
+  record rec;
+  rec.fTime  = tbeg - fT0;
+  rec.fLba   = uint32_t(lba);
+  rec.fDt    = dt > 0xffffffff ? 0xffffffff : uint32_t(dt);
+  rec.fNBlk  = nblk > 0xffff ? 0xffff : uint16_t(nblk);
+  rec.fOp    = op;
+  rec.fOk    = ok ? 1 : 0;
+  rec.fSpare = 0;
+  fBuf.push_back(rec);
+  fNRecord += 1;
+  if (fBuf.size() >= kNBuf) {
+    RerrMsg emsg;
+    Flush(emsg);
+  }
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+//! Returns CLOCK_MONOTONIC time in ns.
+
+uint64_t Rw11DiskRecorder::TimeNs()
+{
+  struct timespec ts;
+  ::clock_gettime(CLOCK_MONOTONIC, &ts);
+  return uint64_t(ts.tv_sec)*1000000000 + uint64_t(ts.tv_nsec);
+}
+
+//------------------------------------------+-----------------------------------
+//! Load a record file.
+
+bool Rw11DiskRecorder::Load(const std::string& fname, header& hdr,
+                            std::vector<record>& list, RerrMsg& emsg)
+{
+  list.clear();
+  RfileFd fd("Rw11DiskRecorder::Load.fd.");
+  if (!fd.Open(fname.c_str(), O_RDONLY, emsg)) return false;
+  struct stat sbuf;
+  if (!fd.Stat(&sbuf, emsg)) return false;
+
+  uint8_t buf[kHdrSize];
+  if (fd.Read(buf, kHdrSize, emsg) != ssize_t(kHdrSize) ||
+      ::memcmp(buf, kFileMagic, 8) != 0) {
+    if (emsg.Text().empty())
+      emsg.Init("Rw11DiskRecorder::Load",
+                string("'") + fname + "' is not a disk record file");
+    return false;
+  }
+  uint32_t val[6];
+  ::memcpy(val, buf+8, sizeof(val));
+  if (val[0] != kRecSize) {
+    emsg.Init("Rw11DiskRecorder::Load",
+              string("'") + fname + "' has unsupported record size");
+    return false;
+  }
+  hdr.fBlkSize = val[1];
+  hdr.fNBlock  = val[2];
+  hdr.fNCyl    = val[3];
+  hdr.fNHead   = val[4];
+  hdr.fNSect   = val[5];
+  hdr.fType    = string(reinterpret_cast<const char*>(buf+32),
+                        ::strnlen(reinterpret_cast<const char*>(buf+32), 16));
+
+  size_t nrec = (size_t(sbuf.st_size) - kHdrSize) / kRecSize;
+  list.resize(nrec);
+  if (nrec > 0) {
+    ssize_t nbyt = nrec * kRecSize;
+    if (fd.Read(list.data(), nbyt, emsg) != nbyt) {
+      if (emsg.Text().empty())
+        emsg.Init("Rw11DiskRecorder::Load",
+                  string("'") + fname + "' short read");
+      list.clear();
+      return false;
+    }
+  }
+  fd.Close();
+  return true;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+bool Rw11DiskRecorder::Flush(RerrMsg& emsg)
+{
+  if (fBuf.empty()) return true;
+  bool ok = fFile.WriteAll(fBuf.data(), fBuf.size()*kRecSize, emsg);
+  if (!ok) fNError += 1;
+  fBuf.clear();
+  return ok;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+void Rw11DiskRecorder::Dump(std::ostream& os, int ind, const char* text,
+                            int /*detail*/) const
+{
+  RosFill bl(ind);
+  os << bl << (text?text:"--") << "Rw11DiskRecorder @ " << this << endl;
+  os << bl << "  fFile:           " << fFile.Fd() << endl;
+  os << bl << "  fFName:          " << fFName << endl;
+  os << bl << "  fNRecord:        " << fNRecord << endl;
+  os << bl << "  fNError:         " << fNError << endl;
+  os << bl << "  fBuf.size:       " << fBuf.size() << endl;
+  return;
+}
+
+} // end namespace Retro
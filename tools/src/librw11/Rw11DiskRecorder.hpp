@@ -0,0 +1,102 @@
+// $Id: Rw11DiskRecorder.hpp 1302 2026-10-19 20:41:12Z mueller $
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// 
+// Revision History: 
+// Date         Rev Version  Comment
+// 2026-10-19  1302   1.0    Initial version
+// ---------------------------------------------------------------------------
+
+
+/*!
+  \brief   Declaration of class Rw11DiskRecorder.
+*/
+
+#ifndef included_Retro_Rw11DiskRecorder
+#define included_Retro_Rw11DiskRecorder 1
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <ostream>
+
+#include "librtools/RerrMsg.hpp"
+#include "librtools/RfileFd.hpp"
+
+namespace Retro {
+
+  class Rw11DiskRecorder {
+    public:
+    // disk geometry, stored in the file header
+      struct header {
+        std::string fType;                  //!< drive type
+        uint32_t    fBlkSize;               //!< block size in bytes
+        uint32_t    fNBlock;                //!< disk size in blocks
+        uint32_t    fNCyl;                  //!< # cylinder
+        uint32_t    fNHead;                 //!< # heads
+        uint32_t    fNSect;                 //!< # sectors
+                    header();
+      };
+
+    // one backend access, as stored in the file
+      struct record {
+        uint64_t    fTime;                  //!< start time (ns since Open)
+        uint32_t    fLba;                   //!< first block
+        uint32_t    fDt;                    //!< backend latency (ns)
+        uint16_t    fNBlk;                  //!< number of blocks
+        uint8_t     fOp;                    //!< kOpRead or kOpWrite
+        uint8_t     fOk;                    //!< 1 if access succeeded
+        uint32_t    fSpare;                 //!< spare, 0
+      };
+
+      enum op {
+        kOpRead  = 0,                       //!< VirtRead
+        kOpWrite = 1                        //!< VirtWrite
+      };
+
+                    Rw11DiskRecorder();
+                   ~Rw11DiskRecorder();
+
+                    Rw11DiskRecorder(const Rw11DiskRecorder&) = delete;
+      Rw11DiskRecorder& operator=(const Rw11DiskRecorder&) = delete;
+
+      bool          Open(const std::string& fname, const header& hdr,
+                         RerrMsg& emsg);
+      bool          Close(RerrMsg& emsg);
+      bool          IsOpen() const;
+      const std::string& FileName() const;
+
+      void          Add(uint8_t op, size_t lba, size_t nblk, uint64_t tbeg,
+                        bool ok);
+      uint64_t      NRecord() const;
+      uint64_t      NError() const;
+
+      static uint64_t TimeNs();
+      static bool   Load(const std::string& fname, header& hdr,
+                         std::vector<record>& list, RerrMsg& emsg);
+
+      void          Dump(std::ostream& os, int ind=0, const char* text=0,
+                         int detail=0) const;
+
+    // some constants (also defined in cpp)
+      static const size_t kHdrSize = 48;    //!< file header size
+      static const size_t kRecSize = 24;    //!< file record size
+      static const size_t kNBuf    = 256;   //!< records buffered before write
+
+    protected:
+      bool          Flush(RerrMsg& emsg);
+
+    protected:
+      RfileFd       fFile;                  //!< record file
+      std::string   fFName;                 //!< record file name
+      uint64_t      fT0;                    //!< time of Open (ns)
+      uint64_t      fNRecord;               //!< records added
+      uint64_t      fNError;                //!< file write errors
+      std::vector<record> fBuf;             //!< records pending for file
+  };
+
+} // end namespace Retro
+
+#include "Rw11DiskRecorder.ipp"
+
+#endif
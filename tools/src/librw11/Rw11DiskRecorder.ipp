@@ -0,0 +1,49 @@
+// $Id: Rw11DiskRecorder.ipp 1302 2026-10-19 20:41:12Z mueller $
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// 
+// Revision History: 
+// Date         Rev Version  Comment
+// 2026-10-19  1302   1.0    Initial version
+// ---------------------------------------------------------------------------
+
+/*!
+  \brief   Implemenation (inline) of Rw11DiskRecorder.
+*/
+
+// all method definitions in namespace Retro
+namespace Retro {
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+inline bool Rw11DiskRecorder::IsOpen() const
+{
+  return fFile.IsOpen();
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+inline const std::string& Rw11DiskRecorder::FileName() const
+{
+  return fFName;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+inline uint64_t Rw11DiskRecorder::NRecord() const
+{
+  return fNRecord;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+inline uint64_t Rw11DiskRecorder::NError() const
+{
+  return fNError;
+}
+
+} // end namespace Retro
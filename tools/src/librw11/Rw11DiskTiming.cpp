@@ -0,0 +1,391 @@
+// $Id: Rw11DiskTiming.cpp 1304 2026-10-19 21:12:37Z mueller $
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// 
+// Revision History: 
+// Date         Rev Version  Comment
+// 2026-10-19  1306   1.0.1  time stats in usec
+// 2026-10-19  1304   1.0    Initial version
+// ---------------------------------------------------------------------------
+
+/*!
+  \brief   Implemenation of Rw11DiskTiming.
+*/
+
+#include <time.h>
+#include <math.h>
+
+#include <algorithm>
+#include <mutex>
+
+#include "librtools/Rexception.hpp"
+#include "librtools/Rtools.hpp"
+#include "librtools/RosFill.hpp"
+#include "librtools/RosPrintf.hpp"
+
+#include "Rw11Cntl.hpp"
+#include "Rw11UnitDisk.hpp"
+
+#include "Rw11DiskTiming.hpp"
+
+using namespace std;
+
+/*!
+  \class Retro::Rw11DiskTiming
+  \brief Seek and rotational timing model for disk controllers.
+
+  Without timing model a disk controller completes a request as soon as
+  the backend access and the DMA transfer are done. When enabled, the
+  controller still does the data transfer immediately, but asks Transfer()
+  or Seek() for the time a real drive would have finished, and defers the
+  final register update, which raises the interrupt, with Schedule().
+
+  The model keeps for each unit the cylinder and the time the positioner
+  becomes free. The seek time is
+    tmin + (tmax-tmin)*sqrt((dist-1)/(ncyl-2))
+  for a move of \c dist cylinders, and 0 without cylinder change. The
+  rotational position is derived from CLOCK_MONOTONIC modulo the time of
+  a revolution, so the wait for the start sector depends on when the
+  positioning ends, the transfer takes one sector time per block. Units
+  are modeled independently, so a seek on one unit overlaps with seeks
+  and transfers on other units.
+
+  In mode kModeScaled all times are multiplied with the scale factor,
+  a factor below 1 gives a faster, above 1 a slower drive.
+
+  Scheduled actions are executed from a RtimerFd poll handler in the server
+  thread with the connect lock held, just like attn handlers. Schedule(),
+  SetMode() and Flush() must be called with the connect lock held.
+*/
+
+// all method definitions in namespace Retro
+namespace Retro {
+
+// rpm and seek times from the DEC drive handbooks
+static const Rw11DiskTiming::drive kDriveTable[] = {
+  //  type    trot        tseek min   max
+  {"rk05", 60./1500.,  0.010,  0.085},
+  {"rl01", 60./2400.,  0.015,  0.100},
+  {"rl02", 60./2400.,  0.015,  0.100},
+  {"rp04", 60./3600.,  0.007,  0.050},
+  {"rp06", 60./3600.,  0.007,  0.050},
+  {"rm03", 60./3600.,  0.006,  0.055},
+  {"rm80", 60./3600.,  0.006,  0.050},
+  {"rm05", 60./3600.,  0.006,  0.055},
+  {"rp07", 60./3600.,  0.004,  0.040}
+};
+
+//------------------------------------------+-----------------------------------
+//! Constructor
+
+Rw11DiskTiming::Rw11DiskTiming(Rw11Cntl* pcntl)
+  : fpCntl(pcntl),
+    fMode(kModeOff),
+    fScale(1.),
+    fUnitState(),
+    fQueue(),
+    fTimer("Rw11DiskTiming::fTimer."),
+    fStats()
+{
+  fStats.Define(kStatNSeek , "NSeek" , "seeks with cylinder change");
+  fStats.Define(kStatNXfer , "NXfer" , "transfers timed");
+  fStats.Define(kStatNSched, "NSched", "actions delayed");
+  fStats.Define(kStatNLate , "NLate" , "actions already due");
+  fStats.Define(kStatTSeek , "TSeek" , "sum of seek time (us)");
+  fStats.Define(kStatTRot  , "TRot"  , "sum of rotational wait (us)");
+  fStats.Define(kStatTXfer , "TXfer" , "sum of transfer time (us)");
+}
+
+//------------------------------------------+-----------------------------------
+//! Destructor
+
+Rw11DiskTiming::~Rw11DiskTiming()
+{
+  if (fTimer.IsOpen())
+    Rtools::Catch2Cerr(__func__, [this](){ StopTimer(); } );
+}
+
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Set timing mode.
+
+  Switching to kModeOff executes all pending actions immediately, so no
+  request is left without completion.
+ */
+
+void Rw11DiskTiming::SetMode(mode mode, double scale)
+{
+  if (mode == kModeScaled && !(scale > 0.))
+    throw Rexception("Rw11DiskTiming::SetMode()",
+                     "Bad args: scale must be > 0");
+  if (mode == kModeReal) scale = 1.;
+  if (mode == kModeOff) {
+    Flush();
+    StopTimer();
+  } else {
+    StartTimer();
+  }
+  fMode  = mode;
+  fScale = (mode == kModeOff) ? 1. : scale;
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Position unit \a iu on cylinder \a cyl.
+
+  \param iu      unit number
+  \param unit    unit, provides type and geometry
+  \param cyl     target cylinder
+  \param tstart  earliest start time (CLOCK_MONOTONIC)
+
+  \returns time the positioner reaches the cylinder, \a tstart when
+           timing is off or the drive type is unknown
+ */
+
+double Rw11DiskTiming::Seek(size_t iu, const Rw11UnitDisk& unit, uint32_t cyl,
+                            double tstart)
+{
+  if (iu >= fUnitState.size()) fUnitState.resize(iu+1, ustate{0,0.});
+  ustate& ust = fUnitState[iu];
+  const drive* pdrv = FindDrive(unit.Type());
+
+  if (!Enabled() || pdrv == nullptr) {
+    ust.fCyl = cyl;
+    return tstart;
+  }
+
+  double   tbeg = max(tstart, ust.fTFree);
+  uint32_t dist = (cyl > ust.fCyl) ? cyl - ust.fCyl : ust.fCyl - cyl;
+  double   dt   = fScale * SeekTime(*pdrv, unit.NCylinder(), dist);
+  if (dist > 0) fStats.Inc(kStatNSeek);
+  fStats.Inc(kStatTSeek, 1.e6*dt);
+  ust.fCyl   = cyl;
+  ust.fTFree = tbeg + dt;
+  return ust.fTFree;
+}
+
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Model a transfer of \a nblk blocks starting at \a lba.
+
+  Includes the implied seek to the cylinder of \a lba, the rotational wait
+  for the start sector and the transfer itself. The seek may start at
+  \a tseek, earlier than \a tstart, when the drive was positioned by the
+  controller firmware before the request, the rotational wait and the
+  transfer start not before \a tstart.
+
+  \returns time the transfer ends, \a tstart when timing is off or the
+           drive type is unknown
+ */
+
+double Rw11DiskTiming::Transfer(size_t iu, const Rw11UnitDisk& unit,
+                                uint32_t lba, uint32_t nblk, double tstart,
+                                double tseek)
+{
+  size_t nsec = unit.NSector();
+  size_t ntrk = unit.NHead() * nsec;
+  const drive* pdrv = FindDrive(unit.Type());
+  if (!Enabled() || pdrv == nullptr || ntrk == 0) return tstart;
+
+  if (tseek < 0. || tseek > tstart) tseek = tstart;
+  double tpos  = max(Seek(iu, unit, lba / ntrk, tseek), tstart);
+  double trot  = fScale * pdrv->fTRot;
+  double tsec  = trot / double(nsec);
+  double phase = fmod(tpos, trot) / tsec;   // sector under head at tpos
+  double nwait = fmod(double(lba % nsec) - phase + double(nsec), double(nsec));
+  double twait = nwait * tsec;
+  double txfer = double(nblk) * tsec;
+
+  fStats.Inc(kStatNXfer);
+  fStats.Inc(kStatTRot,  1.e6*twait);
+  fStats.Inc(kStatTXfer, 1.e6*txfer);
+  fUnitState[iu].fTFree = tpos + twait + txfer;
+  return fUnitState[iu].fTFree;
+}
+
+//------------------------------------------+-----------------------------------
+//! Set cylinder of unit \a iu without seek, e.g. after a drive reset.
+
+void Rw11DiskTiming::SetCylinder(size_t iu, uint32_t cyl)
+{
+  if (iu >= fUnitState.size()) fUnitState.resize(iu+1, ustate{0,0.});
+  fUnitState[iu].fCyl = cyl;
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+//! Returns current cylinder of unit \a iu.
+
+uint32_t Rw11DiskTiming::Cylinder(size_t iu) const
+{
+  return (iu < fUnitState.size()) ? fUnitState[iu].fCyl : 0;
+}
+
+//------------------------------------------+-----------------------------------
+//! Returns time the positioner of unit \a iu becomes free.
+
+double Rw11DiskTiming::TFree(size_t iu) const
+{
+  return (iu < fUnitState.size()) ? fUnitState[iu].fTFree : 0.;
+}
+
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Execute \a action at time \a tdue.
+
+  The action is executed immediately when timing is off, or when it is
+  already due and no other action is pending. Actions are executed in
+  order of due time, actions with equal due time in order of scheduling.
+ */
+
+void Rw11DiskTiming::Schedule(double tdue, action_t&& action)
+{
+  if (!Enabled()) {
+    action();
+    return;
+  }
+  if (fQueue.empty() && tdue <= Now()) {
+    fStats.Inc(kStatNLate);
+    action();
+    return;
+  }
+
+  fStats.Inc(kStatNSched);
+  auto it = upper_bound(fQueue.begin(), fQueue.end(), tdue,
+                        [](double t, const event& e){ return t < e.fTDue; });
+  fQueue.insert(it, event{tdue, move(action)});
+  ArmTimer();
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+//! Execute all pending actions immediately.
+
+void Rw11DiskTiming::Flush()
+{
+  while (!fQueue.empty()) {
+    action_t action = move(fQueue.front().fAction);
+    fQueue.pop_front();
+    action();
+  }
+  if (fTimer.IsOpen()) fTimer.Cancel();
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+void Rw11DiskTiming::Dump(std::ostream& os, int ind, const char* text,
+                          int detail) const
+{
+  RosFill bl(ind);
+  os << bl << (text?text:"--") << "Rw11DiskTiming @ " << this << endl;
+  os << bl << "  fMode:           " << fMode << endl;
+  os << bl << "  fScale:          " << fScale << endl;
+  os << bl << "  fQueue.size:     " << fQueue.size() << endl;
+  os << bl << "  fUnitState:      " << endl;
+  double tnow = Now();
+  for (size_t i=0; i<fUnitState.size(); i++) {
+    double tfree = fUnitState[i].fTFree - tnow;
+    os << bl << "    " << i << ": cyl " << RosPrintf(fUnitState[i].fCyl,"d",4)
+       << " free in " << RosPrintf(max(tfree,0.)*1000.,"f",7,3) << " ms"
+       << endl;
+  }
+  os << bl << "  fTimer.IsOpen:   " << RosPrintf(fTimer.IsOpen()) << endl;
+  fStats.Dump(os, ind+2, "fStats: ", detail-1);
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+//! Returns CLOCK_MONOTONIC time in sec.
+
+double Rw11DiskTiming::Now()
+{
+  struct timespec ts;
+  ::clock_gettime(CLOCK_MONOTONIC, &ts);
+  return double(ts.tv_sec) + 1.e-9 * double(ts.tv_nsec);
+}
+
+//------------------------------------------+-----------------------------------
+//! Returns timing parameters for unit type \a type, nullptr if unknown.
+
+const Rw11DiskTiming::drive* Rw11DiskTiming::FindDrive(const std::string& type)
+{
+  for (auto& drv : kDriveTable) {
+    if (type == drv.fType) return &drv;
+  }
+  return nullptr;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+void Rw11DiskTiming::StartTimer()
+{
+  if (fTimer.IsOpen()) return;
+  fTimer.Open();
+  fpCntl->Server().AddPollHandler([this](const pollfd& pfd)
+                                    { return TimerHandler(pfd); },
+                                  fTimer.Fd(), POLLIN);
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+void Rw11DiskTiming::StopTimer()
+{
+  if (!fTimer.IsOpen()) return;
+  fpCntl->Server().RemovePollHandler(fTimer.Fd());
+  fTimer.Close();
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+//! Arm timer for the first pending action.
+
+void Rw11DiskTiming::ArmTimer()
+{
+  if (fQueue.empty()) return;
+  StartTimer();
+  double dt = fQueue.front().fTDue - Now();
+  fTimer.SetRelative(max(dt, 1.e-6));       // SetRelative requires dt > 0
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+int Rw11DiskTiming::TimerHandler(const pollfd& pfd)
+{
+  // bail-out and cancel handler if poll returns an error event
+  if (pfd.revents & (~pfd.events)) return -1;
+
+  fTimer.Read();                            // harvest expiration count
+
+  // lock connect, actions run in the same context as attn handlers
+  lock_guard<RlinkConnect> lock(fpCntl->Connect());
+  double tnow = Now();
+  while (!fQueue.empty() && fQueue.front().fTDue <= tnow) {
+    action_t action = move(fQueue.front().fAction);
+    fQueue.pop_front();
+    action();                               // may Schedule() new actions
+  }
+  ArmTimer();
+  return 0;
+}
+
+//------------------------------------------+-----------------------------------
+//! Returns seek time for a move of \a dist cylinders, unscaled.
+
+double Rw11DiskTiming::SeekTime(const drive& drv, size_t ncyl,
+                                uint32_t dist) const
+{
+  if (dist == 0) return 0.;
+  double frac = (ncyl > 2) ? double(dist-1) / double(ncyl-2) : 0.;
+  frac = min(frac, 1.);
+  return drv.fTSeekMin + (drv.fTSeekMax - drv.fTSeekMin) * sqrt(frac);
+}
+
+} // end namespace Retro
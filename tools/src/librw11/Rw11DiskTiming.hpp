@@ -0,0 +1,131 @@
+// $Id: Rw11DiskTiming.hpp 1304 2026-10-19 21:12:37Z mueller $
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// 
+// Revision History: 
+// Date         Rev Version  Comment
+// 2026-10-19  1306   1.0.1  time stats in usec
+// 2026-10-19  1304   1.0    Initial version
+// ---------------------------------------------------------------------------
+
+
+/*!
+  \brief   Declaration of class Rw11DiskTiming.
+*/
+
+#ifndef included_Retro_Rw11DiskTiming
+#define included_Retro_Rw11DiskTiming 1
+
+#include <poll.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <deque>
+#include <functional>
+#include <ostream>
+
+#include "librtools/Rstats.hpp"
+#include "librtools/RtimerFd.hpp"
+
+namespace Retro {
+
+  class Rw11Cntl;                           // forw decl to avoid circular incl
+  class Rw11UnitDisk;
+
+  class Rw11DiskTiming {
+    public:
+      typedef std::function<void()>  action_t;
+
+    // timing modes
+      enum mode {
+        kModeOff = 0,                       //!< no delays, complete asap
+        kModeReal,                          //!< delays as real drive
+        kModeScaled                         //!< real delays times scale
+      };
+
+    // timing parameters of a drive type; all times in sec
+      struct drive {
+        const char* fType;                  //!< unit type name
+        double      fTRot;                  //!< time for one revolution
+        double      fTSeekMin;              //!< track-to-track seek time
+        double      fTSeekMax;              //!< full stroke seek time
+      };
+
+      explicit      Rw11DiskTiming(Rw11Cntl* pcntl);
+                   ~Rw11DiskTiming();
+
+                    Rw11DiskTiming(const Rw11DiskTiming&) = delete; // noncopy
+      Rw11DiskTiming& operator=(const Rw11DiskTiming&) = delete;  // noncopy
+
+      void          SetMode(mode mode, double scale=1.);
+      mode          Mode() const;
+      double        Scale() const;
+      bool          Enabled() const;
+
+      double        Seek(size_t iu, const Rw11UnitDisk& unit, uint32_t cyl,
+                         double tstart);
+      double        Transfer(size_t iu, const Rw11UnitDisk& unit,
+                             uint32_t lba, uint32_t nblk, double tstart,
+                             double tseek=-1.);
+      void          SetCylinder(size_t iu, uint32_t cyl);
+      uint32_t      Cylinder(size_t iu) const;
+      double        TFree(size_t iu) const;
+
+      void          Schedule(double tdue, action_t&& action);
+      void          Flush();
+      size_t        NPending() const;
+
+      Rstats&       Stats();
+      void          Dump(std::ostream& os, int ind=0, const char* text=0,
+                         int detail=0) const;
+
+      static double Now();
+      static const drive* FindDrive(const std::string& type);
+
+    // statistics counter indices
+      enum stats {
+        kStatNSeek = 0,                     //!< seeks with cyl change
+        kStatNXfer,                         //!< transfers timed
+        kStatNSched,                        //!< actions delayed
+        kStatNLate,                         //!< actions already due
+        kStatTSeek,                         //!< sum of seek time (us)
+        kStatTRot,                          //!< sum of rotational wait (us)
+        kStatTXfer,                         //!< sum of transfer time (us)
+        kDimStat
+      };
+
+    protected:
+      void          StartTimer();
+      void          StopTimer();
+      void          ArmTimer();
+      int           TimerHandler(const pollfd& pfd);
+      double        SeekTime(const drive& drv, size_t ncyl,
+                             uint32_t dist) const;
+
+    protected:
+    // one delayed action
+      struct event {
+        double      fTDue;                  //!< due time (CLOCK_MONOTONIC)
+        action_t    fAction;                //!< action to execute
+      };
+    // positioner state of one unit
+      struct ustate {
+        uint32_t    fCyl;                   //!< current cylinder
+        double      fTFree;                 //!< positioner free after
+      };
+
+      Rw11Cntl*     fpCntl;                 //!< ptr to owning controller
+      mode          fMode;                  //!< timing mode
+      double        fScale;                 //!< time scale factor
+      std::vector<ustate> fUnitState;       //!< per unit positioner state
+      std::deque<event> fQueue;             //!< pending actions, by due time
+      RtimerFd      fTimer;                 //!< timer for delayed actions
+      Rstats        fStats;                 //!< statistics
+  };
+  
+} // end namespace Retro
+
+#include "Rw11DiskTiming.ipp"
+
+#endif
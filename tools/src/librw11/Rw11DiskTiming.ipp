@@ -0,0 +1,57 @@
+// $Id: Rw11DiskTiming.ipp 1304 2026-10-19 21:12:37Z mueller $
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// 
+// Revision History: 
+// Date         Rev Version  Comment
+// 2026-10-19  1304   1.0    Initial version
+// ---------------------------------------------------------------------------
+
+/*!
+  \brief   Implemenation (inline) of Rw11DiskTiming.
+*/
+
+// all method definitions in namespace Retro
+namespace Retro {
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+inline Rw11DiskTiming::mode Rw11DiskTiming::Mode() const
+{
+  return fMode;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+inline double Rw11DiskTiming::Scale() const
+{
+  return fScale;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+inline bool Rw11DiskTiming::Enabled() const
+{
+  return fMode != kModeOff;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+inline size_t Rw11DiskTiming::NPending() const
+{
+  return fQueue.size();
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+inline Rstats& Rw11DiskTiming::Stats()
+{
+  return fStats;
+}
+
+} // end namespace Retro
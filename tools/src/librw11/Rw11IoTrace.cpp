@@ -0,0 +1,205 @@
+// $Id: Rw11IoTrace.cpp 1301 2026-10-19 20:05:41Z mueller $
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// 
+// Revision History: 
+// Date         Rev Version  Comment
+// 2026-10-19  1301   1.0    Initial version
+// ---------------------------------------------------------------------------
+
+/*!
+  \brief   Implemenation of Rw11IoTrace.
+*/
+
+#include <fcntl.h>
+#include <time.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "librtools/RfileFd.hpp"
+#include "librtools/RosFill.hpp"
+#include "librtools/RosPrintf.hpp"
+
+#include "Rw11IoTrace.hpp"
+
+using namespace std;
+
+/*!
+  \class Retro::Rw11IoTrace
+  \brief Per-request I/O trace for disk and tape controllers.
+
+  A controller calls Begin() when it accepts a request in its attn handler,
+  Back() when the backend (virtual disk or tape) operation completed, and
+  End() after the final register update, which raises the interrupt, was
+  executed. Controllers handle one request at a time, so one in flight
+  entry is enough.
+
+  The completed entries are stored in a ring. The ring is written from the
+  server thread only, readers use GetLast() without any lock. The writer
+  announces a slot overwrite in fNBegin before it writes the slot and
+  publishes it in fNWrite afterwards, the reader copies the entries and
+  re-checks fNBegin, entries which might have been overwritten during the
+  copy are discarded. Enable(), Disable() and Clear() must be called with
+  the connect lock held.
+
+  WriteFile() writes a binary file with a 16 byte header, the magic
+  "w11iotr1", the entry size as uint32 and the number of entries as
+  uint32, followed by the entries oldest first in host byte order.
+*/
+
+// all method definitions in namespace Retro
+namespace Retro {
+
+static const char kFileMagic[8] = {'w','1','1','i','o','t','r','1'};
+
+//------------------------------------------+-----------------------------------
+//! Default constructor
+
+Rw11IoTrace::Rw11IoTrace()
+  : fRing(),
+    fNWrite(0),
+    fNBegin(0),
+    fEnabled(false),
+    fOpen(false),
+    fCur()
+{}
+
+//------------------------------------------+-----------------------------------
+//! Destructor
+
+Rw11IoTrace::~Rw11IoTrace()
+{}
+
+//------------------------------------------+-----------------------------------
+//! Enable trace with a ring of \a nring entries, clears the ring.
+
+void Rw11IoTrace::Enable(size_t nring)
+{
+  if (nring == 0) nring = 1;
+  fRing.assign(nring, entry());
+  fNWrite.store(0, memory_order_release);
+  fNBegin.store(0, memory_order_release);
+  fOpen    = false;
+  fEnabled = true;
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+//! Disable trace, keeps the ring content.
+
+void Rw11IoTrace::Disable()
+{
+  fEnabled = false;
+  fOpen    = false;
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+//! Clear the ring.
+
+void Rw11IoTrace::Clear()
+{
+  fNWrite.store(0, memory_order_release);
+  fNBegin.store(0, memory_order_release);
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Complete the request in flight and store it in the ring.
+
+  \param result  error bits, or'ed to those given with AddResult()
+ */
+
+void Rw11IoTrace::End(uint16_t result)
+{
+  if (!fOpen) return;
+  fOpen = false;
+  if (!fEnabled || fRing.empty()) return;
+  fCur.fTDone  = TimeNs();
+  fCur.fResult |= result;
+  uint64_t nw = fNWrite.load(memory_order_relaxed);
+  fNBegin.store(nw+1, memory_order_relaxed);  // announce slot overwrite
+  atomic_thread_fence(memory_order_release);
+  fRing[size_t(nw % fRing.size())] = fCur;
+  fNWrite.store(nw+1, memory_order_release);
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+//! Returns up to \a nent last entries, oldest first.
+
+void Rw11IoTrace::GetLast(std::vector<entry>& list, size_t nent) const
+{
+  list.clear();
+  size_t nring = fRing.size();
+  if (nring == 0) return;
+
+  uint64_t nw1  = fNWrite.load(memory_order_acquire);
+  uint64_t nava = min(nw1, uint64_t(nring));
+  if (nent > nava) nent = size_t(nava);
+  uint64_t ibeg = nw1 - nent;
+  list.resize(nent);
+  for (size_t i=0; i<nent; i++) list[i] = fRing[size_t((ibeg+i) % nring)];
+
+  // entries with index < nb-nring were (or are) overwritten while copying
+  atomic_thread_fence(memory_order_acquire);
+  uint64_t nb = fNBegin.load(memory_order_relaxed);
+  if (nb > nring && nb - nring > ibeg) {
+    size_t ndrop = size_t(min(nb - nring - ibeg, uint64_t(nent)));
+    list.erase(list.begin(), list.begin()+ndrop);
+  }
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+//! Write ring content to a binary file.
+
+bool Rw11IoTrace::WriteFile(const std::string& fname, RerrMsg& emsg) const
+{
+  vector<entry> list;
+  GetLast(list, fRing.size());
+
+  RfileFd fd("Rw11IoTrace::WriteFile.fd.");
+  if (!fd.Open(fname.c_str(), O_WRONLY|O_CREAT|O_TRUNC, 0644, emsg))
+    return false;
+  uint8_t  hdr[16];
+  uint32_t esize = sizeof(entry);
+  uint32_t nent  = list.size();
+  ::memcpy(hdr,    kFileMagic, 8);
+  ::memcpy(hdr+8,  &esize,     4);
+  ::memcpy(hdr+12, &nent,      4);
+  if (!fd.WriteAll(hdr, sizeof(hdr), emsg)) return false;
+  if (nent > 0 && !fd.WriteAll(list.data(), nent*sizeof(entry), emsg))
+    return false;
+  fd.Close();
+  return true;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+void Rw11IoTrace::Dump(std::ostream& os, int ind, const char* text,
+                       int /*detail*/) const
+{
+  RosFill bl(ind);
+  os << bl << (text?text:"--") << "Rw11IoTrace @ " << this << endl;
+  os << bl << "  fRing.size:      " << fRing.size() << endl;
+  os << bl << "  fNWrite:         " << NEntry() << endl;
+  os << bl << "  fEnabled:        " << RosPrintf(fEnabled) << endl;
+  os << bl << "  fOpen:           " << RosPrintf(fOpen) << endl;
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+//! Returns CLOCK_MONOTONIC time in ns.
+
+uint64_t Rw11IoTrace::TimeNs()
+{
+  struct timespec ts;
+  ::clock_gettime(CLOCK_MONOTONIC, &ts);
+  return uint64_t(ts.tv_sec)*1000000000ull + uint64_t(ts.tv_nsec);
+}
+
+} // end namespace Retro
@@ -0,0 +1,83 @@
+// $Id: Rw11IoTrace.hpp 1301 2026-10-19 20:05:41Z mueller $
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// 
+// Revision History: 
+// Date         Rev Version  Comment
+// 2026-10-19  1301   1.0    Initial version
+// ---------------------------------------------------------------------------
+
+
+/*!
+  \brief   Declaration of class Rw11IoTrace.
+*/
+
+#ifndef included_Retro_Rw11IoTrace
+#define included_Retro_Rw11IoTrace 1
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <ostream>
+
+#include "librtools/RerrMsg.hpp"
+
+namespace Retro {
+
+  class Rw11IoTrace {
+    public:
+    // one traced request; all times in ns, CLOCK_MONOTONIC
+      struct entry {
+        uint64_t    fTAttn;                 //!< attn handler entry
+        uint64_t    fTBack;                 //!< backend completion (0 if none)
+        uint64_t    fTDone;                 //!< final register update done
+        uint32_t    fLba;                   //!< lba (disk) or record (tape)
+        uint32_t    fNwrd;                  //!< requested transfer (words)
+        uint16_t    fResult;                //!< error bits set by cntl
+        uint8_t     fUnit;                  //!< unit number
+        uint8_t     fFunc;                  //!< function code
+        uint32_t    fSpare;                 //!< unused, pads to 40 bytes
+      };
+
+                    Rw11IoTrace();
+                   ~Rw11IoTrace();
+
+                    Rw11IoTrace(const Rw11IoTrace&) = delete;   // noncopyable 
+      Rw11IoTrace&  operator=(const Rw11IoTrace&) = delete;  // noncopyable
+
+      void          Enable(size_t nring);
+      void          Disable();
+      void          Clear();
+      bool          IsEnabled() const;
+      size_t        RingSize() const;
+      uint64_t      NEntry() const;
+
+      void          Begin(uint8_t unit, uint8_t func, uint32_t lba,
+                          uint32_t nwrd);
+      void          Back();
+      void          AddResult(uint16_t result);
+      void          End(uint16_t result=0);
+
+      void          GetLast(std::vector<entry>& list, size_t nent) const;
+      bool          WriteFile(const std::string& fname, RerrMsg& emsg) const;
+
+      void          Dump(std::ostream& os, int ind=0, const char* text=0,
+                         int detail=0) const;
+
+      static uint64_t TimeNs();
+
+    protected:
+      std::vector<entry> fRing;             //!< trace ring
+      std::atomic<uint64_t> fNWrite;        //!< entries written (index)
+      std::atomic<uint64_t> fNBegin;        //!< entries being written
+      bool          fEnabled;               //!< trace enabled
+      bool          fOpen;                  //!< request in flight
+      entry         fCur;                   //!< request in flight
+  };
+  
+} // end namespace Retro
+
+#include "Rw11IoTrace.ipp"
+
+#endif
@@ -0,0 +1,79 @@
+// $Id: Rw11IoTrace.ipp 1301 2026-10-19 20:05:41Z mueller $
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// 
+// Revision History: 
+// Date         Rev Version  Comment
+// 2026-10-19  1301   1.0    Initial version
+// ---------------------------------------------------------------------------
+
+/*!
+  \brief   Implemenation (inline) of Rw11IoTrace.
+*/
+
+// all method definitions in namespace Retro
+namespace Retro {
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+inline bool Rw11IoTrace::IsEnabled() const
+{
+  return fEnabled;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+inline size_t Rw11IoTrace::RingSize() const
+{
+  return fRing.size();
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+inline uint64_t Rw11IoTrace::NEntry() const
+{
+  return fNWrite.load(std::memory_order_acquire);
+}
+
+//------------------------------------------+-----------------------------------
+//! Start tracing a request, a no-op when trace is disabled.
+
+inline void Rw11IoTrace::Begin(uint8_t unit, uint8_t func, uint32_t lba,
+                               uint32_t nwrd)
+{
+  if (!fEnabled) return;
+  fCur.fTAttn   = TimeNs();
+  fCur.fTBack   = 0;
+  fCur.fTDone   = 0;
+  fCur.fLba     = lba;
+  fCur.fNwrd    = nwrd;
+  fCur.fResult  = 0;
+  fCur.fUnit    = unit;
+  fCur.fFunc    = func;
+  fCur.fSpare   = 0;
+  fOpen = true;
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+//! Mark backend completion of the request in flight.
+
+inline void Rw11IoTrace::Back()
+{
+  if (fOpen) fCur.fTBack = TimeNs();
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+//! Add error bits to the result of the request in flight.
+
+inline void Rw11IoTrace::AddResult(uint16_t result)
+{
+  if (fOpen) fCur.fResult |= result;
+  return;
+}
+
+} // end namespace Retro
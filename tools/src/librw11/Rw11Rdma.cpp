@@ -1,9 +1,11 @@
 // $Id: Rw11Rdma.cpp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2015-2019 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2015-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1306   1.2.1  BUGFIX: chunk size hist: NChunkLarge now used
+// 2026-10-19  1282   1.2    add adaptive chunk sizing; add chunk size stats
 // 2019-02-23  1114   1.1.5  use std::bind instead of lambda
 // 2018-12-19  1090   1.1.4  use RosPrintf(bool)
 // 2018-12-15  1083   1.1.3  for std::function setups: use rval ref and move
@@ -24,6 +26,7 @@
 #include "librtools/RosFill.hpp"
 #include "librtools/RosPrintf.hpp"
 #include "librtools/RosPrintBvi.hpp"
+#include "librtools/Rtime.hpp"
 
 #include "Rw11Rdma.hpp"
 
@@ -37,6 +40,12 @@ using namespace std;
 // all method definitions in namespace Retro
 namespace Retro {
 
+//------------------------------------------+-----------------------------------
+// constants definitions
+
+const size_t   Rw11Rdma::kChunkMin;
+const uint32_t Rw11Rdma::kChunkTimeUs;
+
 //------------------------------------------+-----------------------------------
 //! Constructor
 
@@ -45,6 +54,8 @@ Rw11Rdma::Rw11Rdma(Rw11Cntl* pcntl, precb_t&& precb, postcb_t&& postcb)
     fPreExecCB(move(precb)),
     fPostExecCB(move(postcb)),
     fChunksize(0),
+    fChunkAuto(true),
+    fChunkRate(0.),
     fStatus(kStatusDone),
     fIsWMem(false),
     fAddr(0),
@@ -61,6 +72,14 @@ Rw11Rdma::Rw11Rdma(Rw11Cntl* pcntl, precb_t&& precb, postcb_t&& postcb)
   fStats.Define(kStatNRdmaWMem,    "NRdmaWMem"    , "WMem chunks done");
   fStats.Define(kStatNExtClist,    "NExtClist"    , "clist extended");
   fStats.Define(kStatNFailRdma,    "NFailRdma"    , "Rdma failures");
+  fStats.Define(kStatNChunkAdapt,  "NChunkAdapt"  , "chunk size adapted");
+  fStats.Define(kStatNChunk0064,   "NChunk0064"   , "chunks with size <   64");
+  fStats.Define(kStatNChunk0128,   "NChunk0128"   , "chunks with size <  128");
+  fStats.Define(kStatNChunk0256,   "NChunk0256"   , "chunks with size <  256");
+  fStats.Define(kStatNChunk0512,   "NChunk0512"   , "chunks with size <  512");
+  fStats.Define(kStatNChunk1024,   "NChunk1024"   , "chunks with size < 1024");
+  fStats.Define(kStatNChunk2048,   "NChunk2048"   , "chunks with size < 2048");
+  fStats.Define(kStatNChunkLarge,  "NChunkLarge"  , "chunks with size >=2048");
 }
 
 //------------------------------------------+-----------------------------------
@@ -70,13 +89,18 @@ Rw11Rdma::~Rw11Rdma()
 {}
 
 //------------------------------------------+-----------------------------------
-//! FIXME_docs
+//! Set chunk size.
+/*!
+  Setting a chunk size pins it, the adaptive chunk sizing is switched off.
+  A \a chunk of 0 selects the maximal prudent size.
+ */
 
 void Rw11Rdma::SetChunkSize(size_t chunk)
 {
   size_t cmax = CntlBase().IsStarted() ? Connect().BlockSizePrudent() : 0;
   if (chunk==0 || chunk>cmax) chunk = cmax;
   fChunksize = chunk;
+  fChunkAuto = false;
   return;
 }
 
@@ -114,6 +138,8 @@ void Rw11Rdma::Dump(std::ostream& os, int ind, const char* text,
   os << bl << (text?text:"--") << "Rw11Rdma @ " << this << endl;
 
   os << bl << "  fChunkSize:      " << RosPrintf(fChunksize,"d",4) << endl;
+  os << bl << "  fChunkAuto:      " << RosPrintf(fChunkAuto) << endl;
+  os << bl << "  fChunkRate:      " << RosPrintf(fChunkRate,"f",9,1) << endl;
   os << bl << "  fStatus:         " << fStatus << endl;
   os << bl << "  fIsWMem:         " << RosPrintf(fIsWMem) << endl;
   os << bl << "  fAddr:           " << RosPrintBvi(fAddr,8,22) << endl;
@@ -171,15 +197,21 @@ int Rw11Rdma::RdmaHandler()
     Cpu().AddRMem(clist, fAddr, fpBlock, nwnext, fMode, true);
   }
   size_t ncmd = clist.Size();
+  fStats.IncLogHist(kStatNChunk0064, 0x3f, 0xfff, nwnext);
   
   if (nwnext == fNWordRest) fStatus = kStatusBusyLast;
   
   fPreExecCB(fStatus, fNWordDone, nwnext, clist);
   if (clist.Size() != ncmd) fStats.Inc(kStatNExtClist);
 
+  Rtime tbeg(CLOCK_MONOTONIC);
   Server().Exec(clist);
+  double dt = double(Rtime(CLOCK_MONOTONIC) - tbeg);
 
   size_t nwdone = clist[ncmd-1].BlockDone();
+  // only full chunks give a good estimate of the link performance
+  if (fChunkAuto && nwnext == fNWordMax && nwdone == nwnext)
+    ChunkAdapt(nwdone, dt);
   
   fAddr      += 2*nwdone;
   fNWordRest -= nwdone;
@@ -209,6 +241,48 @@ int Rw11Rdma::RdmaHandler()
   return 0;
 }
 
+//------------------------------------------+-----------------------------------
+//! Adapt chunk size to observed link performance.
+/*!
+  A chunk should be large to minimize round trip overhead, but the link is
+  blocked for other devices while a chunk is transfered. The chunk size is
+  therefore set such that a chunk takes about kChunkTimeUs on the link. It
+  is derived from the average transfer rate of full chunks, which includes
+  the round trip time. For a link with latency \c tl and bandwidth \c bw
+  this converges to <tt>bw*(kChunkTimeUs-tl)</tt>. On fast links the size
+  saturates at BlockSizePrudent(), on slow serial links it settles at a
+  fraction of that, but never below kChunkMin.
+
+  The size is only changed when it differs by more than 1/8 from the current
+  one to avoid jitter.
+
+  \param nwdone  number of words transfered
+  \param dt      time for Exec() in seconds
+ */
+
+void Rw11Rdma::ChunkAdapt(size_t nwdone, double dt)
+{
+  if (dt <= 0.) return;
+
+  double rate = double(nwdone)/dt;
+  if (fChunkRate == 0.) {
+    fChunkRate = rate;
+  } else {
+    fChunkRate += 0.25*(rate-fChunkRate);
+  }
+
+  size_t cmax  = Connect().BlockSizePrudent();
+  size_t chunk = size_t(fChunkRate*(1.e-6*kChunkTimeUs));
+  chunk = max(kChunkMin, min(chunk, cmax));
+
+  size_t diff = (chunk > fChunksize) ? chunk-fChunksize : fChunksize-chunk;
+  if (chunk == cmax || diff > fChunksize/8) {
+    if (chunk != fChunksize) fStats.Inc(kStatNChunkAdapt);
+    fChunksize = chunk;
+  }
+  return;
+}
+
 //------------------------------------------+-----------------------------------
 //! FIXME_docs
 
@@ -1,9 +1,10 @@
 // $Id: Rw11Rdma.hpp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2015-2019 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2015-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1282   1.2    add adaptive chunk sizing; add chunk size stats
 // 2019-06-07  1160   1.1.5  Stats() not longer const
 // 2018-12-16  1084   1.1.4  use =delete for noncopyable instead of boost
 // 2018-12-15  1083   1.1.3  for std::function setups: use rval ref and move
@@ -55,6 +56,8 @@ namespace Retro {
 
       void          SetChunkSize(size_t chunk);
       size_t        ChunkSize() const;
+      void          SetChunkAuto(bool autoena);
+      bool          ChunkAuto() const;
 
       bool          IsActive() const;
 
@@ -75,9 +78,21 @@ namespace Retro {
         kStatNRdmaWMem,                     //!< WMem chunks done
         kStatNExtClist,                     //!< clist extended
         kStatNFailRdma,                     //!< Rdma failures
+        kStatNChunkAdapt,                   //!< chunk size adapted
+        kStatNChunk0064,                    //!< chunks with size <   64
+        kStatNChunk0128,                    //!< chunks with size <  128
+        kStatNChunk0256,                    //!< chunks with size <  256
+        kStatNChunk0512,                    //!< chunks with size <  512
+        kStatNChunk1024,                    //!< chunks with size < 1024
+        kStatNChunk2048,                    //!< chunks with size < 2048
+        kStatNChunkLarge,                   //!< chunks with size >=2048
         kDimStat
       };    
 
+    // chunk size adaption parameters
+      static const size_t   kChunkMin    = 32;   //!< minimal adaptive chunk
+      static const uint32_t kChunkTimeUs = 20000;//!< target chunk time in usec
+
     // status values
       enum status {
         kStatusDone,                        //!< all chunks done and ok
@@ -89,6 +104,7 @@ namespace Retro {
     protected:
       void          SetupRdma(bool iswmem, uint32_t addr, uint16_t* block,
                               size_t size, uint16_t mode);
+      void          ChunkAdapt(size_t nwdone, double dt);
       int           RdmaHandler();
       virtual void  PreRdmaHook();
       virtual void  PostRdmaHook(size_t nwdone);
@@ -98,6 +114,8 @@ namespace Retro {
       precb_t       fPreExecCB;             //!< pre Exec callback
       postcb_t      fPostExecCB;            //!< post Exec callback
       size_t        fChunksize;             //!< channel chunk size
+      bool          fChunkAuto;             //!< adapt chunk size to link
+      double        fChunkRate;             //!< avg rate of full chunks (w/s)
       enum status   fStatus;                //!< dma status
       bool          fIsWMem;                //!< is memory write
       uint32_t      fAddr;                  //!< current mem address
@@ -1,9 +1,10 @@
 // $Id: Rw11Rdma.ipp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2015-2019 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2015-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1282   1.1    add adaptive chunk sizing; add chunk size stats
 // 2019-06-07  1160   1.0.1  Stats() not longer const
 // 2015-01-04   627   1.0    Initial version
 // ---------------------------------------------------------------------------
@@ -74,6 +75,23 @@ inline size_t Rw11Rdma::ChunkSize() const
 //------------------------------------------+-----------------------------------
 //! FIXME_docs
 
+inline void Rw11Rdma::SetChunkAuto(bool autoena)
+{
+  fChunkAuto = autoena;
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+inline bool Rw11Rdma::ChunkAuto() const
+{
+  return fChunkAuto;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
 inline bool Rw11Rdma::IsActive() const
 {
   return fStatus != kStatusDone;
@@ -1,9 +1,11 @@
 // $Id: Rw11RdmaDisk.cpp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2015-2018 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2015-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1305   1.0.4  add SetWriteAsync(), async disk writes
+// 2026-10-19  1301   1.0.3  add SetIoTrace(), mark backend completion
 // 2018-09-16  1047   1.0.2  coverity fixup (uninitialized scalar)
 // 2017-04-02   865   1.0.1  Dump(): add detail arg
 // 2015-01-04   628   1.0    Initial version
@@ -39,10 +41,13 @@ Rw11RdmaDisk::Rw11RdmaDisk(Rw11Cntl* pcntl, precb_t&& precb, postcb_t&& postcb)
     fNWord(0),
     fNBlock(0),
     fLba(),
-    fFunc(kFuncRead)
+    fFunc(kFuncRead),
+    fpIoTrace(nullptr),
+    fWriteAsync(false)
 {
   fStats.Define(kStatNWritePadded, "NWritePadded" , "padded disk write");
   fStats.Define(kStatNWChkFail,    "NWChkFail"    , "write check failed");
+  fStats.Define(kStatNWriteAsync,  "NWriteAsync"  , "disk write queued async");
 }
 
 //------------------------------------------+-----------------------------------
@@ -102,6 +107,7 @@ size_t Rw11RdmaDisk::WriteCheck(size_t nwdone)
                              reinterpret_cast<uint8_t*>(dbuf.data()), emsg);
   if (!rc) throw Rexception("Rw11RdmaDisk::WriteCheck()", 
                             "VirtRead() failed: ", emsg);
+  if (fpIoTrace) fpIoTrace->Back();
   
   uint16_t* pdsk = dbuf.data();
   uint16_t* pmem = fBuf.data();
@@ -129,6 +135,7 @@ void Rw11RdmaDisk::Dump(std::ostream& os, int ind, const char* text,
   os << bl << "  fNBlock:         " << RosPrintf(fNBlock,"d",5) << endl;
   os << bl << "  fLba:            " << RosPrintf(fLba,"d",8) << endl;
   os << bl << "  fFunc:           " << fFunc << endl;
+  os << bl << "  fWriteAsync:     " << RosPrintf(fWriteAsync) << endl;
 
   Rw11Rdma::Dump(os, ind, " ^", detail);
   return;
@@ -166,6 +173,7 @@ void Rw11RdmaDisk::PreRdmaHook()
                              reinterpret_cast<uint8_t*>(fBuf.data()), emsg);
   if (!rc) throw Rexception("Rw11RdmaDisk::PreRdmaHook()", 
                             "VirtRead() failed: ", emsg);
+  if (fpIoTrace) fpIoTrace->Back();
   return;
 }
 
@@ -189,10 +197,21 @@ void Rw11RdmaDisk::PostRdmaHook(size_t nwdone)
   }
 
   RerrMsg emsg;
-  bool rc = fpUnit->VirtWrite(fLba, nblock, 
-                              reinterpret_cast<uint8_t*>(fBuf.data()), emsg);
-  if (!rc) throw Rexception("Rw11RdmaDisk::PostRdmaHook()", 
-                            "VirtWrite() failed: ", emsg);
+  if (fWriteAsync) {                        // write done by unit thread,
+                                            //   Back() marks the hand-over
+    fStats.Inc(kStatNWriteAsync);
+    bool rc = fpUnit->VirtWriteAsync(fLba, nblock,
+                                     reinterpret_cast<uint8_t*>(fBuf.data()),
+                                     emsg);
+    if (!rc) throw Rexception("Rw11RdmaDisk::PostRdmaHook()", 
+                              "VirtWriteAsync() failed: ", emsg);
+  } else {
+    bool rc = fpUnit->VirtWrite(fLba, nblock, 
+                                reinterpret_cast<uint8_t*>(fBuf.data()), emsg);
+    if (!rc) throw Rexception("Rw11RdmaDisk::PostRdmaHook()", 
+                              "VirtWrite() failed: ", emsg);
+  }
+  if (fpIoTrace) fpIoTrace->Back();
   return;
 }
 
@@ -1,9 +1,11 @@
 // $Id: Rw11RdmaDisk.hpp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2015-2018 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2015-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1305   1.0.4  add SetWriteAsync(), async disk writes
+// 2026-10-19  1301   1.0.3  add SetIoTrace(), mark backend completion
 // 2018-12-15  1083   1.0.2  for std::function setups: use rval ref and move
 // 2017-04-02   865   1.0.1  Dump(): add detail arg
 // 2015-01-04   627   1.0    Initial version
@@ -21,6 +23,7 @@
 
 #include "Rw11Rdma.hpp"
 #include "Rw11UnitDisk.hpp"
+#include "Rw11IoTrace.hpp"
 
 namespace Retro {
 
@@ -40,6 +43,10 @@ namespace Retro {
 
       size_t        WriteCheck(size_t nwdone); 
 
+      void          SetIoTrace(Rw11IoTrace* ptrace);
+      void          SetWriteAsync(bool async);
+      bool          WriteAsync() const;
+
       virtual void  Dump(std::ostream& os, int ind=0, const char* text=0,
                          int detail=0) const;
 
@@ -47,6 +54,7 @@ namespace Retro {
       enum stats {
         kStatNWritePadded = Rw11Rdma::kDimStat,//!< padded disk write
         kStatNWChkFail,                        //!< write check failed
+        kStatNWriteAsync,                      //!< disk write queued async
         kDimStat
       };
     
@@ -70,6 +78,8 @@ namespace Retro {
       size_t        fNBlock;                //!< disk blocks to transfer
       size_t        fLba;                   //!< disk lba
       enum func     fFunc;                  //!< current function
+      Rw11IoTrace*  fpIoTrace;              //!< I/O trace (or nullptr)
+      bool          fWriteAsync;            //!< use unit writer thread
   };
   
 } // end namespace Retro
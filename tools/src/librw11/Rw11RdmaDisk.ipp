@@ -1,9 +1,11 @@
 // $Id: Rw11RdmaDisk.ipp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2015- by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2015-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1305   1.0.2  add SetWriteAsync(), async disk writes
+// 2026-10-19  1301   1.0.1  add SetIoTrace(), mark backend completion
 // 2015-01-04   627   1.0    Initial version
 // ---------------------------------------------------------------------------
 
@@ -15,4 +17,30 @@
 // all method definitions in namespace Retro
 namespace Retro {
 
+//------------------------------------------+-----------------------------------
+//! Set I/O trace to be informed on backend completion (or nullptr).
+
+inline void Rw11RdmaDisk::SetIoTrace(Rw11IoTrace* ptrace)
+{
+  fpIoTrace = ptrace;
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+//! Hand disk writes to the writer thread of the unit (see VirtWriteAsync()).
+
+inline void Rw11RdmaDisk::SetWriteAsync(bool async)
+{
+  fWriteAsync = async;
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+inline bool Rw11RdmaDisk::WriteAsync() const
+{
+  return fWriteAsync;
+}
+
 } // end namespace Retro
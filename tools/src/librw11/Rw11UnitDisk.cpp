@@ -1,9 +1,13 @@
 // $Id: Rw11UnitDisk.cpp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2013-2018 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2013-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1306   1.0.7  add VirtCheck(); Dump(): recorder only with
+//                           idle writer
+// 2026-10-19  1305   1.0.6  add VirtWriteAsync(),VirtDrain(), writer thread
+// 2026-10-19  1302   1.0.5  add StartRecord(),StopRecord(),Recorder()
 // 2018-12-19  1090   1.0.4  use RosPrintf(bool)
 // 2018-12-09  1080   1.0.3  use HasVirt(); Virt() returns ref
 // 2017-04-07   868   1.0.2  Dump(): add detail arg
@@ -17,6 +21,7 @@
 */
 
 #include "librtools/Rexception.hpp"
+#include "librtools/RlogMsg.hpp"
 #include "librtools/RosFill.hpp"
 #include "librtools/RosPrintf.hpp"
 
@@ -27,11 +32,26 @@ using namespace std;
 /*!
   \class Retro::Rw11UnitDisk
   \brief FIXME_docs
+
+  VirtWriteAsync() hands a write to a per-unit writer thread and returns
+  immediately, so a controller can complete the request while the backend
+  write is still in progress, and serve other units in the meantime. The
+  writes of a unit are done in order, and VirtRead(), VirtWrite() as well
+  as StartRecord() and StopRecord() wait until all pending writes of the
+  unit are done, so the backend is never accessed concurrently and reads
+  always see the data written before. A failed asynchronous write is
+  latched and returned by the next access of the unit until it is
+  detached, VirtCheck() returns it without waiting for pending writes.
 */
 
 // all method definitions in namespace Retro
 namespace Retro {
 
+//------------------------------------------+-----------------------------------
+// constants definitions
+
+const size_t Rw11UnitDisk::kAsyncBufMax;
+
 //------------------------------------------+-----------------------------------
 //! Constructor
 
@@ -44,14 +64,26 @@ Rw11UnitDisk::Rw11UnitDisk(Rw11Cntl* pcntl, size_t index)
     fNSect(0),
     fBlksize(0),
     fNBlock(),
-    fWProt(false)
+    fWProt(false),
+    fupRecorder(),
+    fWriter(),
+    fAsyncMutex(),
+    fAsyncCond(),
+    fAsyncQueue(),
+    fAsyncBytes(0),
+    fAsyncBusy(false),
+    fAsyncStop(false),
+    fAsyncFail(false),
+    fAsyncEmsg()
 {}
 
 //------------------------------------------+-----------------------------------
 //! Destructor
 
 Rw11UnitDisk::~Rw11UnitDisk()
-{}
+{
+  AsyncStop();                              // must be done before Virt is gone
+}
 
 //------------------------------------------+-----------------------------------
 //! FIXME_docs
@@ -72,7 +104,13 @@ bool Rw11UnitDisk::VirtRead(size_t lba, size_t nblk, uint8_t* data,
     emsg.Init("Rw11UnitDisk::VirtRead", "no disk attached");
     return false;
   }
-  return Virt().Read(lba, nblk, data, emsg);
+  if (!VirtDrain(emsg)) return false;
+  if (!fupRecorder) return Virt().Read(lba, nblk, data, emsg);
+
+  uint64_t tbeg = Rw11DiskRecorder::TimeNs();
+  bool ok = Virt().Read(lba, nblk, data, emsg);
+  fupRecorder->Add(Rw11DiskRecorder::kOpRead, lba, nblk, tbeg, ok);
+  return ok;
 }
 
 //------------------------------------------+-----------------------------------
@@ -80,12 +118,134 @@ bool Rw11UnitDisk::VirtRead(size_t lba, size_t nblk, uint8_t* data,
 
 bool Rw11UnitDisk::VirtWrite(size_t lba, size_t nblk, const uint8_t* data, 
                              RerrMsg& emsg)
+{
+  if (!VirtDrain(emsg)) return false;
+  return VirtWriteRec(lba, nblk, data, emsg);
+}
+
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Queue a write for the writer thread of the unit.
+
+  The data is copied, so \a data can be reused after the call. Blocks only
+  when more than kAsyncBufMax bytes are pending, and returns an error
+  latched by the writer thread for an earlier write. The writer thread is
+  started with the first call.
+ */
+
+bool Rw11UnitDisk::VirtWriteAsync(size_t lba, size_t nblk,
+                                  const uint8_t* data, RerrMsg& emsg)
+{
+  if (!HasVirt()) {
+    emsg.Init("Rw11UnitDisk::VirtWriteAsync", "no disk attached");
+    return false;
+  }
+  if (!fWriter.joinable()) fWriter = thread([this](){ Writer(); });
+
+  unique_lock<mutex> lock(fAsyncMutex);
+  if (fAsyncFail) return AsyncError(emsg);
+  if (fAsyncBytes >= kAsyncBufMax) {
+    fAsyncCond.wait(lock, [this](){ return fAsyncBytes < kAsyncBufMax ||
+                                           fAsyncFail; });
+    if (fAsyncFail) return AsyncError(emsg);
+  }
+  size_t nbyt = nblk*fBlksize;
+  fAsyncQueue.push_back(asyncreq{lba, nblk,
+                                 vector<uint8_t>(data, data+nbyt)});
+  fAsyncBytes += nbyt;
+  fAsyncCond.notify_all();
+  return true;
+}
+
+//------------------------------------------+-----------------------------------
+//! Wait until the writer thread has done all pending writes.
+
+bool Rw11UnitDisk::VirtDrain(RerrMsg& emsg)
+{
+  if (!fWriter.joinable()) return true;
+  unique_lock<mutex> lock(fAsyncMutex);
+  fAsyncCond.wait(lock, [this](){ return (fAsyncQueue.empty() &&
+                                          !fAsyncBusy) || fAsyncFail; });
+  if (fAsyncFail) return AsyncError(emsg);
+  return true;
+}
+
+//------------------------------------------+-----------------------------------
+//! Returns the latched writer error in \a emsg, doesn't wait for writes.
+
+bool Rw11UnitDisk::VirtCheck(RerrMsg& emsg)
+{
+  lock_guard<mutex> lock(fAsyncMutex);
+  if (fAsyncFail) return AsyncError(emsg);
+  return true;
+}
+
+//------------------------------------------+-----------------------------------
+//! Returns number of writes not yet done by the writer thread.
+
+size_t Rw11UnitDisk::NWritePending() const
+{
+  lock_guard<mutex> lock(fAsyncMutex);
+  return fAsyncQueue.size() + (fAsyncBusy ? 1 : 0);
+}
+
+//------------------------------------------+-----------------------------------
+//! Write to backend and record the access when a recorder is attached.
+
+bool Rw11UnitDisk::VirtWriteRec(size_t lba, size_t nblk, const uint8_t* data,
+                                RerrMsg& emsg)
 {
   if (!HasVirt()) {
     emsg.Init("Rw11UnitDisk::VirtWrite", "no disk attached");
     return false;
   }
-  return Virt().Write(lba, nblk, data, emsg);
+  if (!fupRecorder) return Virt().Write(lba, nblk, data, emsg);
+
+  uint64_t tbeg = Rw11DiskRecorder::TimeNs();
+  bool ok = Virt().Write(lba, nblk, data, emsg);
+  fupRecorder->Add(Rw11DiskRecorder::kOpWrite, lba, nblk, tbeg, ok);
+  return ok;
+}
+
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Start recording of backend accesses to file \a fname.
+
+  All VirtRead() and VirtWrite() calls are recorded with lba, block count,
+  start time and latency until StopRecord() is called. The file can be
+  replayed against any disk backend with dskbench. Must be called with
+  the connect lock held.
+ */
+
+bool Rw11UnitDisk::StartRecord(const std::string& fname, RerrMsg& emsg)
+{
+  if (!VirtDrain(emsg)) return false;
+
+  Rw11DiskRecorder::header hdr;
+  hdr.fType    = fType;
+  hdr.fBlkSize = uint32_t(fBlksize);
+  hdr.fNBlock  = uint32_t(fNBlock);
+  hdr.fNCyl    = uint32_t(fNCyl);
+  hdr.fNHead   = uint32_t(fNHead);
+  hdr.fNSect   = uint32_t(fNSect);
+
+  unique_ptr<Rw11DiskRecorder> uprec(new Rw11DiskRecorder());
+  if (!uprec->Open(fname, hdr, emsg)) return false;
+  if (!StopRecord(emsg)) return false;
+  fupRecorder = move(uprec);
+  return true;
+}
+
+//------------------------------------------+-----------------------------------
+//! Stop recording, write pending records and close the file.
+
+bool Rw11UnitDisk::StopRecord(RerrMsg& emsg)
+{
+  if (!fupRecorder) return true;
+  if (!VirtDrain(emsg)) return false;
+  bool ok = fupRecorder->Close(emsg);
+  fupRecorder.reset();
+  return ok;
 }
 
 //------------------------------------------+-----------------------------------
@@ -104,10 +264,102 @@ void Rw11UnitDisk::Dump(std::ostream& os, int ind, const char* text,
   os << bl << "  fBlksize:        " << fBlksize << endl;
   os << bl << "  fNBlock:         " << fNBlock  << endl;
   os << bl << "  fWProt:          " << RosPrintf(fWProt) << endl;
+  os << bl << "  fWriter:         " << RosPrintf(fWriter.joinable()) << endl;
+  {
+    // writer thread adds to the recorder, dump it only while writer is idle
+    unique_lock<mutex> lock(fAsyncMutex);
+    fAsyncCond.wait(lock, [this](){ return !fAsyncBusy; });
+    if (fupRecorder) {
+      fupRecorder->Dump(os, ind+2, "fupRecorder: ", detail);
+    } else {
+      os << bl << "  fupRecorder:     " << fupRecorder.get() << endl;
+    }
+    os << bl << "  fAsyncQueue.size: " << fAsyncQueue.size() << endl;
+    os << bl << "  fAsyncBytes:     " << fAsyncBytes << endl;
+    os << bl << "  fAsyncBusy:      " << RosPrintf(fAsyncBusy) << endl;
+    os << bl << "  fAsyncFail:      " << RosPrintf(fAsyncFail) << endl;
+  }
 
   Rw11UnitVirt<Rw11VirtDisk>::Dump(os, ind, " ^", detail);
   return;
 } 
 
+//------------------------------------------+-----------------------------------
+//! Stop writer thread before the backend is detached.
+
+void Rw11UnitDisk::DetachCleanup()
+{
+  AsyncStop();
+  if (fAsyncFail) {
+    RlogMsg lmsg(LogFile());
+    lmsg << "-E " << Name() << ": async write failed: " << fAsyncEmsg;
+    fAsyncFail = false;
+  }
+  Rw11UnitVirt<Rw11VirtDisk>::DetachCleanup();
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+//! Setup \a emsg from latched writer error, must be called with lock held.
+
+bool Rw11UnitDisk::AsyncError(RerrMsg& emsg)
+{
+  emsg = fAsyncEmsg;
+  return false;
+}
+
+//------------------------------------------+-----------------------------------
+//! Stop writer thread after all pending writes are done.
+
+void Rw11UnitDisk::AsyncStop()
+{
+  if (!fWriter.joinable()) return;
+  {
+    lock_guard<mutex> lock(fAsyncMutex);
+    fAsyncStop = true;
+    fAsyncCond.notify_all();
+  }
+  fWriter.join();
+  fAsyncStop = false;
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Writer thread body.
+
+  Does the queued writes in order until AsyncStop() is called and all
+  pending writes are done. After a failed write the remaining ones are
+  discarded, the error is returned by the next access of the unit.
+ */
+
+void Rw11UnitDisk::Writer()
+{
+  unique_lock<mutex> lock(fAsyncMutex);
+  while (true) {
+    fAsyncCond.wait(lock, [this](){ return fAsyncStop ||
+                                           !fAsyncQueue.empty(); });
+    if (fAsyncQueue.empty()) break;         // stop and nothing pending
+    asyncreq req = move(fAsyncQueue.front());
+    fAsyncQueue.pop_front();
+    fAsyncBytes -= req.fData.size();
+    fAsyncBusy   = true;
+    bool fail    = fAsyncFail;
+    lock.unlock();
+
+    RerrMsg emsg;
+    bool ok = fail || VirtWriteRec(req.fLba, req.fNBlock, req.fData.data(),
+                                   emsg);
+
+    lock.lock();
+    fAsyncBusy = false;
+    if (!ok && !fAsyncFail) {
+      fAsyncFail = true;
+      fAsyncEmsg = emsg;
+    }
+    fAsyncCond.notify_all();                // wakeup drain and back-pressure
+  }
+  return;
+}
 
 } // end namespace Retro
@@ -1,9 +1,12 @@
 // $Id: Rw11UnitDisk.hpp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2013-2017 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2013-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1306   1.0.6  add VirtCheck(); fAsyncCond mutable
+// 2026-10-19  1305   1.0.5  add VirtWriteAsync(),VirtDrain(), writer thread
+// 2026-10-19  1302   1.0.4  add StartRecord(),StopRecord(),Recorder()
 // 2017-04-07   868   1.0.3  Dump(): add detail arg
 // 2015-03-21   659   1.0.2  add fEnabled, Enabled()
 // 2015-02-18   647   1.0.1  add Nwrd2Nblk()
@@ -19,7 +22,15 @@
 #ifndef included_Retro_Rw11UnitDisk
 #define included_Retro_Rw11UnitDisk 1
 
+#include <memory>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
 #include "Rw11VirtDisk.hpp"
+#include "Rw11DiskRecorder.hpp"
 
 #include "Rw11UnitVirt.hpp"
 
@@ -52,10 +63,37 @@ namespace Retro {
                              RerrMsg& emsg);
       bool          VirtWrite(size_t lba, size_t nblk, const uint8_t* data, 
                               RerrMsg& emsg);
+      bool          VirtWriteAsync(size_t lba, size_t nblk,
+                                   const uint8_t* data, RerrMsg& emsg);
+      bool          VirtDrain(RerrMsg& emsg);
+      bool          VirtCheck(RerrMsg& emsg);
+      size_t        NWritePending() const;
+
+      bool          StartRecord(const std::string& fname, RerrMsg& emsg);
+      bool          StopRecord(RerrMsg& emsg);
+      const Rw11DiskRecorder* Recorder() const;
 
       virtual void  Dump(std::ostream& os, int ind=0, const char* text=0,
                          int detail=0) const;
 
+    // some constants (also defined in cpp)
+      static const size_t kAsyncBufMax = 4*1024*1024; //!< back-pressure limit
+
+    protected:
+    // one pending asynchronous write
+      struct asyncreq {
+        size_t      fLba;                   //!< disk lba
+        size_t      fNBlock;                //!< disk blocks to write
+        std::vector<uint8_t> fData;         //!< data to write
+      };
+
+      virtual void  DetachCleanup();
+      bool          VirtWriteRec(size_t lba, size_t nblk, const uint8_t* data,
+                                 RerrMsg& emsg);
+      bool          AsyncError(RerrMsg& emsg);
+      void          AsyncStop();
+      void          Writer();
+
     protected:
       std::string   fType;                  //!< drive type
       bool          fEnabled;               //!< unit enabled
@@ -65,6 +103,16 @@ namespace Retro {
       size_t        fBlksize;               //!< block size (in bytes)
       size_t        fNBlock;                //!< # blocks
       bool          fWProt;                 //!< unit write protected
+      std::unique_ptr<Rw11DiskRecorder> fupRecorder; //!< access recorder
+      std::thread   fWriter;                //!< writer thread
+      mutable std::mutex fAsyncMutex;       //!< protects fAsync* state
+      mutable std::condition_variable fAsyncCond; //!< signals writer, waiters
+      std::deque<asyncreq> fAsyncQueue;     //!< writes pending for writer
+      size_t        fAsyncBytes;            //!< bytes pending in fAsyncQueue
+      bool          fAsyncBusy;             //!< writer is busy
+      bool          fAsyncStop;             //!< writer stop requested
+      bool          fAsyncFail;             //!< writer error latched
+      RerrMsg       fAsyncEmsg;             //!< latched writer error
   };
   
 } // end namespace Retro
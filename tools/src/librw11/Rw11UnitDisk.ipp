@@ -1,9 +1,10 @@
 // $Id: Rw11UnitDisk.ipp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2013-2015 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2013-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1302   1.0.3  add StartRecord(),StopRecord(),Recorder()
 // 2015-03-21   659   1.0.2  add fEnabled, Enabled()
 // 2015-02-18   647   1.0.1  add Nwrd2Nblk()
 // 2013-04-19   507   1.0    Initial version
@@ -119,4 +120,12 @@ inline bool Rw11UnitDisk::WProt() const
 }
 
 
+//------------------------------------------+-----------------------------------
+//! Returns the active access recorder, or nullptr if not recording.
+
+inline const Rw11DiskRecorder* Rw11UnitDisk::Recorder() const
+{
+  return fupRecorder.get();
+}
+
 } // end namespace Retro
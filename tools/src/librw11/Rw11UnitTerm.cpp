@@ -1,9 +1,10 @@
 // $Id: Rw11UnitTerm.cpp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2013-2019 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2013-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1286   1.2.1  add SndReady(),WakeupCntlTx()
 // 2019-05-18  1150   1.2    add detailed stats and StatInc{Rx,Tx}
 // 2018-12-19  1090   1.1.7  use RosPrintf(bool)
 // 2018-12-17  1085   1.1.6  use std::lock_guard instead of boost
@@ -334,6 +335,7 @@ void Rw11UnitTerm::Dump(std::ostream& os, int ind, const char* text,
 void Rw11UnitTerm::AttachDone()
 {
   Virt().SetupRcvCallback(std::bind(&Rw11UnitTerm::RcvCallback, this, _1, _2));
+  Virt().SetupSndRdyCallback(std::bind(&Rw11UnitTerm::WakeupCntlTx, this));
   return;
 }
 
@@ -1,9 +1,10 @@
 // $Id: Rw11UnitTerm.hpp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2013-2019 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2013-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1286   1.2.1  add SndReady(),WakeupCntlTx()
 // 2019-05-18  1150   1.2    add detailed stats and StatInc{Rx,Tx}
 // 2017-04-07   868   1.1.2  Dump(): add detail arg
 // 2017-02-25   855   1.1.1  RcvNext() --> RcvQueueNext(); WakeupCntl() now pure
@@ -57,9 +58,11 @@ namespace Retro {
       virtual size_t Rcv(uint8_t* buf, size_t count);
 
       virtual bool  Snd(const uint8_t* buf, size_t count);
+      bool          SndReady() const;
 
       virtual bool  RcvCallback(const uint8_t* buf, size_t count);
       virtual void  WakeupCntl() = 0;
+      virtual void  WakeupCntlTx() = 0;
 
       virtual void  Dump(std::ostream& os, int ind=0, const char* text=0,
                          int detail=0) const;
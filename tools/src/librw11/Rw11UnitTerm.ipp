@@ -1,9 +1,10 @@
 // $Id: Rw11UnitTerm.ipp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2013-2017 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2013-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1286   1.0.3  add SndReady(),WakeupCntlTx()
 // 2017-02-25   855   1.0.2  inline RcvQueueEmpty(),RcvQueueSize()
 // 2013-04-20   508   1.0.1  add 7bit and non-printable masking; add log file
 // 2013-04-13   504   1.0    Initial version
@@ -92,5 +93,13 @@ inline size_t Rw11UnitTerm::RcvQueueSize()
   return fRcvQueue.size();
 }
 
+//------------------------------------------+-----------------------------------
+//! Returns \c false when the attached virtual terminal asserts backpressure.
+
+inline bool Rw11UnitTerm::SndReady() const
+{
+  return HasVirt() ? Virt().SndReady() : true;
+}
+
 
 } // end namespace Retro
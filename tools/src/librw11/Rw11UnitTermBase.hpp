@@ -1,9 +1,10 @@
 // $Id: Rw11UnitTermBase.hpp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2013-2019 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2013-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1286   1.1.1  add SndReady(),WakeupCntlTx()
 // 2019-05-12  1149   1.1    add AttachDone(),DetachDone()
 // 2017-04-07   868   1.0.1  Dump(): add detail arg
 // 2013-03-03   494   1.0    Initial version
@@ -32,6 +33,7 @@ namespace Retro {
       TC&           Cntl() const;
 
       virtual void  WakeupCntl();
+      virtual void  WakeupCntlTx();
 
       virtual void  Dump(std::ostream& os, int ind=0, const char* text=0,
                          int detail=0) const;
@@ -1,9 +1,10 @@
 // $Id: Rw11VirtDisk.cpp 1190 2019-07-13 17:05:39Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2013-2019 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2013-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1291   1.5    add Rw11VirtDiskPack
 // 2019-06-21  1167   1.4.1  remove dtor
 // 2018-12-02  1076   1.4    use unique_ptr for New()
 // 2018-10-27  1061   1.3    add fNCyl,fNHead,fNSect; add Rw11VirtDiskRam
@@ -25,6 +26,7 @@
 #include "Rw11VirtDiskFile.hpp"
 #include "Rw11VirtDiskOver.hpp"
 #include "Rw11VirtDiskRam.hpp"
+#include "Rw11VirtDiskPack.hpp"
 
 #include "Rw11VirtDisk.hpp"
 
@@ -100,6 +102,10 @@ std::unique_ptr<Rw11VirtDisk> Rw11VirtDisk::New(const std::string& url,
     up.reset(new Rw11VirtDiskRam(punit));
     if (!up->Open(url, emsg)) up.reset();
 
+  } else if (scheme == "pack") {            // scheme -> pack:
+    up.reset(new Rw11VirtDiskPack(punit));
+    if (!up->Open(url, emsg)) up.reset();
+
   } else {                                  // scheme -> no match
     emsg.Init("Rw11VirtDisk::New", string("Scheme '") + scheme +
               "' is not supported");
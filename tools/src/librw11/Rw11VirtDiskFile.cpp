@@ -1,9 +1,10 @@
 // $Id: Rw11VirtDiskFile.cpp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2013-2019 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2013-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1292   1.2.1  Open(): add overload with optlist
 // 2019-06-21  1167   1.2    use RfileFd; remove dtor
 // 2018-09-22  1048   1.1.4  BUGFIX: coverity (resource leak)
 // 2018-09-16  1047   1.1.3  coverity fixup (uninitialized scalar)
@@ -55,7 +56,16 @@ bool Rw11VirtDiskFile::Open(const std::string& url, RerrMsg& emsg)
 bool Rw11VirtDiskFile::Open(const std::string& url, const std::string& scheme,
                             RerrMsg& emsg)
 {
-  if (!fUrl.Set(url, "|wpro|", scheme, emsg)) return false;
+  return Open(url, scheme, "|wpro|", emsg);
+}
+
+//------------------------------------------+-----------------------------------
+//! Open with scheme and option list, \a optlist must contain 'wpro'
+
+bool Rw11VirtDiskFile::Open(const std::string& url, const std::string& scheme,
+                            const std::string& optlist, RerrMsg& emsg)
+{
+  if (!fUrl.Set(url, optlist, scheme, emsg)) return false;
   
   fWProt = fUrl.FindOpt("wpro");
 
@@ -1,9 +1,10 @@
 // $Id: Rw11VirtDiskFile.hpp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2013-2019 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2013-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1292   1.1.1  Open(): add overload with optlist
 // 2019-06-21  1167   1.1    use RfileFd; remove dtor
 // 2017-04-15   875   1.0.2  Open(): add overload with scheme handling
 // 2017-04-07   868   1.0.1  Dump(): add detail arg
@@ -33,6 +34,8 @@ namespace Retro {
       virtual bool  Open(const std::string& url, RerrMsg& emsg);
       bool          Open(const std::string& url, const std::string& scheme,
                          RerrMsg& emsg);
+      bool          Open(const std::string& url, const std::string& scheme,
+                         const std::string& optlist, RerrMsg& emsg);
 
       virtual bool  Read(size_t lba, size_t nblk, uint8_t* data, 
                          RerrMsg& emsg);
@@ -1,9 +1,10 @@
 // $Id: Rw11VirtDiskOver.cpp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2017-2018 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2017-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1292   1.1    add persistent snapshot layers
 // 2018-12-22  1091   1.0.6  Read(): it->it1 (-Wshadow fix)
 // 2017-06-05   907   1.0.5  more detailed stats
 // 2017-06-03   903   1.0.4  Read(): BUGFIX: fix index error in blockwise read
@@ -17,6 +18,12 @@
   \brief   Implemenation of Rw11VirtDiskOver.
 */
 
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+
+#include <algorithm>
+
 #include "librtools/RosFill.hpp"
 #include "librtools/RosPrintf.hpp"
 
@@ -32,12 +39,20 @@ using namespace std;
 // all method definitions in namespace Retro
 namespace Retro {
 
+//------------------------------------------+-----------------------------------
+// constants definitions
+
+const std::string Rw11VirtDiskOver::kSnapMagic("w11layr1");
+const size_t Rw11VirtDiskOver::kSnapDepthMax;
+
 //------------------------------------------+-----------------------------------
 //! Default constructor
 
 Rw11VirtDiskOver::Rw11VirtDiskOver(Rw11Unit* punit)
   : Rw11VirtDiskFile(punit),
-    fBlkMap()
+    fBlkMap(),
+    fLayers(),
+    fOwner()
 {
   fStats.Define(kStatNVDORead,      "NVDORead",     "over: Read() calls");
   fStats.Define(kStatNVDOReadBlkFF, "NVDOReadBlkFF",
@@ -49,6 +64,12 @@ Rw11VirtDiskOver::Rw11VirtDiskOver(Rw11Unit* punit)
   fStats.Define(kStatNVDOWrite,     "NVDOWrite",    "over: Write() calls");
   fStats.Define(kStatNVDOWriteBlk,  "NVDOWriteBlk", "over: blocks written");
   fStats.Define(kStatNVDOFlush,     "NVDOFlush",    "over: Flush() calls");
+  fStats.Define(kStatNVDOReadBlkS,  "NVDOReadBlkS",
+                                      "over: blocks read from snapshot");
+  fStats.Define(kStatNVDOWriteBlkS, "NVDOWriteBlkS",
+                                      "over: blocks rewritten in snapshot");
+  fStats.Define(kStatNVDOWriteBlkA, "NVDOWriteBlkA",
+                                      "over: blocks appended to snapshot");
 }
 
 //------------------------------------------+-----------------------------------
@@ -71,7 +92,13 @@ bool Rw11VirtDiskOver::WProt() const
 bool Rw11VirtDiskOver::Open(const std::string& url, RerrMsg& emsg)
 {
   // FIXME_code: do we need to handle wpro ?
-  return Rw11VirtDiskFile::Open(url, "over", emsg);
+  if (!Rw11VirtDiskFile::Open(url, "over", "|wpro|snap=|", emsg)) return false;
+
+  string snap;
+  if (fUrl.FindOpt("snap", snap) && snap.length() > 0) {
+    if (!SnapLoad(snap, emsg)) return false;
+  }
+  return true;
 }
 
 //------------------------------------------+-----------------------------------
@@ -81,6 +108,30 @@ bool Rw11VirtDiskOver::Read(size_t lba, size_t nblk, uint8_t* data,
                             RerrMsg& emsg)
 {
   fStats.Inc(kStatNVDORead);
+
+  if (!fLayers.empty()) {                   // snapshot layers active
+    if (!SnapCheck(emsg)) return false;
+    size_t i = 0;
+    while (i < nblk) {
+      uint16_t own = SnapOwner(lba+i);
+      if (own == 0) {                       // get runs from base in one swoop
+        size_t nrun = 1;
+        while (i+nrun < nblk && SnapOwner(lba+i+nrun) == 0) nrun += 1;
+        fStats.Inc(kStatNVDOReadBlkFP, double(nrun));
+        if (!Rw11VirtDiskFile::Read(lba+i, nrun, data+i*fBlkSize, emsg))
+          return false;
+        i += nrun;
+      } else {
+        fStats.Inc(kStatNVDOReadBlkS);
+        const layer& lay = *fLayers[own-1];
+        if (!SnapRead(lay, lay.fRec.at(lba+i), data+i*fBlkSize, emsg))
+          return false;
+        i += 1;
+      }
+    }
+    return true;
+  }
+
   auto it = fBlkMap.lower_bound(lba);
 
   if (it == fBlkMap.end() || it->first >= lba+nblk) { // no match
@@ -107,10 +158,22 @@ bool Rw11VirtDiskOver::Read(size_t lba, size_t nblk, uint8_t* data,
 //! FIXME_docs
 
 bool Rw11VirtDiskOver::Write(size_t lba, size_t nblk, const uint8_t* data, 
-                             RerrMsg& /*emsg*/)
+                             RerrMsg& emsg)
 {
   fStats.Inc(kStatNVDOWrite);
   fStats.Inc(kStatNVDOWriteBlk, double(nblk));
+
+  if (!fLayers.empty()) {                   // snapshot layers active
+    if (!SnapCheck(emsg)) return false;
+    layer& top = *fLayers.back();
+    if (top.fWProt) {
+      emsg.Init("Rw11VirtDiskOver::Write()", 
+                string("snapshot '") + top.fName + "' write protected");
+      return false;
+    }
+    return SnapWrite(top, uint16_t(fLayers.size()), lba, nblk, data, emsg);
+  }
+
   for (size_t i=0; i<nblk; i++) {
     auto it = fBlkMap.find(lba+i);
     if (it == fBlkMap.end()) {
@@ -176,8 +239,362 @@ void Rw11VirtDiskOver::Dump(std::ostream& os, int ind, const char* text,
   os << bl << (text?text:"--") << "Rw11VirtDiskOver @ " << this << endl;
 
   os << bl << "  fBlkMap.size:    " << fBlkMap.size() << endl;
+  os << bl << "  fLayers.size:    " << fLayers.size() << endl;
+  for (auto& o: fLayers) {
+    os << bl << "    " << o->fName << " : nrec=" << o->fNRec
+       << " nblk=" << o->fRec.size() << endl;
+  }
+  os << bl << "  fOwner.size:     " << fOwner.size() << endl;
   Rw11VirtDiskFile::Dump(os, ind, " ^", detail);
   return;
 }
 
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Create a new snapshot layer on top of the current ones.
+
+  All further writes go to the new layer file \a fname. Blocks of the
+  in-memory overlay, if any, are moved into the new layer.
+ */
+
+bool Rw11VirtDiskOver::SnapCreate(const std::string& fname, RerrMsg& emsg)
+{
+  if (fLayers.size() >= kSnapDepthMax) {
+    emsg.Init("Rw11VirtDiskOver::SnapCreate()", "snapshot chain too long");
+    return false;
+  }
+  if (fBlkSize == 0) {
+    emsg.Init("Rw11VirtDiskOver::SnapCreate()", "disk not set up");
+    return false;
+  }
+
+  layer_uptr_t up(new layer());
+  up->fName    = fname;
+  up->fParent  = fLayers.empty() ? string() : fLayers.back()->fName;
+  up->fBlkSize = fBlkSize;
+  if (!up->fFd.Open(fname.c_str(), O_RDWR|O_CREAT|O_EXCL,
+                    S_IRUSR|S_IWUSR|S_IRGRP|S_IROTH, emsg)) return false;
+
+  // header: magic, block size, parent name length, parent name, pad to 8
+  uint32_t hdr[2] = {uint32_t(fBlkSize), uint32_t(up->fParent.length())};
+  up->fDataOff = kSnapMagic.length() + sizeof(hdr) +
+                 ((up->fParent.length()+7) & ~size_t(7));
+  string buf(kSnapMagic);
+  buf.append(reinterpret_cast<const char*>(hdr), sizeof(hdr));
+  buf.append(up->fParent);
+  buf.resize(up->fDataOff, '\0');
+  if (!up->fFd.WriteAll(buf.data(), buf.length(), emsg)) {
+    up->fFd.Close();
+    ::unlink(fname.c_str());
+    return false;
+  }
+
+  fLayers.push_back(move(up));
+
+  // move in-memory overlay into the new layer
+  layer& top = *fLayers.back();
+  for (auto& kv: fBlkMap) {
+    if (!SnapWrite(top, uint16_t(fLayers.size()), kv.first, 1,
+                   kv.second.Data(), emsg)) return false;
+  }
+  fBlkMap.clear();
+  return true;
+}
+
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Merge the topmost snapshot layer into its parent.
+
+  The parent is the next lower layer, or the base file when only one layer
+  is left. The layer file is removed afterwards.
+ */
+
+bool Rw11VirtDiskOver::SnapCommit(RerrMsg& emsg)
+{
+  if (fLayers.empty()) {
+    emsg.Init("Rw11VirtDiskOver::SnapCommit()", "no snapshot layer");
+    return false;
+  }
+  if (!SnapCheck(emsg)) return false;
+
+  layer& top = *fLayers.back();
+  size_t npar = fLayers.size()-1;           // 1-based index of parent
+  layer* ppar = (npar > 0) ? fLayers[npar-1].get() : nullptr;
+  if ((ppar && ppar->fWProt) || (!ppar && fWProt)) {
+    emsg.Init("Rw11VirtDiskOver::SnapCommit()", 
+              string("parent of '") + top.fName + "' write protected");
+    return false;
+  }
+
+  // merge in lba order, gives sequential access on the parent
+  vector<pair<uint32_t,uint32_t>> recs(top.fRec.begin(), top.fRec.end());
+  sort(recs.begin(), recs.end());
+  vector<uint8_t> buf(fBlkSize);
+  for (auto& o: recs) {
+    if (!SnapRead(top, o.second, buf.data(), emsg)) return false;
+    if (ppar) {
+      if (!SnapWrite(*ppar, uint16_t(npar), o.first, 1, buf.data(), emsg))
+        return false;
+    } else {
+      if (!Rw11VirtDiskFile::Write(o.first, 1, buf.data(), emsg))
+        return false;
+      SnapOwnerSet(o.first, 0);
+    }
+  }
+
+  string fname = top.fName;
+  fLayers.pop_back();
+  if (fLayers.empty()) fOwner.clear();
+  if (::unlink(fname.c_str()) < 0) {
+    emsg.InitErrno("Rw11VirtDiskOver::SnapCommit()",
+                   string("merged, but unlink '") + fname + "' failed: ",
+                   errno);
+    return false;
+  }
+  return true;
+}
+
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Drop the topmost snapshot layer and remove its file.
+ */
+
+bool Rw11VirtDiskOver::SnapDiscard(RerrMsg& emsg)
+{
+  if (fLayers.empty()) {
+    emsg.Init("Rw11VirtDiskOver::SnapDiscard()", "no snapshot layer");
+    return false;
+  }
+
+  layer_uptr_t up = move(fLayers.back());
+  fLayers.pop_back();
+  for (auto& kv: up->fRec) {                // find new topmost owner
+    uint16_t own = 0;
+    for (size_t i=fLayers.size(); i>0; i--) {
+      if (fLayers[i-1]->fRec.count(kv.first)) {
+        own = uint16_t(i);
+        break;
+      }
+    }
+    SnapOwnerSet(kv.first, own);
+  }
+  if (fLayers.empty()) fOwner.clear();
+
+  up->fFd.Close();
+  if (::unlink(up->fName.c_str()) < 0) {
+    emsg.InitErrno("Rw11VirtDiskOver::SnapDiscard()",
+                   string("unlink '") + up->fName + "' failed: ", errno);
+    return false;
+  }
+  return true;
+}
+
+//------------------------------------------+-----------------------------------
+//! List snapshot layers, topmost first
+
+void Rw11VirtDiskOver::SnapList(std::ostream& os) const
+{
+  for (size_t i=fLayers.size(); i>0; i--) {
+    const layer& lay = *fLayers[i-1];
+    os << RosPrintf(i,"d",2) << " " << lay.fName
+       << " : nb=" << RosPrintf(lay.fRec.size(),"d",8)
+       << " nr=" << RosPrintf(lay.fNRec,"d",8)
+       << (lay.fWProt ? " wpro" : "") << endl;
+  }
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+//! Open snapshot chain with topmost layer \a fname
+
+bool Rw11VirtDiskOver::SnapLoad(const std::string& fname, RerrMsg& emsg)
+{
+  vector<layer_uptr_t> chain;               // topmost first
+  string name = fname;
+  while (name.length() > 0) {
+    if (chain.size() >= kSnapDepthMax) {
+      emsg.Init("Rw11VirtDiskOver::SnapLoad()", "snapshot chain too long");
+      return false;
+    }
+    layer_uptr_t up(new layer());
+    up->fName = name;
+    if (!SnapOpen(*up, emsg)) return false;
+    name = up->fParent;
+    chain.push_back(move(up));
+  }
+
+  fLayers.clear();
+  fOwner.clear();
+  for (auto it=chain.rbegin(); it!=chain.rend(); it++) {
+    fLayers.push_back(move(*it));
+    for (auto& kv: fLayers.back()->fRec) 
+      SnapOwnerSet(kv.first, uint16_t(fLayers.size()));
+  }
+  return true;
+}
+
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Open layer file and build its block map.
+
+  The records are scanned in chunks of about 1 MB. A torn record at the
+  end, e.g. after a crash, ends the scan and will be overwritten by the
+  next append.
+ */
+
+bool Rw11VirtDiskOver::SnapOpen(layer& lay, RerrMsg& emsg)
+{
+  RerrMsg emsg_rw;
+  if (!lay.fFd.Open(lay.fName.c_str(), O_RDWR, emsg_rw)) {
+    if (!lay.fFd.Open(lay.fName.c_str(), O_RDONLY, emsg)) return false;
+    lay.fWProt = true;
+  }
+
+  char     magic[8];
+  uint32_t hdr[2];
+  if (::pread(lay.fFd.Fd(), magic, sizeof(magic), 0) != sizeof(magic) ||
+      ::memcmp(magic, kSnapMagic.data(), sizeof(magic)) != 0 ||
+      ::pread(lay.fFd.Fd(), hdr, sizeof(hdr), sizeof(magic)) != sizeof(hdr) ||
+      hdr[0] == 0 || hdr[0] > 65536 || hdr[1] > 4096) {
+    emsg.Init("Rw11VirtDiskOver::SnapOpen()",
+              string("'") + lay.fName + "' is not a snapshot layer");
+    return false;
+  }
+  lay.fBlkSize = hdr[0];
+  lay.fParent.resize(hdr[1]);
+  if (hdr[1] > 0 &&
+      ::pread(lay.fFd.Fd(), &lay.fParent[0], hdr[1], sizeof(magic)+sizeof(hdr))
+      != ssize_t(hdr[1])) {
+    emsg.Init("Rw11VirtDiskOver::SnapOpen()",
+              string("'") + lay.fName + "' bad header");
+    return false;
+  }
+  lay.fDataOff = sizeof(magic) + sizeof(hdr) + ((hdr[1]+7) & ~uint32_t(7));
+
+  struct stat sbuf;
+  if (!lay.fFd.Stat(&sbuf, emsg)) return false;
+  size_t fsize  = sbuf.st_size;
+  size_t recsiz = SnapRecSize(lay);
+  size_t nrec   = (fsize > lay.fDataOff) ? (fsize-lay.fDataOff)/recsiz : 0;
+
+  size_t nchunk = max(size_t(1), size_t(1024*1024)/recsiz);
+  vector<uint8_t> buf(nchunk*recsiz);
+  lay.fRec.clear();
+  lay.fNRec = 0;
+  for (size_t i=0; i<nrec; i+=nchunk) {
+    size_t nget = min(nchunk, nrec-i);
+    if (::pread(lay.fFd.Fd(), buf.data(), nget*recsiz,
+                lay.fDataOff+i*recsiz) != ssize_t(nget*recsiz)) {
+      emsg.InitErrno("Rw11VirtDiskOver::SnapOpen()", 
+                     string("read '") + lay.fName + "' failed: ", errno);
+      return false;
+    }
+    for (size_t j=0; j<nget; j++) {
+      uint32_t rhdr[2];
+      ::memcpy(rhdr, buf.data()+j*recsiz, sizeof(rhdr));
+      if (rhdr[1] != ~rhdr[0]) return true;  // torn record, stop here
+      lay.fRec[rhdr[0]] = lay.fNRec;
+      lay.fNRec += 1;
+    }
+  }
+  return true;
+}
+
+//------------------------------------------+-----------------------------------
+//! Check that all layers match disk block size
+
+bool Rw11VirtDiskOver::SnapCheck(RerrMsg& emsg) const
+{
+  for (auto& o: fLayers) {
+    if (o->fBlkSize != fBlkSize) {
+      emsg.Init("Rw11VirtDiskOver::SnapCheck()", 
+                string("block size mismatch for '") + o->fName + "'");
+      return false;
+    }
+  }
+  return true;
+}
+
+//------------------------------------------+-----------------------------------
+//! Read data of record \a rec of layer \a lay
+
+bool Rw11VirtDiskOver::SnapRead(const layer& lay, uint32_t rec, uint8_t* data,
+                                RerrMsg& emsg)
+{
+  size_t pos = lay.fDataOff + rec*SnapRecSize(lay) + 2*sizeof(uint32_t);
+  if (::pread(lay.fFd.Fd(), data, lay.fBlkSize, pos) != 
+      ssize_t(lay.fBlkSize)) {
+    emsg.InitErrno("Rw11VirtDiskOver::SnapRead()", 
+                   string("read '") + lay.fName + "' failed: ", errno);
+    return false;
+  }
+  return true;
+}
+
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Write blocks into layer \a lay, which is layer \a own (1-based).
+
+  Blocks already held by the layer are rewritten in place, all others are
+  appended as new records with a single pwrite().
+ */
+
+bool Rw11VirtDiskOver::SnapWrite(layer& lay, uint16_t own, size_t lba,
+                                 size_t nblk, const uint8_t* data,
+                                 RerrMsg& emsg)
+{
+  size_t recsiz = SnapRecSize(lay);
+  vector<uint8_t> abuf;
+  vector<uint32_t> alba;
+
+  for (size_t i=0; i<nblk; i++) {
+    uint32_t blba = uint32_t(lba+i);
+    const uint8_t* pdat = data + i*lay.fBlkSize;
+    auto it = lay.fRec.find(blba);
+    if (it != lay.fRec.end()) {             // rewrite in place
+      fStats.Inc(kStatNVDOWriteBlkS);
+      size_t pos = lay.fDataOff + it->second*recsiz + 2*sizeof(uint32_t);
+      if (::pwrite(lay.fFd.Fd(), pdat, lay.fBlkSize, pos) != 
+          ssize_t(lay.fBlkSize)) {
+        emsg.InitErrno("Rw11VirtDiskOver::SnapWrite()", 
+                       string("write '") + lay.fName + "' failed: ", errno);
+        return false;
+      }
+      SnapOwnerSet(blba, own);
+    } else {                                // append
+      uint32_t rhdr[2] = {blba, ~blba};
+      const uint8_t* phdr = reinterpret_cast<const uint8_t*>(rhdr);
+      abuf.insert(abuf.end(), phdr, phdr+sizeof(rhdr));
+      abuf.insert(abuf.end(), pdat, pdat+lay.fBlkSize);
+      alba.push_back(blba);
+    }
+  }
+
+  if (alba.empty()) return true;
+  fStats.Inc(kStatNVDOWriteBlkA, double(alba.size()));
+  size_t pos = lay.fDataOff + lay.fNRec*recsiz;
+  if (::pwrite(lay.fFd.Fd(), abuf.data(), abuf.size(), pos) != 
+      ssize_t(abuf.size())) {
+    emsg.InitErrno("Rw11VirtDiskOver::SnapWrite()", 
+                   string("append '") + lay.fName + "' failed: ", errno);
+    return false;
+  }
+  for (auto blba: alba) {
+    lay.fRec[blba] = lay.fNRec;
+    lay.fNRec += 1;
+    SnapOwnerSet(blba, own);
+  }
+  return true;
+}
+
+//------------------------------------------+-----------------------------------
+//! Set topmost owning layer of block \a lba
+
+void Rw11VirtDiskOver::SnapOwnerSet(uint32_t lba, uint16_t own)
+{
+  if (lba >= fOwner.size()) fOwner.resize(max(size_t(lba)+1, fNBlock), 0);
+  fOwner[lba] = own;
+  return;
+}
+
 } // end namespace Retro
@@ -1,9 +1,10 @@
 // $Id: Rw11VirtDiskOver.hpp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2017- by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2017-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1292   1.1    add persistent snapshot layers
 // 2017-06-05   907   1.0.2  more detailed stats
 // 2017-04-07   868   1.0.1  Dump(): add detail arg
 // 2017-03-10   859   1.0    Initial version
@@ -18,6 +19,9 @@
 #define included_Retro_Rw11VirtDiskOver 1
 
 #include <map>
+#include <vector>
+#include <memory>
+#include <unordered_map>
 
 #include "Rw11VirtDiskBuffer.hpp"
 
@@ -45,6 +49,12 @@ namespace Retro {
       bool          Flush(RerrMsg& emsg);
       void          List(std::ostream& os) const;
 
+      bool          SnapCreate(const std::string& fname, RerrMsg& emsg);
+      bool          SnapCommit(RerrMsg& emsg);
+      bool          SnapDiscard(RerrMsg& emsg);
+      void          SnapList(std::ostream& os) const;
+      size_t        SnapDepth() const;
+
       virtual void  Dump(std::ostream& os, int ind=0, const char* text=0,
                          int detail=0) const;
 
@@ -57,15 +67,56 @@ namespace Retro {
         kStatNVDOWrite,
         kStatNVDOWriteBlk,
         kStatNVDOFlush,
+        kStatNVDOReadBlkS,
+        kStatNVDOWriteBlkS,
+        kStatNVDOWriteBlkA,
         kDimStat
       };    
 
+    // some constants (also defined in cpp)
+      static const std::string kSnapMagic;  //!< snapshot layer file magic
+      static const size_t kSnapDepthMax = 64; //!< max snapshot chain length
+
+    protected:
+      /*!
+        \brief snapshot layer: an append-only file of (lba,data) records on
+        top of a parent layer or the base file.
+       */
+      struct layer {
+        std::string fName;                  //!< file name
+        std::string fParent;                //!< parent name ("" for base)
+        RfileFd     fFd;                    //!< file
+        bool        fWProt;                 //!< file write protected
+        size_t      fBlkSize;               //!< block size
+        size_t      fDataOff;               //!< offset of first record
+        uint32_t    fNRec;                  //!< number of records
+        std::unordered_map<uint32_t,uint32_t> fRec; //!< lba -> record index
+
+                    layer() : fName(), fParent(), fFd("Rw11VirtDiskOver::layer."),
+                              fWProt(false), fBlkSize(0), fDataOff(0),
+                              fNRec(0), fRec() {}
+      };
+      typedef std::unique_ptr<layer> layer_uptr_t;
+
+      bool          SnapLoad(const std::string& fname, RerrMsg& emsg);
+      bool          SnapOpen(layer& lay, RerrMsg& emsg);
+      bool          SnapCheck(RerrMsg& emsg) const;
+      bool          SnapRead(const layer& lay, uint32_t rec, uint8_t* data,
+                             RerrMsg& emsg);
+      bool          SnapWrite(layer& lay, uint16_t own, size_t lba,
+                              size_t nblk, const uint8_t* data, RerrMsg& emsg);
+      void          SnapOwnerSet(uint32_t lba, uint16_t own);
+      uint16_t      SnapOwner(uint32_t lba) const;
+      size_t        SnapRecSize(const layer& lay) const;
+
     protected:
-      bmap_t        fBlkMap;
+      bmap_t        fBlkMap;                //!< in-memory overlay
+      std::vector<layer_uptr_t> fLayers;    //!< snapshot layers, bottom first
+      std::vector<uint16_t> fOwner;         //!< topmost owning layer (1-based)
   };
   
 } // end namespace Retro
 
-//#include "Rw11VirtDiskOver.ipp"
+#include "Rw11VirtDiskOver.ipp"
 
 #endif
@@ -0,0 +1,41 @@
+// $Id: Rw11VirtDiskOver.ipp 1292 2026-10-19 10:41:07Z mueller $
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// 
+// Revision History: 
+// Date         Rev Version  Comment
+// 2026-10-19  1292   1.0    Initial version
+// ---------------------------------------------------------------------------
+
+/*!
+  \brief   Implemenation (inline) of Rw11VirtDiskOver.
+*/
+
+// all method definitions in namespace Retro
+namespace Retro {
+
+//------------------------------------------+-----------------------------------
+//! Returns number of snapshot layers
+
+inline size_t Rw11VirtDiskOver::SnapDepth() const
+{
+  return fLayers.size();
+}
+
+//------------------------------------------+-----------------------------------
+//! Returns topmost layer owning block \a lba (1-based), 0 if none
+
+inline uint16_t Rw11VirtDiskOver::SnapOwner(uint32_t lba) const
+{
+  return (lba < fOwner.size()) ? fOwner[lba] : 0;
+}
+
+//------------------------------------------+-----------------------------------
+//! Returns record size of layer \a lay
+
+inline size_t Rw11VirtDiskOver::SnapRecSize(const layer& lay) const
+{
+  return 2*sizeof(uint32_t) + lay.fBlkSize;
+}
+
+} // end namespace Retro
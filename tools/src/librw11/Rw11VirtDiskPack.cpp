@@ -0,0 +1,345 @@
+// $Id: Rw11VirtDiskPack.cpp 1291 2026-10-19 09:12:31Z mueller $
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// 
+// Revision History: 
+// Date         Rev Version  Comment
+// 2026-10-19  1291   1.0    Initial version
+// ---------------------------------------------------------------------------
+
+/*!
+  \brief   Implemenation of Rw11VirtDiskPack.
+*/
+
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <zlib.h>
+
+#include "librtools/RosFill.hpp"
+#include "librtools/RosPrintf.hpp"
+
+#include "Rw11VirtDiskPack.hpp"
+
+using namespace std;
+
+/*!
+  \class Retro::Rw11VirtDiskPack
+  \brief Virtual disk with a compressed, read-only base image.
+
+  The base image is a container file, created with \c disk2pack, which holds
+  the disk image in compressed clusters:
+    - header: magic 'w11pack1', cluster size (32 bit), number of clusters
+      (32 bit), and image size in bytes (64 bit)
+    - index: for each cluster the file offset (64 bit), the stored length
+      (32 bit) and flags (32 bit). A length of 0 denotes an all-zero cluster,
+      the flag kFlagRaw an uncompressed cluster. Clusters with identical
+      content can share the stored data.
+    - data: zlib compressed clusters
+
+  All values are little-endian. Clusters are decompressed on demand into a
+  small LRU cache. Writes go to an in-memory overlay, like for scheme over:,
+  so the container is never modified.
+*/
+
+// all method definitions in namespace Retro
+namespace Retro {
+
+//------------------------------------------+-----------------------------------
+// constants definitions
+
+const std::string Rw11VirtDiskPack::kMagic("w11pack1");
+const size_t   Rw11VirtDiskPack::kHdrSize;
+const size_t   Rw11VirtDiskPack::kIdxSize;
+const size_t   Rw11VirtDiskPack::kCacheSize;
+const uint32_t Rw11VirtDiskPack::kFlagRaw;
+
+//------------------------------------------+-----------------------------------
+//! Default constructor
+
+Rw11VirtDiskPack::Rw11VirtDiskPack(Rw11Unit* punit)
+  : Rw11VirtDisk(punit),
+    fFd("Rw11VirtDiskPack::fFd."),
+    fCluSize(0),
+    fImgSize(0),
+    fIndex(),
+    fCache(kCacheSize),
+    fCacheClu(kCacheSize, size_t(-1)),
+    fCacheUse(kCacheSize, 0),
+    fCacheTick(0),
+    fZBuf(),
+    fBlkMap()
+{
+  fStats.Define(kStatNVDPRead,     "NVDPRead",     "pack: Read() calls");
+  fStats.Define(kStatNVDPReadBlkP, "NVDPReadBlkP", "pack: blocks read pack");
+  fStats.Define(kStatNVDPReadBlkO, "NVDPReadBlkO", "pack: blocks read over");
+  fStats.Define(kStatNVDPCluHit,   "NVDPCluHit",   "pack: cluster cache hits");
+  fStats.Define(kStatNVDPCluLoad,  "NVDPCluLoad",  "pack: clusters inflated");
+  fStats.Define(kStatNVDPCluZero,  "NVDPCluZero",  "pack: zero clusters read");
+  fStats.Define(kStatNVDPWrite,    "NVDPWrite",    "pack: Write() calls");
+  fStats.Define(kStatNVDPWriteBlk, "NVDPWriteBlk", "pack: blocks written");
+}
+
+//------------------------------------------+-----------------------------------
+//! Destructor
+
+Rw11VirtDiskPack::~Rw11VirtDiskPack()
+{}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+bool Rw11VirtDiskPack::WProt() const
+{
+  return false;                             // from unit always writable !!
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+bool Rw11VirtDiskPack::Open(const std::string& url, RerrMsg& emsg)
+{
+  if (!fUrl.Set(url, "", "pack", emsg)) return false;
+
+  if (!fFd.Open(fUrl.Path().c_str(), O_RDONLY, emsg)) return false;
+
+  struct stat sbuf;
+  if (!fFd.Stat(&sbuf, emsg)) {
+    fFd.Close();
+    return false;
+  }
+  size_t fsize = sbuf.st_size;
+
+  // helpers to get little-endian fields
+  auto get32 = [](const uint8_t* p) {
+    return uint32_t(p[0]) | uint32_t(p[1])<<8 |
+           uint32_t(p[2])<<16 | uint32_t(p[3])<<24;
+  };
+  auto get64 = [&get32](const uint8_t* p) {
+    return uint64_t(get32(p)) | uint64_t(get32(p+4))<<32;
+  };
+
+  uint8_t hdr[kHdrSize];
+  if (fsize < kHdrSize ||
+      ::pread(fFd.Fd(), hdr, kHdrSize, 0) != ssize_t(kHdrSize) ||
+      ::memcmp(hdr, kMagic.data(), kMagic.size()) != 0) {
+    emsg.Init("Rw11VirtDiskPack::Open()",
+              string("not a pack container: '") + fUrl.Path() + "'");
+    fFd.Close();
+    return false;
+  }
+
+  fCluSize = get32(hdr+8);
+  size_t ncl = get32(hdr+12);
+  fImgSize = get64(hdr+16);
+  if (fCluSize == 0 || fCluSize > (size_t(1)<<24) ||
+      (fImgSize+fCluSize-1)/fCluSize != ncl ||
+      kHdrSize+ncl*kIdxSize > fsize) {
+    emsg.Init("Rw11VirtDiskPack::Open()", "bad container header");
+    fFd.Close();
+    return false;
+  }
+
+  vector<uint8_t> ibuf(ncl*kIdxSize);
+  if (ncl > 0 && ::pread(fFd.Fd(), ibuf.data(), ibuf.size(), kHdrSize) !=
+                   ssize_t(ibuf.size())) {
+    emsg.InitErrno("Rw11VirtDiskPack::Open()", "index read failed: ", errno);
+    fFd.Close();
+    return false;
+  }
+
+  size_t zmax = 0;
+  fIndex.resize(ncl);
+  for (size_t i=0; i<ncl; i++) {
+    cluster& cl = fIndex[i];
+    const uint8_t* p = ibuf.data() + i*kIdxSize;
+    cl.fOffset = get64(p);
+    cl.fLength = get32(p+8);
+    cl.fFlags  = get32(p+12);
+    if (cl.fOffset+cl.fLength > fsize ||
+        ((cl.fFlags & kFlagRaw) && cl.fLength != 0 &&
+         cl.fLength != min(fCluSize, fImgSize-i*fCluSize))) {
+      emsg.Init("Rw11VirtDiskPack::Open()",
+                string("bad index entry for cluster ") + to_string(i));
+      fFd.Close();
+      return false;
+    }
+    if (cl.fLength > zmax) zmax = cl.fLength;
+  }
+
+  fZBuf.resize(zmax);
+  for (auto& o: fCache) o.resize(fCluSize);
+  for (auto& o: fCacheClu) o = size_t(-1);
+  fBlkMap.clear();
+
+  return true;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+bool Rw11VirtDiskPack::Read(size_t lba, size_t nblk, uint8_t* data,
+                            RerrMsg& emsg)
+{
+  fStats.Inc(kStatNVDRead);
+  fStats.Inc(kStatNVDReadBlk, double(nblk));
+  fStats.Inc(kStatNVDPRead);
+
+  // read runs of blocks not in overlay in one go from pack
+  size_t iblk = 0;
+  while (iblk < nblk) {
+    auto it = fBlkMap.lower_bound(lba+iblk);
+    size_t nrun = (it == fBlkMap.end()) ? nblk-iblk :
+                    min(nblk-iblk, size_t(it->first)-(lba+iblk));
+    if (nrun > 0) {
+      fStats.Inc(kStatNVDPReadBlkP, double(nrun));
+      if (!ReadPack((lba+iblk)*fBlkSize, nrun*fBlkSize, data+iblk*fBlkSize,
+                    emsg)) return false;
+      iblk += nrun;
+    } else {
+      fStats.Inc(kStatNVDPReadBlkO);
+      (it->second).Read(data+iblk*fBlkSize);
+      iblk += 1;
+    }
+  }
+  return true;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+bool Rw11VirtDiskPack::Write(size_t lba, size_t nblk, const uint8_t* data,
+                             RerrMsg& /*emsg*/)
+{
+  fStats.Inc(kStatNVDWrite);
+  fStats.Inc(kStatNVDWriteBlk, double(nblk));
+  fStats.Inc(kStatNVDPWrite);
+  fStats.Inc(kStatNVDPWriteBlk, double(nblk));
+  for (size_t i=0; i<nblk; i++) {
+    auto it = fBlkMap.find(lba+i);
+    if (it == fBlkMap.end()) {
+      auto rc = fBlkMap.emplace(lba+i, Rw11VirtDiskBuffer(fBlkSize));
+      it = rc.first;
+    }
+    (it->second).Write(data+i*fBlkSize);
+  }
+  return true;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+void Rw11VirtDiskPack::Dump(std::ostream& os, int ind, const char* text,
+                            int detail) const
+{
+  RosFill bl(ind);
+  os << bl << (text?text:"--") << "Rw11VirtDiskPack @ " << this << endl;
+
+  os << bl << "  fFd:             " << fFd.Fd() << endl;
+  os << bl << "  fCluSize:        " << fCluSize << endl;
+  os << bl << "  fImgSize:        " << fImgSize << endl;
+  os << bl << "  fIndex.size:     " << fIndex.size() << endl;
+  os << bl << "  fCacheClu:      ";
+  for (auto& o: fCacheClu) {
+    if (o == size_t(-1)) {
+      os << " -";
+    } else {
+      os << " " << o;
+    }
+  }
+  os << endl;
+  os << bl << "  fBlkMap.size:    " << fBlkMap.size() << endl;
+  Rw11VirtDisk::Dump(os, ind, " ^", detail);
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+//! Read \a nbyt bytes of the base image starting at byte offset \a pos.
+
+bool Rw11VirtDiskPack::ReadPack(size_t pos, size_t nbyt, uint8_t* data,
+                                RerrMsg& emsg)
+{
+  while (nbyt > 0) {
+    if (pos >= fImgSize) {                  // beyond image: return zeros
+      ::memset(data, 0, nbyt);
+      return true;
+    }
+    size_t icl  = pos / fCluSize;
+    size_t off  = pos - icl*fCluSize;
+    size_t nget = min(nbyt, min(fCluSize-off, fImgSize-pos));
+    const uint8_t* pclu;
+    if (!LoadCluster(icl, pclu, emsg)) return false;
+    if (pclu) {
+      ::memcpy(data, pclu+off, nget);
+    } else {
+      ::memset(data, 0, nget);
+    }
+    pos  += nget;
+    data += nget;
+    nbyt -= nget;
+  }
+  return true;
+}
+
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Get decompressed data of cluster \a icl.
+
+  Returns in \a pdata a pointer to the cluster data in the cache, or
+  \c nullptr for an all-zero cluster. On a cache miss the least recently
+  used slot is reloaded.
+ */
+
+bool Rw11VirtDiskPack::LoadCluster(size_t icl, const uint8_t*& pdata,
+                                   RerrMsg& emsg)
+{
+  const cluster& cl = fIndex[icl];
+  pdata = nullptr;
+  if (cl.fLength == 0) {
+    fStats.Inc(kStatNVDPCluZero);
+    return true;
+  }
+
+  fCacheTick += 1;
+  size_t islot = 0;
+  for (size_t i=0; i<kCacheSize; i++) {
+    if (fCacheClu[i] == icl) {
+      fStats.Inc(kStatNVDPCluHit);
+      fCacheUse[i] = fCacheTick;
+      pdata = fCache[i].data();
+      return true;
+    }
+    if (fCacheUse[i] < fCacheUse[islot]) islot = i;
+  }
+
+  fStats.Inc(kStatNVDPCluLoad);
+  fCacheClu[islot] = size_t(-1);
+  uint8_t* pbuf = fCache[islot].data();
+  size_t   nclu = min(fCluSize, fImgSize-icl*fCluSize);
+  uint8_t* pget = (cl.fFlags & kFlagRaw) ? pbuf : fZBuf.data();
+
+  ssize_t irc = ::pread(fFd.Fd(), pget, cl.fLength, cl.fOffset);
+  if (irc != ssize_t(cl.fLength)) {
+    emsg.InitErrno("Rw11VirtDiskPack::LoadCluster()",
+                   string("read failed for cluster ") + to_string(icl) + ": ",
+                   irc < 0 ? errno : EIO);
+    return false;
+  }
+
+  if ((cl.fFlags & kFlagRaw) == 0) {
+    uLongf ndest = nclu;
+    int zrc = ::uncompress(pbuf, &ndest, fZBuf.data(), cl.fLength);
+    if (zrc != Z_OK || ndest != nclu) {
+      emsg.Init("Rw11VirtDiskPack::LoadCluster()",
+                string("inflate failed for cluster ") + to_string(icl));
+      return false;
+    }
+  }
+
+  fCacheClu[islot] = icl;
+  fCacheUse[islot] = fCacheTick;
+  pdata = pbuf;
+  return true;
+}
+
+} // end namespace Retro
@@ -0,0 +1,98 @@
+// $Id: Rw11VirtDiskPack.hpp 1291 2026-10-19 09:12:31Z mueller $
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// 
+// Revision History: 
+// Date         Rev Version  Comment
+// 2026-10-19  1291   1.0    Initial version
+// ---------------------------------------------------------------------------
+
+
+/*!
+  \brief   Declaration of class Rw11VirtDiskPack.
+*/
+
+#ifndef included_Retro_Rw11VirtDiskPack
+#define included_Retro_Rw11VirtDiskPack 1
+
+#include <vector>
+#include <map>
+
+#include "librtools/RfileFd.hpp"
+
+#include "Rw11VirtDiskBuffer.hpp"
+
+#include "Rw11VirtDisk.hpp"
+
+namespace Retro {
+
+  class Rw11VirtDiskPack : public Rw11VirtDisk {
+    public:
+
+      typedef std::map<uint32_t,Rw11VirtDiskBuffer> bmap_t;
+
+      explicit      Rw11VirtDiskPack(Rw11Unit* punit);
+                   ~Rw11VirtDiskPack();
+
+      virtual bool  WProt() const;
+
+      virtual bool  Open(const std::string& url, RerrMsg& emsg);
+
+      virtual bool  Read(size_t lba, size_t nblk, uint8_t* data,
+                         RerrMsg& emsg);
+      virtual bool  Write(size_t lba, size_t nblk, const uint8_t* data,
+                          RerrMsg& emsg);
+
+      virtual void  Dump(std::ostream& os, int ind=0, const char* text=0,
+                         int detail=0) const;
+
+    // some constants (also defined in cpp)
+      static const std::string kMagic;      //!< container file magic
+      static const size_t kHdrSize   = 24;  //!< header size
+      static const size_t kIdxSize   = 16;  //!< index entry size
+      static const size_t kCacheSize =  8;  //!< # of cached clusters
+      static const uint32_t kFlagRaw = 0x1; //!< cluster stored uncompressed
+
+    // statistics counter indices
+      enum stats {
+        kStatNVDPRead = Rw11VirtDisk::kDimStat,
+        kStatNVDPReadBlkP,
+        kStatNVDPReadBlkO,
+        kStatNVDPCluHit,
+        kStatNVDPCluLoad,
+        kStatNVDPCluZero,
+        kStatNVDPWrite,
+        kStatNVDPWriteBlk,
+        kDimStat
+      };
+
+    protected:
+      struct cluster {
+        uint64_t    fOffset;                //!< offset in container file
+        uint32_t    fLength;                //!< stored length (0=all zero)
+        uint32_t    fFlags;                 //!< flags (kFlagRaw)
+      };
+
+      bool          ReadPack(size_t pos, size_t nbyt, uint8_t* data,
+                             RerrMsg& emsg);
+      bool          LoadCluster(size_t icl, const uint8_t*& pdata,
+                                RerrMsg& emsg);
+
+    protected:
+      RfileFd       fFd;                    //!< container file
+      size_t        fCluSize;               //!< cluster size in byte
+      size_t        fImgSize;               //!< image size in byte
+      std::vector<cluster> fIndex;          //!< cluster index
+      std::vector<std::vector<uint8_t>> fCache; //!< decompressed clusters
+      std::vector<size_t> fCacheClu;        //!< cluster number in cache slot
+      std::vector<uint64_t> fCacheUse;      //!< last use tick of cache slot
+      uint64_t      fCacheTick;             //!< cache use tick
+      std::vector<uint8_t> fZBuf;           //!< compressed data buffer
+      bmap_t        fBlkMap;                //!< overlay for written blocks
+  };
+
+} // end namespace Retro
+
+//#include "Rw11VirtDiskPack.ipp"
+
+#endif
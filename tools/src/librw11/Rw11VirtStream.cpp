@@ -1,9 +1,10 @@
 // $Id: Rw11VirtStream.cpp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2013-2019 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2013-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1296   1.2    add async writer thread (async url option)
 // 2019-04-14  1131   1.1.2  add Error(),Eof()
 // 2018-12-19  1090   1.1.1  use RosPrintf(bool)
 // 2018-12-02  1076   1.1    use unique_ptr for New()
@@ -17,6 +18,8 @@
 /*!
   \brief   Implemenation of Rw11VirtStream.
 */
+#include <errno.h>
+
 #include <memory>
 
 #include "librtools/Rtools.hpp"
@@ -37,6 +40,11 @@ using namespace std;
 // all method definitions in namespace Retro
 namespace Retro {
 
+//------------------------------------------+-----------------------------------
+// constants definitions
+
+const size_t Rw11VirtStream::kAsyncBufMax;
+
 //------------------------------------------+-----------------------------------
 //! Default constructor
 
@@ -44,7 +52,17 @@ Rw11VirtStream::Rw11VirtStream(Rw11Unit* punit)
   : Rw11Virt(punit),
     fIStream(false),
     fOStream(false),
-    fFile(0)
+    fFile(0),
+    fAsync(false),
+    fWriter(),
+    fAsyncMutex(),
+    fAsyncCond(),
+    fAsyncBuf(),
+    fAsyncFlush(false),
+    fAsyncBusy(false),
+    fAsyncStop(false),
+    fAsyncErrno(0),
+    fAsyncErrWhat(nullptr)
 {
   fStats.Define(kStatNVSRead,    "NVSRead",     "Read() calls");
   fStats.Define(kStatNVSReadByt, "NVSReadByt",  "bytes read");
@@ -60,6 +78,7 @@ Rw11VirtStream::Rw11VirtStream(Rw11Unit* punit)
 
 Rw11VirtStream::~Rw11VirtStream()
 {
+  AsyncStop();
   if (fFile) ::fclose(fFile);
 }
 
@@ -77,10 +96,14 @@ bool Rw11VirtStream::Open(const std::string& url, RerrMsg& emsg)
                      "Bad state: neither ronly nor wonly seen");
 
   if (fOStream) {                           // handle output streams
-    if (!fUrl.Set(url, "|app|bck=|", emsg)) return false;
+    if (!fUrl.Set(url, "|app|bck=|async|", emsg)) return false;
     if (!Rtools::CreateBackupFile(fUrl, emsg)) return false;
         
     fFile = ::fopen(fUrl.Path().c_str(), fUrl.FindOpt("app") ? "a" : "w");
+    if (fFile && fUrl.FindOpt("async")) {
+      fAsync  = true;
+      fWriter = thread([this](){ Writer(); });
+    }
 
   } else {                                  // handle input  streams
     fWProt = true;
@@ -132,6 +155,12 @@ bool Rw11VirtStream::Write(const uint8_t* data, size_t count, RerrMsg& emsg)
     throw Rexception("Rw11VirtStream::Write", "Bad state: file not open");
 
   fStats.Inc(kStatNVSWrite);
+  if (fAsync) {
+    if (!AsyncWrite(data, count, emsg)) return false;
+    fStats.Inc(kStatNVSWriteByt, double(count));
+    return true;
+  }
+
   size_t irc = ::fwrite(data, 1, count, fFile);
   if (irc != count) {
     emsg.InitErrno("Rw11VirtStream::Write()", "fwrite() failed: ", errno);
@@ -152,6 +181,8 @@ bool Rw11VirtStream::Flush(RerrMsg& emsg)
     throw Rexception("Rw11VirtStream::Write", "Bad state: file not open");
 
   fStats.Inc(kStatNVSFlush);
+  if (fAsync) return AsyncFlush(emsg);
+
   size_t irc = ::fflush(fFile);
   if (irc != 0) {
     emsg.InitErrno("Rw11VirtStream::Flush()", "fflush() failed: ", errno);
@@ -170,6 +201,7 @@ int Rw11VirtStream::Tell(RerrMsg& emsg)
     throw Rexception("Rw11VirtStream::Tell", "Bad state: file not open");
 
   fStats.Inc(kStatNVSTell);
+  if (fAsync && !AsyncDrain(emsg)) return -1;
   long irc = ::ftell(fFile);
   if (irc < 0) {
     emsg.InitErrno("Rw11VirtStream::Tell()", "ftell() failed: ", errno);
@@ -188,6 +220,7 @@ bool Rw11VirtStream::Seek(int pos, RerrMsg& emsg)
     throw Rexception("Rw11VirtStream::Seek", "Bad state: file not open");
 
   fStats.Inc(kStatNVSSeek);
+  if (fAsync && !AsyncDrain(emsg)) return false;
   int whence = SEEK_SET;
   if (pos < 0) {
     pos = 0;
@@ -231,6 +264,7 @@ void Rw11VirtStream::Dump(std::ostream& os, int ind, const char* text,
   os << bl << "  fIStream:        " << RosPrintf(fIStream) << endl;
   os << bl << "  fOStream:        " << RosPrintf(fOStream) << endl;
   os << bl << "  fFile:           " << fFile << endl;
+  os << bl << "  fAsync:          " << RosPrintf(fAsync) << endl;
   if (fFile) {
     os << bl << "  fFile.tell       " << ::ftell(fFile) << endl;
     os << bl << "  fFile.error      " << ::ferror(fFile) << endl;
@@ -241,6 +275,128 @@ void Rw11VirtStream::Dump(std::ostream& os, int ind, const char* text,
   return;
 }
 
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Queue data for the writer thread.
+
+  Blocks only when more than kAsyncBufMax bytes are pending, and returns
+  errors latched by the writer thread for earlier writes.
+ */
+
+bool Rw11VirtStream::AsyncWrite(const uint8_t* data, size_t count,
+                                RerrMsg& emsg)
+{
+  unique_lock<mutex> lock(fAsyncMutex);
+  if (fAsyncErrno) return AsyncError(emsg);
+  if (fAsyncBuf.size() >= kAsyncBufMax) {
+    fStats.Inc(kStatNVSAsyncWait);
+    fAsyncCond.wait(lock, [this](){ return fAsyncBuf.size() < kAsyncBufMax ||
+                                           fAsyncErrno != 0; });
+    if (fAsyncErrno) return AsyncError(emsg);
+  }
+  fAsyncBuf.insert(fAsyncBuf.end(), data, data+count);
+  fAsyncCond.notify_all();
+  return true;
+}
+
+//------------------------------------------+-----------------------------------
+//! Request a flush from the writer thread, does not wait for completion.
+
+bool Rw11VirtStream::AsyncFlush(RerrMsg& emsg)
+{
+  lock_guard<mutex> lock(fAsyncMutex);
+  if (fAsyncErrno) return AsyncError(emsg);
+  fAsyncFlush = true;
+  fAsyncCond.notify_all();
+  return true;
+}
+
+//------------------------------------------+-----------------------------------
+//! Wait until the writer thread has written all pending data.
+
+bool Rw11VirtStream::AsyncDrain(RerrMsg& emsg)
+{
+  unique_lock<mutex> lock(fAsyncMutex);
+  fAsyncCond.wait(lock, [this](){ return (fAsyncBuf.empty() && !fAsyncFlush &&
+                                          !fAsyncBusy) || fAsyncErrno != 0; });
+  if (fAsyncErrno) return AsyncError(emsg);
+  return true;
+}
+
+//------------------------------------------+-----------------------------------
+//! Setup \a emsg from latched writer error, must be called with lock held.
+
+bool Rw11VirtStream::AsyncError(RerrMsg& emsg)
+{
+  emsg.InitErrno("Rw11VirtStream::Writer()",
+                 string(fAsyncErrWhat) + " failed: ", fAsyncErrno);
+  return false;
+}
+
+//------------------------------------------+-----------------------------------
+//! Stop writer thread after all pending data is written.
+
+void Rw11VirtStream::AsyncStop()
+{
+  if (!fWriter.joinable()) return;
+  {
+    lock_guard<mutex> lock(fAsyncMutex);
+    fAsyncStop = true;
+    fAsyncCond.notify_all();
+  }
+  fWriter.join();
+  fAsync = false;
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Writer thread body.
+
+  Takes all pending data in one go, so the fwrite() and fflush() system
+  call load is moved out of the rlink server thread. Runs until
+  AsyncStop() is called and all pending data is written.
+ */
+
+void Rw11VirtStream::Writer()
+{
+  vector<uint8_t> buf;
+  unique_lock<mutex> lock(fAsyncMutex);
+  while (true) {
+    fAsyncCond.wait(lock, [this](){ return fAsyncStop || fAsyncFlush ||
+                                           !fAsyncBuf.empty(); });
+    if (fAsyncBuf.empty() && !fAsyncFlush) break; // stop and nothing pending
+    buf.swap(fAsyncBuf);
+    bool flush  = fAsyncFlush;
+    fAsyncFlush = false;
+    fAsyncBusy  = true;
+    fAsyncCond.notify_all();                // wakeup back-pressure waits
+    lock.unlock();
+
+    int ierr = 0;
+    const char* what = nullptr;
+    if (buf.size() > 0 &&
+        ::fwrite(buf.data(), 1, buf.size(), fFile) != buf.size()) {
+      ierr = errno;
+      what = "fwrite()";
+    }
+    if (ierr == 0 && flush && ::fflush(fFile) != 0) {
+      ierr = errno;
+      what = "fflush()";
+    }
+    buf.clear();
+
+    lock.lock();
+    fAsyncBusy = false;
+    if (ierr != 0 && fAsyncErrno == 0) {
+      fAsyncErrno   = ierr;
+      fAsyncErrWhat = what;
+    }
+    fAsyncCond.notify_all();
+  }
+  return;
+}
+
 //------------------------------------------+-----------------------------------
 //! FIXME_docs
 
@@ -1,9 +1,10 @@
 // $Id: Rw11VirtStream.hpp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2013-2019 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2013-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1296   1.2    add async writer thread (async url option)
 // 2019-04-14  1131   1.1.1  add Error(),Eof()
 // 2018-12-02  1076   1.1    use unique_ptr for New()
 // 2017-04-07   868   1.0.1  Dump(): add detail arg
@@ -21,6 +22,10 @@
 #include <stdio.h>
 
 #include <memory>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 #include "Rw11Virt.hpp"
 
@@ -57,13 +62,36 @@ namespace Retro {
         kStatNVSFlush,
         kStatNVSTell,
         kStatNVSSeek,
+        kStatNVSAsyncWait,
         kDimStat
       };    
 
+    protected:
+      bool          AsyncWrite(const uint8_t* data, size_t count,
+                               RerrMsg& emsg);
+      bool          AsyncFlush(RerrMsg& emsg);
+      bool          AsyncDrain(RerrMsg& emsg);
+      bool          AsyncError(RerrMsg& emsg);
+      void          AsyncStop();
+      void          Writer();
+
+    // some constants (also defined in cpp)
+      static const size_t kAsyncBufMax = 4*1024*1024; //!< back-pressure limit
+
     protected:
       bool          fIStream;               //!< is input (read only) stream
       bool          fOStream;               //!< is output (write only) stream
       FILE*         fFile;                  //!< file ptr
+      bool          fAsync;                 //!< output via writer thread
+      std::thread   fWriter;                //!< writer thread
+      std::mutex    fAsyncMutex;            //!< protects fAsync* state
+      std::condition_variable fAsyncCond;   //!< signals writer and waiters
+      std::vector<uint8_t> fAsyncBuf;       //!< data pending for writer
+      bool          fAsyncFlush;            //!< flush requested
+      bool          fAsyncBusy;             //!< writer is busy
+      bool          fAsyncStop;             //!< writer stop requested
+      int           fAsyncErrno;            //!< latched writer errno
+      const char*   fAsyncErrWhat;          //!< failed call in writer
   };
   
 } // end namespace Retro
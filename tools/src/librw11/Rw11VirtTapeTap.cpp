@@ -1,9 +1,11 @@
 // $Id: Rw11VirtTapeTap.cpp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2015-2019 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2015-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1290   1.3    read-ahead,write-behind; BUGFIX: ReadRecord() skip
+// 2026-10-19  1289   1.2    add record index for fast SpaceForw/SpaceBack
 // 2019-07-08  1180   1.1    use RfileFd; remove dtor
 // 2018-12-19  1090   1.0.4  use RosPrintf(bool)
 // 2018-09-22  1048   1.0.3  BUGFIX: coverity (resource leak; bad expression)
@@ -17,8 +19,15 @@
   \brief   Implemenation of Rw11VirtTapeTap.
 */
 
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+
+#include <algorithm>
+
 #include "librtools/RosFill.hpp"
 #include "librtools/RosPrintf.hpp"
+#include "librtools/RlogMsg.hpp"
 #include "librtools/Rtools.hpp"
 
 #include "Rw11VirtTapeTap.hpp"
@@ -41,6 +50,8 @@ const uint32_t Rw11VirtTapeTap::kMetaEom;
 const uint32_t Rw11VirtTapeTap::kMeta_M_Perr;
 const uint32_t Rw11VirtTapeTap::kMeta_M_Mbz;
 const uint32_t Rw11VirtTapeTap::kMeta_B_Rlen;
+const size_t   Rw11VirtTapeTap::kRBufSize;
+const size_t   Rw11VirtTapeTap::kWBufSize;
 
 //------------------------------------------+-----------------------------------
 //! Default constructor
@@ -52,18 +63,47 @@ Rw11VirtTapeTap::Rw11VirtTapeTap(Rw11Unit* punit)
     fPos(0),
     fBad(true),
     fPadOdd(false),
-    fTruncPend(false)
-{}
+    fTruncPend(false),
+    fIdxUse(true),
+    fIdxValid(false),
+    fIdxPart(false),
+    fIdxPos(),
+    fIdxEof(),
+    fIdxEnd(0),
+    fRBuf(kRBufSize),
+    fRBufPos(0),
+    fRBufLen(0),
+    fWBuf(),
+    fWBufPos(0)
+{
+  fStats.Define(kStatNVTTIdxBuild, "NVTTIdxBuild", "tap: record index builds");
+  fStats.Define(kStatNVTTIdxSpace, "NVTTIdxSpace", "tap: spaces via index");
+  fStats.Define(kStatNVTTRBufFill, "NVTTRBufFill", "tap: read-ahead fills");
+  fStats.Define(kStatNVTTWBufFlush,"NVTTWBufFlush","tap: write-behind flushes");
+}
+
+//------------------------------------------+-----------------------------------
+//! Destructor
+
+Rw11VirtTapeTap::~Rw11VirtTapeTap()
+{
+  RerrMsg emsg;
+  if (!WriteFlush(emsg) && fpUnit) {
+    RlogMsg lmsg(LogFile(),'E');
+    lmsg << emsg;
+  }
+}
 
 //------------------------------------------+-----------------------------------
 //! FIXME_docs
 
 bool Rw11VirtTapeTap::Open(const std::string& url, RerrMsg& emsg)
 {
-  if (!fUrl.Set(url, "|wpro|e11|cap=|", "tap", emsg)) return false;
+  if (!fUrl.Set(url, "|wpro|e11|noidx|cap=|", "tap", emsg)) return false;
 
   fWProt  = fUrl.FindOpt("wpro");
   fPadOdd = fUrl.FindOpt("e11");
+  fIdxUse = !fUrl.FindOpt("noidx");
 
   string str_cap;
   unsigned long capacity=0;
@@ -118,6 +158,9 @@ bool Rw11VirtTapeTap::Open(const std::string& url, RerrMsg& emsg)
   fPos  = 0;
   fBad  = false;
   fTruncPend = true;
+  fIdxValid  = false;
+  fRBufLen   = 0;
+  fWBuf.clear();
 
   fCapacity = capacity;
   fBot = true;
@@ -139,6 +182,7 @@ bool Rw11VirtTapeTap::ReadRecord(size_t nbyt, uint8_t* data, size_t& ndone,
   opcode = kOpCodeBadFormat;
   ndone  = 0;
   if (fBad) return BadTapeMsg("ReadRecord()", emsg);
+  if (!WriteFlush(emsg)) return SetBad();
   
   if (fPos == fSize) {
     fEom   = true;
@@ -179,7 +223,7 @@ bool Rw11VirtTapeTap::ReadRecord(size_t nbyt, uint8_t* data, size_t& ndone,
   ndone = (rlen <= nbyt) ? rlen : nbyt;
   if (!Read(ndone, data, emsg)) return SetBad();
   if (ndone < rlenpad) {
-    if (!Seek(rlenpad, +1, emsg)) return SetBad();
+    if (!Seek(rlenpad-ndone, +1, emsg)) return SetBad();
   }
 
   if (!CheckSizeForw(sizeof(metaend), "missed metaend", emsg)) return SetBad();
@@ -221,6 +265,8 @@ bool Rw11VirtTapeTap::WriteRecord(size_t nbyt, const uint8_t* data,
   if (fBad) return BadTapeMsg("WriteRecord()", emsg);
 
   fEom   = false;
+  IdxTruncate(fPos);
+  size_t posbeg = fPos;
 
   uint32_t meta = nbyt;
   uint8_t  zero = 0x00;
@@ -239,6 +285,10 @@ bool Rw11VirtTapeTap::WriteRecord(size_t nbyt, const uint8_t* data,
   if (!Write(sizeof(kMetaEom), reinterpret_cast<const uint8_t*>(&kMetaEom), 
              true, emsg)) return SetBad();
 
+  if (fIdxValid) {
+    fIdxPos.push_back(posbeg);
+    fIdxEnd = fPos;
+  }
   IncPosRecord(+1);
   opcode = kOpCodeOK;
 
@@ -255,12 +305,19 @@ bool Rw11VirtTapeTap::WriteEof(RerrMsg& emsg)
   if (fBad) return BadTapeMsg("WriteEof()", emsg);
 
   fEom   = false;
+  IdxTruncate(fPos);
+  size_t posbeg = fPos;
 
   if (!Write(sizeof(kMetaEof), reinterpret_cast<const uint8_t*>(&kMetaEof), 
              false, emsg)) return SetBad();
   if (!Write(sizeof(kMetaEom), reinterpret_cast<const uint8_t*>(&kMetaEom), 
              true, emsg)) return SetBad();
 
+  if (fIdxValid) {
+    fIdxEof.push_back(fIdxPos.size());
+    fIdxPos.push_back(posbeg);
+    fIdxEnd = fPos;
+  }
   fPosFile   += 1;
   fPosRecord  = 0;
 
@@ -278,6 +335,40 @@ bool Rw11VirtTapeTap::SpaceForw(size_t nrec, size_t& ndone,
   opcode = kOpCodeBadFormat;
   ndone  = 0;
   if (fBad) return BadTapeMsg("SpaceForw()", emsg);
+  if (!WriteFlush(emsg)) return SetBad();
+
+  // use record index when available; skip records up to next EOF mark
+  size_t ind;
+  if (IdxFind(ind)) {
+    fStats.Inc(kStatNVTTIdxSpace);
+    auto   it    = lower_bound(fIdxEof.begin(), fIdxEof.end(), ind);
+    bool   haseof = it != fIdxEof.end();
+    size_t lim   = haseof ? *it : fIdxPos.size();
+    size_t nskip = min(nrec, lim-ind);
+    if (nskip > 0) {
+      if (!Seek(IdxOffset(ind+nskip), 0, emsg)) return SetBad();
+      IncPosRecord(int(nskip));
+      nrec  -= nskip;
+      ndone += nskip;
+    }
+    if (nrec == 0) {
+      opcode = kOpCodeOK;
+      return true;
+    }
+    if (haseof) {
+      if (!Seek(IdxOffset(lim+1), 0, emsg)) return SetBad();
+      opcode = kOpCodeEof;
+      fPosFile   += 1;
+      fPosRecord  = 0;
+      return true;
+    }
+    if (!fIdxPart) {
+      fEom   = true;
+      opcode = kOpCodeEom;
+      return true;
+    }
+    // index ends at bad data, continue with scan to get proper diagnostics
+  }
 
   while (nrec > 0) {
 
@@ -337,10 +428,42 @@ bool Rw11VirtTapeTap::SpaceBack(size_t nrec, size_t& ndone,
   opcode = kOpCodeBadFormat;
   ndone  = 0;
   if (fBad) return BadTapeMsg("SpaceBack()", emsg);
+  if (!WriteFlush(emsg)) return SetBad();
 
   fEom = false;
   fTruncPend = true;
 
+  // use record index when available; skip records back to last EOF mark
+  size_t ind;
+  if (IdxFind(ind)) {
+    fStats.Inc(kStatNVTTIdxSpace);
+    auto   it    = lower_bound(fIdxEof.begin(), fIdxEof.end(), ind);
+    bool   haseof = it != fIdxEof.begin();
+    size_t first = haseof ? *(it-1)+1 : 0;
+    size_t nskip = min(nrec, ind-first);
+    if (nskip > 0) {
+      if (!Seek(IdxOffset(ind-nskip), 0, emsg)) return SetBad();
+      IncPosRecord(-int(nskip));
+      nrec  -= nskip;
+      ndone += nskip;
+    }
+    if (nrec == 0) {
+      opcode = kOpCodeOK;
+      return true;
+    }
+    if (haseof) {
+      if (!Seek(IdxOffset(first-1), 0, emsg)) return SetBad();
+      opcode = kOpCodeEof;
+      fPosFile   -= 1;
+      fPosRecord  = -1;
+      return true;
+    }
+    opcode = kOpCodeBot;
+    fPosFile    = 0;
+    fPosRecord  = 0;
+    return true;
+  }
+
   while (nrec > 0) {
 
     if (fPos == 0) {
@@ -397,6 +520,7 @@ bool Rw11VirtTapeTap::Rewind(int& opcode, RerrMsg& emsg)
   fStats.Inc(kStatNVTRewind);
 
   opcode = kOpCodeBadFormat;
+  if (!WriteFlush(emsg)) return SetBad();
   if (!Seek(0, 0, emsg)) return SetBad();
 
   fBot = true;
@@ -426,54 +550,115 @@ void Rw11VirtTapeTap::Dump(std::ostream& os, int ind, const char* text,
   os << bl << "  fBad:            " << RosPrintf(fBad) << endl;
   os << bl << "  fPadOdd:         " << RosPrintf(fPadOdd) << endl;
   os << bl << "  fTruncPend:      " << RosPrintf(fTruncPend) << endl;
+  os << bl << "  fIdxUse:         " << RosPrintf(fIdxUse) << endl;
+  os << bl << "  fIdxValid:       " << RosPrintf(fIdxValid) << endl;
+  os << bl << "  fIdxPart:        " << RosPrintf(fIdxPart) << endl;
+  os << bl << "  fIdxPos.size:    " << fIdxPos.size() << endl;
+  os << bl << "  fIdxEof.size:    " << fIdxEof.size() << endl;
+  os << bl << "  fIdxEnd:         " << fIdxEnd << endl;
+  os << bl << "  fRBufPos,Len:    " << fRBufPos << ", " << fRBufLen << endl;
+  os << bl << "  fWBufPos,size:   " << fWBufPos << ", " << fWBuf.size() << endl;
   Rw11VirtTape::Dump(os, ind, " ^", detail);
   return;
 }
 
 //------------------------------------------+-----------------------------------
-//! FIXME_docs
+/*!
+  \brief Change tape position.
 
-bool Rw11VirtTapeTap::Seek(size_t seekpos, int dir, RerrMsg& emsg)
-{
-  off_t offset = seekpos;
-  int   whence = SEEK_SET;
-  if (dir > 0) {
-    whence = SEEK_CUR;
-  } else if (dir < 0) {
-    whence = SEEK_CUR;
-    offset = -offset;
-  }
-  if (!fFd.Seek(offset, whence, emsg)) return false;
+  All file I/O is done with pread() and pwrite(), so a seek only updates
+  the position and needs no system call.
+ */
 
+bool Rw11VirtTapeTap::Seek(size_t seekpos, int dir, RerrMsg& /*emsg*/)
+{
   UpdatePos(seekpos, dir);
-
   return true;
 }
 
 //------------------------------------------+-----------------------------------
-//! FIXME_docs
+/*!
+  \brief Read \a nbyt bytes at the current position.
+
+  Requests are served from a read-ahead buffer of kRBufSize bytes. On a miss
+  the buffer is filled starting at the current position, or, when the miss
+  is before the buffer as in SpaceBack(), with a window ending after the
+  requested data. Requests larger than the buffer are read directly.
+ */
 
 bool Rw11VirtTapeTap::Read(size_t nbyt, uint8_t* data, RerrMsg& emsg)
 {
-  ssize_t irc = fFd.Read(data, nbyt, emsg);
-  if (irc < 0) return false;
+  if (!WriteFlush(emsg)) return false;
+
+  if (fPos < fRBufPos || fPos+nbyt > fRBufPos+fRBufLen) {
+    if (nbyt > kRBufSize) {
+      ssize_t irc = ::pread(fFd.Fd(), data, nbyt, fPos);
+      if (irc < 0) {
+        emsg.InitErrno("Rw11VirtTapeTap::Read()", "pread() failed: ", errno);
+        return false;
+      }
+      if (size_t(irc) < nbyt) {
+        emsg.Init("Rw11VirtTapeTap::Read()", "unexpected end of file");
+        return false;
+      }
+      UpdatePos(nbyt, +1);
+      return true;
+    }
+
+    fStats.Inc(kStatNVTTRBufFill);
+    size_t posbeg = fPos;
+    if (fPos < fRBufPos)                    // backward: window ends at data
+      posbeg = (fPos+nbyt > kRBufSize) ? fPos+nbyt-kRBufSize : 0;
+    fRBufLen = 0;
+    ssize_t irc = ::pread(fFd.Fd(), fRBuf.data(), kRBufSize, posbeg);
+    if (irc < 0) {
+      emsg.InitErrno("Rw11VirtTapeTap::Read()", "pread() failed: ", errno);
+      return false;
+    }
+    fRBufPos = posbeg;
+    fRBufLen = irc;
+    if (fPos+nbyt > fRBufPos+fRBufLen) {
+      emsg.Init("Rw11VirtTapeTap::Read()", "unexpected end of file");
+      return false;
+    }
+  }
+
+  ::memcpy(data, fRBuf.data()+(fPos-fRBufPos), nbyt);
   UpdatePos(nbyt, +1);
   return true;
 }
 
 //------------------------------------------+-----------------------------------
-//! FIXME_docs
+/*!
+  \brief Write \a nbyt bytes at the current position.
+
+  The data is collected in a write-behind buffer, which is written to the
+  file when it exceeds kWBufSize bytes or when any non-write operation is
+  done. Writes overlapping the buffer, like the EOM marker which is
+  overwritten by the next record, are merged into the buffer.
+ */
 
 bool Rw11VirtTapeTap::Write(size_t nbyt, const uint8_t* data, bool back,
                             RerrMsg& emsg)
 {
   if (fTruncPend) {
+    if (!WriteFlush(emsg)) return false;
     if (!fFd.Truncate(fPos, emsg)) return false;
     fTruncPend = false;    
     fSize = fPos;
   }
 
-  if (!fFd.WriteAll(data, nbyt, emsg)) return false;
+  fRBufLen = 0;                             // invalidate read-ahead
+  if (!fWBuf.empty() &&
+      (fPos < fWBufPos || fPos > fWBufPos+fWBuf.size())) {
+    if (!WriteFlush(emsg)) return false;
+  }
+  if (fWBuf.empty()) fWBufPos = fPos;
+
+  size_t off = fPos - fWBufPos;
+  if (off+nbyt > fWBuf.size()) fWBuf.resize(off+nbyt);
+  ::memcpy(fWBuf.data()+off, data, nbyt);
+
   UpdatePos(nbyt, +1);
   if (fPos > fSize) fSize = fPos;
 
@@ -481,6 +666,35 @@ bool Rw11VirtTapeTap::Write(size_t nbyt, const uint8_t* data, bool back,
     if (!Seek(nbyt, -1, emsg)) return false;
   }
 
+  if (fWBuf.size() >= kWBufSize) {
+    if (!WriteFlush(emsg)) return false;
+  }
+
+  return true;
+}
+
+//------------------------------------------+-----------------------------------
+//! Write out the write-behind buffer.
+
+bool Rw11VirtTapeTap::WriteFlush(RerrMsg& emsg)
+{
+  if (fWBuf.empty()) return true;
+  fStats.Inc(kStatNVTTWBufFlush);
+
+  size_t ndone = 0;
+  while (ndone < fWBuf.size()) {
+    ssize_t irc = ::pwrite(fFd.Fd(), fWBuf.data()+ndone, fWBuf.size()-ndone,
+                           fWBufPos+ndone);
+    if (irc < 0) {
+      if (errno == EINTR) continue;
+      emsg.InitErrno("Rw11VirtTapeTap::WriteFlush()", 
+                     "pwrite() failed: ", errno);
+      fWBuf.clear();
+      return false;
+    }
+    ndone += irc;
+  }
+  fWBuf.clear();
   return true;
 }
 
@@ -549,4 +763,99 @@ bool Rw11VirtTapeTap::BadTapeMsg(const char* meth, RerrMsg& emsg)
   return false;
 }
 
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Locate current position in record index.
+
+  Builds the index when needed. Returns \c true and the index entry for the
+  current file position in \a ind when the index can be used, \c false
+  otherwise (index disabled or position not on a record boundary known to
+  the index).
+ */
+
+bool Rw11VirtTapeTap::IdxFind(size_t& ind)
+{
+  if (!fIdxUse) return false;
+  if (!fIdxValid) IdxBuild();
+
+  if (fPos == fIdxEnd) {
+    ind = fIdxPos.size();
+    return true;
+  }
+  auto it = lower_bound(fIdxPos.begin(), fIdxPos.end(), fPos);
+  if (it == fIdxPos.end() || *it != fPos) return false;
+  ind = it - fIdxPos.begin();
+  return true;
+}
+
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Build record index.
+
+  Scans the metadata of all records with one pread() per record and keeps
+  the start offset of all records and EOF marks. The scan stops at an EOM
+  marker, at the end of file, or at bad data. In the later case \c fIdxPart
+  is set and the index covers only the good part of the tape.
+ */
+
+void Rw11VirtTapeTap::IdxBuild()
+{
+  fStats.Inc(kStatNVTTIdxBuild);
+  fIdxPos.clear();
+  fIdxEof.clear();
+  fIdxPart = false;
+
+  size_t pos = 0;
+  while (pos < fSize) {
+    uint32_t meta;
+    if (pos+sizeof(meta) > fSize ||
+        ::pread(fFd.Fd(), &meta, sizeof(meta), pos) != sizeof(meta)) {
+      fIdxPart = true;
+      break;
+    }
+    if (meta == kMetaEom) break;
+    if (meta == kMetaEof) {
+      fIdxEof.push_back(fIdxPos.size());
+      fIdxPos.push_back(pos);
+      pos += sizeof(meta);
+      continue;
+    }
+    size_t nbyt = 2*sizeof(meta) + BytePadding(meta & kMeta_B_Rlen);
+    if ((meta & kMeta_M_Mbz) || pos+nbyt > fSize) {
+      fIdxPart = true;
+      break;
+    }
+    fIdxPos.push_back(pos);
+    pos += nbyt;
+  }
+
+  fIdxEnd   = pos;
+  fIdxValid = true;
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Drop all index entries at or beyond file offset \a pos.
+
+  Called before a write, which always discards the rest of the tape. Writes
+  then append to the index, so it stays valid while a tape is written.
+ */
+
+void Rw11VirtTapeTap::IdxTruncate(size_t pos)
+{
+  if (!fIdxValid) return;
+  auto it = lower_bound(fIdxPos.begin(), fIdxPos.end(), pos);
+  if (pos != fIdxEnd && (it == fIdxPos.end() || *it != pos)) {
+    fIdxValid = false;                      // not on a known boundary
+    return;
+  }
+  size_t nent = it - fIdxPos.begin();
+  fIdxPos.resize(nent);
+  while (!fIdxEof.empty() && fIdxEof.back() >= nent) fIdxEof.pop_back();
+  fIdxEnd  = pos;
+  fIdxPart = false;
+  return;
+}
+
 } // end namespace Retro
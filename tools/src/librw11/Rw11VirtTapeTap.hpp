@@ -1,9 +1,11 @@
 // $Id: Rw11VirtTapeTap.hpp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2015-2019 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2015-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1290   1.3    add read-ahead and write-behind buffers
+// 2026-10-19  1289   1.2    add record index for fast SpaceForw/SpaceBack
 // 2019-07-08  1180   1.1    use RfileFd; remove dtor
 // 2017-04-07   868   1.0.1  Dump(): add detail arg
 // 2015-06-04   686   1.0    Initial version
@@ -18,6 +20,8 @@
 #ifndef included_Retro_Rw11VirtTapeTap
 #define included_Retro_Rw11VirtTapeTap 1
 
+#include <vector>
+
 #include "librtools/RfileFd.hpp"
 
 #include "Rw11VirtTape.hpp"
@@ -28,6 +32,7 @@ namespace Retro {
     public:
 
       explicit      Rw11VirtTapeTap(Rw11Unit* punit);
+                   ~Rw11VirtTapeTap();
 
       virtual bool  Open(const std::string& url, RerrMsg& emsg);
 
@@ -51,12 +56,24 @@ namespace Retro {
       static const uint32_t kMeta_M_Perr = 0x80000000;
       static const uint32_t kMeta_M_Mbz  = 0x7fff0000;
       static const uint32_t kMeta_B_Rlen = 0x0000ffff;
+      static const size_t kRBufSize = 262144; //!< read-ahead buffer size
+      static const size_t kWBufSize = 262144; //!< write-behind flush limit
+
+    // statistics counter indices
+      enum stats {
+        kStatNVTTIdxBuild = Rw11VirtTape::kDimStat,
+        kStatNVTTIdxSpace,
+        kStatNVTTRBufFill,
+        kStatNVTTWBufFlush,
+        kDimStat
+      };    
 
     protected:
       bool          Seek(size_t seekpos, int dir, RerrMsg& emsg);
       bool          Read(size_t nbyt, uint8_t* data, RerrMsg& emsg);
       bool          Write(size_t nbyt, const uint8_t* data, bool back,
                           RerrMsg& emsg);
+      bool          WriteFlush(RerrMsg& emsg);
       bool          CheckSizeForw(size_t nbyt, const char* text, RerrMsg& emsg);
       bool          CheckSizeBack(size_t nbyt, const char* text, RerrMsg& emsg);
       void          UpdatePos(size_t nbyt, int dir);
@@ -67,6 +84,11 @@ namespace Retro {
       bool          BadTapeMsg(const char* meth, RerrMsg& emsg);
       void          IncPosRecord(int delta);
 
+      bool          IdxFind(size_t& ind);
+      void          IdxBuild();
+      void          IdxTruncate(size_t pos);
+      size_t        IdxOffset(size_t ind) const;
+
     protected:
       RfileFd       fFd;                    //!< file number
       size_t        fSize;                  //!< file size
@@ -74,6 +96,17 @@ namespace Retro {
       bool          fBad;                   //!< BAD file format flag
       bool          fPadOdd;                //!< do odd byte padding
       bool          fTruncPend;             //!< truncate on next write
+      bool          fIdxUse;                //!< use record index
+      bool          fIdxValid;              //!< record index valid
+      bool          fIdxPart;               //!< record index stops at bad data
+      std::vector<size_t> fIdxPos;          //!< index: start of record or EOF
+      std::vector<size_t> fIdxEof;          //!< index: indices of EOF marks
+      size_t        fIdxEnd;                //!< index: end of data
+      std::vector<uint8_t> fRBuf;           //!< read-ahead buffer
+      size_t        fRBufPos;               //!< read-ahead: file offset
+      size_t        fRBufLen;               //!< read-ahead: valid bytes
+      std::vector<uint8_t> fWBuf;           //!< write-behind buffer
+      size_t        fWBufPos;               //!< write-behind: file offset
   };
   
 } // end namespace Retro
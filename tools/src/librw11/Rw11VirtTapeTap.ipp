@@ -1,9 +1,10 @@
 // $Id: Rw11VirtTapeTap.ipp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2015- by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2015-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1289   1.1    add IdxOffset(); SetBad(): invalidate index
 // 2015-06-04   686   1.0    Initial version
 // 2015-05-17   683   0.1    First draft
 // ---------------------------------------------------------------------------
@@ -29,6 +30,7 @@ inline size_t Rw11VirtTapeTap::BytePadding(size_t rlen)
 inline bool Rw11VirtTapeTap::SetBad()
 {
   fBad = true;
+  fIdxValid = false;
   return false;
 }
 
@@ -41,5 +43,12 @@ inline void Rw11VirtTapeTap::IncPosRecord(int delta)
   return;
 }  
 
+//------------------------------------------+-----------------------------------
+//! Returns file offset of index entry \a ind, end of data if beyond last.
+
+inline size_t Rw11VirtTapeTap::IdxOffset(size_t ind) const
+{
+  return (ind < fIdxPos.size()) ? fIdxPos[ind] : fIdxEnd;
+}
 
 } // end namespace Retro
@@ -1,9 +1,10 @@
 // $Id: Rw11VirtTerm.cpp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2013-2018 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2013-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1286   1.1.1  add SndReady(),SetupSndRdyCallback()
 // 2018-12-02  1076   1.1    use unique_ptr for New()
 // 2017-04-07   868   1.0.1  Dump(): add detail arg
 // 2013-03-06   495   1.0    Initial version
@@ -38,7 +39,8 @@ namespace Retro {
 Rw11VirtTerm::Rw11VirtTerm(Rw11Unit* punit)
   : Rw11Virt(punit),
     fChannelId(),
-    fRcvCb()
+    fRcvCb(),
+    fSndRdyCb()
 {
   fStats.Define(kStatNVTRcvPoll,     "NVTRcvPoll", "VT RcvPollHandler() calls");
   fStats.Define(kStatNVTSnd,         "NVTSnd",       "VT Snd() calls");
@@ -78,6 +80,19 @@ std::unique_ptr<Rw11VirtTerm> Rw11VirtTerm::New(const std::string& url,
   return up;
 }
 
+//------------------------------------------+-----------------------------------
+//! Returns \c false when the output backlog is above the high-water mark.
+/*!
+  The default is to always accept data. When a derived class returns
+  \c false it must call the callback setup with SetupSndRdyCallback() when
+  the backlog has drained again.
+ */
+
+bool Rw11VirtTerm::SndReady() const
+{
+  return true;
+}
+
 //------------------------------------------+-----------------------------------
 //! FIXME_docs
 
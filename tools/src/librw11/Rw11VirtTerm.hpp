@@ -1,9 +1,10 @@
 // $Id: Rw11VirtTerm.hpp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2013-2018 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2013-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1286   1.1.3  add SndReady(),SetupSndRdyCallback()
 // 2018-12-15  1083   1.1.2  SetupRcvCallback(): use rval ref and move semantics
 // 2018-12-14  1081   1.1.1  use std::function instead of boost
 // 2018-12-02  1076   1.1    use unique_ptr for New()
@@ -29,6 +30,7 @@ namespace Retro {
   class Rw11VirtTerm : public Rw11Virt {
     public:
       typedef std::function<bool(const uint8_t*, size_t)> rcvcbfo_t;
+      typedef std::function<void()> sndrdycbfo_t;
 
       explicit      Rw11VirtTerm(Rw11Unit* punit);
                    ~Rw11VirtTerm();
@@ -36,7 +38,9 @@ namespace Retro {
       virtual const std::string& ChannelId() const;
 
       void          SetupRcvCallback(rcvcbfo_t&& rcvcbfo);
+      void          SetupSndRdyCallback(sndrdycbfo_t&& sndrdycbfo);
       virtual bool  Snd(const uint8_t* data, size_t count, RerrMsg& emsg) = 0;
+      virtual bool  SndReady() const;
 
       virtual void  Dump(std::ostream& os, int ind=0, const char* text=0,
                          int detail=0) const;
@@ -56,6 +60,7 @@ namespace Retro {
     protected:
       std::string   fChannelId;             //!< channel id 
       rcvcbfo_t     fRcvCb;                 //!< receive callback fobj
+      sndrdycbfo_t  fSndRdyCb;              //!< send ready callback fobj
   };
   
 } // end namespace Retro
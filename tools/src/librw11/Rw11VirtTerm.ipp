@@ -1,9 +1,10 @@
 // $Id: Rw11VirtTerm.ipp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2013-2018 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2013-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1286   1.0.2  add SndReady(),SetupSndRdyCallback()
 // 2018-12-15  1083   1.0.1  SetupRcvCallback(): use rval ref and move semantics
 // 2013-03-06   495   1.0    Initial version
 // 2013-02-19   490   0.1    First draft
@@ -34,4 +35,13 @@ inline void Rw11VirtTerm::SetupRcvCallback(rcvcbfo_t&& rcvcbfo)
   return;
 }
 
+//------------------------------------------+-----------------------------------
+//! Setup callback called when Snd() can accept data again.
+
+inline void Rw11VirtTerm::SetupSndRdyCallback(sndrdycbfo_t&& sndrdycbfo)
+{
+  fSndRdyCb = move(sndrdycbfo);
+  return;
+}
+
 } // end namespace Retro
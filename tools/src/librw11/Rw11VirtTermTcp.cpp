@@ -1,9 +1,13 @@
 // $Id: Rw11VirtTermTcp.cpp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2013-2019 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2013-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1306   1.2.1  send queue as contiguous ring, writev() from it;
+//                           drop fState, parser state is per client
+// 2026-10-19  1287   1.2    multiple clients: one writer, read-only observers
+// 2026-10-19  1286   1.1    buffered non-blocking output, backpressure
 // 2019-02-23  1114   1.0.14 use std::bind instead of lambda
 // 2018-12-22  1091   1.0.13 pfd->pfd1 (-Wshadow fix)
 // 2018-12-19  1090   1.0.12 use RosPrintf(bool)
@@ -30,9 +34,13 @@
 #include <sys/socket.h>
 #include <netdb.h>
 #include <unistd.h>
+#include <sys/uio.h>
+#include <errno.h>
 
+#include <vector>
 #include <sstream>
 #include <functional>
+#include <algorithm>
 
 #include "librtools/RosFill.hpp"
 #include "librtools/RosPrintf.hpp"
@@ -77,6 +85,12 @@ const uint8_t  Rw11VirtTermTcp::kOpt_TTYP;
 const uint8_t  Rw11VirtTermTcp::kOpt_LINE;  
 
 const size_t   Rw11VirtTermTcp::kPreConQue_limit;
+const size_t   Rw11VirtTermTcp::kSndQue_hiwat;
+const size_t   Rw11VirtTermTcp::kSndQue_lowat;
+const size_t   Rw11VirtTermTcp::kSndQue_limit;
+const size_t   Rw11VirtTermTcp::kObsLag_limit;
+const size_t   Rw11VirtTermTcp::kSndRing_init;
+const size_t   Rw11VirtTermTcp::kClient_limit;
 
 //------------------------------------------+-----------------------------------
 //! Default constructor
@@ -84,10 +98,12 @@ const size_t   Rw11VirtTermTcp::kPreConQue_limit;
 Rw11VirtTermTcp::Rw11VirtTermTcp(Rw11Unit* punit)
   : Rw11VirtTerm(punit),
     fFdListen(-1),
-    fFd(-1),
-    fState(ts_Closed),
     fTcpTrace(false),
-    fSndPreConQue()
+    fClients(),
+    fSndRing(),
+    fSndBase(0),
+    fSndEnd(0),
+    fSndHold(false)
 {
   fStats.Define(kStatNVTPreConSave , "NVTPreConSave" ,
                 "VT snd bytes saved prior connect");
@@ -98,6 +114,18 @@ Rw11VirtTermTcp::Rw11VirtTermTcp(Rw11Unit* punit)
   fStats.Define(kStatNVTAccept,      "NVTAccept",     "VT socket accepts");
   fStats.Define(kStatNVTRcvRaw,      "NVTRcvRaw",     "VT raw bytes received");
   fStats.Define(kStatNVTSndRaw,      "NVTSndRaw",     "VT raw bytes send");
+  fStats.Define(kStatNVTSndPoll,     "NVTSndPoll",
+                "VT SndPollHandler() calls");
+  fStats.Define(kStatNVTSndHold,     "NVTSndHold",
+                "VT snd backpressure asserted");
+  fStats.Define(kStatNVTSndDrop,     "NVTSndDrop",
+                "VT snd bytes dropped, queue full");
+  fStats.Define(kStatNVTRefuse,      "NVTRefuse",
+                "VT connects refused, too many clients");
+  fStats.Define(kStatNVTObsDrop,     "NVTObsDrop",
+                "VT observers dropped, too slow");
+  fStats.Define(kStatNVTObsRcv,      "NVTObsRcv",
+                "VT bytes from observers ignored");
 }
 
 //------------------------------------------+-----------------------------------
@@ -110,10 +138,11 @@ Rw11VirtTermTcp::~Rw11VirtTermTcp()
                        [this](){ Server().RemovePollHandler(fFdListen); } );
     ::close(fFdListen);
   }
-  if (Connected()) {
+  for (auto& cl : fClients) {
+    int fd = cl.fFd;
     Rtools::Catch2Cerr(__func__,
-                       [this](){ Server().RemovePollHandler(fFd); } );
-    ::close(fFd);
+                       [this,fd](){ Server().RemovePollHandler(fd); } );
+    ::close(fd);
   }
 }
 
@@ -166,7 +195,7 @@ bool Rw11VirtTermTcp::Open(const std::string& url, RerrMsg& emsg)
     return false;
   }
 
-  if (listen(fd, 1) <0) {
+  if (listen(fd, kClient_limit) <0) {
     emsg.InitErrno("Rw11VirtTermTcp::Open","listen() failed: ", errno);
     ::close(fd);
     return false;    
@@ -174,7 +203,6 @@ bool Rw11VirtTermTcp::Open(const std::string& url, RerrMsg& emsg)
 
   fFdListen = fd;
   fChannelId = port;
-  fState = ts_Listen;
 
   if (fTcpTrace) {
     RlogMsg lmsg(LogFile(),'I');
@@ -193,44 +221,24 @@ bool Rw11VirtTermTcp::Open(const std::string& url, RerrMsg& emsg)
 bool Rw11VirtTermTcp::Snd(const uint8_t* data, size_t count, RerrMsg& /*emsg*/)
 {
   fStats.Inc(kStatNVTSnd);
-  const uint8_t* pdata = data;
-  const uint8_t* pdataend = data+count;
   if (count == 0) return true;              // quit if nothing to do
 
-  if (!Connected()) {                       // if not connected keep last chars
-    for (size_t i=0; i<count; i++) fSndPreConQue.push_back(data[i]);
+  if (Connected()) {
+    fStats.Inc(kStatNVTSndByt, double(count));
+  } else {                                  // if not connected keep last chars
     fStats.Inc(kStatNVTPreConSave, double(count));
-    while (fSndPreConQue.size() > kPreConQue_limit) {
-      fSndPreConQue.pop_front();
-      fStats.Inc(kStatNVTPreConDrop);
-    }
-    return true;
   }
 
-  const size_t c_bufsiz=1024;
-  uint8_t  obuf[c_bufsiz];
-  while (pdata < pdataend) {
-    uint8_t* pobuf = obuf;
-    uint8_t* pobufend = obuf+sizeof(obuf);
-    while (pdata < pdataend && pobuf < pobufend-1) {
-      if (*pdata == kCode_IAC) *pobuf++ = kCode_IAC;
-      *pobuf++ = *pdata++;
-    }
+  SndQueAdd(data, count);
+  return true;
+}
 
-    int irc = ::write(fFd, obuf, pobuf-obuf);
-    if (irc < 0) {
-      RlogMsg lmsg(LogFile(),'E');
-      RerrMsg emsg("Rw11VirtTermTcp::Snd", 
-                   string("write() for port ") + fChannelId + " failed: ", 
-                   errno);
-      lmsg << emsg;
-    } else {
-      fStats.Inc(kStatNVTSndRaw, double(irc));
-    }
-  }
+//------------------------------------------+-----------------------------------
+//! Returns \c false while the writer backlog is above the high-water mark.
 
-  fStats.Inc(kStatNVTSndByt, double(count));
-  return true;
+bool Rw11VirtTermTcp::SndReady() const
+{
+  return !fSndHold;
 }
 
 //------------------------------------------+-----------------------------------
@@ -243,21 +251,27 @@ void Rw11VirtTermTcp::Dump(std::ostream& os, int ind, const char* text,
   os << bl << (text?text:"--") << "Rw11VirtTermTcp @ " << this << endl;
 
   os << bl << "  fFdListen:       " << fFdListen << endl;
-  os << bl << "  fFd:             " << fFd << endl;
-  const char* t_state = "";
-  switch (fState) {
-  case ts_Closed: t_state = "ts_Closed";  break;
-  case ts_Listen: t_state = "ts_Listen";  break;
-  case ts_Stream: t_state = "ts_Stream";  break;
-  case ts_Iac:    t_state = "ts_Iac";     break;
-  case ts_Cmd:    t_state = "ts_Cmd";     break;
-  case ts_Subneg: t_state = "ts_Subneg";  break;
-  case ts_Subiac: t_state = "ts_Subiac";  break;
-  default: t_state = "???";
-  }
-  os << bl << "  fState:            " << t_state    << endl;
   os << bl << "  fTcpTrace:         " << RosPrintf(fTcpTrace)  << endl;
-  os << bl << "  fSndPreConQue.size:" << fSndPreConQue.size()  << endl;
+  os << bl << "  fClients.size:     " << fClients.size()  << endl;
+  for (auto& cl : fClients) {
+    const char* t_state = "";
+    switch (cl.fState) {
+    case ts_Stream: t_state = "ts_Stream";  break;
+    case ts_Iac:    t_state = "ts_Iac";     break;
+    case ts_Cmd:    t_state = "ts_Cmd";     break;
+    case ts_Subneg: t_state = "ts_Subneg";  break;
+    case ts_Subiac: t_state = "ts_Subiac";  break;
+    default: t_state = "???";
+    }
+    os << bl << "    fd: " << RosPrintf(cl.fFd,"d",3)
+       << (cl.fWriter ? "  writer  " : "  observer")
+       << "  state: " << t_state
+       << "  lag: " << SndLag(cl) << endl;
+  }
+  os << bl << "  fSndRing.size:     " << fSndRing.size()  << endl;
+  os << bl << "  fSndBase:          " << fSndBase  << endl;
+  os << bl << "  fSndEnd:           " << fSndEnd  << endl;
+  os << bl << "  fSndHold:          " << RosPrintf(fSndHold)  << endl;
   Rw11VirtTerm::Dump(os, ind, " ^", detail);
   return;
 }
@@ -265,14 +279,77 @@ void Rw11VirtTermTcp::Dump(std::ostream& os, int ind, const char* text,
 //------------------------------------------+-----------------------------------
 //! FIXME_docs
 
+Rw11VirtTermTcp::client* Rw11VirtTermTcp::FindClient(int fd)
+{
+  for (auto& cl : fClients) if (cl.fFd == fd) return &cl;
+  return nullptr;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+Rw11VirtTermTcp::client* Rw11VirtTermTcp::Writer()
+{
+  for (auto& cl : fClients) if (cl.fWriter) return &cl;
+  return nullptr;
+}
+
+//------------------------------------------+-----------------------------------
+//! Returns number of output bytes not yet send to client \a cl.
+
+size_t Rw11VirtTermTcp::SndLag(const client& cl) const
+{
+  return size_t(fSndEnd - cl.fSndPos);
+}
+
+//------------------------------------------+-----------------------------------
+//! Closes client connection; promotes the oldest observer when writer closed.
+
+void Rw11VirtTermTcp::CloseClient(int fd)
+{
+  auto it = find_if(fClients.begin(), fClients.end(),
+                    [fd](const client& cl){ return cl.fFd == fd; });
+  if (it == fClients.end()) return;
+  bool writer = it->fWriter;
+
+  Server().RemovePollHandler(fd);
+  ::close(fd);
+  fClients.erase(it);
+
+  if (fTcpTrace) {
+    RlogMsg lmsg(LogFile(),'I');
+    lmsg << "TermTcp: close on " << fChannelId << " for " << Unit().Name()
+         << (writer ? "" : " (observer)");
+  }
+
+  if (writer && !fClients.empty()) {        // promote oldest observer
+    fClients.front().fWriter = true;
+    if (fTcpTrace) {
+      RlogMsg lmsg(LogFile(),'I');
+      lmsg << "TermTcp: observer promoted to writer on " << fChannelId
+           << " for " << Unit().Name();
+    }
+  }
+
+  SndQueTrim();
+  SndQueCheck();
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
 int Rw11VirtTermTcp::ListenPollHandler(const pollfd& pfd)
 {
+  fStats.Inc(kStatNVTListenPoll);
+
   // bail-out and cancel handler if poll returns an error event
   if (pfd.revents & (~pfd.events)) return -1;
 
-  fFd = ::accept(fFdListen, nullptr, 0);
+  // use non-blocking socket, output is queued and drained by SndPollHandler
+  int fd = ::accept4(fFdListen, nullptr, 0, SOCK_NONBLOCK);
 
-  if (fFd < 0) {
+  if (fd < 0) {
     RlogMsg lmsg(LogFile(),'E');
     RerrMsg emsg("Rw11VirtTermTcp::ListenPollHandler", 
                  string("accept() for port ") + fChannelId + " failed: ", 
@@ -284,6 +361,16 @@ int Rw11VirtTermTcp::ListenPollHandler(const pollfd& pfd)
 
   fStats.Inc(kStatNVTAccept);
 
+  if (fClients.size() >= kClient_limit) {   // refuse when too many clients
+    fStats.Inc(kStatNVTRefuse);
+    string str = "\r\nport " + fChannelId + " busy, too many clients\r\n";
+    if (::write(fd, str.c_str(), str.length()) < 0) {} // best effort only
+    ::close(fd);
+    return 0;
+  }
+
+  bool writer = fClients.empty();           // first client is the writer
+
   uint8_t buf_1[3] = {kCode_IAC, kCode_WILL, kOpt_LINE};
   uint8_t buf_2[3] = {kCode_IAC, kCode_WILL, kOpt_SGA};
   uint8_t buf_3[3] = {kCode_IAC, kCode_WILL, kOpt_ECHO};
@@ -293,35 +380,24 @@ int Rw11VirtTermTcp::ListenPollHandler(const pollfd& pfd)
   int nerr = 0;
 
   // send initial negotiation WILLs and DOs
-  if (::write(fFd, buf_1, sizeof(buf_1)) < 0) nerr += 1;
-  if (::write(fFd, buf_2, sizeof(buf_2)) < 0) nerr += 1;
-  if (::write(fFd, buf_3, sizeof(buf_3)) < 0) nerr += 1;
-  if (::write(fFd, buf_4, sizeof(buf_4)) < 0) nerr += 1;
-  if (::write(fFd, buf_5, sizeof(buf_5)) < 0) nerr += 1;
+  if (::write(fd, buf_1, sizeof(buf_1)) < 0) nerr += 1;
+  if (::write(fd, buf_2, sizeof(buf_2)) < 0) nerr += 1;
+  if (::write(fd, buf_3, sizeof(buf_3)) < 0) nerr += 1;
+  if (::write(fd, buf_4, sizeof(buf_4)) < 0) nerr += 1;
+  if (::write(fd, buf_5, sizeof(buf_5)) < 0) nerr += 1;
 
   // send connect message
   if (nerr==0) {
     stringstream msg;
     msg << "\r\nconnect on port " << fChannelId 
-        << " for " << Unit().Name() << "\r\n\r\n";
-    string str = msg.str();
-    if (::write(fFd, str.c_str(), str.length()) < 0) nerr += 1;
-  }
-
-  // send chars buffered while attached but not connected
-  if (nerr==0 && fSndPreConQue.size()) {
-    stringstream msg;
-    while (!fSndPreConQue.empty()) {
-      msg << char(fSndPreConQue.front());
-      fSndPreConQue.pop_front();
-    }
+        << " for " << Unit().Name() 
+        << (writer ? "" : " as read-only observer") << "\r\n\r\n";
     string str = msg.str();
-    if (::write(fFd, str.c_str(), str.length()) < 0) nerr += 1;
+    if (::write(fd, str.c_str(), str.length()) < 0) nerr += 1;
   }
 
   if (nerr) {
-    ::close(fFd);
-    fFd = -1;
+    ::close(fd);
     RlogMsg lmsg(LogFile(),'E');
     RerrMsg emsg("Rw11VirtTermTcp::ListenPollHandler", 
                  string("initial write()s for port ") + fChannelId + 
@@ -332,14 +408,21 @@ int Rw11VirtTermTcp::ListenPollHandler(const pollfd& pfd)
 
   if (fTcpTrace) {
     RlogMsg lmsg(LogFile(),'I');
-    lmsg << "TermTcp: accept on " << fChannelId << " for " << Unit().Name();
+    lmsg << "TermTcp: accept on " << fChannelId << " for " << Unit().Name()
+         << (writer ? "" : " (observer)");
   }
 
-  fState = ts_Stream;
+  // new clients get at most the last kPreConQue_limit bytes of output; for
+  // the first client that's the output buffered while attached but not
+  // connected. Starting further back would let SndQueTrim() drop a new
+  // observer right away when the writer lags by more than kObsLag_limit.
+  uint64_t spos = (fSndEnd > kPreConQue_limit) ? fSndEnd - kPreConQue_limit : 0;
+  fClients.push_back({fd, ts_Stream, max(fSndBase, spos), writer});
 
-  Server().RemovePollHandler(fFdListen);
   Server().AddPollHandler(bind(&Rw11VirtTermTcp::RcvPollHandler, this, _1), 
-                          fFd, POLLIN);
+                          fd, POLLIN);
+  SndKick(fd);
+  SndQueCheck();
   return 0;
 }
   
@@ -350,6 +433,9 @@ int Rw11VirtTermTcp::RcvPollHandler(const pollfd& pfd)
 {
   fStats.Inc(kStatNVTRcvPoll);
 
+  client* pcl = FindClient(pfd.fd);
+  if (pcl == nullptr) return -1;            // already closed
+
   int irc = -1;
 
   if (pfd.revents & POLLIN) {
@@ -358,7 +444,7 @@ int Rw11VirtTermTcp::RcvPollHandler(const pollfd& pfd)
     uint8_t obuf[c_bufsiz];
     uint8_t* pobuf = obuf;
 
-    irc = ::read(fFd, ibuf, sizeof(ibuf));
+    irc = ::read(pcl->fFd, ibuf, sizeof(ibuf));
 
     if (irc < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return 0;
 
@@ -366,39 +452,38 @@ int Rw11VirtTermTcp::RcvPollHandler(const pollfd& pfd)
       fStats.Inc(kStatNVTRcvRaw, double(irc));
       for (int i=0; i<irc; i++) {
         uint8_t byt = ibuf[i];
-        switch (fState) {
+        switch (pcl->fState) {
         case ts_Stream:
           if (byt == kCode_IAC) {
-            fState = ts_Iac;
+            pcl->fState = ts_Iac;
           } else {
             *pobuf++ = byt;
-            fStats.Inc(kStatNVTRcvByt, 1.);
           }
           break;
 
         case ts_Iac:
           if (byt == kCode_WILL || byt == kCode_WONT ||
               byt == kCode_DO   || byt == kCode_DONT) {
-            fState = ts_Cmd;
+            pcl->fState = ts_Cmd;
           } else if (byt == kCode_SB) {
-            fState = ts_Subneg;
+            pcl->fState = ts_Subneg;
           } else {
-            fState = ts_Stream;
+            pcl->fState = ts_Stream;
           }
           break;
 
         case ts_Cmd:
-          fState = ts_Stream;
+          pcl->fState = ts_Stream;
           break;
 
         case ts_Subneg:
           if (byt == kCode_IAC) {
-            fState = ts_Subiac;
+            pcl->fState = ts_Subiac;
           }
           break;
 
         case ts_Subiac:
-          fState = ts_Stream;
+          pcl->fState = ts_Stream;
           break;
         default:
           break;
@@ -407,10 +492,16 @@ int Rw11VirtTermTcp::RcvPollHandler(const pollfd& pfd)
       }
     }
 
-    if (pobuf > obuf) fRcvCb(obuf, pobuf - obuf);
+    if (pobuf > obuf) {
+      if (pcl->fWriter) {                   // only writer input is forwarded
+        fStats.Inc(kStatNVTRcvByt, double(pobuf - obuf));
+        fRcvCb(obuf, pobuf - obuf);
+      } else {
+        fStats.Inc(kStatNVTObsRcv, double(pobuf - obuf));
+      }
+    }
   }
 
-
   if (irc <= 0) {
     if (irc < 0) {
       RlogMsg lmsg(LogFile(),'E');
@@ -419,20 +510,186 @@ int Rw11VirtTermTcp::RcvPollHandler(const pollfd& pfd)
                    errno);
       lmsg << emsg;
     }
-    if (fTcpTrace) {
-      RlogMsg lmsg(LogFile(),'I');
-      lmsg << "TermTcp: close on " << fChannelId << " for " << Unit().Name();
-    }
-    ::close(fFd);
-    fFd = -1;
-    Server().AddPollHandler(bind(&Rw11VirtTermTcp::ListenPollHandler, this, _1), 
-                            fFdListen, POLLIN);    
-    fState = ts_Listen;
+    CloseClient(pfd.fd);
     return -1;
   }
 
   return 0;
 }
+
+//------------------------------------------+-----------------------------------
+//! Drains the output ring for a client when its socket accepts data again.
+
+int Rw11VirtTermTcp::SndPollHandler(const pollfd& pfd)
+{
+  fStats.Inc(kStatNVTSndPoll);
+
+  // cancel handler on error events, RcvPollHandler will handle the close
+  if (pfd.revents & (~pfd.events)) return -1;
+
+  client* pcl = FindClient(pfd.fd);
+  if (pcl == nullptr) return -1;            // already closed
+  if (!SndQueDrain(*pcl)) return -1;
+  bool done = SndLag(*pcl) == 0;
+
+  SndQueTrim();                             // note: may close observers
+  SndQueCheck();
   
+  return done ? -1 : 0;                     // remove handler when drained
+}
+
+//------------------------------------------+-----------------------------------
+//! Adds data to the output ring and starts sending it to all clients.
+/*!
+  The data is telnet escaped once and shared by all clients, each client
+  has its own read position. An immediate write is tried for clients
+  without pending output, the remainder is drained by SndPollHandler().
+  Backpressure is asserted when the writer lags by more than kSndQue_hiwat,
+  data is only dropped when the writer lags by more than kSndQue_limit.
+  Observers lagging by more than kObsLag_limit are disconnected.
+ */
+
+void Rw11VirtTermTcp::SndQueAdd(const uint8_t* data, size_t count)
+{
+  client* pwr = Writer();
+  for (size_t i=0; i<count; i++) {
+    if (pwr && SndLag(*pwr) >= kSndQue_limit) {
+      fStats.Inc(kStatNVTSndDrop, double(count-i));
+      break;
+    }
+    if (data[i] == kCode_IAC) SndQuePut(kCode_IAC);
+    SndQuePut(data[i]);
+  }
+
+  vector<int> fds;
+  for (auto& cl : fClients) fds.push_back(cl.fFd);
+  for (auto fd : fds) SndKick(fd);
+
+  SndQueTrim();
+  SndQueCheck();
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+//! Appends one byte to the output ring, grows the ring when full.
+
+void Rw11VirtTermTcp::SndQuePut(uint8_t byte)
+{
+  if (fSndEnd - fSndBase == fSndRing.size()) SndQueGrow();
+  fSndRing[size_t(fSndEnd) & (fSndRing.size()-1)] = byte;
+  fSndEnd += 1;
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+//! Doubles the output ring size, retained bytes keep their ring position.
+
+void Rw11VirtTermTcp::SndQueGrow()
+{
+  size_t nsize = fSndRing.empty() ? kSndRing_init : 2*fSndRing.size();
+  vector<uint8_t> nring(nsize);
+  for (uint64_t pos=fSndBase; pos<fSndEnd; pos++) {
+    nring[size_t(pos) & (nsize-1)] =
+      fSndRing[size_t(pos) & (fSndRing.size()-1)];
+  }
+  fSndRing.swap(nring);
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+//! Starts sending pending output to a client.
+
+void Rw11VirtTermTcp::SndKick(int fd)
+{
+  if (Server().TestPollHandler(fd, POLLOUT)) return; // drain already pending
+  client* pcl = FindClient(fd);
+  if (pcl == nullptr) return;
+  if (!SndQueDrain(*pcl)) return;           // RcvPollHandler will close
+  if (SndLag(*pcl) > 0) {
+    Server().AddPollHandler(bind(&Rw11VirtTermTcp::SndPollHandler, this, _1),
+                            fd, POLLOUT);
+  }
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+//! Writes as much of the output ring as the client socket accepts.
+/*!
+  \returns \c false on a write error, which is logged
+ */
+
+bool Rw11VirtTermTcp::SndQueDrain(client& cl)
+{
+  while (SndLag(cl) > 0) {
+    // pending output is one or, when wrapping, two ring segments
+    size_t nbyt = SndLag(cl);
+    size_t off  = size_t(cl.fSndPos) & (fSndRing.size()-1);
+    size_t nseg = min(nbyt, fSndRing.size()-off);
+    iovec iov[2];
+    iov[0].iov_base = fSndRing.data()+off;
+    iov[0].iov_len  = nseg;
+    iov[1].iov_base = fSndRing.data();
+    iov[1].iov_len  = nbyt-nseg;
+    ssize_t irc = ::writev(cl.fFd, iov, (nbyt > nseg) ? 2 : 1);
+    if (irc < 0) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK) return true;
+      RlogMsg lmsg(LogFile(),'E');
+      RerrMsg emsg("Rw11VirtTermTcp::SndQueDrain", 
+                   string("writev() for port ") + fChannelId + " failed: ", 
+                   errno);
+      lmsg << emsg;
+      return false;
+    }
+    fStats.Inc(kStatNVTSndRaw, double(irc));
+    cl.fSndPos += irc;
+    if (size_t(irc) < nbyt) break;          // short write, socket buffer full
+  }
+  return true;
+}
+
+//------------------------------------------+-----------------------------------
+//! Drops too slow observers and releases output seen by all clients.
+/*!
+  The last kPreConQue_limit bytes are always retained, they are send to
+  clients connecting later, like the first client after attach.
+ */
+
+void Rw11VirtTermTcp::SndQueTrim()
+{
+  vector<int> fds;
+  for (auto& cl : fClients) {
+    if (!cl.fWriter && SndLag(cl) > kObsLag_limit) fds.push_back(cl.fFd);
+  }
+  for (auto fd : fds) {
+    fStats.Inc(kStatNVTObsDrop);
+    CloseClient(fd);
+  }
+
+  uint64_t keep = (fSndEnd > kPreConQue_limit) ? fSndEnd - kPreConQue_limit : 0;
+  for (auto& cl : fClients) keep = min(keep, cl.fSndPos);
+  if (keep > fSndBase) {
+    size_t ndrop = size_t(keep - fSndBase);
+    if (!Connected()) fStats.Inc(kStatNVTPreConDrop, double(ndrop));
+    fSndBase = keep;
+  }
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+//! Updates backpressure state from the writer lag.
+
+void Rw11VirtTermTcp::SndQueCheck()
+{
+  client* pwr = Writer();
+  size_t lag = pwr ? SndLag(*pwr) : 0;
+  if (!fSndHold && lag >= kSndQue_hiwat) {
+    fSndHold = true;
+    fStats.Inc(kStatNVTSndHold);
+  } else if (fSndHold && lag <= kSndQue_lowat) {
+    fSndHold = false;
+    if (fSndRdyCb) fSndRdyCb();
+  }
+  return;
+}
 
 } // end namespace Retro
@@ -1,9 +1,13 @@
 // $Id: Rw11VirtTermTcp.hpp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2013-2017 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2013-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1306   1.2.1  send queue as contiguous ring, writev() from it;
+//                           drop fState, parser state is per client
+// 2026-10-19  1287   1.2    multiple clients: one writer, read-only observers
+// 2026-10-19  1286   1.1    buffered non-blocking output, backpressure
 // 2017-04-07   868   1.0.2  Dump(): add detail arg
 // 2013-04-20   508   1.0.1  add fSndPreConQue handling
 // 2013-03-06   495   1.0    Initial version
@@ -18,7 +22,7 @@
 #ifndef included_Retro_Rw11VirtTermTcp
 #define included_Retro_Rw11VirtTermTcp 1
 
-#include <deque>
+#include <vector>
 
 #include "Rw11VirtTerm.hpp"
 
@@ -33,6 +37,7 @@ namespace Retro {
       virtual bool  Open(const std::string& url, RerrMsg& emsg);
 
       virtual bool  Snd(const uint8_t* data, size_t count, RerrMsg& emsg);
+      virtual bool  SndReady() const;
 
       virtual void  Dump(std::ostream& os, int ind=0, const char* text=0,
                          int detail=0) const;
@@ -45,14 +50,47 @@ namespace Retro {
         kStatNVTAccept,
         kStatNVTRcvRaw,
         kStatNVTSndRaw,
+        kStatNVTSndPoll,
+        kStatNVTSndHold,
+        kStatNVTSndDrop,
+        kStatNVTRefuse,
+        kStatNVTObsDrop,
+        kStatNVTObsRcv,
         kDimStat
       };    
 
     protected:
 
+      enum telnet_state {
+        ts_Stream = 0,
+        ts_Iac,
+        ts_Cmd,
+        ts_Subneg,
+        ts_Subiac
+      };
+
+      struct client {
+        int           fFd;                  //!< socket fd
+        telnet_state  fState;               //!< telnet parser state
+        uint64_t      fSndPos;              //!< output ring read position
+        bool          fWriter;              //!< writer, otherwise observer
+      };
+
       bool          Connected() const;
+      client*       FindClient(int fd);
+      client*       Writer();
+      size_t        SndLag(const client& cl) const;
+      void          CloseClient(int fd);
       int           ListenPollHandler(const pollfd& pfd);
       int           RcvPollHandler(const pollfd& pfd);
+      int           SndPollHandler(const pollfd& pfd);
+      void          SndQueAdd(const uint8_t* data, size_t count);
+      void          SndQuePut(uint8_t byte);
+      void          SndQueGrow();
+      void          SndKick(int fd);
+      bool          SndQueDrain(client& cl);
+      void          SndQueTrim();
+      void          SndQueCheck();
 
     // some constants (also defined in cpp)
       static const uint8_t  kCode_NULL =   0;
@@ -77,23 +115,21 @@ namespace Retro {
       static const uint8_t  kOpt_LINE  =  34;
 
       static const size_t   kPreConQue_limit = 65536;
-
-      enum telnet_state {
-        ts_Closed = 0,
-        ts_Listen,
-        ts_Stream,
-        ts_Iac,
-        ts_Cmd,
-        ts_Subneg,
-        ts_Subiac
-      };
+      static const size_t   kSndQue_hiwat    = 16384;
+      static const size_t   kSndQue_lowat    =  4096;
+      static const size_t   kSndQue_limit    = 1048576;
+      static const size_t   kObsLag_limit    = 262144;
+      static const size_t   kSndRing_init    = 65536;
+      static const size_t   kClient_limit    = 8;
     
     protected:
       int           fFdListen;
-      int           fFd;
-      telnet_state  fState;
       bool          fTcpTrace;
-      std::deque<uint8_t> fSndPreConQue;
+      std::vector<client> fClients;         //!< connected clients
+      std::vector<uint8_t> fSndRing;        //!< output ring, 2^n bytes
+      uint64_t      fSndBase;               //!< position of oldest byte in ring
+      uint64_t      fSndEnd;                //!< position after newest byte
+      bool          fSndHold;               //!< backpressure: writer above hiwat
   };
   
 } // end namespace Retro
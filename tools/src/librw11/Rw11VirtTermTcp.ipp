@@ -1,9 +1,10 @@
 // $Id: Rw11VirtTermTcp.ipp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2013- by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2013-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1287   1.1    multiple clients: one writer, read-only observers
 // 2013-04-20   508   1.0    Initial version
 // ---------------------------------------------------------------------------
 
@@ -26,7 +27,7 @@ namespace Retro {
 
 inline bool Rw11VirtTermTcp::Connected() const
 {
-  return fFd > 2;
+  return !fClients.empty();
 }
 
 } // end namespace Retro
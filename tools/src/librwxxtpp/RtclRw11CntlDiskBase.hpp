@@ -1,9 +1,10 @@
 // $Id: RtclRw11CntlDiskBase.hpp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2017- by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2017-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1304   1.0.1  add M_timing
 // 2017-04-16   878   1.0    Initial version
 // ---------------------------------------------------------------------------
 
@@ -27,6 +28,7 @@ namespace Retro {
                    ~RtclRw11CntlDiskBase();
 
     protected:
+      int           M_timing(RtclArgs& args);
       virtual int   M_default(RtclArgs& args);
   };
   
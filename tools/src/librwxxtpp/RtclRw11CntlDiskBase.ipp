@@ -1,9 +1,10 @@
 // $Id: RtclRw11CntlDiskBase.ipp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2017- by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2017-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1304   1.0.1  add M_timing
 // 2017-04-16   878   1.0    Initial version
 // ---------------------------------------------------------------------------
 
@@ -17,10 +18,14 @@
 */
 
 #include <sstream>
+#include <mutex>
 
 #include "librtools/RosPrintf.hpp"
+#include "librtcltools/RtclOPtr.hpp"
+#include "librtcltools/RtclNameSet.hpp"
 
 #include "librw11/Rw11UnitDisk.hpp"
+#include "librw11/Rw11DiskTiming.hpp"
 
 // all method definitions in namespace Retro
 namespace Retro {
@@ -32,7 +37,9 @@ template <class TC>
 inline RtclRw11CntlDiskBase<TC>::RtclRw11CntlDiskBase(const std::string& type,
                                                       const std::string& cclass)
   : RtclRw11CntlRdmaBase<TC>(type,cclass)
-{}
+{
+  this->AddMeth("timing", [this](RtclArgs& args){ return M_timing(args); });
+}
 
 //------------------------------------------+-----------------------------------
 //! FIXME_docs
@@ -41,6 +48,65 @@ template <class TC>
 inline RtclRw11CntlDiskBase<TC>::~RtclRw11CntlDiskBase()
 {}
 
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Access to the seek and rotation timing model.
+
+  \c -off, \c -real and \c -scaled select the mode, \c -info returns
+  \c {mode m scale s npending n}, \c -stats returns the statistics as
+  name value list, times in usec. Without option \c -info is assumed.
+ */
+
+template <class TC>
+inline int RtclRw11CntlDiskBase<TC>::M_timing(RtclArgs& args)
+{
+  static RtclNameSet optset("-off|-real|-scaled|-info|-stats");
+  static const char* modenam[3] = {"off","real","scaled"};
+
+  std::string opt;
+  if (!args.NextOpt(opt, optset)) {
+    if (!args.OptValid()) return this->kERR;
+    opt = "-info";
+  }
+
+  double scale = 1.;
+  if (opt == "-scaled") {
+    if (!args.GetArg("factor", scale, 1.e-3, 1.e3)) return this->kERR;
+  }
+  if (!args.AllDone()) return this->kERR;
+
+  std::lock_guard<RlinkConnect> lock(this->Obj().Connect());
+  Rw11DiskTiming& timing = this->Obj().Timing();
+
+  if (opt == "-off") {
+    timing.SetMode(Rw11DiskTiming::kModeOff);
+  } else if (opt == "-real") {
+    timing.SetMode(Rw11DiskTiming::kModeReal);
+  } else if (opt == "-scaled") {
+    timing.SetMode(Rw11DiskTiming::kModeScaled, scale);
+  } else if (opt == "-stats") {
+    RtclOPtr plist(Tcl_NewListObj(0, nullptr));
+    Rstats& stats = timing.Stats();
+    for (size_t i=0; i<stats.Size(); i++) {
+      Tcl_ListObjAppendElement(nullptr, plist,
+                               Tcl_NewStringObj(stats.Name(i).c_str(), -1));
+      Tcl_ListObjAppendElement(nullptr, plist, Tcl_NewDoubleObj(stats[i]));
+    }
+    args.SetResult(plist);
+  } else {
+    RtclOPtr plist(Tcl_NewListObj(0, nullptr));
+    Tcl_Obj* pval[6] = {Tcl_NewStringObj("mode", -1),
+                        Tcl_NewStringObj(modenam[timing.Mode()], -1),
+                        Tcl_NewStringObj("scale", -1),
+                        Tcl_NewDoubleObj(timing.Scale()),
+                        Tcl_NewStringObj("npending", -1),
+                        Tcl_NewWideIntObj(Tcl_WideInt(timing.NPending()))};
+    for (auto pobj : pval) Tcl_ListObjAppendElement(nullptr, plist, pobj);
+    args.SetResult(plist);
+  }
+  return this->kOK;
+}
+
 //------------------------------------------+-----------------------------------
 //! FIXME_docs
 
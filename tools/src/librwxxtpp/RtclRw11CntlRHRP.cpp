@@ -1,9 +1,10 @@
 // $Id: RtclRw11CntlRHRP.cpp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2015-2019 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2015-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1305   1.1.2  add overlap getter/setter
 // 2019-06-07  1160   1.1.1  use RtclStats::Exec()
 // 2017-04-16   878   1.1    add class in ctor; derive from RtclRw11CntlDiskBase
 // 2015-05-14   680   1.0    Initial version
@@ -14,12 +15,15 @@
   \brief   Implemenation of RtclRw11CntlRHRP.
 */
 
+#include <functional>
+
 #include "librtcltools/RtclNameSet.hpp"
 
 #include "RtclRw11CntlRHRP.hpp"
 #include "RtclRw11UnitRHRP.hpp"
 
 using namespace std;
+using namespace std::placeholders;
 
 /*!
   \class Retro::RtclRw11CntlRHRP
@@ -34,7 +38,11 @@ namespace Retro {
 
 RtclRw11CntlRHRP::RtclRw11CntlRHRP()
   : RtclRw11CntlDiskBase<Rw11CntlRHRP>("Rw11CntlRHRP","disk")
-{}
+{
+  Rw11CntlRHRP* pobj = &Obj();
+  fGets.Add<bool>  ("overlap", bind(&Rw11CntlRHRP::Overlap,    pobj));
+  fSets.Add<bool>  ("overlap", bind(&Rw11CntlRHRP::SetOverlap, pobj, _1));
+}
 
 //------------------------------------------+-----------------------------------
 //! Destructor
@@ -1,9 +1,10 @@
 // $Id: RtclRw11CntlRdmaBase.hpp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2017- by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2017-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1301   1.0.1  add M_iotrace
 // 2017-04-16   878   1.0    Initial version
 // ---------------------------------------------------------------------------
 
@@ -17,6 +18,8 @@
 
 #include "RtclRw11CntlBase.hpp"
 
+#include "librw11/Rw11IoTrace.hpp"
+
 namespace Retro {
 
   template <class TC>
@@ -27,6 +30,7 @@ namespace Retro {
                    ~RtclRw11CntlRdmaBase();
 
     protected:
+      int           M_iotrace(RtclArgs& args);
   };
   
 } // end namespace Retro
@@ -1,9 +1,11 @@
 // $Id: RtclRw11CntlRdmaBase.ipp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2017-2019 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2017-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1301   1.2.4  add M_iotrace
+// 2026-10-19  1282   1.2.3  add chunkauto getter/setter
 // 2019-02-23  1114   1.2.2  use std::bind instead of lambda
 // 2018-12-15  1082   1.2.1  use lambda instead of boost::bind
 // 2017-04-16   877   1.2    add class in ctor
@@ -22,9 +24,12 @@
 */
 
 #include <functional>
+#include <mutex>
+#include <vector>
 
 #include "librtcltools/Rtcl.hpp"
 #include "librtcltools/RtclOPtr.hpp"
+#include "librtcltools/RtclNameSet.hpp"
 
 // all method definitions in namespace Retro
 namespace Retro {
@@ -37,12 +42,17 @@ inline RtclRw11CntlRdmaBase<TC>::RtclRw11CntlRdmaBase(const std::string& type,
                                                       const std::string& cclass)
   : RtclRw11CntlBase<TC>(type,cclass)
 {
+  this->AddMeth("iotrace", [this](RtclArgs& args){ return M_iotrace(args); });
+
   TC* pobj = &this->Obj();
   RtclGetList& gets = this->fGets;
   RtclSetList& sets = this->fSets;
   gets.Add<size_t>  ("chunksize", std::bind(&TC::ChunkSize,    pobj));
+  gets.Add<bool>    ("chunkauto", std::bind(&TC::ChunkAuto,    pobj));
   sets.Add<size_t>  ("chunksize", std::bind(&TC::SetChunkSize, pobj,
                                             std::placeholders::_1));
+  sets.Add<bool>    ("chunkauto", std::bind(&TC::SetChunkAuto, pobj,
+                                            std::placeholders::_1));
 }
 
 //------------------------------------------+-----------------------------------
@@ -52,5 +62,85 @@ template <class TC>
 inline RtclRw11CntlRdmaBase<TC>::~RtclRw11CntlRdmaBase()
 {}
 
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Access to the per request I/O trace.
+
+  \c -read returns a list of \c {unit func lba nwrd result tattn tback tdone}
+  entries, oldest first, times in ns (CLOCK_MONOTONIC), \c tback is 0 for
+  requests without backend access. Without option \c -info is assumed.
+ */
+
+template <class TC>
+inline int RtclRw11CntlRdmaBase<TC>::M_iotrace(RtclArgs& args)
+{
+  static RtclNameSet optset("-enable|-disable|-clear|-read|-write|-info");
+
+  std::string opt;
+  if (!args.NextOpt(opt, optset)) {
+    if (!args.OptValid()) return this->kERR;
+    opt = "-info";
+  }
+
+  Rw11IoTrace& trace = this->Obj().IoTrace();
+
+  if (opt == "-read") {                     // lock free, no connect lock
+    uint32_t nent = trace.RingSize();
+    if (!args.GetArg("??nent", nent)) return this->kERR;
+    if (!args.AllDone()) return this->kERR;
+    std::vector<Rw11IoTrace::entry> list;
+    trace.GetLast(list, nent);
+    RtclOPtr plist(Tcl_NewListObj(0, nullptr));
+    for (auto& e : list) {
+      Tcl_Obj* pent[8] = {Tcl_NewIntObj(e.fUnit),
+                          Tcl_NewIntObj(e.fFunc),
+                          Tcl_NewWideIntObj(Tcl_WideInt(e.fLba)),
+                          Tcl_NewWideIntObj(Tcl_WideInt(e.fNwrd)),
+                          Tcl_NewIntObj(e.fResult),
+                          Tcl_NewWideIntObj(Tcl_WideInt(e.fTAttn)),
+                          Tcl_NewWideIntObj(Tcl_WideInt(e.fTBack)),
+                          Tcl_NewWideIntObj(Tcl_WideInt(e.fTDone))};
+      Tcl_ListObjAppendElement(nullptr, plist, Tcl_NewListObj(8, pent));
+    }
+    args.SetResult(plist);
+    return this->kOK;
+  }
+
+  uint32_t nring = 4096;
+  std::string fname;
+  if (opt == "-enable") {
+    if (!args.GetArg("??nring", nring, 1u<<22, 1)) return this->kERR;
+  } else if (opt == "-write") {
+    if (!args.GetArg("fname", fname)) return this->kERR;
+  }
+  if (!args.AllDone()) return this->kERR;
+
+  if (opt == "-write") {                    // lock free, no connect lock
+    RerrMsg emsg;
+    if (!trace.WriteFile(fname, emsg)) return args.Quit(emsg);
+    return this->kOK;
+  }
+
+  std::lock_guard<RlinkConnect> lock(this->Obj().Connect());
+  if (opt == "-enable") {
+    trace.Enable(nring);
+  } else if (opt == "-disable") {
+    trace.Disable();
+  } else if (opt == "-clear") {
+    trace.Clear();
+  } else {
+    RtclOPtr plist(Tcl_NewListObj(0, nullptr));
+    Tcl_Obj* pval[6] = {Tcl_NewStringObj("enabled", -1),
+                        Tcl_NewBooleanObj(trace.IsEnabled()),
+                        Tcl_NewStringObj("nring", -1),
+                        Tcl_NewWideIntObj(Tcl_WideInt(trace.RingSize())),
+                        Tcl_NewStringObj("nentry", -1),
+                        Tcl_NewWideIntObj(Tcl_WideInt(trace.NEntry()))};
+    for (auto pobj : pval) Tcl_ListObjAppendElement(nullptr, plist, pobj);
+    args.SetResult(plist);
+  }
+  return this->kOK;
+}
+
 
 } // end namespace Retro
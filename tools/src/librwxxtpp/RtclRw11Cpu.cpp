@@ -1,9 +1,16 @@
 // $Id: RtclRw11Cpu.cpp 1280 2022-08-15 09:12:03Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2013-2022 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2013-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1303   1.2.42 add M_dasm
+// 2026-10-19  1300   1.2.41 add M_ibmcap
+// 2026-10-19  1299   1.2.40 add M_pcnt
+// 2026-10-19  1298   1.2.39 add M_prof
+// 2026-10-19  1297   1.2.38 add M_cmon
+// 2026-10-19  1285   1.2.37 add M_memdump
+// 2026-10-19  1284   1.2.36 add M_snapsave,M_snaprestore
 // 2022-08-11  1276   1.2.35 ssr->mmr rename
 // 2022-07-07  1249   1.2.34 BUGFIX: quit before mem write if asm-11 error seen
 // 2019-06-29  1175   1.2.33 M_ldabs(): add missing OptValid() call
@@ -59,6 +66,7 @@
 */
 
 #include <unistd.h>
+#include <fcntl.h>
 #include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -73,13 +81,17 @@
 #include "librtools/RlogMsg.hpp"
 #include "librtools/RosPrintf.hpp"
 #include "librtools/RosPrintBvi.hpp"
+#include "librtools/RfileFd.hpp"
+#include "librtools/Rtime.hpp"
 #include "librtcltools/Rtcl.hpp"
 #include "librtcltools/RtclStats.hpp"
 #include "librtcltools/RtclOPtr.hpp"
 #include "librtcltools/RtclNameSet.hpp"
+#include "librlinktpp/RtclRlinkMonCapture.hpp"
 #include "librlink/RlinkCommandList.hpp"
 
 #include "librw11/Rw11Unit.hpp"
+#include "librw11/Rw11Dasm.hpp"
 
 #include "RtclRw11.hpp"
 
@@ -115,9 +127,17 @@ RtclRw11Cpu::RtclRw11Cpu(const std::string& type)
   AddMeth("deposit",  bind(&RtclRw11Cpu::M_deposit, this, _1));
   AddMeth("examine",  bind(&RtclRw11Cpu::M_examine, this, _1));
   AddMeth("lsmem",    bind(&RtclRw11Cpu::M_lsmem,   this, _1));
+  AddMeth("memdump",  bind(&RtclRw11Cpu::M_memdump, this, _1));
+  AddMeth("cmon",     bind(&RtclRw11Cpu::M_cmon,    this, _1));
+  AddMeth("prof",     bind(&RtclRw11Cpu::M_prof,    this, _1));
+  AddMeth("pcnt",     bind(&RtclRw11Cpu::M_pcnt,    this, _1));
+  AddMeth("ibmcap",   bind(&RtclRw11Cpu::M_ibmcap,  this, _1));
+  AddMeth("dasm",     bind(&RtclRw11Cpu::M_dasm,    this, _1));
   AddMeth("ldabs",    bind(&RtclRw11Cpu::M_ldabs,   this, _1));
   AddMeth("ldasm",    bind(&RtclRw11Cpu::M_ldasm,   this, _1));
   AddMeth("boot",     bind(&RtclRw11Cpu::M_boot,    this, _1));
+  AddMeth("snapsave", bind(&RtclRw11Cpu::M_snapsave,this, _1));
+  AddMeth("snaprestore", bind(&RtclRw11Cpu::M_snaprestore, this, _1));
   AddMeth("get",      bind(&RtclRw11Cpu::M_get,     this, _1));
   AddMeth("set",      bind(&RtclRw11Cpu::M_set,     this, _1));
   AddMeth("stats",    bind(&RtclRw11Cpu::M_stats,   this, _1));
@@ -963,6 +983,458 @@ int RtclRw11Cpu::M_lsmem(RtclArgs& args)
   return kOK;
 }
 
+//------------------------------------------+-----------------------------------
+//! Bulk memory read.
+/*!
+  Syntax: <tt>memdump ?-file name? ?-rate varRate? addr nbyte</tt>
+
+  Reads \a nbyte bytes starting at the 22 bit address \a addr. The data
+  is returned as Tcl byte array, or, when \c -file is given, written as
+  binary file. With \c -rate the achieved transfer rate in kB/sec is
+  returned in \a varRate.
+ */
+
+int RtclRw11Cpu::M_memdump(RtclArgs& args)
+{
+  static RtclNameSet optset("-file|-rate");
+  
+  string opt;
+  string file;
+  string varrate;
+  while (args.NextOpt(opt, optset)) {
+    if (opt == "-file") {
+      if (!args.GetArg("file", file)) return kERR;
+    } else if (opt == "-rate") {
+      if (!args.GetArg("varRate", varrate)) return kERR;
+    }
+  }
+  if (!args.OptValid()) return kERR;
+
+  uint32_t addr  = 0;
+  uint32_t nbyte = 0;
+  if (!args.GetArg("addr", addr, 017777776)) return kERR;
+  if (!args.GetArg("nbyte", nbyte, 020000000, 2)) return kERR;
+  if (!args.AllDone()) return kERR;
+  if ((addr|nbyte) & 0x1) return args.Quit("-E: addr and nbyte must be even");
+
+  RerrMsg emsg;
+  vector<uint16_t> data;
+  Rtime tbeg(CLOCK_MONOTONIC);
+  if (!Obj().MemReadBulk(addr, data, nbyte/2, emsg)) return args.Quit(emsg);
+  double dt = (Rtime(CLOCK_MONOTONIC) - tbeg).ToDouble();
+
+  vector<uint8_t> bytes(nbyte);
+  for (size_t i=0; i<data.size(); i++) {
+    bytes[2*i]   = uint8_t(data[i]);
+    bytes[2*i+1] = uint8_t(data[i]>>8);
+  }
+
+  if (file.length()) {
+    RfileFd fd("RtclRw11Cpu::M_memdump.fd.");
+    if (!fd.Open(file.c_str(), O_WRONLY|O_CREAT|O_TRUNC, 0644, emsg) ||
+        !fd.WriteAll(bytes.data(), bytes.size(), emsg)) return args.Quit(emsg);
+    fd.Close();
+  } else {
+    args.SetResult(Tcl_NewByteArrayObj(bytes.data(), int(bytes.size())));
+  }
+
+  if (varrate.length()) {
+    double rate = (dt > 0.) ? double(nbyte)/1024./dt : 0.;
+    RtclOPtr pres(Tcl_NewDoubleObj(rate));
+    if (!Rtcl::SetVar(args.Interp(), varrate, pres)) return kERR;
+  }
+
+  return kOK;
+}
+
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Access to the dmcmon readout engine.
+
+  Returns for \c -read and \c -load a list in the format used by
+  \c rw11::cm_read, so \c rw11::cm_print can be used for output.
+ */
+
+int RtclRw11Cpu::M_cmon(RtclArgs& args)
+{
+  static RtclNameSet optset("-start|-stop|-drain|-read|-load|-stats|"
+                            "-imode|-mwsup|-file|-period");
+
+  string opt;
+  string func;
+  bool   imode  = false;
+  bool   mwsup  = false;
+  string file;
+  double period = 0.;
+  while (args.NextOpt(opt, optset)) {
+    if (opt == "-imode") {
+      imode = true;
+    } else if (opt == "-mwsup") {
+      mwsup = true;
+    } else if (opt == "-file") {
+      if (!args.GetArg("file", file)) return kERR;
+    } else if (opt == "-period") {
+      if (!args.GetArg("period", period, 0., 3600.)) return kERR;
+    } else {
+      if (func.length()) return args.Quit("-E: only one of -start,-stop,"
+                                          "-drain,-read,-load,-stats allowed");
+      func = opt;
+      if (func == "-read" || func == "-load" || func == "-stats") break;
+    }
+  }
+  if (!args.OptValid()) return kERR;
+  if (func.length() == 0) func = "-stats";
+
+  if (!Obj().HasCmon()) return args.Quit("-E: cpu has no dmcmon");
+  Rw11CpuMonitor& cmon = Obj().Cmon();
+
+  if (func == "-stats") {
+    RtclStats::Context cntx;
+    if (!RtclStats::GetArgs(args, cntx)) return kERR;
+    lock_guard<RlinkConnect> lock(Obj().Connect());
+    if (!RtclStats::Exec(args, cntx, cmon.Stats())) return kERR;
+    return kOK;
+  }
+
+  RerrMsg emsg;
+  uint16_t cntl = 0;
+  uint16_t stat = 0;
+  vector<uint16_t> data;
+
+  if (func == "-load") {
+    string fname;
+    uint32_t first = 0;
+    uint32_t nent  = 0;
+    if (!args.GetArg("fname", fname)) return kERR;
+    if (!args.GetArg("??first", first)) return kERR;
+    if (!args.GetArg("??nent", nent)) return kERR;
+    if (!args.AllDone()) return kERR;
+    if (!Rw11CpuMonitor::LoadFile(fname, first, nent, data, cntl, stat, emsg))
+      return args.Quit(emsg);
+
+  } else {
+    uint32_t nent = Rw11CpuMonitor::kRingSize;
+    if (func == "-read") {
+      if (!args.GetArg("??nent", nent, Rw11CpuMonitor::kRingSize)) return kERR;
+    }
+    if (!args.AllDone()) return kERR;
+
+    lock_guard<RlinkConnect> lock(Obj().Connect());
+    if (func == "-start") {
+      if (!cmon.Start(imode, mwsup, file, Rtime(period), emsg))
+        return args.Quit(emsg);
+      return kOK;
+    } else if (func == "-stop") {
+      if (!cmon.Stop(emsg)) return args.Quit(emsg);
+      return kOK;
+    } else if (func == "-drain") {
+      if (!cmon.Drain(true, emsg)) return args.Quit(emsg);
+      return kOK;
+    }
+    cntl = cmon.Cntl();
+    stat = cmon.Stat();
+    cmon.GetLast(data, nent);
+  }
+
+  Tcl_Interp* interp = args.Interp();
+  RtclOPtr plist(Tcl_NewListObj(0, nullptr));
+  Tcl_Obj* phead[3] = {Tcl_NewIntObj(cntl), Tcl_NewIntObj(stat),
+                       Tcl_NewIntObj(0)};
+  Tcl_ListObjAppendElement(nullptr, plist, Tcl_NewListObj(3, phead));
+  for (size_t i=0; i+Rw11CpuMonitor::kEntSize<=data.size();
+       i+=Rw11CpuMonitor::kEntSize) {
+    Tcl_Obj* pent[Rw11CpuMonitor::kEntSize];
+    for (size_t j=0; j<Rw11CpuMonitor::kEntSize; j++)
+      pent[j] = Tcl_NewIntObj(data[i+j]);
+    Tcl_ListObjAppendElement(nullptr, plist,
+                             Tcl_NewListObj(Rw11CpuMonitor::kEntSize, pent));
+  }
+  Tcl_SetObjResult(interp, plist);
+  return kOK;
+}
+
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Access to the pc sampling profiler.
+
+  Without function option a list of name value pairs with the profiler
+  settings and the measured overhead is returned. \c -get returns a list
+  of \c {mode pc count} triples sorted by decreasing count.
+ */
+
+int RtclRw11Cpu::M_prof(RtclArgs& args)
+{
+  static RtclNameSet optset("-start|-stop|-clear|-write|-get|-stats|"
+                            "-period|-budget|-susp");
+
+  string opt;
+  string func;
+  double period = 0.001;
+  double budget = 0.;
+  bool   susp   = false;
+  while (args.NextOpt(opt, optset)) {
+    if (opt == "-period") {
+      if (!args.GetArg("period", period, 1.e-6, 3600.)) return kERR;
+    } else if (opt == "-budget") {
+      if (!args.GetArg("budget", budget, 0., 0.99)) return kERR;
+    } else if (opt == "-susp") {
+      susp = true;
+    } else {
+      if (func.length()) return args.Quit("-E: only one of -start,-stop,"
+                                          "-clear,-write,-get,-stats allowed");
+      func = opt;
+      if (func == "-write" || func == "-get" || func == "-stats") break;
+    }
+  }
+  if (!args.OptValid()) return kERR;
+
+  Rw11CpuProfiler& prof = Obj().Prof();
+
+  if (func == "-stats") {
+    RtclStats::Context cntx;
+    if (!RtclStats::GetArgs(args, cntx)) return kERR;
+    lock_guard<RlinkConnect> lock(Obj().Connect());
+    if (!RtclStats::Exec(args, cntx, prof.Stats())) return kERR;
+    return kOK;
+  }
+
+  string fname;
+  uint32_t nmax = 0;
+  if (func == "-write") {
+    if (!args.GetArg("fname", fname)) return kERR;
+  } else if (func == "-get") {
+    if (!args.GetArg("??nmax", nmax)) return kERR;
+  }
+  if (!args.AllDone()) return kERR;
+
+  RerrMsg emsg;
+  lock_guard<RlinkConnect> lock(Obj().Connect());
+
+  if (func == "-start") {
+    if (!prof.Start(Rtime(period), budget, susp, emsg)) return args.Quit(emsg);
+  } else if (func == "-stop") {
+    prof.Stop();
+  } else if (func == "-clear") {
+    prof.Clear();
+  } else if (func == "-write") {
+    if (!prof.WriteFile(fname, emsg)) return args.Quit(emsg);
+
+  } else if (func == "-get") {
+    static const char* modnam[] = {"k", "s", "i", "u"};
+    vector<Rw11CpuProfiler::entry> hist;
+    prof.GetHist(hist);
+    if (nmax > 0 && hist.size() > nmax) hist.resize(nmax);
+    RtclOPtr plist(Tcl_NewListObj(0, nullptr));
+    for (auto& e : hist) {
+      Tcl_Obj* pent[3] = {Tcl_NewStringObj(modnam[e.fMode], -1),
+                          Tcl_NewIntObj(e.fPc),
+                          Tcl_NewWideIntObj(Tcl_WideInt(e.fCount))};
+      Tcl_ListObjAppendElement(nullptr, plist, Tcl_NewListObj(3, pent));
+    }
+    args.SetResult(plist);
+
+  } else {
+    RtclOPtr plist(Tcl_NewListObj(0, nullptr));
+    auto add = [&plist](const char* name, Tcl_Obj* pval) {
+      Tcl_ListObjAppendElement(nullptr, plist, Tcl_NewStringObj(name, -1));
+      Tcl_ListObjAppendElement(nullptr, plist, pval);
+    };
+    add("active",    Tcl_NewBooleanObj(prof.IsActive()));
+    add("method",    Tcl_NewStringObj(prof.UseSuspend() ? "susp":"cmon", -1));
+    add("period",    Tcl_NewDoubleObj(prof.Period().ToDouble()));
+    add("periodeff", Tcl_NewDoubleObj(prof.PeriodEff().ToDouble()));
+    add("budget",    Tcl_NewDoubleObj(prof.Budget()));
+    add("overhead",  Tcl_NewDoubleObj(prof.Overhead()));
+    add("nsample",   Tcl_NewWideIntObj(Tcl_WideInt(prof.NSample())));
+    args.SetResult(plist);
+  }
+
+  return kOK;
+}
+
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Access to the dmpcnt sampler.
+
+  \c -read returns a list of \c {time dt {v0 ... v31}} samples, oldest
+  first, with counter deltas, or with rates in 1/sec when \c -rate is given.
+ */
+
+int RtclRw11Cpu::M_pcnt(RtclArgs& args)
+{
+  static RtclNameSet optset("-start|-stop|-read|-names|-stats|"
+                            "-period|-nring|-file|-bin|-rate");
+
+  string opt;
+  string func;
+  double period = 1.;
+  uint32_t nring = 1024;
+  string file;
+  bool   binary = false;
+  bool   rate   = false;
+  while (args.NextOpt(opt, optset)) {
+    if (opt == "-period") {
+      if (!args.GetArg("period", period, 1.e-4, 3600.)) return kERR;
+    } else if (opt == "-nring") {
+      if (!args.GetArg("nring", nring, 1u<<20, 1)) return kERR;
+    } else if (opt == "-file") {
+      if (!args.GetArg("file", file)) return kERR;
+    } else if (opt == "-bin") {
+      binary = true;
+    } else if (opt == "-rate") {
+      rate = true;
+    } else {
+      if (func.length()) return args.Quit("-E: only one of -start,-stop,"
+                                          "-read,-names,-stats allowed");
+      func = opt;
+      if (func == "-stats") break;
+    }
+  }
+  if (!args.OptValid()) return kERR;
+  if (func.length() == 0) func = "-read";
+
+  Rw11CpuPerfCnt& pcnt = Obj().Pcnt();
+
+  if (func == "-stats") {
+    RtclStats::Context cntx;
+    if (!RtclStats::GetArgs(args, cntx)) return kERR;
+    lock_guard<RlinkConnect> lock(Obj().Connect());
+    if (!RtclStats::Exec(args, cntx, pcnt.Stats())) return kERR;
+    return kOK;
+  }
+
+  uint32_t nsam = 1;
+  if (func == "-read") {
+    if (!args.GetArg("??nsam", nsam)) return kERR;
+  }
+  if (!args.AllDone()) return kERR;
+
+  RerrMsg emsg;
+  lock_guard<RlinkConnect> lock(Obj().Connect());
+
+  if (func == "-start") {
+    if (!pcnt.Start(Rtime(period), nring, file, binary, emsg))
+      return args.Quit(emsg);
+  } else if (func == "-stop") {
+    if (!pcnt.Stop(emsg)) return args.Quit(emsg);
+
+  } else if (func == "-names") {
+    RtclOPtr plist(Tcl_NewListObj(0, nullptr));
+    for (size_t i=0; i<Rw11CpuPerfCnt::kNCnt; i++) {
+      Tcl_ListObjAppendElement(nullptr, plist,
+                     Tcl_NewStringObj(Rw11CpuPerfCnt::CntName(i), -1));
+    }
+    args.SetResult(plist);
+
+  } else {
+    vector<Rw11CpuPerfCnt::sample> list;
+    pcnt.GetLast(list, nsam);
+    RtclOPtr plist(Tcl_NewListObj(0, nullptr));
+    for (auto& sam : list) {
+      Tcl_Obj* pval = Tcl_NewListObj(0, nullptr);
+      for (size_t i=0; i<Rw11CpuPerfCnt::kNCnt; i++) {
+        Tcl_Obj* pv;
+        if (rate) {
+          pv = Tcl_NewDoubleObj((sam.fDt > 0.) ? sam.fDlt[i]/sam.fDt : 0.);
+        } else {
+          pv = Tcl_NewWideIntObj(Tcl_WideInt(sam.fDlt[i]));
+        }
+        Tcl_ListObjAppendElement(nullptr, pval, pv);
+      }
+      Tcl_Obj* pent[3] = {Tcl_NewDoubleObj(sam.fTime),
+                          Tcl_NewDoubleObj(sam.fDt), pval};
+      Tcl_ListObjAppendElement(nullptr, plist, Tcl_NewListObj(3, pent));
+    }
+    args.SetResult(plist);
+  }
+
+  return kOK;
+}
+
+//------------------------------------------+-----------------------------------
+//! Access to the ibmon background capture.
+
+int RtclRw11Cpu::M_ibmcap(RtclArgs& args)
+{
+  if (!Obj().HasIbmon())
+    return args.Quit("-E: no ibus monitor (ibd_ibmon) available");
+  return RtclRlinkMonCapture::Exec(args, Obj().IbmonCapture());
+}
+
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Disassemble instructions with the native disassembler.
+
+  \c wlist and \c -mem return a list of \c {addr nwrd text} triples,
+  \c -ireg returns a list of texts, one per word, each word disassembled
+  alone as done by \c rw11::dasm_ireg2txt. \c -vec returns the name of a
+  vector as done by \c rw11::dasm_vec2txt.
+ */
+
+int RtclRw11Cpu::M_dasm(RtclArgs& args)
+{
+  static RtclNameSet optset("-addr|-mem|-ireg|-vec");
+
+  string opt;
+  string func;
+  uint32_t addr = 0;
+  while (args.NextOpt(opt, optset)) {
+    if (opt == "-addr") {
+      if (!args.GetArg("addr", addr, 017777776)) return kERR;
+    } else {
+      if (func.length()) return args.Quit("-E: only one of -mem,-ireg,-vec "
+                                          "allowed");
+      func = opt;
+      break;
+    }
+  }
+  if (!args.OptValid()) return kERR;
+
+  if (func == "-vec") {
+    uint16_t vec = 0;
+    if (!args.GetArg("vec", vec)) return kERR;
+    if (!args.AllDone()) return kERR;
+    args.SetResult(string(Rw11Dasm::Vec2Txt(vec)));
+    return kOK;
+  }
+
+  vector<uint16_t> data;
+  if (func == "-mem") {
+    uint32_t nbyte = 0;
+    if (!args.GetArg("addr", addr, 017777776)) return kERR;
+    if (!args.GetArg("nbyte", nbyte, 020000000, 2)) return kERR;
+    if (!args.AllDone()) return kERR;
+    if ((addr|nbyte) & 0x1) return args.Quit("-E: addr and nbyte must be even");
+    RerrMsg emsg;
+    if (!Obj().MemReadBulk(addr, data, nbyte/2, emsg)) return args.Quit(emsg);
+  } else {
+    if (!args.GetArg("wlist", data)) return kERR;
+    if (!args.AllDone()) return kERR;
+  }
+
+  RtclOPtr plist(Tcl_NewListObj(0, nullptr));
+  if (func == "-ireg") {
+    string txt;
+    for (auto w : data) {
+      Rw11Dasm::Inst2Txt(&w, 1, txt);
+      Tcl_ListObjAppendElement(nullptr, plist,
+                               Tcl_NewStringObj(txt.data(), int(txt.size())));
+    }
+  } else {
+    vector<Rw11Dasm::line> list;
+    Rw11Dasm::Buffer(addr, data.data(), data.size(), list);
+    for (auto& l : list) {
+      Tcl_Obj* pent[3] = {Tcl_NewIntObj(int(l.fAddr)),
+                          Tcl_NewIntObj(l.fNWrd),
+                          Tcl_NewStringObj(l.fText.data(),
+                                           int(l.fText.size()))};
+      Tcl_ListObjAppendElement(nullptr, plist, Tcl_NewListObj(3, pent));
+    }
+  }
+  args.SetResult(plist);
+  return kOK;
+}
+
 //------------------------------------------+-----------------------------------
 //! FIXME_docs
 
@@ -1264,6 +1736,41 @@ int RtclRw11Cpu::M_boot(RtclArgs& args)
 //------------------------------------------+-----------------------------------
 //! FIXME_docs
 
+int RtclRw11Cpu::M_snapsave(RtclArgs& args)
+{
+  string file;
+  if (!args.GetArg("file", file)) return kERR;
+  if (!args.AllDone()) return kERR;
+  RerrMsg emsg;
+  if (!Obj().SnapSave(file, emsg)) return args.Quit(emsg);
+  return kOK;
+}
+  
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
+int RtclRw11Cpu::M_snaprestore(RtclArgs& args)
+{
+  static RtclNameSet optset("-force");
+  
+  string opt;
+  bool force = false;
+  while (args.NextOpt(opt, optset)) {
+    if (opt == "-force") force = true;
+  }
+  if (!args.OptValid()) return kERR;
+
+  string file;
+  if (!args.GetArg("file", file)) return kERR;
+  if (!args.AllDone()) return kERR;
+  RerrMsg emsg;
+  if (!Obj().SnapRestore(file, emsg, force)) return args.Quit(emsg);
+  return kOK;
+}
+  
+//------------------------------------------+-----------------------------------
+//! FIXME_docs
+
 int RtclRw11Cpu::M_get(RtclArgs& args)
 {
   // synchronize with server thread
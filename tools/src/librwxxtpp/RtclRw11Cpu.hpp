@@ -1,9 +1,16 @@
 // $Id: RtclRw11Cpu.hpp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2013-2017 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2013-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1303   1.0.12 add M_dasm
+// 2026-10-19  1300   1.0.11 add M_ibmcap
+// 2026-10-19  1299   1.0.10 add M_pcnt
+// 2026-10-19  1298   1.0.9  add M_prof
+// 2026-10-19  1297   1.0.8  add M_cmon
+// 2026-10-19  1285   1.0.7  add M_memdump
+// 2026-10-19  1284   1.0.6  add M_snapsave,M_snaprestore
 // 2017-04-16   876   1.0.5  add ControllerCommands()
 // 2015-04-03   661   1.0.4  add ClistNonEmpty()
 // 2015-03-21   659   1.0.3  rename M_amap->M_imap; add M_rmap; add GetRAddr()
@@ -51,9 +58,17 @@ namespace Retro {
       int           M_deposit(RtclArgs& args);
       int           M_examine(RtclArgs& args);
       int           M_lsmem(RtclArgs& args);
+      int           M_memdump(RtclArgs& args);
+      int           M_cmon(RtclArgs& args);
+      int           M_prof(RtclArgs& args);
+      int           M_pcnt(RtclArgs& args);
+      int           M_ibmcap(RtclArgs& args);
+      int           M_dasm(RtclArgs& args);
       int           M_ldabs(RtclArgs& args);
       int           M_ldasm(RtclArgs& args);
       int           M_boot(RtclArgs& args);
+      int           M_snapsave(RtclArgs& args);
+      int           M_snaprestore(RtclArgs& args);
       int           M_get(RtclArgs& args);
       int           M_set(RtclArgs& args);
       int           M_show(RtclArgs& args);
@@ -1,9 +1,10 @@
 // $Id: RtclRw11UnitDisk.cpp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2013-2019 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2013-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1302   1.2.4  add M_record
 // 2019-02-23  1114   1.2.3  use std::bind instead of lambda
 // 2018-12-15  1082   1.2.2  use lambda instead of boost::bind
 // 2018-10-06  1053   1.2.1  move using after includes (clang warning)
@@ -19,6 +20,10 @@
 */
 
 #include <functional>
+#include <mutex>
+
+#include "librtcltools/RtclNameSet.hpp"
+#include "librtcltools/RtclOPtr.hpp"
 
 #include "RtclRw11UnitDisk.hpp"
 
@@ -38,7 +43,9 @@ namespace Retro {
 
 RtclRw11UnitDisk::RtclRw11UnitDisk(const std::string& type)
   : RtclRw11Unit(type)
-{}
+{
+  AddMeth("record", bind(&RtclRw11UnitDisk::M_record, this, _1));
+}
 
 //------------------------------------------+-----------------------------------
 //! FIXME_docs
@@ -46,6 +53,54 @@ RtclRw11UnitDisk::RtclRw11UnitDisk(const std::string& type)
 RtclRw11UnitDisk::~RtclRw11UnitDisk()
 {}
 
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Record backend accesses for replay with dskbench.
+
+  \c -start fname starts, \c -stop stops recording, \c -info returns
+  a list with file name, number of records and write errors, an empty
+  list when not recording. Without option \c -info is assumed.
+ */
+
+int RtclRw11UnitDisk::M_record(RtclArgs& args)
+{
+  static RtclNameSet optset("-start|-stop|-info");
+
+  string opt;
+  if (!args.NextOpt(opt, optset)) {
+    if (!args.OptValid()) return kERR;
+    opt = "-info";
+  }
+
+  string fname;
+  if (opt == "-start" && !args.GetArg("fname", fname)) return kERR;
+  if (!args.AllDone()) return kERR;
+
+  RerrMsg emsg;
+  // synchronize with server thread
+  lock_guard<RlinkConnect> lock(Cpu().Connect());
+  Rw11UnitDisk& unit = ObjUV();
+
+  if (opt == "-start") {
+    if (!unit.StartRecord(fname, emsg)) return args.Quit(emsg);
+  } else if (opt == "-stop") {
+    if (!unit.StopRecord(emsg)) return args.Quit(emsg);
+  } else {
+    const Rw11DiskRecorder* prec = unit.Recorder();
+    RtclOPtr plist(Tcl_NewListObj(0, nullptr));
+    if (prec) {
+      Tcl_ListObjAppendElement(nullptr, plist,
+                          Tcl_NewStringObj(prec->FileName().c_str(), -1));
+      Tcl_ListObjAppendElement(nullptr, plist,
+                          Tcl_NewWideIntObj(Tcl_WideInt(prec->NRecord())));
+      Tcl_ListObjAppendElement(nullptr, plist,
+                          Tcl_NewWideIntObj(Tcl_WideInt(prec->NError())));
+    }
+    args.SetResult(plist);
+  }
+  return kOK;
+}
+
 //------------------------------------------+-----------------------------------
 //! FIXME_docs
 
@@ -1,9 +1,10 @@
 // $Id: RtclRw11UnitDisk.hpp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2013-2017 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2013-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1302   1.1.1  add M_record
 // 2017-04-08   870   1.1    use Rw11UnitDisk& ObjUV(); inherit from RtclRw11Unit
 // 2013-04-19   507   1.0    Initial version
 // 2013-02-22   490   0.1    First draft
@@ -31,6 +32,7 @@ namespace Retro {
       virtual Rw11UnitDisk&  ObjUV() = 0;
 
     protected:
+      int           M_record(RtclArgs& args);
       void          SetupGetSet();
 
   };
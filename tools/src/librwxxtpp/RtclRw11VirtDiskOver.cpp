@@ -1,9 +1,10 @@
 // $Id: RtclRw11VirtDiskOver.cpp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2013-2019 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2013-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1292   1.1    add snap method
 // 2019-02-23  1114   1.0.3  use std::bind instead of lambda
 // 2018-12-17  1087   1.0.2  use std::lock_guard instead of boost
 // 2018-12-15  1082   1.0.1  use lambda instead of boost::bind
@@ -16,6 +17,8 @@
 
 #include <functional>
 
+#include "librtcltools/RtclNameSet.hpp"
+
 #include "RtclRw11VirtDiskOver.hpp"
 
 using namespace std;
@@ -37,6 +40,7 @@ RtclRw11VirtDiskOver::RtclRw11VirtDiskOver(Rw11VirtDiskOver* pobj)
 {
   AddMeth("flush", bind(&RtclRw11VirtDiskOver::M_flush,  this, _1));
   AddMeth("list",  bind(&RtclRw11VirtDiskOver::M_list,   this, _1));
+  AddMeth("snap",  bind(&RtclRw11VirtDiskOver::M_snap,   this, _1));
 }
 
 //------------------------------------------+-----------------------------------
@@ -74,4 +78,46 @@ int RtclRw11VirtDiskOver::M_list(RtclArgs& args)
   return kOK;
 }
 
+//------------------------------------------+-----------------------------------
+/*!
+  \brief Handle snapshot layers.
+
+  Usage: snap ?-create fname|-commit|-discard|-list|-depth?. Without
+  option the layer list is returned.
+ */
+
+int RtclRw11VirtDiskOver::M_snap(RtclArgs& args)
+{
+  static RtclNameSet optset("-create|-commit|-discard|-list|-depth");
+
+  string opt;
+  string fname;
+  if (args.NextOpt(opt, optset)) {
+    if (opt == "-create") {
+      if (!args.GetArg("fname", fname)) return kERR;
+    }
+  } else {
+    opt = "-list";
+  }
+  if (!args.AllDone()) return kERR;
+
+  // synchronize with server thread
+  lock_guard<RlinkConnect> lock(Obj().Cpu().Connect());
+  RerrMsg emsg;
+  if        (opt == "-create") {
+    if (!Obj().SnapCreate(fname, emsg)) return args.Quit(emsg);
+  } else if (opt == "-commit") {
+    if (!Obj().SnapCommit(emsg)) return args.Quit(emsg);
+  } else if (opt == "-discard") {
+    if (!Obj().SnapDiscard(emsg)) return args.Quit(emsg);
+  } else if (opt == "-depth") {
+    args.SetResult(int(Obj().SnapDepth()));
+  } else {
+    ostringstream sos;
+    Obj().SnapList(sos);
+    args.SetResult(sos);
+  }
+  return kOK;
+}
+
 } // end namespace Retro
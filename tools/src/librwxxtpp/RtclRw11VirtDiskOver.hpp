@@ -1,9 +1,10 @@
 // $Id: RtclRw11VirtDiskOver.hpp 1186 2019-07-12 17:49:59Z mueller $
 // SPDX-License-Identifier: GPL-3.0-or-later
-// Copyright 2017- by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// Copyright 2017-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 // 
 // Revision History: 
 // Date         Rev Version  Comment
+// 2026-10-19  1292   1.1    add snap method
 // 2013-03-11   859   1.0    Initial version
 // ---------------------------------------------------------------------------
 
@@ -29,6 +30,7 @@ namespace Retro {
     protected:
       int           M_flush(RtclArgs& args);
       int           M_list(RtclArgs& args);
+      int           M_snap(RtclArgs& args);
   };
   
 } // end namespace Retro
@@ -0,0 +1,182 @@
+// $Id: test_dasm.cpp 1306 2026-10-19 20:41:12Z mueller $
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// 
+// Revision History: 
+// Date         Rev Version  Comment
+// 2026-10-19  1306   1.0    Initial version
+
+// Rw11Dasm: known encodings -> text. The expected texts are those given by
+// rw11::dasm_inst2txt, Rw11Dasm must stay text compatible with dasm.tcl.
+
+#include <string>
+#include <vector>
+
+#include "librw11/Rw11Dasm.hpp"
+
+#include "testrw11.hpp"
+
+using namespace std;
+using namespace Retro;
+
+// one instruction: words given, words expected to be used, expected text
+struct dasmref {
+  size_t      fNw;
+  uint16_t    fWrd[3];
+  size_t      fNUse;
+  const char* fText;
+};
+
+static const dasmref kDasmRef[] = {
+  // 0 operand, cc and spl
+  {1, {0000000}, 1, "halt"},
+  {1, {0000001}, 1, "wait"},
+  {1, {0000002}, 1, "rti"},
+  {1, {0000006}, 1, "rtt"},
+  {1, {0000007}, 1, "!mfpt"},
+  {1, {0000230}, 1, "spl 0 "},
+  {1, {0000234}, 1, "spl 4 "},
+  {1, {0000237}, 1, "spl 7 "},
+  {1, {0000241}, 1, "clc"},
+  {1, {0000257}, 1, "ccc"},
+  {1, {0000262}, 1, "sev"},
+  {1, {0000277}, 1, "scc"},
+  {1, {0000240}, 1, "nop"},
+  // jmp, jsr, rts, mark, sob and branches
+  {1, {0000100}, 1, "jmp r0"},
+  {2, {0000137, 0001000}, 2, "jmp @#001000"},
+  {2, {0000167, 0000100}, 2, "jmp 000100(pc)"},
+  {1, {0000207}, 1, "rts pc"},
+  {1, {0000400}, 1, "br .+2"},
+  {1, {0000777}, 1, "br .-0"},
+  {1, {0001377}, 1, "bne .-0"},
+  {2, {0004737, 0002000}, 2, "jsr pc,@#002000"},
+  {2, {0004567, 0000010}, 2, "jsr r5,000010(pc)"},
+  {1, {0006427}, 1, "mark 027"},
+  {1, {0006401}, 1, "mark 001"},
+  {1, {0077101}, 1, "sob r1,.-0"},
+  {1, {0077277}, 1, "sob r2,.-124"},
+  // 1 and 2 operand, all address modes
+  {1, {0000300}, 1, "swab r0"},
+  {1, {0005000}, 1, "clr r0"},
+  {2, {0005027, 0000100}, 2, "clr #000100"},
+  {2, {0005237, 0000200}, 2, "inc @#000200"},
+  {2, {0005267, 0177776}, 2, "inc 177776(pc)"},
+  {1, {0006503}, 1, "mfpi r3"},
+  {1, {0006603}, 1, "mtpi r3"},
+  {1, {0006700}, 1, "sxt r0"},
+  {1, {0010102}, 1, "mov r1,r2"},
+  {2, {0012700, 0000123}, 2, "mov #000123,r0"},
+  {3, {0012737, 0000001, 0177560}, 3, "mov #000001,@#177560"},
+  {3, {0016062, 0000002, 0000004}, 3, "mov 000002(r0),000004(r2)"},
+  {1, {0060102}, 1, "add r1,r2"},
+  {2, {0066527, 0000010}, 2, "add 000010(r5),#n"},
+  {1, {0070203}, 1, "mul r3,r2"},
+  {2, {0071067, 0000020}, 2, "div 000020(pc),r0"},
+  {2, {0072127, 0000003}, 2, "ash #000003,r1"},
+  {1, {0073204}, 1, "ashc r4,r2"},
+  {1, {0074120}, 1, "xor r1,(r0)+"},
+  {2, {0105737, 0177560}, 2, "tstb @#177560"},
+  {1, {0106000}, 1, "rorb r0"},
+  {1, {0110001}, 1, "movb r0,r1"},
+  {1, {0106500}, 1, "mfpd r0"},
+  {1, {0006727}, 1, "sxt #n"},
+  // traps
+  {1, {0104000}, 1, "emt 000"},
+  {1, {0104377}, 1, "emt 377"},
+  {1, {0104477}, 1, "trap 077"},
+  // FPP, incl. setd (was missed by dasm_getdsc)
+  {1, {0170000}, 1, "!cfcc"},
+  {1, {0170001}, 1, "!setf"},
+  {1, {0170002}, 1, "!seti"},
+  {1, {0170011}, 1, "!setd"},
+  {2, {0170127, 0040200}, 2, "!ldfps #040200"},
+  {1, {0170300}, 1, "!stst f0"},
+  {1, {0170400}, 1, "!clrf f0"},
+  {2, {0170527, 0000000}, 2, "!tstf #000000"},
+  {1, {0170600}, 1, "!absf f0"},
+  {1, {0170700}, 1, "!negf f0"},
+  {1, {0171001}, 1, "!mulf f0,f1"},
+  {1, {0171200}, 1, "!mulf f2,f0"},
+  {1, {0171401}, 1, "!modf f0,f1"},
+  {1, {0172001}, 1, "!addf f0,f1"},
+  {2, {0172467, 0000002}, 2, "!ldf f0,000002(pc)"},
+  {1, {0173001}, 1, "!subf f0,f1"},
+  {1, {0174100}, 1, "!stf f1,f0"},
+  {1, {0175001}, 1, "!stexp f0,f1"},
+  {1, {0175400}, 1, "!stcif f0,f0"},
+  {1, {0176001}, 1, "!stcfd f0,f1"},
+  {1, {0177001}, 1, "!ldcif f0,f1"},
+  {1, {0177400}, 1, "!ldcdf f0,f0"},
+  // other codes flagged with ! in dasm_opdsc
+  {1, {0106427}, 1, "!mtps #n"},
+  {2, {0106737, 0177566}, 2, "!mfps @#177566"},
+  {1, {0106400}, 1, "!mtps r0"},
+  {1, {0007000}, 1, "!csm r0"},
+  {1, {0007201}, 1, "!tstset r1"},
+  // unknown codes
+  {1, {0170004}, 1, "?170004?"},
+  {1, {0170022}, 1, "?170022?"},
+  {1, {0075004}, 1, "?075004?"},
+  {1, {0075104}, 1, "?075104?"},
+  {1, {0075204}, 1, "?075204?"},
+  {1, {0075304}, 1, "?075304?"},
+};
+
+//------------------------------------------+-----------------------------------
+static string Oct(uint32_t val)
+{
+  string txt;
+  for (int sh=15; sh>=0; sh-=3) txt += char('0' + ((val >> sh) & 07));
+  return txt;
+}
+
+//------------------------------------------+-----------------------------------
+void TestDasm()
+{
+  // table of known encodings, words beyond fNw show as 'n'
+  for (auto& r : kDasmRef) {
+    string txt;
+    size_t nuse = Rw11Dasm::Inst2Txt(r.fWrd, r.fNw, txt);
+    Check(nuse == r.fNUse && txt == r.fText,
+          "Inst2Txt(" + Oct(r.fWrd[0]) + "): got '" + txt + "' nuse=" +
+          to_string(nuse) + ", expect '" + r.fText + "' nuse=" +
+          to_string(r.fNUse));
+    if (r.fNw == 1) {
+      Check(Rw11Dasm::Ireg2Txt(r.fWrd[0]) == r.fText,
+            "Ireg2Txt(" + Oct(r.fWrd[0]) + ") differs from Inst2Txt()");
+    }
+  }
+
+  // buffer: instruction boundaries, addresses, incomplete last instruction
+  static const uint16_t code[] = {0012737, 0000001, 0177560,   // 1000
+                                  0000240,                     // 1006
+                                  0077101,                     // 1010
+                                  0012700};                    // 1012
+  static const Rw11Dasm::line blist[] = {
+    {0001000, 3, "mov #000001,@#177560"},
+    {0001006, 1, "nop"},
+    {0001010, 1, "sob r1,.-0"},
+    {0001012, 1, "mov #n,r0"}
+  };
+  vector<Rw11Dasm::line> list;
+  Rw11Dasm::Buffer(01000, code, sizeof(code)/sizeof(code[0]), list);
+  if (Check(list.size() == 4, "Buffer(): expect 4 lines, got " +
+            to_string(list.size()))) {
+    for (size_t i=0; i<list.size(); i++) {
+      const Rw11Dasm::line& r = blist[i];
+      Check(list[i].fAddr == r.fAddr && list[i].fNWrd == r.fNWrd &&
+            list[i].fText == r.fText,
+            "Buffer(): line " + to_string(i) + " is " +
+            Oct(list[i].fAddr) + " " + to_string(list[i].fNWrd) + " '" +
+            list[i].fText + "'");
+    }
+  }
+
+  // vector names
+  Check(string(Rw11Dasm::Vec2Txt(0004)) == "iit",  "Vec2Txt(004)");
+  Check(string(Rw11Dasm::Vec2Txt(0034)) == "trp",  "Vec2Txt(034)");
+  Check(string(Rw11Dasm::Vec2Txt(0100)) == "kw-l", "Vec2Txt(100)");
+  Check(string(Rw11Dasm::Vec2Txt(0002)) == "",     "Vec2Txt(002)");
+  return;
+}
@@ -0,0 +1,253 @@
+// $Id: test_pack.cpp 1306 2026-10-19 20:41:12Z mueller $
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// 
+// Revision History: 
+// Date         Rev Version  Comment
+// 2026-10-19  1306   1.0    Initial version
+
+// Rw11VirtDiskPack: cluster format. The container is built here from the
+// format description, like disk2pack does it, and holds compressed, raw,
+// all-zero, shared and a partial last cluster. Reads must give back the
+// image, writes go to the overlay, broken containers are rejected.
+
+#include <zlib.h>
+
+#include <cstring>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "librtools/RerrMsg.hpp"
+#include "librw11/Rw11VirtDisk.hpp"
+#include "librw11/Rw11VirtDiskPack.hpp"
+
+#include "testrw11.hpp"
+
+using namespace std;
+using namespace Retro;
+
+static const size_t kBlkSize = 512;
+static const size_t kCluSize = 4096;        // 8 blocks per cluster
+static const size_t kNClu    = 11;          // > Rw11VirtDiskPack::kCacheSize
+static const size_t kImgSize = kNClu*kCluSize - kCluSize/2; // last partial
+static const size_t kNBlock  = kImgSize/kBlkSize;
+
+typedef vector<uint8_t> bytes;
+
+// what the pack builder did, to check that all cluster kinds are covered
+struct packinfo {
+  size_t fNZero;
+  size_t fNRaw;
+  size_t fNDup;
+  size_t fNComp;
+  vector<size_t> fOffset;                   // data offset of each cluster
+};
+
+//------------------------------------------+-----------------------------------
+static void Put32(bytes& buf, size_t pos, uint32_t val)
+{
+  for (size_t i=0; i<4; i++) buf[pos+i] = uint8_t(val >> (8*i));
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+// build a pack container from image, same layout and rules as disk2pack
+static bytes MakePack(const bytes& img, size_t csize, packinfo& info)
+{
+  size_t ncl = (img.size()+csize-1)/csize;
+  bytes pack(Rw11VirtDiskPack::kHdrSize + ncl*Rw11VirtDiskPack::kIdxSize);
+  memcpy(pack.data(), Rw11VirtDiskPack::kMagic.data(), 8);
+  Put32(pack,  8, uint32_t(csize));
+  Put32(pack, 12, uint32_t(ncl));
+  Put32(pack, 16, uint32_t(img.size()));
+  Put32(pack, 20, uint32_t(uint64_t(img.size()) >> 32));
+
+  info = packinfo{0, 0, 0, 0, {}};
+  map<bytes,size_t> seen;                   // content -> cluster number
+  vector<uint32_t> len(ncl), flags(ncl);
+  for (size_t i=0; i<ncl; i++) {
+    size_t nclu = min(csize, img.size()-i*csize);
+    bytes clu(img.begin()+i*csize, img.begin()+i*csize+nclu);
+    info.fOffset.push_back(0);
+    if (clu == bytes(nclu, 0)) {            // all zero cluster
+      info.fNZero += 1;
+      continue;
+    }
+    auto it = seen.find(clu);
+    if (it != seen.end()) {                 // duplicate cluster
+      info.fNDup += 1;
+      info.fOffset[i] = info.fOffset[it->second];
+      len[i]   = len[it->second];
+      flags[i] = flags[it->second];
+      continue;
+    }
+    uLongf nz = compressBound(nclu);
+    bytes zbuf(nz);
+    compress2(zbuf.data(), &nz, clu.data(), nclu, 9);
+    zbuf.resize(nz);
+    if (nz >= nclu) {                       // incompressible, store raw
+      zbuf = clu;
+      flags[i] = Rw11VirtDiskPack::kFlagRaw;
+      info.fNRaw += 1;
+    } else {
+      info.fNComp += 1;
+    }
+    info.fOffset[i] = pack.size();
+    len[i] = uint32_t(zbuf.size());
+    pack.insert(pack.end(), zbuf.begin(), zbuf.end());
+    seen[clu] = i;
+  }
+
+  for (size_t i=0; i<ncl; i++) {
+    size_t pos = Rw11VirtDiskPack::kHdrSize + i*Rw11VirtDiskPack::kIdxSize;
+    Put32(pack, pos,    uint32_t(info.fOffset[i]));
+    Put32(pack, pos+4,  uint32_t(uint64_t(info.fOffset[i]) >> 32));
+    Put32(pack, pos+8,  len[i]);
+    Put32(pack, pos+12, flags[i]);
+  }
+  return pack;
+}
+
+//------------------------------------------+-----------------------------------
+// image with compressible, zero, random, duplicate and partial clusters
+static bytes MakeImage()
+{
+  bytes img(kImgSize, 0);
+  srand(4711);
+  for (size_t i=0; i<kNClu; i++) {
+    uint8_t* p = img.data() + i*kCluSize;
+    size_t nclu = min(kCluSize, kImgSize-i*kCluSize);
+    if (i == 1) continue;                               // zero
+    if (i == 2 || i == kNClu-1) {                       // random -> raw
+      for (size_t k=0; k<nclu; k++) p[k] = uint8_t(rand());
+    } else if (i == 3) {                                // copy of 0
+      memcpy(p, img.data(), nclu);
+    } else {                                            // ramps
+      for (size_t k=0; k<nclu; k++) p[k] = uint8_t(k/16 + 7*i);
+    }
+  }
+  return img;
+}
+
+//------------------------------------------+-----------------------------------
+static unique_ptr<Rw11VirtDisk> OpenPack(const string& fname, size_t nblock,
+                                         RerrMsg& emsg)
+{
+  unique_ptr<Rw11VirtDisk> up = Rw11VirtDisk::New("pack:" + fname, nullptr,
+                                                   emsg);
+  if (up) up->Setup(kBlkSize, nblock, 0, 0, 0);
+  return up;
+}
+
+//------------------------------------------+-----------------------------------
+static bool ReadCmp(Rw11VirtDisk& disk, size_t lba, size_t nblk,
+                    const bytes& ref)
+{
+  bytes buf(nblk*kBlkSize);
+  RerrMsg emsg;
+  if (!disk.Read(lba, nblk, buf.data(), emsg)) {
+    Check(false, "Read(" + to_string(lba) + "," + to_string(nblk) +
+          ") failed: " + emsg.Text());
+    return false;
+  }
+  return Check(memcmp(buf.data(), ref.data()+lba*kBlkSize, buf.size()) == 0,
+               "Read(" + to_string(lba) + "," + to_string(nblk) +
+               ") data differs");
+}
+
+//------------------------------------------+-----------------------------------
+void TestPack()
+{
+  bytes img = MakeImage();
+  packinfo info;
+  bytes pack = MakePack(img, kCluSize, info);
+  Check(info.fNZero == 1 && info.fNRaw == 2 && info.fNDup == 1 &&
+        info.fNComp == kNClu-4, "test image covers all cluster kinds");
+  string fname = TmpName("test.dpk");
+  WriteFile(fname, pack);
+
+  // read back: whole image, then random runs across cluster borders
+  RerrMsg emsg;
+  unique_ptr<Rw11VirtDisk> up = OpenPack(fname, kNBlock, emsg);
+  if (!Check(bool(up), "open pack: failed: " + emsg.Text())) return;
+  Rw11VirtDisk& disk = *up;
+  ReadCmp(disk, 0, kNBlock, img);
+  for (size_t i=0; i<500; i++) {
+    size_t lba  = size_t(rand()) % kNBlock;
+    size_t nblk = 1 + size_t(rand()) % 20;
+    if (lba+nblk > kNBlock) nblk = kNBlock-lba;
+    if (!ReadCmp(disk, lba, nblk, img)) break;
+  }
+  const Rstats& stats = disk.Stats();
+  Check(stats.Value(Rw11VirtDiskPack::kStatNVDPCluZero) > 0,
+        "zero clusters are not loaded");
+  Check(stats.Value(Rw11VirtDiskPack::kStatNVDPCluHit) > 0,
+        "cluster cache hits");
+  Check(stats.Value(Rw11VirtDiskPack::kStatNVDPCluLoad) > kNClu-1,
+        "cluster cache evicts, more clusters than slots");
+
+  // writes go to the overlay, container stays unchanged
+  bytes ref = img;
+  bytes wbuf(3*kBlkSize);
+  for (auto& b : wbuf) b = uint8_t(rand());
+  for (size_t lba : {size_t(0), size_t(7), size_t(14), kNBlock-3}) {
+    Check(disk.Write(lba, 3, wbuf.data(), emsg), "Write() failed");
+    memcpy(ref.data()+lba*kBlkSize, wbuf.data(), wbuf.size());
+  }
+  ReadCmp(disk, 0, kNBlock, ref);
+  up.reset();
+  bytes pack2;
+  ReadFile(fname, pack2);
+  Check(pack2 == pack, "container not modified by writes");
+
+  // disk larger than image: blocks beyond image read as zero
+  up = OpenPack(fname, kNBlock+8, emsg);
+  if (Check(bool(up), "open pack: failed: " + emsg.Text())) {
+    bytes zref = img;
+    zref.resize((kNBlock+8)*kBlkSize, 0);
+    ReadCmp(*up, kNBlock-4, 12, zref);
+  }
+
+  // broken containers must be rejected at open
+  struct patch {
+    const char* fText;
+    size_t      fPos;
+    uint32_t    fVal;
+  };
+  size_t idx2 = Rw11VirtDiskPack::kHdrSize + 2*Rw11VirtDiskPack::kIdxSize;
+  const patch badopen[] = {
+    {"bad magic",                 0,      0x21212121},
+    {"cluster size 0",            8,      0},
+    {"cluster count mismatch",    12,     uint32_t(kNClu+1)},
+    {"image size mismatch",       16,     uint32_t(kImgSize+kCluSize)},
+    {"data offset beyond file",   idx2,   uint32_t(pack.size())},
+    {"raw cluster length",        idx2+8, uint32_t(kCluSize-1)}
+  };
+  for (auto& p : badopen) {
+    bytes bad = pack;
+    Put32(bad, p.fPos, p.fVal);
+    WriteFile(fname, bad);
+    up = OpenPack(fname, kNBlock, emsg);
+    Check(!up, string("open rejects container with ") + p.fText);
+  }
+  bytes shrt(pack.begin(), pack.begin()+Rw11VirtDiskPack::kHdrSize+8);
+  WriteFile(fname, shrt);
+  up = OpenPack(fname, kNBlock, emsg);
+  Check(!up, "open rejects container with truncated index");
+
+  // corrupt compressed data is detected when the cluster is loaded
+  bytes bad = pack;
+  for (size_t i=0; i<8; i++) bad[info.fOffset[0]+4+i] ^= 0x55;
+  WriteFile(fname, bad);
+  up = OpenPack(fname, kNBlock, emsg);
+  if (Check(bool(up), "open pack with corrupt data: " + emsg.Text())) {
+    bytes buf(kBlkSize);
+    Check(!up->Read(0, 1, buf.data(), emsg), "Read() fails on bad data");
+    Check(up->Read(2*kCluSize/kBlkSize, 1, buf.data(), emsg),
+          "Read() of other clusters still works");
+  }
+  return;
+}
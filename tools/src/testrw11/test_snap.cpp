@@ -0,0 +1,227 @@
+// $Id: test_snap.cpp 1306 2026-10-19 20:41:12Z mueller $
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// 
+// Revision History: 
+// Date         Rev Version  Comment
+// 2026-10-19  1306   1.0    Initial version
+
+// Rw11VirtDiskOver: snapshot layers. A two layer chain is created, loaded
+// again at each level, the top layer discarded and committed, and finally
+// everything committed into the base file. After each step the disk must
+// read as expected and the base file may only change on the last commit.
+
+#include <unistd.h>
+
+#include <cstring>
+#include <cstdlib>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "librtools/RerrMsg.hpp"
+#include "librw11/Rw11VirtDisk.hpp"
+#include "librw11/Rw11VirtDiskOver.hpp"
+
+#include "testrw11.hpp"
+
+using namespace std;
+using namespace Retro;
+
+static const size_t kBlkSize = 512;
+static const size_t kNBlock  = 256;
+
+typedef vector<uint8_t> bytes;
+
+//------------------------------------------+-----------------------------------
+static unique_ptr<Rw11VirtDiskOver> OpenOver(const string& url, RerrMsg& emsg)
+{
+  unique_ptr<Rw11VirtDisk> up = Rw11VirtDisk::New("over:" + url, nullptr,
+                                                   emsg);
+  if (!up) return nullptr;
+  up->Setup(kBlkSize, kNBlock, 0, 0, 0);
+  return unique_ptr<Rw11VirtDiskOver>(
+           static_cast<Rw11VirtDiskOver*>(up.release()));
+}
+
+//------------------------------------------+-----------------------------------
+// writes nwrite random runs of random data, keeps ref up to date
+static void WriteRandom(Rw11VirtDisk& disk, bytes& ref, size_t nwrite)
+{
+  RerrMsg emsg;
+  bytes buf(16*kBlkSize);
+  for (size_t i=0; i<nwrite; i++) {
+    size_t lba  = size_t(rand()) % kNBlock;
+    size_t nblk = 1 + size_t(rand()) % 16;
+    if (lba+nblk > kNBlock) nblk = kNBlock-lba;
+    for (size_t k=0; k<nblk*kBlkSize; k++) buf[k] = uint8_t(rand());
+    if (!Check(disk.Write(lba, nblk, buf.data(), emsg),
+               "Write() failed: " + emsg.Text())) return;
+    memcpy(ref.data()+lba*kBlkSize, buf.data(), nblk*kBlkSize);
+  }
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+// full read, and reads of random runs, must match ref
+static void ReadCheck(Rw11VirtDisk& disk, const bytes& ref, const string& text)
+{
+  RerrMsg emsg;
+  bytes buf(kNBlock*kBlkSize);
+  if (!Check(disk.Read(0, kNBlock, buf.data(), emsg),
+             text + ": Read() failed: " + emsg.Text())) return;
+  if (!Check(buf == ref, text + ": data differs")) return;
+  for (size_t i=0; i<100; i++) {
+    size_t lba  = size_t(rand()) % kNBlock;
+    size_t nblk = 1 + size_t(rand()) % 32;
+    if (lba+nblk > kNBlock) nblk = kNBlock-lba;
+    disk.Read(lba, nblk, buf.data(), emsg);
+    if (!Check(memcmp(buf.data(), ref.data()+lba*kBlkSize, nblk*kBlkSize) == 0,
+               text + ": partial read differs")) return;
+  }
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+static bool FileExists(const string& fname)
+{
+  return ::access(fname.c_str(), F_OK) == 0;
+}
+
+//------------------------------------------+-----------------------------------
+void TestSnap()
+{
+  string base = TmpName("snap_base.dsk");
+  string l1   = TmpName("snap_l1.lay");
+  string l2   = TmpName("snap_l2.lay");
+
+  srand(815);
+  bytes r0(kNBlock*kBlkSize);
+  for (auto& b : r0) b = uint8_t(rand());
+  WriteFile(base, r0);
+
+  RerrMsg emsg;
+  bytes r1, r2, rnow, fbuf;
+
+  // create chain base <- l1 <- l2; in-memory overlay moves into l1
+  {
+    unique_ptr<Rw11VirtDiskOver> up = OpenOver(base, emsg);
+    if (!Check(bool(up), "open over: failed: " + emsg.Text())) return;
+    Rw11VirtDiskOver& disk = *up;
+    Check(!disk.SnapCommit(emsg), "commit without layer fails");
+    Check(!disk.SnapDiscard(emsg), "discard without layer fails");
+    rnow = r0;
+    WriteRandom(disk, rnow, 10);
+    Check(disk.SnapCreate(l1, emsg), "create l1: " + emsg.Text());
+    Check(disk.SnapDepth() == 1, "depth 1 after create l1");
+    WriteRandom(disk, rnow, 100);
+    r1 = rnow;
+    Check(disk.SnapCreate(l2, emsg), "create l2: " + emsg.Text());
+    Check(!disk.SnapCreate(l2, emsg), "create on existing file fails");
+    WriteRandom(disk, rnow, 100);
+    r2 = rnow;
+    Check(disk.SnapDepth() == 2, "depth 2 after create l2");
+    ReadCheck(disk, r2, "live chain");
+    Check(disk.Stats().Value(Rw11VirtDiskOver::kStatNVDOWriteBlkS) > 0 &&
+          disk.Stats().Value(Rw11VirtDiskOver::kStatNVDOWriteBlkA) > 0,
+          "layer blocks are appended and rewritten");
+  }
+  ReadFile(base, fbuf);
+  Check(fbuf == r0, "base file unchanged by layers");
+
+  // load chain at each level
+  {
+    unique_ptr<Rw11VirtDiskOver> up = OpenOver(base + "?snap=" + l2, emsg);
+    if (!Check(bool(up), "load l2: " + emsg.Text())) return;
+    Check(up->SnapDepth() == 2, "depth 2 after load l2");
+    ostringstream sos;
+    up->SnapList(sos);
+    string list = sos.str();
+    size_t p2 = list.find(l2);
+    size_t p1 = list.find(l1);
+    Check(p2 != string::npos && p1 != string::npos && p2 < p1,
+          "SnapList() shows topmost layer first");
+    ReadCheck(*up, r2, "load l2");
+  }
+  {
+    unique_ptr<Rw11VirtDiskOver> up = OpenOver(base + "?snap=" + l1, emsg);
+    if (!Check(bool(up), "load l1: " + emsg.Text())) return;
+    Check(up->SnapDepth() == 1, "depth 1 after load l1");
+    ReadCheck(*up, r1, "load l1");
+  }
+  {
+    unique_ptr<Rw11VirtDiskOver> up = OpenOver(base + "?snap=" + base, emsg);
+    Check(!up, "load of a non layer file fails");
+  }
+
+  // discard l2: back to l1 state, l2 file removed
+  {
+    unique_ptr<Rw11VirtDiskOver> up = OpenOver(base + "?snap=" + l2, emsg);
+    if (!Check(bool(up), "load l2: " + emsg.Text())) return;
+    Check(up->SnapDiscard(emsg), "discard l2: " + emsg.Text());
+    Check(up->SnapDepth() == 1, "depth 1 after discard");
+    Check(!FileExists(l2), "l2 file removed by discard");
+    ReadCheck(*up, r1, "after discard");
+  }
+
+  // new l2, commit into l1, then l1 into base
+  {
+    unique_ptr<Rw11VirtDiskOver> up = OpenOver(base + "?snap=" + l1, emsg);
+    if (!Check(bool(up), "load l1: " + emsg.Text())) return;
+    Check(up->SnapCreate(l2, emsg), "create l2: " + emsg.Text());
+    rnow = r1;
+    WriteRandom(*up, rnow, 100);
+    Check(up->SnapCommit(emsg), "commit l2: " + emsg.Text());
+    Check(up->SnapDepth() == 1 && !FileExists(l2), "l2 merged and removed");
+    ReadCheck(*up, rnow, "after commit l2");
+    ReadFile(base, fbuf);
+    Check(fbuf == r0, "base file unchanged by commit into l1");
+  }
+  {
+    unique_ptr<Rw11VirtDiskOver> up = OpenOver(base + "?snap=" + l1, emsg);
+    if (!Check(bool(up), "load l1: " + emsg.Text())) return;
+    ReadCheck(*up, rnow, "load l1 after commit l2");
+    Check(up->SnapCommit(emsg), "commit l1: " + emsg.Text());
+    Check(up->SnapDepth() == 0 && !FileExists(l1), "l1 merged and removed");
+    ReadCheck(*up, rnow, "after commit l1");
+  }
+  ReadFile(base, fbuf);
+  Check(fbuf == rnow, "base file holds committed data");
+  r0 = rnow;
+
+  // torn last record is ignored on load and overwritten by next append
+  {
+    unique_ptr<Rw11VirtDiskOver> up = OpenOver(base, emsg);
+    if (!Check(bool(up), "open over: failed: " + emsg.Text())) return;
+    Check(up->SnapCreate(l1, emsg), "create l1: " + emsg.Text());
+    bytes buf(kBlkSize);
+    for (size_t i=0; i<3; i++) {
+      memset(buf.data(), int(i+1), kBlkSize);
+      up->Write(10+i, 1, buf.data(), emsg);
+    }
+  }
+  ReadFile(l1, fbuf);
+  Check(::truncate(l1.c_str(), off_t(fbuf.size()-kBlkSize/2)) == 0,
+        "truncate l1");
+  {
+    unique_ptr<Rw11VirtDiskOver> up = OpenOver(base + "?snap=" + l1, emsg);
+    if (!Check(bool(up), "load torn l1: " + emsg.Text())) return;
+    rnow = r0;
+    memset(rnow.data()+10*kBlkSize, 1, kBlkSize);
+    memset(rnow.data()+11*kBlkSize, 2, kBlkSize);
+    ReadCheck(*up, rnow, "torn record dropped");
+    bytes buf(kBlkSize, 0x77);
+    up->Write(20, 1, buf.data(), emsg);
+    memcpy(rnow.data()+20*kBlkSize, buf.data(), kBlkSize);
+  }
+  {
+    unique_ptr<Rw11VirtDiskOver> up = OpenOver(base + "?snap=" + l1, emsg);
+    if (!Check(bool(up), "reload l1: " + emsg.Text())) return;
+    ReadCheck(*up, rnow, "append after torn record");
+    Check(up->SnapDiscard(emsg), "discard l1: " + emsg.Text());
+  }
+  ReadFile(base, fbuf);
+  Check(fbuf == r0, "base file unchanged by discarded layer");
+  return;
+}
@@ -0,0 +1,143 @@
+// $Id: test_tapidx.cpp 1306 2026-10-19 20:41:12Z mueller $
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// 
+// Revision History: 
+// Date         Rev Version  Comment
+// 2026-10-19  1306   1.0    Initial version
+
+// Rw11VirtTapeTap: record index. The same random sequence of write, space,
+// read and rewind operations is done on a tap with record index and on one
+// opened with ?noidx. Results, tape position and file offset must agree
+// after each operation, and both files must end up identical.
+
+#include <cstring>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "librtools/RerrMsg.hpp"
+#include "librw11/Rw11VirtTapeTap.hpp"
+
+#include "testrw11.hpp"
+
+using namespace std;
+using namespace Retro;
+
+// expose file position for comparison
+struct TapeTap : public Rw11VirtTapeTap {
+  TapeTap() : Rw11VirtTapeTap(nullptr) {}
+  size_t FilePos() const { return fPos; }
+};
+
+//------------------------------------------+-----------------------------------
+static bool Same(TapeTap& a, TapeTap& b)
+{
+  return a.FilePos()   == b.FilePos()   &&
+         a.PosFile()   == b.PosFile()   &&
+         a.PosRecord() == b.PosRecord() &&
+         a.Eom()       == b.Eom()       &&
+         a.Bot()       == b.Bot();
+}
+
+//------------------------------------------+-----------------------------------
+void TestTapIdx()
+{
+  string fidx = TmpName("tapidx_idx.tap");
+  string fnox = TmpName("tapidx_noidx.tap");
+  const size_t nop = 5000;
+
+  RerrMsg emsg;
+  srand(4711);
+  {
+    TapeTap a;
+    TapeTap b;
+    if (!Check(a.Open(fidx, emsg), "open idx: " + emsg.Text())) return;
+    if (!Check(b.Open(fnox + "?noidx", emsg),
+               "open noidx: " + emsg.Text())) return;
+
+    vector<uint8_t> buf(70000);
+    size_t nfail = 0;
+    for (size_t i=0; i<nop && nfail<10; i++) {
+      int    op  = rand() % 10;
+      size_t cnt = size_t(rand()%6 + 1);
+      bool   ra  = false;
+      bool   rb  = false;
+      int    oca = 0;
+      int    ocb = 0;
+      size_t na  = 0;
+      size_t nb  = 0;
+      if (op == 0) {                          // write record, some long
+        size_t len = (rand()%4 == 0) ? size_t(rand()%65535 + 1) :
+                                       size_t(rand()%300 + 1);
+        memset(buf.data(), int(i), len);
+        ra = a.WriteRecord(len, buf.data(), oca, emsg);
+        rb = b.WriteRecord(len, buf.data(), ocb, emsg);
+      } else if (op == 1) {                   // write eof
+        ra = a.WriteEof(emsg);
+        rb = b.WriteEof(emsg);
+      } else if (op <= 4) {                   // space forward
+        ra = a.SpaceForw(cnt, na, oca, emsg);
+        rb = b.SpaceForw(cnt, nb, ocb, emsg);
+      } else if (op <= 7) {                   // space backward
+        ra = a.SpaceBack(cnt, na, oca, emsg);
+        rb = b.SpaceBack(cnt, nb, ocb, emsg);
+      } else if (op == 8) {                   // read, some truncated
+        size_t nbyt = (rand()%2) ? buf.size() : 100;
+        ra = a.ReadRecord(nbyt, buf.data(), na, oca, emsg);
+        rb = b.ReadRecord(nbyt, buf.data(), nb, ocb, emsg);
+      } else {                                // rewind
+        ra = a.Rewind(oca, emsg);
+        rb = b.Rewind(ocb, emsg);
+      }
+      if (!Check(ra == rb && oca == ocb && na == nb && Same(a, b),
+                 "idx and noidx differ at op " + to_string(i) +
+                 " type " + to_string(op))) nfail += 1;
+    }
+    Check(a.Stats().Value(TapeTap::kStatNVTTIdxSpace) > 0,
+          "record index used for spacing");
+    Check(b.Stats().Value(TapeTap::kStatNVTTIdxSpace) == 0,
+          "record index not used with ?noidx");
+  }
+
+  vector<uint8_t> da;
+  vector<uint8_t> db;
+  ReadFile(fidx, da);
+  ReadFile(fnox, db);
+  Check(!da.empty() && da == db, "tap files identical");
+
+  // reopen existing tap: index built on demand, space file by file to EOM
+  {
+    TapeTap a;
+    TapeTap b;
+    if (!Check(a.Open(fidx, emsg), "reopen idx: " + emsg.Text())) return;
+    if (!Check(b.Open(fidx + "?noidx", emsg),
+               "reopen noidx: " + emsg.Text())) return;
+    for (size_t i=0; i<1000; i++) {
+      size_t na = 0;
+      size_t nb = 0;
+      int    oca = 0;
+      int    ocb = 0;
+      bool ra = a.SpaceForw(100000, na, oca, emsg);
+      bool rb = b.SpaceForw(100000, nb, ocb, emsg);
+      if (!Check(ra == rb && oca == ocb && na == nb && Same(a, b),
+                 "reopen: idx and noidx differ")) break;
+      if (oca == Rw11VirtTape::kOpCodeEom) break;
+    }
+    Check(a.Eom(), "reopen: spaced to EOM");
+    Check(a.Stats().Value(TapeTap::kStatNVTTIdxBuild) > 0,
+          "reopen: record index built");
+    for (size_t i=0; i<1000 && !a.Bot(); i++) {
+      size_t na = 0;
+      size_t nb = 0;
+      int    oca = 0;
+      int    ocb = 0;
+      bool ra = a.SpaceBack(100000, na, oca, emsg);
+      bool rb = b.SpaceBack(100000, nb, ocb, emsg);
+      if (!Check(ra == rb && oca == ocb && na == nb && Same(a, b),
+                 "reopen: idx and noidx differ backward")) break;
+    }
+    Check(a.Bot(), "reopen: spaced back to BOT");
+  }
+  return;
+}
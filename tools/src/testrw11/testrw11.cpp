@@ -0,0 +1,142 @@
+// $Id: testrw11.cpp 1306 2026-10-19 20:41:12Z mueller $
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// 
+// Revision History: 
+// Date         Rev Version  Comment
+// 2026-10-19  1306   1.0    Initial version
+
+// testrw11 runs self checks of librw11 parts which work without a w11
+// system, like the disassembler and the disk and tape backends.
+//
+// Each test module checks known results with Check(), a failed check is
+// reported with its text. Scratch files are created in a private
+// directory below $TMPDIR (or /tmp) which is removed at the end. Without
+// arguments all modules are run, otherwise only the named ones. The exit
+// status is 1 when any check failed.
+//
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <dirent.h>
+
+#include <iostream>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "testrw11.hpp"
+
+using namespace std;
+
+// test module table
+struct module {
+  const char* fName;                        //!< module name
+  void      (*fFunc)();                     //!< test function
+};
+
+static const module gModules[] = {
+  {"dasm",   TestDasm},
+  {"pack",   TestPack},
+  {"snap",   TestSnap},
+  {"tapidx", TestTapIdx}
+};
+
+static string gTmpDir;                      // scratch directory
+static size_t gNCheck = 0;                  // checks done
+static size_t gNFail  = 0;                  // checks failed
+
+//------------------------------------------+-----------------------------------
+bool Check(bool ok, const string& text)
+{
+  gNCheck += 1;
+  if (!ok) {
+    gNFail += 1;
+    cout << "  FAIL: " << text << endl;
+  }
+  return ok;
+}
+
+//------------------------------------------+-----------------------------------
+string TmpName(const string& name)
+{
+  return gTmpDir + "/" + name;
+}
+
+//------------------------------------------+-----------------------------------
+bool ReadFile(const string& fname, vector<uint8_t>& data)
+{
+  ifstream ifs(fname, ios::binary);
+  if (!ifs) return false;
+  data.assign(istreambuf_iterator<char>(ifs), istreambuf_iterator<char>());
+  return true;
+}
+
+//------------------------------------------+-----------------------------------
+bool WriteFile(const string& fname, const vector<uint8_t>& data)
+{
+  ofstream ofs(fname, ios::binary|ios::trunc);
+  ofs.write(reinterpret_cast<const char*>(data.data()), data.size());
+  return bool(ofs);
+}
+
+//------------------------------------------+-----------------------------------
+// remove scratch directory and all files in it
+static void CleanTmpDir()
+{
+  DIR* pdir = ::opendir(gTmpDir.c_str());
+  if (pdir) {
+    while (struct dirent* pent = ::readdir(pdir)) {
+      string name(pent->d_name);
+      if (name == "." || name == "..") continue;
+      ::unlink(TmpName(name).c_str());
+    }
+    ::closedir(pdir);
+  }
+  ::rmdir(gTmpDir.c_str());
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+int main(int argc, const char* argv[])
+{
+  vector<const module*> mods;
+  for (int i=1; i<argc; i++) {
+    string arg(argv[i]);
+    const module* pmod = nullptr;
+    for (auto& m : gModules) if (arg == m.fName) pmod = &m;
+    if (pmod == nullptr) {
+      cerr << "testrw11-E: unknown test '" << arg << "', available:";
+      for (auto& m : gModules) cerr << " " << m.fName;
+      cerr << endl;
+      return 1;
+    }
+    mods.push_back(pmod);
+  }
+  if (mods.empty()) for (auto& m : gModules) mods.push_back(&m);
+
+  const char* tmp = ::getenv("TMPDIR");
+  string tmpl = string((tmp && *tmp) ? tmp : "/tmp") + "/testrw11_XXXXXX";
+  vector<char> buf(tmpl.begin(), tmpl.end());
+  buf.push_back(0);
+  if (::mkdtemp(buf.data()) == nullptr) {
+    cerr << "testrw11-E: can't create scratch directory " << tmpl << endl;
+    return 1;
+  }
+  gTmpDir = buf.data();
+
+  for (auto pmod : mods) {
+    size_t ncheck = gNCheck;
+    size_t nfail  = gNFail;
+    cout << "-- " << pmod->fName << endl;
+    pmod->fFunc();
+    cout << "   " << gNCheck-ncheck << " checks, "
+         << gNFail-nfail << " failed" << endl;
+  }
+  CleanTmpDir();
+
+  cout << "testrw11: " << gNCheck << " checks, " << gNFail << " failed"
+       << endl;
+  return gNFail ? 1 : 0;
+}
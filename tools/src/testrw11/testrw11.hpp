@@ -0,0 +1,31 @@
+// $Id: testrw11.hpp 1306 2026-10-19 20:41:12Z mueller $
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// 
+// Revision History: 
+// Date         Rev Version  Comment
+// 2026-10-19  1306   1.0    Initial version
+// ---------------------------------------------------------------------------
+
+// checks and helpers shared by the testrw11 test modules
+
+#ifndef included_testrw11
+#define included_testrw11 1
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+bool        Check(bool ok, const std::string& text);
+std::string TmpName(const std::string& name);
+bool        ReadFile(const std::string& fname, std::vector<uint8_t>& data);
+bool        WriteFile(const std::string& fname,
+                      const std::vector<uint8_t>& data);
+
+// test modules, failures are reported and counted via Check()
+void        TestDasm();
+void        TestPack();
+void        TestSnap();
+void        TestTapIdx();
+
+#endif
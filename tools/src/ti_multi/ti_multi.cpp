@@ -0,0 +1,414 @@
+// $Id: ti_multi.cpp 1293 2026-10-19 11:32:18Z mueller $
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+// 
+// Revision History: 
+// Date         Rev Version  Comment
+// 2026-10-19  1306   1.0.1  WriteStats(): handle TYPE lines
+// 2026-10-19  1293   1.0    Initial version
+
+// ti_multi runs several ti_rri sessions, called systems here, in one process.
+//
+// Each system gets a thread of its own with a Tcl interpreter of its own.
+// The usual rlc, rls and w11 objects and the rlink server thread are thus
+// per system, while shared libraries, Tcl packages and the page cache for
+// base disk images are shared. The system thread can be pinned to a core,
+// the rlink server thread it creates inherits the affinity.
+//
+// The 'exit' command is replaced in each interpreter. It records the exit
+// code, collects the statistics of the system, and unwinds the interpreter
+// without terminating the process.
+//
+// As for tclshcpp, <iostream> is included to ensure that the C++ I/O streams
+// are initialized before any Tcl interpreter starts.
+//
+
+#include "tcl.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace std;
+
+struct job {
+  size_t          fIndex;                   //!< job index
+  string          fName;                    //!< system name
+  vector<string>  fArgs;                    //!< ti_rri arguments
+  int             fCore;                    //!< core to pin to (-1 if none)
+  bool            fDone;                    //!< job finished
+  bool            fExitSeen;                //!< exit command seen
+  int             fRc;                      //!< exit code
+  double          fTime;                    //!< run time in sec
+  string          fStats;                   //!< statistics, prom format
+};
+
+struct mentry {
+  string          fHelp;                    //!< HELP line of metric
+  string          fType;                    //!< TYPE line of metric
+  vector<string>  fSample;                  //!< samples of all systems
+};
+
+static vector<int>    gCpus;                // cores for --cpus
+static size_t         gNJob = 0;            // max concurrent jobs
+static string         gStats;               // consolidated stats file
+static string         gLogDir = ".";        // log file directory
+static string         gScript;              // per system script
+static vector<job>    gJobs;                // job list
+static atomic<size_t> gNextJob(0);          // next job to start
+static mutex          gMutex;               // protects report and stats
+
+// collects all stats of a system, same as rw11::stats_prom
+static const char* kStatsScript =
+  "apply {{} {\n"
+  "  set rval {}\n"
+  "  foreach cmd {rlc rls} {\n"
+  "    if {[info commands $cmd] ne \"\"} { lappend rval [$cmd stats -prom] }\n"
+  "  }\n"
+  "  foreach cmd [lsort [info commands cpu*]] {\n"
+  "    if {[catch {$cmd stats -prom} res] == 0} { lappend rval $res }\n"
+  "    if {[catch {$cmd virt stats -prom} res] == 0} { lappend rval $res }\n"
+  "  }\n"
+  "  return [join $rval \"\\n\"]\n"
+  "}}\n";
+
+//------------------------------------------+-----------------------------------
+static double TimeNow()
+{
+  struct timespec ts;
+  ::clock_gettime(CLOCK_MONOTONIC, &ts);
+  return double(ts.tv_sec) + 1.e-9 * double(ts.tv_nsec);
+}
+
+//------------------------------------------+-----------------------------------
+// collect stats, add a sys label to all samples
+static void CollectStats(job& j, Tcl_Interp* interp)
+{
+  if (Tcl_EvalEx(interp, kStatsScript, -1, TCL_EVAL_GLOBAL) != TCL_OK) {
+    Tcl_ResetResult(interp);
+    return;
+  }
+  string text = Tcl_GetStringResult(interp);
+  string label = "{sys=\"" + j.fName + "\",obj=";
+  string rval;
+  size_t pos = 0;
+  while (true) {
+    size_t ind = text.find("{obj=", pos);
+    if (ind == string::npos) break;
+    rval.append(text, pos, ind-pos);
+    rval.append(label);
+    pos = ind + 5;
+  }
+  rval.append(text, pos, string::npos);
+  j.fStats = rval;
+  Tcl_ResetResult(interp);
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+// replacement for 'exit': record rc, get stats, unwind interpreter
+static int ExitCmd(ClientData cdata, Tcl_Interp* interp, int objc,
+                   Tcl_Obj* const objv[])
+{
+  job& j = *reinterpret_cast<job*>(cdata);
+  int rc = 0;
+  if (objc > 2) {
+    Tcl_WrongNumArgs(interp, 1, objv, "?returnCode?");
+    return TCL_ERROR;
+  }
+  if (objc == 2 && Tcl_GetIntFromObj(interp, objv[1], &rc) != TCL_OK)
+    return TCL_ERROR;
+
+  j.fRc       = rc;
+  j.fExitSeen = true;
+  CollectStats(j, interp);
+  Tcl_CancelEval(interp, nullptr, nullptr, TCL_CANCEL_UNWIND);
+  return TCL_ERROR;
+}
+
+//------------------------------------------+-----------------------------------
+// write consolidated stats of all finished jobs (call with gMutex held)
+static void WriteStats()
+{
+  if (gStats.empty()) return;
+  string ftmp = gStats + ".tmp";
+  ofstream ofs(ftmp.c_str());
+  if (!ofs) {
+    cerr << "ti_multi-E: failed to create '" << ftmp << "'" << endl;
+    return;
+  }
+  ofs << "# HELP timulti_rc system exit code\n";
+  ofs << "# TYPE timulti_rc gauge\n";
+  for (auto& j: gJobs) {
+    if (j.fDone) ofs << "timulti_rc{sys=\"" << j.fName << "\"} "
+                     << j.fRc << "\n";
+  }
+  ofs << "# HELP timulti_time system run time in sec\n";
+  ofs << "# TYPE timulti_time gauge\n";
+  for (auto& j: gJobs) {
+    if (j.fDone) ofs << "timulti_time{sys=\"" << j.fName << "\"} "
+                     << j.fTime << "\n";
+  }
+
+  // group samples of all systems by metric, as the text format requires
+  vector<string> order;
+  map<string, mentry> fmap;
+  for (auto& j: gJobs) {
+    if (!j.fDone) continue;
+    istringstream iss(j.fStats);
+    string line;
+    while (getline(iss, line)) {
+      if (line.compare(0, 7, "# HELP ") == 0 ||
+          line.compare(0, 7, "# TYPE ") == 0) {
+        string mname = line.substr(7, line.find(' ', 7)-7);
+        if (fmap.find(mname) == fmap.end()) order.push_back(mname);
+        if (line[2] == 'H') {
+          fmap[mname].fHelp = line;
+        } else {
+          fmap[mname].fType = line;
+        }
+      } else if (!line.empty()) {
+        string mname = line.substr(0, line.find('{'));
+        if (fmap.find(mname) == fmap.end()) order.push_back(mname);
+        fmap[mname].fSample.push_back(line);
+      }
+    }
+  }
+  for (auto& mname: order) {
+    auto& ent = fmap[mname];
+    if (!ent.fHelp.empty()) ofs << ent.fHelp << "\n";
+    if (!ent.fType.empty()) ofs << ent.fType << "\n";
+    for (auto& l: ent.fSample) ofs << l << "\n";
+  }
+  ofs.close();
+  if (::rename(ftmp.c_str(), gStats.c_str()) != 0)
+    cerr << "ti_multi-E: failed to rename '" << ftmp << "'" << endl;
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+// run one system in the calling thread
+static void RunJob(job& j)
+{
+  if (j.fCore >= 0) {
+    cpu_set_t cset;
+    CPU_ZERO(&cset);
+    CPU_SET(j.fCore, &cset);
+    if (::pthread_setaffinity_np(::pthread_self(), sizeof(cset), &cset) != 0)
+      cerr << "ti_multi-W: " << j.fName << ": failed to pin to core "
+           << j.fCore << endl;
+  }
+
+  // stdout and stderr are thread specific in Tcl, redirect them to a log
+  string lname = gLogDir + "/" + j.fName + ".log";
+  Tcl_Channel chan = Tcl_OpenFileChannel(nullptr, lname.c_str(), "w", 0644);
+  if (!chan) {
+    cerr << "ti_multi-E: " << j.fName << ": failed to create '" << lname
+         << "'" << endl;
+    j.fRc = 1;
+    return;
+  }
+  Tcl_RegisterChannel(nullptr, chan);
+  Tcl_SetStdChannel(chan, TCL_STDOUT);
+  Tcl_SetStdChannel(chan, TCL_STDERR);
+
+  Tcl_Interp* interp = Tcl_CreateInterp();
+  double tbeg = TimeNow();
+  int irc = Tcl_Init(interp);
+
+  if (irc == TCL_OK) {
+    Tcl_Obj* pargv = Tcl_NewListObj(0, nullptr);
+    for (auto& a: j.fArgs)
+      Tcl_ListObjAppendElement(nullptr, pargv,
+                               Tcl_NewStringObj(a.c_str(), -1));
+    Tcl_SetVar(interp, "argv0", gScript.c_str(), TCL_GLOBAL_ONLY);
+    Tcl_SetVar2Ex(interp, "argv", nullptr, pargv, TCL_GLOBAL_ONLY);
+    Tcl_SetVar2Ex(interp, "argc", nullptr, Tcl_NewIntObj(int(j.fArgs.size())),
+                  TCL_GLOBAL_ONLY);
+    Tcl_SetVar(interp, "tcl_interactive", "0", TCL_GLOBAL_ONLY);
+    Tcl_SetVar(interp, "tirri_embedded", j.fName.c_str(), TCL_GLOBAL_ONLY);
+    Tcl_CreateObjCommand(interp, "exit", ExitCmd,
+                         reinterpret_cast<ClientData>(&j), nullptr);
+    irc = Tcl_EvalFile(interp, gScript.c_str());
+  }
+
+  if (!j.fExitSeen) {                       // script ended without exit
+    if (irc != TCL_OK) {
+      const char* einfo = Tcl_GetVar(interp, "errorInfo", TCL_GLOBAL_ONLY);
+      string emsg = string("-E: ") + (einfo ? einfo :
+                                      Tcl_GetStringResult(interp)) + "\n";
+      Tcl_WriteChars(chan, emsg.c_str(), -1);
+      j.fRc = 1;
+    }
+    CollectStats(j, interp);
+    Tcl_EvalEx(interp, "if {[info commands rls] eq \"rls\"} {rls server -stop}",
+               -1, TCL_EVAL_GLOBAL);
+  }
+  j.fTime = TimeNow() - tbeg;
+
+  Tcl_DeleteInterp(interp);
+  Tcl_SetStdChannel(nullptr, TCL_STDOUT);
+  Tcl_SetStdChannel(nullptr, TCL_STDERR);
+  Tcl_UnregisterChannel(nullptr, chan);
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+static void Worker()
+{
+  while (true) {
+    size_t ind = gNextJob++;
+    if (ind >= gJobs.size()) break;
+    job& j = gJobs[ind];
+    RunJob(j);
+
+    lock_guard<mutex> lock(gMutex);
+    j.fDone = true;
+    cout << "ti_multi-I: " << j.fName << " rc=" << j.fRc
+         << " time=" << j.fTime << "s";
+    if (j.fCore >= 0) cout << " core=" << j.fCore;
+    cout << endl;
+    WriteStats();
+  }
+  Tcl_FinalizeThread();
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+// parse a core list like 0,2,4-7
+static bool ParseCpus(const string& str)
+{
+  istringstream iss(str);
+  string item;
+  while (getline(iss, item, ',')) {
+    int beg = 0;
+    int end = 0;
+    char dash = 0;
+    istringstream is(item);
+    if (!(is >> beg)) return false;
+    end = beg;
+    if (is >> dash) {
+      if (dash != '-' || !(is >> end) || end < beg) return false;
+    }
+    for (int i=beg; i<=end; i++) gCpus.push_back(i);
+  }
+  return !gCpus.empty();
+}
+
+//------------------------------------------+-----------------------------------
+static void PrintHelp()
+{
+  cout << "usage: ti_multi [OPTION]... JOBFILE\n"
+       << "  runs one ti_rri session per JOBFILE line in a single process.\n"
+       << "  Each line holds the ti_rri arguments of one system as Tcl list,\n"
+       << "  empty lines and lines starting with # are ignored.\n"
+       << "  Options:\n"
+       << "    --cpus=LIST    pin system i to core LIST[i % n], e.g. 2,4-7\n"
+       << "    --njob=N       run at most N systems concurrently\n"
+       << "    --stats=FILE   write consolidated stats after each system\n"
+       << "    --logdir=DIR   directory for the s<i>.log files (default .)\n"
+       << "    --script=FILE  per system script (default ti_rri)\n"
+       << "    --help         this message\n";
+  return;
+}
+
+//------------------------------------------+-----------------------------------
+int main(int argc, char **argv)
+{
+  Tcl_FindExecutable(argv[0]);
+
+  string jobfile;
+  for (int i=1; i<argc; i++) {
+    string arg = argv[i];
+    string val;
+    size_t ieq = arg.find('=');
+    if (ieq != string::npos) val = arg.substr(ieq+1);
+    if        (arg.compare(0, 7, "--cpus=") == 0) {
+      if (!ParseCpus(val)) {
+        cerr << "ti_multi-E: bad core list '" << val << "'" << endl;
+        return 1;
+      }
+    } else if (arg.compare(0, 7, "--njob=") == 0) {
+      gNJob = ::strtoul(val.c_str(), nullptr, 10);
+    } else if (arg.compare(0, 8, "--stats=") == 0) {
+      gStats = val;
+    } else if (arg.compare(0, 9, "--logdir=") == 0) {
+      gLogDir = val;
+    } else if (arg.compare(0, 9, "--script=") == 0) {
+      gScript = val;
+    } else if (arg == "--help") {
+      PrintHelp();
+      return 0;
+    } else if (arg.compare(0, 1, "-") == 0 || !jobfile.empty()) {
+      cerr << "ti_multi-E: bad option or argument '" << arg
+           << "', see --help" << endl;
+      return 1;
+    } else {
+      jobfile = arg;
+    }
+  }
+
+  if (jobfile.empty()) {
+    PrintHelp();
+    return 1;
+  }
+  if (gScript.empty()) {
+    const char* rbase = ::getenv("RETROBASE");
+    if (!rbase) {
+      cerr << "ti_multi-E: RETROBASE environment variable not defined" << endl;
+      return 1;
+    }
+    gScript = string(rbase) + "/tools/bin/ti_rri";
+  }
+
+  ifstream ifs(jobfile.c_str());
+  if (!ifs) {
+    cerr << "ti_multi-E: failed to open '" << jobfile << "'" << endl;
+    return 1;
+  }
+  string line;
+  while (getline(ifs, line)) {
+    size_t ibeg = line.find_first_not_of(" \t");
+    if (ibeg == string::npos || line[ibeg] == '#') continue;
+    int          nelem;
+    const char** pelem;
+    if (Tcl_SplitList(nullptr, line.c_str(), &nelem, &pelem) != TCL_OK) {
+      cerr << "ti_multi-E: bad job line '" << line << "'" << endl;
+      return 1;
+    }
+    job j = {};
+    j.fIndex = gJobs.size();
+    j.fName  = "s" + to_string(j.fIndex);
+    j.fCore  = gCpus.empty() ? -1 : gCpus[j.fIndex % gCpus.size()];
+    for (int k=0; k<nelem; k++) j.fArgs.push_back(pelem[k]);
+    Tcl_Free(reinterpret_cast<char*>(pelem));
+    gJobs.push_back(j);
+  }
+  if (gJobs.empty()) {
+    cerr << "ti_multi-E: no jobs in '" << jobfile << "'" << endl;
+    return 1;
+  }
+
+  size_t nthread = gJobs.size();
+  if (gNJob > 0 && gNJob < nthread) nthread = gNJob;
+  vector<thread> threads;
+  for (size_t i=0; i<nthread; i++) threads.emplace_back(Worker);
+  for (auto& t: threads) t.join();
+
+  int rc = 0;
+  for (auto& j: gJobs) if (j.fRc != 0) rc = 1;
+  Tcl_Finalize();
+  return rc;
+}
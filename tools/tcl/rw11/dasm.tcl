@@ -1,9 +1,11 @@
 # $Id: dasm.tcl 1177 2019-06-30 12:34:07Z mueller $
 # SPDX-License-Identifier: GPL-3.0-or-later
-# Copyright 2015- by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+# Copyright 2015-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 #
 #  Revision History:
 # Date         Rev Version  Comment
+# 2026-10-19  1303   1.1.1  BUGFIX: dasm_opdsc: sort seti before setd, the
+#                           binary search in dasm_getdsc missed setd
 # 2015-12-25   717   1.1    add dasm_inst2txt; add nriName arg in dasm_iline
 # 2015-08-04   709   1.0    Initial version
 # 2015-07-26   705   0.1    First draft
@@ -105,8 +107,8 @@ namespace eval rw11 {
   {0160000 0007777  sub     2arg  {sr dm}  b } \
   {0170000 0000000  !cfcc   0arg  {}       - } \
   {0170001 0000000  !setf   0arg  {}       - } \
-  {0170011 0000000  !setd   0arg  {}       - } \
   {0170002 0000000  !seti   0arg  {}       - } \
+  {0170011 0000000  !setd   0arg  {}       - } \
   {0170012 0000000  !setl   0arg  {}       - } \
   {0170100 0000077  !ldfps  1fpp  {dr}     w } \
   {0170200 0000077  !stfps  1fpp  {dw}     w } \
@@ -0,0 +1,119 @@
+# $Id: prof.tcl 1298 2026-10-19 16:02:44Z mueller $
+# SPDX-License-Identifier: GPL-3.0-or-later
+# Copyright 2026- by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+#
+#  Revision History:
+# Date         Rev Version  Comment
+# 2026-10-19  1298   1.0    Initial version
+#
+
+package provide rw11 1.0
+
+package require rlink
+package require rwxxtpp
+
+namespace eval rw11 {
+  #
+  # prof_load: read profile file written with 'cpu prof -write' --------------
+  #   returns list of {mode pc count}, like 'cpu prof -get'
+  #
+  proc prof_load {file} {
+    set fh [open $file r]
+    set rval {}
+    while {[gets $fh line] >= 0} {
+      if {[string match "#*" $line]} {continue}
+      if {[llength $line] != 3} {continue}
+      lassign $line mode pc count
+      lappend rval [list $mode [scan $pc %o] $count]
+    }
+    close $fh
+    return $rval
+  }
+
+  #
+  # prof_symload: read symbol map, returns list of {addr name} sorted by addr
+  #   accepts 'addr name' and nm style 'addr type name' lines, addr in octal
+  #
+  proc prof_symload {file} {
+    set fh [open $file r]
+    set rval {}
+    while {[gets $fh line] >= 0} {
+      if {[llength $line] < 2} {continue}
+      set addr [lindex $line 0]
+      if {![regexp {^[0-7]+$} $addr]} {continue}
+      lappend rval [list [expr {[scan $addr %o] & 0177777}] \
+                         [lindex $line end]]
+    }
+    close $fh
+    return [lsort -integer -index 0 $rval]
+  }
+
+  #
+  # prof_print: print profile, optionally symbolized ------------------------
+  #   plist:   list of {mode pc count} from 'cpu prof -get' or prof_load
+  #   symfile: symbol map (see prof_symload), when given samples are
+  #            accumulated per symbol
+  #   mode:    only samples of mode k, s or u, all when empty
+  #   nmax:    maximal number of lines printed
+  #
+  proc prof_print {plist {symfile ""} {mode ""} {nmax 20}} {
+    set ntot 0
+    set bins {}
+    foreach item $plist {
+      lassign $item imode pc count
+      if {$mode ne "" && $imode ne $mode} {continue}
+      incr ntot $count
+      lappend bins $item
+    }
+    if {$ntot == 0} {return "no samples"}
+
+    if {$symfile ne ""} {
+      set syms [prof_symload $symfile]
+      set nsym [llength $syms]
+      array set symcnt {}
+      foreach item $bins {
+        lassign $item imode pc count
+        # binary search for last symbol with addr <= pc
+        set lo 0
+        set hi [expr {$nsym - 1}]
+        set isym -1
+        while {$lo <= $hi} {
+          set mid [expr {($lo + $hi) / 2}]
+          if {[lindex $syms $mid 0] <= $pc} {
+            set isym $mid
+            set lo [expr {$mid + 1}]
+          } else {
+            set hi [expr {$mid - 1}]
+          }
+        }
+        set key [expr {$isym >= 0 ? [lindex $syms $isym 1] : "?"}]
+        set key "$imode:$key"
+        if {[info exists symcnt($key)]} {
+          incr symcnt($key) $count
+        } else {
+          set symcnt($key) $count
+        }
+      }
+      set bins {}
+      foreach key [array names symcnt] {
+        lappend bins [list $key $symcnt($key)]
+      }
+      set bins [lsort -integer -decreasing -index 1 $bins]
+      set rval [format "%10s %6s  %s" "count" "pct" "symbol"]
+      foreach item [lrange $bins 0 [expr {$nmax - 1}]] {
+        lassign $item key count
+        append rval "\n" [format "%10d %6.2f  %s" $count \
+                            [expr {100. * $count / $ntot}] $key]
+      }
+      return $rval
+    }
+
+    set rval [format "%4s %6s %10s %6s" "mode" "pc" "count" "pct"]
+    foreach item [lrange $bins 0 [expr {$nmax - 1}]] {
+      lassign $item imode pc count
+      append rval "\n" [format "%4s %6.6o %10d %6.2f" $imode $pc $count \
+                          [expr {100. * $count / $ntot}]]
+    }
+    return $rval
+  }
+}
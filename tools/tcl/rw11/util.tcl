@@ -1,9 +1,12 @@
 # $Id: util.tcl 1177 2019-06-30 12:34:07Z mueller $
 # SPDX-License-Identifier: GPL-3.0-or-later
-# Copyright 2013-2019 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
+# Copyright 2013-2026 by Walter F.J. Mueller <W.F.J.Mueller@gsi.de>
 #
 #  Revision History:
 # Date         Rev Version  Comment
+# 2026-10-19  1306   1.3.16 stats_prom: one HELP,TYPE per metric
+# 2026-10-19  1296   1.3.15 setup_{ostr,lp,pp}: add async; BUGFIX: use lappend
+# 2026-10-19  1288   1.3.14 add stats_prom
 # 2019-05-04  1146   1.3.13 add dz11 support
 # 2019-04-27  1140   1.3.12 setup_tt: add dl{rxqlim,txrlim}; dlrrlim->dlrxrlim
 # 2019-04-20  1134   1.3.11 setup_pp: add {pr,pp}rlim and prqlim options
@@ -145,15 +148,18 @@ namespace eval rw11 {
   # 
   proc setup_ostr {cpu unit args} {
     # process and check options
-    args2opts opt {app 0 nbck 1} {*}$args
+    args2opts opt {app 0 nbck 1 async 0} {*}$args
 
     # setup attach url options
     set urloptlist {}
     if {$opt(app) != 0} {
-      append urloptlist "app"
+      lappend urloptlist "app"
     }
     if {$opt(nbck) != 0} {
-      append urloptlist "bck=$opt(nbck)"
+      lappend urloptlist "bck=$opt(nbck)"
+    }
+    if {$opt(async) != 0} {
+      lappend urloptlist "async"
     }
     set urlopt ""
     if {[llength $urloptlist] > 0} {
@@ -171,9 +177,9 @@ namespace eval rw11 {
   # 
   proc setup_lp {{cpu "cpu0"} args} {
     # process and check options
-    args2opts opt {nlp 1 rlim 0 app 0 nbck 1} {*}$args
+    args2opts opt {nlp 1 rlim 0 app 0 nbck 1 async 0} {*}$args
     if {$opt(nlp) != 0} {
-      setup_ostr $cpu "lpa0" app $opt(app) nbck $opt(nbck)
+      setup_ostr $cpu "lpa0" app $opt(app) nbck $opt(nbck) async $opt(async)
       ${cpu}lpa set rlim $opt(rlim)
     }
   }
@@ -182,9 +188,10 @@ namespace eval rw11 {
   # 
   proc setup_pp {{cpu "cpu0"} args} {
     # process and check options
-    args2opts opt {npc 1 pprlim 0 prrlim 0 prqlim 0 app 0 nbck 1} {*}$args
+    args2opts opt {npc 1 pprlim 0 prrlim 0 prqlim 0 app 0 nbck 1 async 0} \
+      {*}$args
     if {$opt(npc) != 0} {
-      setup_ostr $cpu "pp" app $opt(app) nbck $opt(nbck)
+      setup_ostr $cpu "pp" app $opt(app) nbck $opt(nbck) async $opt(async)
       ${cpu}pca set pprlim $opt(pprlim)
       ${cpu}pca set prrlim $opt(prrlim)
       ${cpu}pca set prqlim $opt(prqlim)
@@ -277,4 +284,56 @@ namespace eval rw11 {
 
     return [list $lolim $hilim]
   }
+
+  #
+  # stats_prom: export all counters in Prometheus text format ----------------
+  #   collects rlc, rls, cpu, controller and attached virt stats, grouped
+  #   by metric with one HELP and TYPE line each. When fname is given, the
+  #   file is written via a temporary and renamed, so that a textfile
+  #   collector never sees a partial file.
+  # 
+  proc stats_prom {{fname ""} {cpu "cpu0"}} {
+    set rval {}
+    foreach cmd {rlc rls} {
+      if {[info commands $cmd] ne ""} { lappend rval [$cmd stats -prom] }
+    }
+    foreach cmd [lsort [info commands "${cpu}*"]] {
+      if {[catch {$cmd stats -prom} res] == 0} { lappend rval $res }
+      if {[catch {$cmd virt stats -prom} res] == 0} { lappend rval $res }
+    }
+
+    # group by metric: one HELP and TYPE line, then samples of all objects
+    set order {}
+    foreach line [split [join $rval "\n"] "\n"] {
+      if {$line eq ""} { continue }
+      if {[regexp {^# (HELP|TYPE) (\S+)} $line dummy key mname]} {
+        set mhead($key,$mname) $line
+      } else {
+        set mname [lindex [split $line "\{ "] 0]
+        lappend msamp($mname) $line
+      }
+      if {![info exists mseen($mname)]} {
+        set mseen($mname) 1
+        lappend order $mname
+      }
+    }
+    set rval {}
+    foreach mname $order {
+      foreach key {HELP TYPE} {
+        if {[info exists mhead($key,$mname)]} {
+          lappend rval $mhead($key,$mname)
+        }
+      }
+      if {[info exists msamp($mname)]} { lappend rval {*}$msamp($mname) }
+    }
+    set rval [join $rval "\n"]
+
+    if {$fname eq ""} { return $rval }
+    set ftmp "${fname}.tmp"
+    set fh [open $ftmp w]
+    puts $fh $rval
+    close $fh
+    file rename -force $ftmp $fname
+    return
+  }
 }